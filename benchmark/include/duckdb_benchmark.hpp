@@ -23,7 +23,8 @@ struct DuckDBBenchmarkState : public BenchmarkState {
 	Connection conn;
 	unique_ptr<QueryResult> result;
 
-	DuckDBBenchmarkState(string path) : db(path.empty() ? nullptr : path.c_str()), conn(db) {
+	DuckDBBenchmarkState(string path, DBConfig *config = nullptr)
+	    : db(path.empty() ? nullptr : path.c_str(), config), conn(db) {
 		conn.EnableProfiling();
 	}
 	virtual ~DuckDBBenchmarkState() {
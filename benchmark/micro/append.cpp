@@ -2,6 +2,8 @@
 #include "duckdb_benchmark_macro.hpp"
 #include "duckdb/main/appender.hpp"
 
+#include <thread>
+
 using namespace duckdb;
 using namespace std;
 
@@ -219,3 +221,67 @@ string BenchmarkInfo() override {
 	return "Write 100K 4-byte integers to CSV";
 }
 FINISH_BENCHMARK(Write100KIntegers)
+
+////////////////////////
+// CONCURRENT COMMITS //
+////////////////////////
+struct DuckDBConcurrentState : public DuckDBBenchmarkState {
+	vector<unique_ptr<Connection>> connections;
+
+	DuckDBConcurrentState(string path, DBConfig *config) : DuckDBBenchmarkState(path, config) {
+	}
+	virtual ~DuckDBConcurrentState() {
+	}
+};
+
+#define APPEND_BENCHMARK_CONCURRENT(THREADS, GROUP_COMMIT_WINDOW)                                                      \
+	unique_ptr<DuckDBBenchmarkState> CreateBenchmarkState() override {                                                 \
+		DBConfig config;                                                                                               \
+		config.wal_group_commit_window = GROUP_COMMIT_WINDOW;                                                          \
+		auto result = make_unique<DuckDBConcurrentState>(GetDatabasePath(), &config);                                  \
+		return move(result);                                                                                           \
+	}                                                                                                                  \
+	void Load(DuckDBBenchmarkState *state_) override {                                                                 \
+		auto state = (DuckDBConcurrentState *)state_;                                                                  \
+		state->conn.Query("CREATE TABLE integers(i INTEGER)");                                                         \
+		for (int32_t i = 0; i < THREADS; i++) {                                                                        \
+			state->connections.push_back(make_unique<Connection>(state->db));                                          \
+		}                                                                                                              \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state_) override {                                                         \
+		auto state = (DuckDBConcurrentState *)state_;                                                                  \
+		vector<thread> threads;                                                                                        \
+		for (int32_t t = 0; t < THREADS; t++) {                                                                        \
+			threads.push_back(thread([state, t]() {                                                                    \
+				for (int32_t i = 0; i < 1000; i++) {                                                                   \
+					state->connections[t]->Query("INSERT INTO integers VALUES (" + to_string(t * 1000 + i) + ")");     \
+				}                                                                                                      \
+			}));                                                                                                       \
+		}                                                                                                              \
+		for (auto &thread : threads) {                                                                                 \
+			thread.join();                                                                                             \
+		}                                                                                                              \
+	}                                                                                                                  \
+	void Cleanup(DuckDBBenchmarkState *state_) override {                                                              \
+		auto state = (DuckDBConcurrentState *)state_;                                                                  \
+		state->connections.clear();                                                                                    \
+		state->conn.Query("DROP TABLE integers");                                                                      \
+		Load(state);                                                                                                   \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Append 1K 4-byte integers from each of " #THREADS " concurrent connections, one INSERT per commit";    \
+	}
+
+DUCKDB_BENCHMARK(Append8KIntegersConcurrentINSERT, "[append]")
+APPEND_BENCHMARK_CONCURRENT(8, 0)
+FINISH_BENCHMARK(Append8KIntegersConcurrentINSERT)
+
+DUCKDB_BENCHMARK(Append8KIntegersConcurrentINSERTGroupWindow, "[append]")
+APPEND_BENCHMARK_CONCURRENT(8, 200)
+FINISH_BENCHMARK(Append8KIntegersConcurrentINSERTGroupWindow)
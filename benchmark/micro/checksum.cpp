@@ -0,0 +1,51 @@
+#include "benchmark_runner.hpp"
+#include "duckdb_benchmark_macro.hpp"
+#include "duckdb/common/checksum.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+#define CHECKSUM_BLOCK_COUNT 4096
+
+struct DuckDBChecksumState : public DuckDBBenchmarkState {
+	vector<uint8_t> block;
+	uint32_t checksum;
+
+	DuckDBChecksumState(string path) : DuckDBBenchmarkState(path), block(Storage::BLOCK_ALLOC_SIZE), checksum(0) {
+	}
+	virtual ~DuckDBChecksumState() {
+	}
+};
+
+//! Compute the checksum of a block over and over, which measures the checksum throughput per block
+#define CHECKSUM_BENCHMARK(FUNCTION)                                                                                   \
+	unique_ptr<DuckDBBenchmarkState> CreateBenchmarkState() override {                                                 \
+		auto result = make_unique<DuckDBChecksumState>(GetDatabasePath());                                             \
+		return move(result);                                                                                           \
+	}                                                                                                                  \
+	void Load(DuckDBBenchmarkState *state_) override {                                                                 \
+		auto state = (DuckDBChecksumState *)state_;                                                                    \
+		for (index_t i = 0; i < state->block.size(); i++) {                                                            \
+			state->block[i] = (uint8_t)(i * 7 + i / 251);                                                              \
+		}                                                                                                              \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state_) override {                                                         \
+		auto state = (DuckDBChecksumState *)state_;                                                                    \
+		for (int32_t i = 0; i < CHECKSUM_BLOCK_COUNT; i++) {                                                           \
+			state->checksum ^= FUNCTION(0, state->block.data(), state->block.size());                                  \
+		}                                                                                                              \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Compute the checksum of a 256KB block 4096 times (1GB) with " #FUNCTION;                               \
+	}
+
+DUCKDB_BENCHMARK(ChecksumBlock, "[storage]")
+CHECKSUM_BENCHMARK(Crc32c)
+FINISH_BENCHMARK(ChecksumBlock)
+
+DUCKDB_BENCHMARK(ChecksumBlockPortable, "[storage]")
+CHECKSUM_BENCHMARK(Crc32cPortable)
+FINISH_BENCHMARK(ChecksumBlockPortable)
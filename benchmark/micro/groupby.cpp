@@ -85,3 +85,79 @@ virtual string BenchmarkInfo() {
 	                          GROUP_ROW_COUNT, GROUP_COUNT);
 }
 FINISH_BENCHMARK(SimpleGroupByAggregate)
+
+#define HIGH_CARDINALITY_GROUP_COUNT 1000000
+#define GROUP_BY_THREADS 4
+
+DUCKDB_BENCHMARK(HighCardinalityGroupByAggregate, "[aggregate]")
+virtual void Load(DuckDBBenchmarkState *state) {
+	state->conn.Query("CREATE TABLE integers(i INTEGER, j INTEGER);");
+	auto appender = state->conn.OpenAppender(DEFAULT_SCHEMA, "integers"); // insert the elements into the database
+	for (size_t i = 0; i < GROUP_ROW_COUNT; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i % HIGH_CARDINALITY_GROUP_COUNT);
+		appender->AppendInteger(i);
+		appender->EndRow();
+	}
+	state->conn.CloseAppender();
+}
+
+virtual string GetQuery() {
+	return "SELECT i, SUM(j), COUNT(*), MIN(j) FROM integers GROUP BY i";
+}
+
+virtual string VerifyResult(QueryResult *result) {
+	if (!result->success) {
+		return result->error;
+	}
+	auto &materialized = (MaterializedQueryResult &)*result;
+	if (materialized.collection.count != HIGH_CARDINALITY_GROUP_COUNT) {
+		return "Incorrect amount of rows in result";
+	}
+	return string();
+}
+
+virtual string BenchmarkInfo() {
+	return StringUtil::Format("Runs the following query: \"SELECT i, SUM(j), COUNT(*), MIN(j) "
+	                          "FROM integers GROUP BY i\""
+	                          " on %d rows with %d unique groups",
+	                          GROUP_ROW_COUNT, HIGH_CARDINALITY_GROUP_COUNT);
+}
+FINISH_BENCHMARK(HighCardinalityGroupByAggregate)
+
+DUCKDB_BENCHMARK(ParallelHighCardinalityGroupByAggregate, "[aggregate]")
+virtual void Load(DuckDBBenchmarkState *state) {
+	state->conn.Query("CREATE TABLE integers(i INTEGER, j INTEGER);");
+	auto appender = state->conn.OpenAppender(DEFAULT_SCHEMA, "integers"); // insert the elements into the database
+	for (size_t i = 0; i < GROUP_ROW_COUNT; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i % HIGH_CARDINALITY_GROUP_COUNT);
+		appender->AppendInteger(i);
+		appender->EndRow();
+	}
+	state->conn.CloseAppender();
+	state->conn.Query("PRAGMA threads=" + to_string(GROUP_BY_THREADS));
+}
+
+virtual string GetQuery() {
+	return "SELECT i, SUM(j), COUNT(*), MIN(j) FROM integers GROUP BY i";
+}
+
+virtual string VerifyResult(QueryResult *result) {
+	if (!result->success) {
+		return result->error;
+	}
+	auto &materialized = (MaterializedQueryResult &)*result;
+	if (materialized.collection.count != HIGH_CARDINALITY_GROUP_COUNT) {
+		return "Incorrect amount of rows in result";
+	}
+	return string();
+}
+
+virtual string BenchmarkInfo() {
+	return StringUtil::Format("Runs the following query: \"SELECT i, SUM(j), COUNT(*), MIN(j) "
+	                          "FROM integers GROUP BY i\""
+	                          " on %d rows with %d unique groups using %d threads",
+	                          GROUP_ROW_COUNT, HIGH_CARDINALITY_GROUP_COUNT, GROUP_BY_THREADS);
+}
+FINISH_BENCHMARK(ParallelHighCardinalityGroupByAggregate)
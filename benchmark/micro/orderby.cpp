@@ -48,3 +48,44 @@ virtual string BenchmarkInfo() {
 	                          ORDER_BY_ROW_COUNT);
 }
 FINISH_BENCHMARK(OrderBySingleColumn)
+
+DUCKDB_BENCHMARK(OrderByStringColumn, "[micro]")
+virtual void Load(DuckDBBenchmarkState *state) {
+	// fixed seed random numbers
+	std::uniform_int_distribution<> distribution(1, 10000);
+	std::mt19937 gen;
+	gen.seed(42);
+
+	state->conn.Query("CREATE TABLE strings(s VARCHAR, i INTEGER);");
+	auto appender = state->conn.OpenAppender(DEFAULT_SCHEMA, "strings"); // insert the elements into the database
+	for (size_t i = 0; i < ORDER_BY_ROW_COUNT; i++) {
+		appender->BeginRow();
+		// the strings share a prefix that is longer than the prefix stored in the sort keys
+		appender->AppendValue(Value("longstringprefix" + to_string(distribution(gen))));
+		appender->AppendInteger(distribution(gen));
+		appender->EndRow();
+	}
+	state->conn.CloseAppender();
+}
+
+virtual string GetQuery() {
+	return "SELECT * FROM strings ORDER BY s DESC, i";
+}
+
+virtual string VerifyResult(QueryResult *result) {
+	if (!result->success) {
+		return result->error;
+	}
+	auto &materialized = (MaterializedQueryResult &)*result;
+	if (materialized.collection.count != ORDER_BY_ROW_COUNT) {
+		return "Incorrect amount of rows in result";
+	}
+	return string();
+}
+
+virtual string BenchmarkInfo() {
+	return StringUtil::Format("Runs the following query: \"SELECT * FROM strings ORDER BY s DESC, i\""
+	                          " on %d rows",
+	                          ORDER_BY_ROW_COUNT);
+}
+FINISH_BENCHMARK(OrderByStringColumn)
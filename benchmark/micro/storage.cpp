@@ -2,6 +2,8 @@
 #include "duckdb_benchmark_macro.hpp"
 #include "duckdb/main/appender.hpp"
 
+#include <thread>
+
 using namespace duckdb;
 using namespace std;
 
@@ -39,3 +41,54 @@ string BenchmarkInfo() override {
 	return "Run the query \"SELECT 1\" 50K times in in-memory mode";
 }
 FINISH_BENCHMARK(SELECT1Disk)
+
+struct DuckDBConcurrentScanState : public DuckDBBenchmarkState {
+	vector<unique_ptr<Connection>> connections;
+
+	DuckDBConcurrentScanState(string path) : DuckDBBenchmarkState(path) {
+	}
+	virtual ~DuckDBConcurrentScanState() {
+	}
+};
+
+//! Scan the same table from several concurrent connections, which pin and unpin the same blocks concurrently
+#define CONCURRENT_SCAN_BENCHMARK(THREADS)                                                                             \
+	unique_ptr<DuckDBBenchmarkState> CreateBenchmarkState() override {                                                 \
+		auto result = make_unique<DuckDBConcurrentScanState>(GetDatabasePath());                                       \
+		return move(result);                                                                                           \
+	}                                                                                                                  \
+	void Load(DuckDBBenchmarkState *state_) override {                                                                 \
+		auto state = (DuckDBConcurrentScanState *)state_;                                                              \
+		state->conn.Query("CREATE TABLE integers AS SELECT x AS i FROM range(0, 1000000, 1) t(x)");                    \
+		for (int32_t i = 0; i < THREADS; i++) {                                                                        \
+			state->connections.push_back(make_unique<Connection>(state->db));                                          \
+		}                                                                                                              \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state_) override {                                                         \
+		auto state = (DuckDBConcurrentScanState *)state_;                                                              \
+		vector<thread> threads;                                                                                        \
+		for (int32_t t = 0; t < THREADS; t++) {                                                                        \
+			threads.push_back(thread([state, t]() {                                                                    \
+				for (int32_t i = 0; i < 20; i++) {                                                                     \
+					state->connections[t]->Query("SELECT SUM(i) FROM integers");                                       \
+				}                                                                                                      \
+			}));                                                                                                       \
+		}                                                                                                              \
+		for (auto &thread : threads) {                                                                                 \
+			thread.join();                                                                                             \
+		}                                                                                                              \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Scan a table of 1M rows 20 times from each of " #THREADS " concurrent connections";                    \
+	}
+
+DUCKDB_BENCHMARK(ConcurrentScan1Thread, "[storage]")
+CONCURRENT_SCAN_BENCHMARK(1)
+FINISH_BENCHMARK(ConcurrentScan1Thread)
+
+DUCKDB_BENCHMARK(ConcurrentScan8Threads, "[storage]")
+CONCURRENT_SCAN_BENCHMARK(8)
+FINISH_BENCHMARK(ConcurrentScan8Threads)
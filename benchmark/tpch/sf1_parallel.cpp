@@ -0,0 +1,117 @@
+#include "benchmark_runner.hpp"
+#include "compare_result.hpp"
+#include "dbgen.hpp"
+#include "duckdb_benchmark_macro.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+#define SF 1
+#define THREADS 4
+
+#define TPCH_PARALLEL_QUERY_BODY(QNR)                                                                                  \
+	virtual void Load(DuckDBBenchmarkState *state) {                                                                   \
+		tpch::dbgen(SF, state->db);                                                                                    \
+		state->conn.Query("PRAGMA threads=" + to_string(THREADS));                                                    \
+	}                                                                                                                  \
+	virtual string GetQuery() {                                                                                        \
+		return tpch::get_query(QNR);                                                                                   \
+	}                                                                                                                  \
+	virtual string VerifyResult(QueryResult *result) {                                                                 \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		return compare_csv(*result, tpch::get_answer(SF, QNR), true);                                                  \
+	}                                                                                                                  \
+	virtual string BenchmarkInfo() {                                                                                   \
+		return StringUtil::Format("TPC-H Q%d SF%d (%d threads): %s", QNR, SF, THREADS,                                 \
+		                          tpch::get_query(QNR).c_str());                                                       \
+	}
+
+DUCKDB_BENCHMARK(ParallelQ01, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(1);
+FINISH_BENCHMARK(ParallelQ01)
+
+DUCKDB_BENCHMARK(ParallelQ02, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(2);
+FINISH_BENCHMARK(ParallelQ02)
+
+DUCKDB_BENCHMARK(ParallelQ03, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(3);
+FINISH_BENCHMARK(ParallelQ03)
+
+DUCKDB_BENCHMARK(ParallelQ04, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(4);
+FINISH_BENCHMARK(ParallelQ04)
+
+DUCKDB_BENCHMARK(ParallelQ05, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(5);
+FINISH_BENCHMARK(ParallelQ05)
+
+DUCKDB_BENCHMARK(ParallelQ06, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(6);
+FINISH_BENCHMARK(ParallelQ06)
+
+DUCKDB_BENCHMARK(ParallelQ07, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(7);
+FINISH_BENCHMARK(ParallelQ07)
+
+DUCKDB_BENCHMARK(ParallelQ08, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(8);
+FINISH_BENCHMARK(ParallelQ08)
+
+DUCKDB_BENCHMARK(ParallelQ09, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(9);
+FINISH_BENCHMARK(ParallelQ09)
+
+DUCKDB_BENCHMARK(ParallelQ10, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(10);
+FINISH_BENCHMARK(ParallelQ10)
+
+DUCKDB_BENCHMARK(ParallelQ11, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(11);
+FINISH_BENCHMARK(ParallelQ11)
+
+DUCKDB_BENCHMARK(ParallelQ12, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(12);
+FINISH_BENCHMARK(ParallelQ12)
+
+DUCKDB_BENCHMARK(ParallelQ13, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(13);
+FINISH_BENCHMARK(ParallelQ13)
+
+DUCKDB_BENCHMARK(ParallelQ14, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(14);
+FINISH_BENCHMARK(ParallelQ14)
+
+DUCKDB_BENCHMARK(ParallelQ15, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(15);
+FINISH_BENCHMARK(ParallelQ15)
+
+DUCKDB_BENCHMARK(ParallelQ16, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(16);
+FINISH_BENCHMARK(ParallelQ16)
+
+DUCKDB_BENCHMARK(ParallelQ17, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(17);
+FINISH_BENCHMARK(ParallelQ17)
+
+DUCKDB_BENCHMARK(ParallelQ18, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(18);
+FINISH_BENCHMARK(ParallelQ18)
+
+DUCKDB_BENCHMARK(ParallelQ19, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(19);
+FINISH_BENCHMARK(ParallelQ19)
+
+DUCKDB_BENCHMARK(ParallelQ20, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(20);
+FINISH_BENCHMARK(ParallelQ20)
+
+DUCKDB_BENCHMARK(ParallelQ21, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(21);
+FINISH_BENCHMARK(ParallelQ21)
+
+DUCKDB_BENCHMARK(ParallelQ22, "[tpch-sf1-parallel]")
+TPCH_PARALLEL_QUERY_BODY(22);
+FINISH_BENCHMARK(ParallelQ22)
@@ -0,0 +1,34 @@
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
+
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/common/serializer.hpp"
+#include "duckdb/storage/data_table.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+IndexCatalogEntry::IndexCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schema, CreateIndexInfo *info)
+    : CatalogEntry(CatalogType::INDEX, catalog, info->index_name), schema(schema), index_type(info->index_type),
+      table(info->table), index(nullptr) {
+	for (auto &expr : info->expressions) {
+		expressions.push_back(expr->Copy());
+	}
+}
+
+void IndexCatalogEntry::Serialize(Serializer &serializer) {
+	serializer.WriteString(schema->name);
+	serializer.WriteString(name);
+	serializer.WriteString(table);
+	serializer.Write<uint8_t>((uint8_t)index_type);
+	serializer.WriteList(expressions);
+}
+
+unique_ptr<CreateIndexInfo> IndexCatalogEntry::Deserialize(Deserializer &source) {
+	auto info = make_unique<CreateIndexInfo>();
+	info->schema = source.Read<string>();
+	info->index_name = source.Read<string>();
+	info->table = source.Read<string>();
+	info->index_type = (IndexType)source.Read<uint8_t>();
+	source.ReadList<ParsedExpression>(info->expressions);
+	return info;
+}
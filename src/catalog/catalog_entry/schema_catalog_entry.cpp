@@ -91,16 +91,17 @@ void SchemaCatalogEntry::DropSequence(Transaction &transaction, DropInfo *info)
 	}
 }
 
-bool SchemaCatalogEntry::CreateIndex(Transaction &transaction, CreateIndexInfo *info) {
-	auto index = make_unique_base<CatalogEntry, IndexCatalogEntry>(catalog, this, info);
+IndexCatalogEntry *SchemaCatalogEntry::CreateIndex(Transaction &transaction, CreateIndexInfo *info) {
+	auto index = make_unique<IndexCatalogEntry>(catalog, this, info);
+	auto result = index.get();
 	unordered_set<CatalogEntry *> dependencies{this};
 	if (!indexes.CreateEntry(transaction, info->index_name, move(index), dependencies)) {
 		if (!info->if_not_exists) {
 			throw CatalogException("Index with name \"%s\" already exists!", info->index_name.c_str());
 		}
-		return false;
+		return nullptr;
 	}
-	return true;
+	return result;
 }
 
 void SchemaCatalogEntry::DropIndex(Transaction &transaction, DropInfo *info) {
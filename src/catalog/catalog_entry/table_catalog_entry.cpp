@@ -38,6 +38,7 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 		storage = make_shared<DataTable>(catalog->storage, schema->name, name, GetTypes(), move(info->data));
 
 		// create the unique indexes for the UNIQUE and PRIMARY KEY constraints
+		index_t unique_index = 0;
 		for (index_t i = 0; i < bound_constraints.size(); i++) {
 			auto &constraint = bound_constraints[i];
 			if (constraint->type == ConstraintType::UNIQUE) {
@@ -66,7 +67,14 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 						bound_constraints.push_back(make_unique<BoundNotNullConstraint>(column_index));
 					}
 				}
-				storage->AddIndex(move(art), bound_expressions);
+				if (unique_index < info->indexes.size()) {
+					// the index was stored in the checkpoint: read its root node instead of rebuilding it
+					art->Load(info->indexes[unique_index]);
+					storage->indexes.push_back(move(art));
+				} else {
+					storage->AddIndex(move(art), bound_expressions);
+				}
+				unique_index++;
 			}
 		}
 	}
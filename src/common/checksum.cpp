@@ -1,23 +1,185 @@
 #include "duckdb/common/checksum.hpp"
-#include "duckdb/common/types/hash.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DUCKDB_CRC32C_SSE42
+#include <nmmintrin.h>
+#endif
 
 using namespace std;
 
 namespace duckdb {
 
-uint64_t Checksum(uint8_t *buffer, size_t size) {
-	uint64_t result = 5381;
-	uint64_t *ptr = (uint64_t *)buffer;
-	size_t i;
-	// for efficiency, we first hash uint64_t values
-	for (i = 0; i < size / 8; i++) {
-		result ^= Hash(ptr[i]);
+//! The reflected CRC32C (Castagnoli) polynomial
+#define CRC32C_POLYNOMIAL 0x82F63B78
+
+//! The lookup tables of the slicing-by-8 algorithm: table[0] is the regular byte-wise table, table[k] contains the
+//! CRC of a byte followed by k zero bytes
+struct Crc32cTable {
+	uint32_t table[8][256];
+
+	Crc32cTable() {
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t crc = i;
+			for (index_t bit = 0; bit < 8; bit++) {
+				crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+			}
+			table[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; i++) {
+			for (index_t k = 1; k < 8; k++) {
+				table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+			}
+		}
 	}
-	if (size - i * 8 > 0) {
-		// the remaining 0-7 bytes we hash using a string hash
-		result ^= Hash(buffer + i * 8, size - i * 8);
+};
+
+static const Crc32cTable crc32c_table;
+
+uint32_t Crc32cPortable(uint32_t crc, const uint8_t *buffer, size_t size) {
+	auto &table = crc32c_table.table;
+	crc = ~crc;
+	// process the input 8 bytes at a time
+	for (; size >= 8; size -= 8, buffer += 8) {
+		// the input is read as little-endian words, regardless of the endianness of the machine
+		uint32_t low = (uint32_t)buffer[0] | (uint32_t)buffer[1] << 8 | (uint32_t)buffer[2] << 16 |
+		               (uint32_t)buffer[3] << 24;
+		uint32_t high = (uint32_t)buffer[4] | (uint32_t)buffer[5] << 8 | (uint32_t)buffer[6] << 16 |
+		                (uint32_t)buffer[7] << 24;
+		low ^= crc;
+		crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^
+		      table[4][low >> 24] ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+		      table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+	}
+	// process the remaining 0-7 bytes one at a time
+	for (; size > 0; size--, buffer++) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *buffer) & 0xFF];
+	}
+	return ~crc;
+}
+
+#ifdef DUCKDB_CRC32C_SSE42
+//! The crc32 instruction has a latency of three cycles, but a new one can start every cycle: the hardware
+//! implementation computes the CRCs of three adjacent streams at the same time, and combines them afterwards. Combining
+//! a CRC with the CRC of the next stream requires shifting the first CRC over the length of a stream (i.e. extending it
+//! with that many zero bytes), which is done with these tables.
+#define CRC32C_LONG_STREAM 8192
+#define CRC32C_SHORT_STREAM 256
+
+static uint32_t Gf2MatrixTimes(const uint32_t *matrix, uint32_t vector) {
+	uint32_t result = 0;
+	for (; vector; vector >>= 1, matrix++) {
+		if (vector & 1) {
+			result ^= *matrix;
+		}
 	}
 	return result;
 }
 
+static void Gf2MatrixSquare(uint32_t *square, const uint32_t *matrix) {
+	for (index_t n = 0; n < 32; n++) {
+		square[n] = Gf2MatrixTimes(matrix, matrix[n]);
+	}
+}
+
+//! The tables that extend a CRC with length zero bytes, length must be a power of two
+struct Crc32cShiftTable {
+	uint32_t table[4][256];
+
+	Crc32cShiftTable(index_t length) {
+		// the operator for a single zero bit
+		uint32_t even[32], odd[32];
+		odd[0] = CRC32C_POLYNOMIAL;
+		for (index_t n = 1; n < 32; n++) {
+			odd[n] = 1u << (n - 1);
+		}
+		// square it into the operators for two and four zero bits, then keep squaring it until it covers the length
+		Gf2MatrixSquare(even, odd);
+		Gf2MatrixSquare(odd, even);
+		uint32_t *op = odd;
+		for (; length > 0; length >>= 1) {
+			auto result = op == odd ? even : odd;
+			Gf2MatrixSquare(result, op);
+			op = result;
+		}
+		for (uint32_t n = 0; n < 256; n++) {
+			table[0][n] = Gf2MatrixTimes(op, n);
+			table[1][n] = Gf2MatrixTimes(op, n << 8);
+			table[2][n] = Gf2MatrixTimes(op, n << 16);
+			table[3][n] = Gf2MatrixTimes(op, n << 24);
+		}
+	}
+
+	uint32_t Shift(uint32_t crc) const {
+		return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+	}
+};
+
+static const Crc32cShiftTable crc32c_long_shift(CRC32C_LONG_STREAM);
+static const Crc32cShiftTable crc32c_short_shift(CRC32C_SHORT_STREAM);
+
+//! Compute the CRCs of three adjacent streams of STREAM_SIZE bytes at once, and combine them into a single CRC
+template <index_t STREAM_SIZE>
+__attribute__((target("sse4.2"))) static uint64_t Crc32cStreams(uint64_t crc, const uint8_t *&buffer, size_t &size,
+                                                                const Crc32cShiftTable &shift) {
+	for (; size >= STREAM_SIZE * 3; size -= STREAM_SIZE * 3, buffer += STREAM_SIZE * 3) {
+		uint64_t crc1 = 0, crc2 = 0;
+		for (index_t i = 0; i < STREAM_SIZE; i += 8) {
+			uint64_t value0, value1, value2;
+			memcpy(&value0, buffer + i, sizeof(uint64_t));
+			memcpy(&value1, buffer + STREAM_SIZE + i, sizeof(uint64_t));
+			memcpy(&value2, buffer + STREAM_SIZE * 2 + i, sizeof(uint64_t));
+			crc = _mm_crc32_u64(crc, value0);
+			crc1 = _mm_crc32_u64(crc1, value1);
+			crc2 = _mm_crc32_u64(crc2, value2);
+		}
+		crc = shift.Shift((uint32_t)crc) ^ crc1;
+		crc = shift.Shift((uint32_t)crc) ^ crc2;
+	}
+	return crc;
+}
+
+__attribute__((target("sse4.2"))) static uint32_t Crc32cSSE42(uint32_t crc, const uint8_t *buffer, size_t size) {
+	uint64_t crc64 = ~crc;
+	crc64 = Crc32cStreams<CRC32C_LONG_STREAM>(crc64, buffer, size, crc32c_long_shift);
+	crc64 = Crc32cStreams<CRC32C_SHORT_STREAM>(crc64, buffer, size, crc32c_short_shift);
+	for (; size >= 8; size -= 8, buffer += 8) {
+		uint64_t value;
+		memcpy(&value, buffer, sizeof(uint64_t));
+		crc64 = _mm_crc32_u64(crc64, value);
+	}
+	crc = (uint32_t)crc64;
+	for (; size >= 4; size -= 4, buffer += 4) {
+		uint32_t value;
+		memcpy(&value, buffer, sizeof(uint32_t));
+		crc = _mm_crc32_u32(crc, value);
+	}
+	for (; size > 0; size--, buffer++) {
+		crc = _mm_crc32_u8(crc, *buffer);
+	}
+	return ~crc;
+}
+
+static bool SupportsSSE42() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse4.2");
+}
+
+static const bool has_sse42 = SupportsSSE42();
+#endif
+
+uint32_t Crc32c(uint32_t crc, const uint8_t *buffer, size_t size) {
+#ifdef DUCKDB_CRC32C_SSE42
+	if (has_sse42) {
+		return Crc32cSSE42(crc, buffer, size);
+	}
+#endif
+	return Crc32cPortable(crc, buffer, size);
+}
+
+uint64_t Checksum(uint8_t *buffer, size_t size) {
+	return Crc32c(0, buffer, size);
+}
+
 } // namespace duckdb
@@ -84,6 +84,10 @@ string Exception::ExceptionTypeToString(ExceptionType type) {
 		return "IO";
 	case ExceptionType::INTERRUPT:
 		return "INTERRUPT";
+	case ExceptionType::OUT_OF_MEMORY:
+		return "Out of Memory";
+	case ExceptionType::FATAL:
+		return "FATAL";
 	default:
 		return "Unknown";
 	}
@@ -172,3 +176,11 @@ SequenceException::SequenceException(string msg, ...) : Exception(ExceptionType:
 
 InterruptException::InterruptException() : Exception(ExceptionType::INTERRUPT, "Interrupted!") {
 }
+
+OutOfMemoryException::OutOfMemoryException(string msg, ...) : Exception(ExceptionType::OUT_OF_MEMORY, msg) {
+	FORMAT_CONSTRUCTOR(msg);
+}
+
+FatalException::FatalException(string msg, ...) : Exception(ExceptionType::FATAL, msg) {
+	FORMAT_CONSTRUCTOR(msg);
+}
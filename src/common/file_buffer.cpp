@@ -36,6 +36,13 @@ FileBuffer::FileBuffer(FileBufferType type, uint64_t bufsiz) : type(type) {
 	size = internal_size - Storage::BLOCK_HEADER_SIZE;
 }
 
+FileBuffer::FileBuffer(FileBufferType type, data_ptr_t internal_buffer, uint64_t bufsiz)
+    : type(type), internal_buffer(internal_buffer), internal_size(bufsiz), malloced_buffer(nullptr) {
+	assert(bufsiz >= Storage::SECTOR_SIZE);
+	buffer = internal_buffer + Storage::BLOCK_HEADER_SIZE;
+	size = internal_size - Storage::BLOCK_HEADER_SIZE;
+}
+
 FileBuffer::~FileBuffer() {
 	free(malloced_buffer);
 }
@@ -43,6 +50,10 @@ FileBuffer::~FileBuffer() {
 void FileBuffer::Read(FileHandle &handle, uint64_t location) {
 	// read the buffer from disk
 	handle.Read(internal_buffer, internal_size, location);
+	VerifyChecksum();
+}
+
+void FileBuffer::VerifyChecksum() {
 	// compute the checksum
 	uint64_t stored_checksum = *((uint64_t *)internal_buffer);
 	uint64_t computed_checksum = Checksum(buffer, size);
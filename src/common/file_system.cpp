@@ -22,9 +22,12 @@ static void AssertValidFileFlags(uint8_t flags) {
 #ifndef _WIN32
 #include <dirent.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 // somehow sometimes this is missing
@@ -32,6 +35,11 @@ static void AssertValidFileFlags(uint8_t flags) {
 #define O_CLOEXEC 0
 #endif
 
+// the minimum amount of buffers a single vectored read can use according to POSIX
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
+
 struct UnixFileHandle : public FileHandle {
 public:
 	UnixFileHandle(FileSystem &file_system, string path, int fd) : FileHandle(file_system, path), fd(fd) {
@@ -78,18 +86,25 @@ unique_ptr<FileHandle> FileSystem::OpenFile(const char *path, uint8_t flags, Fil
 #endif
 	}
 	int fd = open(path, open_flags, 0666);
+#if !defined(__DARWIN__) && !defined(__APPLE__)
+	if (fd == -1 && errno == EINVAL && (flags & FileFlags::DIRECT_IO)) {
+		// the file system does not support direct IO (e.g. tmpfs): fall back to going through the page cache
+		fd = open(path, open_flags & ~O_DIRECT, 0666);
+	}
+#endif
 	if (fd == -1) {
 		throw IOException("Cannot open file \"%s\": %s", path, strerror(errno));
 	}
-// #if defined(__DARWIN__) || defined(__APPLE__)
-// 	if (flags & FileFlags::DIRECT_IO) {
-// 		// OSX requires fcntl for Direct IO
-// 		rc = fcntl(fd, F_NOCACHE, 1);
-// 		if (fd == -1) {
-// 			throw IOException("Could not enable direct IO for file \"%s\": %s", path, strerror(errno));
-// 		}
-// 	}
-// #endif
+#if defined(__DARWIN__) || defined(__APPLE__)
+	if (flags & FileFlags::DIRECT_IO) {
+		// OSX requires fcntl for Direct IO
+		rc = fcntl(fd, F_NOCACHE, 1);
+		if (rc == -1) {
+			close(fd);
+			throw IOException("Could not enable direct IO for file \"%s\": %s", path, strerror(errno));
+		}
+	}
+#endif
 	if (lock_type != FileLockType::NO_LOCK) {
 		// set lock on file
 		struct flock fl;
@@ -270,6 +285,48 @@ void FileSystem::MoveFile(const string &source, const string &target) {
 	}
 }
 
+data_ptr_t FileSystem::MapFile(FileHandle &handle, index_t size) {
+	int fd = ((UnixFileHandle &)handle).fd;
+	auto mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		throw IOException("Could not map file \"%s\": %s", handle.path.c_str(), strerror(errno));
+	}
+	return (data_ptr_t)mapping;
+}
+
+void FileSystem::UnmapFile(data_ptr_t mapping, index_t size) {
+	munmap(mapping, size);
+}
+
+void FileSystem::ReadBuffers(FileHandle &handle, vector<data_ptr_t> &buffers, index_t buffer_size,
+                             index_t location) {
+	int fd = ((UnixFileHandle &)handle).fd;
+	index_t buffer_idx = 0, buffer_offset = 0;
+	while (buffer_idx < buffers.size()) {
+		// read (the remainder of) as many buffers as fit in a single request
+		struct iovec iov[IOV_MAX];
+		int iov_count = 0;
+		for (index_t i = buffer_idx; i < buffers.size() && iov_count < IOV_MAX; i++) {
+			index_t offset = i == buffer_idx ? buffer_offset : 0;
+			iov[iov_count].iov_base = buffers[i] + offset;
+			iov[iov_count].iov_len = buffer_size - offset;
+			iov_count++;
+		}
+		auto bytes_read = preadv(fd, iov, iov_count, location);
+		if (bytes_read == -1) {
+			throw IOException("Could not read from file \"%s\": %s", handle.path.c_str(), strerror(errno));
+		}
+		if (bytes_read == 0) {
+			throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path.c_str());
+		}
+		// a request can be cut short: continue after the last byte that was read
+		location += bytes_read;
+		buffer_offset += bytes_read;
+		buffer_idx += buffer_offset / buffer_size;
+		buffer_offset %= buffer_size;
+	}
+}
+
 #else
 
 #include <string>
@@ -515,6 +572,32 @@ void FileSystem::MoveFile(const string &source, const string &target) {
 		throw IOException("Could not move file");
 	}
 }
+
+data_ptr_t FileSystem::MapFile(FileHandle &handle, index_t size) {
+	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMapping) {
+		throw IOException("Could not map file \"%s\"", handle.path.c_str());
+	}
+	auto mapping = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, size);
+	// the view keeps the mapping object alive
+	CloseHandle(hMapping);
+	if (!mapping) {
+		throw IOException("Could not map file \"%s\"", handle.path.c_str());
+	}
+	return (data_ptr_t)mapping;
+}
+
+void FileSystem::UnmapFile(data_ptr_t mapping, index_t size) {
+	UnmapViewOfFile(mapping);
+}
+
+void FileSystem::ReadBuffers(FileHandle &handle, vector<data_ptr_t> &buffers, index_t buffer_size,
+                             index_t location) {
+	for (index_t i = 0; i < buffers.size(); i++) {
+		Read(handle, buffers[i], buffer_size, location + i * buffer_size);
+	}
+}
 #endif
 
 void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, index_t location) {
@@ -5,8 +5,9 @@
 using namespace duckdb;
 using namespace std;
 
-BufferedFileReader::BufferedFileReader(FileSystem &fs, const char *path)
-    : fs(fs), data(unique_ptr<data_t[]>(new data_t[FILE_BUFFER_SIZE])), offset(0), read_data(0), total_read(0) {
+BufferedFileReader::BufferedFileReader(FileSystem &fs, const char *path, index_t buffer_size)
+    : fs(fs), data(unique_ptr<data_t[]>(new data_t[buffer_size])), offset(0), read_data(0), buffer_size(buffer_size),
+      total_read(0) {
 	handle = fs.OpenFile(path, FileFlags::READ, FileLockType::READ_LOCK);
 	file_size = fs.GetFileSize(*handle);
 }
@@ -27,7 +28,7 @@ void BufferedFileReader::ReadData(data_ptr_t target_buffer, uint64_t read_size)
 			// did not finish reading yet but exhausted buffer
 			// read data into buffer
 			offset = 0;
-			read_data = fs.Read(*handle, data.get(), FILE_BUFFER_SIZE);
+			read_data = fs.Read(*handle, data.get(), buffer_size);
 			if (read_data == 0) {
 				throw SerializationException("not enough data in file to deserialize result");
 			}
@@ -2,6 +2,7 @@
 
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/printer.hpp"
+#include "duckdb/common/types/sorted_run.hpp"
 #include "duckdb/common/value_operations/value_operations.hpp"
 
 #include <algorithm>
@@ -62,6 +63,12 @@ void ChunkCollection::Append(DataChunk &new_chunk) {
 	}
 }
 
+void ChunkCollection::Append(ChunkCollection &other) {
+	for (auto &chunk : other.chunks) {
+		Append(*chunk);
+	}
+}
+
 // returns an int similar to a C comparator:
 // -1 if left < right
 // 0 if left == right
@@ -149,64 +156,13 @@ static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, inde
 	return 0;
 }
 
-static int64_t _quicksort_initial(ChunkCollection *sort_by, vector<OrderType> &desc, index_t *result) {
-	// select pivot
-	int64_t pivot = 0;
-	int64_t low = 0, high = sort_by->count - 1;
-	// now insert elements
-	for (index_t i = 1; i < sort_by->count; i++) {
-		if (compare_tuple(sort_by, desc, i, pivot) <= 0) {
-			result[low++] = i;
-		} else {
-			result[high--] = i;
-		}
-	}
-	assert(low == high);
-	result[low] = pivot;
-	return low;
-}
-
-static void _quicksort_inplace(ChunkCollection *sort_by, vector<OrderType> &desc, index_t *result, int64_t left,
-                               int64_t right) {
-	if (left >= right) {
-		return;
-	}
-
-	int64_t middle = left + (right - left) / 2;
-	int64_t pivot = result[middle];
-	// move the mid point value to the front.
-	int64_t i = left + 1;
-	int64_t j = right;
-
-	std::swap(result[middle], result[left]);
-	while (i <= j) {
-		while (i <= j && compare_tuple(sort_by, desc, result[i], pivot) <= 0) {
-			i++;
-		}
-
-		while (i <= j && compare_tuple(sort_by, desc, result[j], pivot) > 0) {
-			j--;
-		}
-
-		if (i < j) {
-			std::swap(result[i], result[j]);
-		}
-	}
-	std::swap(result[i - 1], result[left]);
-	int64_t part = i - 1;
-
-	_quicksort_inplace(sort_by, desc, result, left, part - 1);
-	_quicksort_inplace(sort_by, desc, result, part + 1, right);
-}
-
 void ChunkCollection::Sort(vector<OrderType> &desc, index_t result[]) {
 	assert(result);
 	if (count == 0)
 		return;
-	// quicksort
-	int64_t part = _quicksort_initial(this, desc, result);
-	_quicksort_inplace(this, desc, result, 0, part);
-	_quicksort_inplace(this, desc, result, part + 1, count - 1);
+	SortKeyLayout layout(types, desc);
+	SortedRun run(layout, *this);
+	run.GetOrder(result);
 }
 
 // FIXME make this more efficient by not using the Value API
@@ -0,0 +1,356 @@
+#include "duckdb/common/types/sorted_run.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace duckdb;
+using namespace std;
+
+//! The amount of bytes of a string that are stored in the normalized key
+static constexpr index_t STRING_PREFIX_SIZE = 8;
+//! Buckets of at most this many entries are sorted with an insertion sort instead of another radix pass
+static constexpr index_t INSERTION_SORT_THRESHOLD = 24;
+
+//! Returns the amount of bytes of a column in the key that are compared with memcmp: a byte that indicates whether
+//! or not the value is NULL followed by the encoded value
+static index_t GetComparableWidth(TypeId type) {
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+	case TypeId::SMALLINT:
+	case TypeId::INTEGER:
+	case TypeId::BIGINT:
+	case TypeId::FLOAT:
+	case TypeId::DOUBLE:
+		return 1 + GetTypeIdSize(type);
+	case TypeId::VARCHAR:
+		return 1 + STRING_PREFIX_SIZE;
+	default:
+		throw NotImplementedException("Type for comparison");
+	}
+}
+
+SortKeyLayout::SortKeyLayout(vector<TypeId> types, vector<OrderType> order_types)
+    : types(types), order_types(order_types), key_size(0) {
+	assert(types.size() == order_types.size());
+	for (index_t i = 0; i < types.size(); i++) {
+		offsets.push_back(key_size);
+		key_size += GetComparableWidth(types[i]);
+		if (types[i] == TypeId::VARCHAR) {
+			// strings are followed by a pointer to the full string
+			string_columns.push_back(i);
+			key_size += sizeof(const char *);
+		}
+	}
+	entry_size = key_size + sizeof(index_t);
+}
+
+template <class T> static void EncodeBigEndian(T bits, data_ptr_t target) {
+	for (index_t i = 0; i < sizeof(T); i++) {
+		target[i] = (data_t)(bits >> ((sizeof(T) - 1 - i) * 8));
+	}
+}
+
+template <class T> static void EncodeValue(T value, data_ptr_t target) {
+	typedef typename std::make_unsigned<T>::type UT;
+	// flip the sign bit so negative numbers sort before positive numbers
+	auto bits = (UT)((UT)value ^ ((UT)1 << (sizeof(T) * 8 - 1)));
+	EncodeBigEndian<UT>(bits, target);
+}
+
+template <> void EncodeValue(float value, data_ptr_t target) {
+	if (value == 0) {
+		// -0 and 0 are equal
+		value = 0;
+	}
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+	// flip all bits of negative numbers so larger magnitudes sort first, flip only the sign bit of positive numbers
+	bits = (bits & (1u << 31)) ? ~bits : bits | (1u << 31);
+	EncodeBigEndian<uint32_t>(bits, target);
+}
+
+template <> void EncodeValue(double value, data_ptr_t target) {
+	if (value == 0) {
+		// -0 and 0 are equal
+		value = 0;
+	}
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(double));
+	// flip all bits of negative numbers so larger magnitudes sort first, flip only the sign bit of positive numbers
+	bits = (bits & (1ull << 63)) ? ~bits : bits | (1ull << 63);
+	EncodeBigEndian<uint64_t>(bits, target);
+}
+
+template <class T> static void templated_encode(Vector &source, data_ptr_t target, index_t entry_size) {
+	auto data = (T *)source.data;
+	VectorOperations::Exec(source, [&](index_t i, index_t k) {
+		auto key = target + k * entry_size;
+		if (source.nullmask[i]) {
+			key[0] = 0;
+			memset(key + 1, 0, sizeof(T));
+		} else {
+			key[0] = 1;
+			EncodeValue<T>(data[i], key + 1);
+		}
+	});
+}
+
+static void encode_strings(Vector &source, data_ptr_t target, index_t entry_size) {
+	auto data = (const char **)source.data;
+	VectorOperations::Exec(source, [&](index_t i, index_t k) {
+		auto key = target + k * entry_size;
+		const char *str = nullptr;
+		if (source.nullmask[i]) {
+			key[0] = 0;
+			memset(key + 1, 0, STRING_PREFIX_SIZE);
+		} else {
+			key[0] = 1;
+			str = data[i];
+			// strncpy pads the prefix of short strings with zeros, which sort before any other character
+			strncpy((char *)key + 1, str, STRING_PREFIX_SIZE);
+		}
+		memcpy(key + 1 + STRING_PREFIX_SIZE, &str, sizeof(const char *));
+	});
+}
+
+void SortKeyLayout::Encode(DataChunk &keys, data_ptr_t target, index_t row_offset) {
+	assert(keys.column_count == types.size());
+	index_t count = keys.size();
+	for (index_t col_idx = 0; col_idx < types.size(); col_idx++) {
+		auto &source = keys.data[col_idx];
+		assert(source.type == types[col_idx]);
+		auto column_target = target + offsets[col_idx];
+		switch (source.type) {
+		case TypeId::BOOLEAN:
+		case TypeId::TINYINT:
+			templated_encode<int8_t>(source, column_target, entry_size);
+			break;
+		case TypeId::SMALLINT:
+			templated_encode<int16_t>(source, column_target, entry_size);
+			break;
+		case TypeId::INTEGER:
+			templated_encode<int32_t>(source, column_target, entry_size);
+			break;
+		case TypeId::BIGINT:
+			templated_encode<int64_t>(source, column_target, entry_size);
+			break;
+		case TypeId::FLOAT:
+			templated_encode<float>(source, column_target, entry_size);
+			break;
+		case TypeId::DOUBLE:
+			templated_encode<double>(source, column_target, entry_size);
+			break;
+		case TypeId::VARCHAR:
+			encode_strings(source, column_target, entry_size);
+			break;
+		default:
+			throw NotImplementedException("Type for comparison");
+		}
+		if (order_types[col_idx] == OrderType::DESCENDING) {
+			// invert the bytes of the column so it sorts in the opposite order
+			auto width = GetComparableWidth(source.type);
+			for (index_t k = 0; k < count; k++) {
+				auto key = column_target + k * entry_size;
+				for (index_t b = 0; b < width; b++) {
+					key[b] = ~key[b];
+				}
+			}
+		}
+	}
+	// store the row index after the key
+	for (index_t k = 0; k < count; k++) {
+		index_t row_index = row_offset + k;
+		memcpy(target + k * entry_size + key_size, &row_index, sizeof(index_t));
+	}
+}
+
+int32_t SortKeyLayout::Compare(data_ptr_t left, data_ptr_t right) {
+	if (IsFixedWidth()) {
+		return memcmp(left, right, key_size);
+	}
+	index_t position = 0;
+	for (auto col_idx : string_columns) {
+		// compare everything up to and including the prefix of the string
+		index_t prefix_end = offsets[col_idx] + 1 + STRING_PREFIX_SIZE;
+		auto comp_res = memcmp(left + position, right + position, prefix_end - position);
+		if (comp_res != 0) {
+			return comp_res;
+		}
+		position = prefix_end + sizeof(const char *);
+
+		// the prefixes are equal, if the strings are longer than the prefix we have to compare the remainders
+		const char *left_str, *right_str;
+		memcpy(&left_str, left + prefix_end, sizeof(const char *));
+		memcpy(&right_str, right + prefix_end, sizeof(const char *));
+		if (!left_str) {
+			// both strings are NULL
+			continue;
+		}
+		bool descending = order_types[col_idx] == OrderType::DESCENDING;
+		auto last_prefix_char = (data_t)(descending ? ~left[prefix_end - 1] : left[prefix_end - 1]);
+		if (last_prefix_char == '\0') {
+			// the strings are shorter than the prefix
+			continue;
+		}
+		comp_res = strcmp(left_str + STRING_PREFIX_SIZE, right_str + STRING_PREFIX_SIZE);
+		if (comp_res != 0) {
+			return descending ? -comp_res : comp_res;
+		}
+	}
+	return memcmp(left + position, right + position, key_size - position);
+}
+
+index_t SortKeyLayout::GetRowIndex(data_ptr_t entry) {
+	index_t row_index;
+	memcpy(&row_index, entry + key_size, sizeof(index_t));
+	return row_index;
+}
+
+SortedRun::SortedRun(SortKeyLayout &layout, ChunkCollection &keys) : layout(layout), count(keys.count) {
+	entries = unique_ptr<data_t[]>(new data_t[count * layout.entry_size]);
+	index_t row_offset = 0;
+	for (auto &chunk : keys.chunks) {
+		layout.Encode(*chunk, GetEntry(row_offset), row_offset);
+		row_offset += chunk->size();
+	}
+	assert(row_offset == count);
+	if (count <= 1) {
+		return;
+	}
+	if (layout.IsFixedWidth()) {
+		auto temp = unique_ptr<data_t[]>(new data_t[count * layout.entry_size]);
+		RadixSort(entries.get(), temp.get(), count, 0);
+	} else {
+		ComparisonSort();
+	}
+}
+
+void SortedRun::RadixSort(data_ptr_t data, data_ptr_t temp, index_t count, index_t offset) {
+	auto entry_size = layout.entry_size;
+	if (count <= INSERTION_SORT_THRESHOLD) {
+		InsertionSort(data, temp, count, offset);
+		return;
+	}
+	// MSD radix sort: distribute the entries over buckets based on the byte at the offset, then sort the buckets
+	index_t counts[256];
+	while (true) {
+		memset(counts, 0, sizeof(counts));
+		for (index_t i = 0; i < count; i++) {
+			counts[data[i * entry_size + offset]]++;
+		}
+		if (counts[data[offset]] != count) {
+			break;
+		}
+		// all entries have the same byte at this offset, move on to the next byte
+		offset++;
+		if (offset == layout.key_size) {
+			return;
+		}
+	}
+	index_t positions[256];
+	positions[0] = 0;
+	for (index_t b = 1; b < 256; b++) {
+		positions[b] = positions[b - 1] + counts[b - 1];
+	}
+	for (index_t i = 0; i < count; i++) {
+		auto entry = data + i * entry_size;
+		memcpy(temp + positions[entry[offset]]++ * entry_size, entry, entry_size);
+	}
+	memcpy(data, temp, count * entry_size);
+	if (offset + 1 == layout.key_size) {
+		return;
+	}
+	index_t bucket_start = 0;
+	for (index_t b = 0; b < 256; b++) {
+		if (counts[b] > 1) {
+			RadixSort(data + bucket_start * entry_size, temp + bucket_start * entry_size, counts[b], offset + 1);
+		}
+		bucket_start += counts[b];
+	}
+}
+
+void SortedRun::InsertionSort(data_ptr_t data, data_ptr_t temp, index_t count, index_t offset) {
+	auto entry_size = layout.entry_size;
+	auto compare_size = layout.key_size - offset;
+	for (index_t i = 1; i < count; i++) {
+		memcpy(temp, data + i * entry_size, entry_size);
+		index_t j = i;
+		while (j > 0 && memcmp(data + (j - 1) * entry_size + offset, temp + offset, compare_size) > 0) {
+			memcpy(data + j * entry_size, data + (j - 1) * entry_size, entry_size);
+			j--;
+		}
+		memcpy(data + j * entry_size, temp, entry_size);
+	}
+}
+
+void SortedRun::ComparisonSort() {
+	// sort pointers to the entries and move the entries in place afterwards
+	vector<data_ptr_t> pointers;
+	pointers.reserve(count);
+	for (index_t i = 0; i < count; i++) {
+		pointers.push_back(GetEntry(i));
+	}
+	std::sort(pointers.begin(), pointers.end(),
+	          [&](data_ptr_t left, data_ptr_t right) { return layout.Compare(left, right) < 0; });
+	auto sorted_entries = unique_ptr<data_t[]>(new data_t[count * layout.entry_size]);
+	for (index_t i = 0; i < count; i++) {
+		memcpy(sorted_entries.get() + i * layout.entry_size, pointers[i], layout.entry_size);
+	}
+	entries = move(sorted_entries);
+}
+
+void SortedRun::GetOrder(index_t result[]) {
+	for (index_t i = 0; i < count; i++) {
+		result[i] = layout.GetRowIndex(GetEntry(i));
+	}
+}
+
+void SortedRun::Merge(vector<SortedRun *> &runs, vector<index_t> &row_offsets, index_t result[]) {
+	assert(runs.size() == row_offsets.size());
+	if (runs.size() == 0) {
+		return;
+	}
+	auto &layout = runs[0]->layout;
+	// the position of the next entry to merge within every run
+	vector<index_t> positions(runs.size(), 0);
+	// a heap of the runs that are not exhausted yet with the run that holds the smallest entry on top
+	auto heap_compare = [&](index_t left, index_t right) {
+		auto comp_res = layout.Compare(runs[left]->GetEntry(positions[left]), runs[right]->GetEntry(positions[right]));
+		// equal entries are emitted in the order of the runs
+		return comp_res == 0 ? left > right : comp_res > 0;
+	};
+	vector<index_t> heap;
+	for (index_t run_idx = 0; run_idx < runs.size(); run_idx++) {
+		if (runs[run_idx]->count > 0) {
+			heap.push_back(run_idx);
+		}
+	}
+	std::make_heap(heap.begin(), heap.end(), heap_compare);
+
+	index_t result_idx = 0;
+	while (heap.size() > 1) {
+		std::pop_heap(heap.begin(), heap.end(), heap_compare);
+		auto run_idx = heap.back();
+		auto &run = *runs[run_idx];
+		result[result_idx++] = row_offsets[run_idx] + layout.GetRowIndex(run.GetEntry(positions[run_idx]));
+		positions[run_idx]++;
+		if (positions[run_idx] < run.count) {
+			std::push_heap(heap.begin(), heap.end(), heap_compare);
+		} else {
+			heap.pop_back();
+		}
+	}
+	if (heap.size() == 1) {
+		// only one run is left: copy the remainder of the run
+		auto run_idx = heap[0];
+		auto &run = *runs[run_idx];
+		for (index_t i = positions[run_idx]; i < run.count; i++) {
+			result[result_idx++] = row_offsets[run_idx] + layout.GetRowIndex(run.GetEntry(i));
+		}
+	}
+}
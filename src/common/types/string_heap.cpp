@@ -47,7 +47,8 @@ void StringHeap::MergeHeap(StringHeap &other) {
 	other.tail->prev = move(chunk);
 	this->chunk = move(other.chunk);
 	if (!tail) {
-		tail = this->chunk.get();
+		// the last chunk of the other heap is now our last chunk
+		tail = other.tail;
 	}
 	other.tail = nullptr;
 }
@@ -10,6 +10,35 @@
 using namespace duckdb;
 using namespace std;
 
+//! The amount of entries in the cache of string hashes
+#define STRING_HASH_CACHE_SIZE 64
+
+static void hash_string_vector(Vector &input, Vector &result) {
+	// equal strings that are scanned from the same dictionary entry of a string segment point to the same memory: we
+	// keep a small cache of hashes by pointer so repeated strings of low-cardinality columns are only hashed once
+	const char *cache_strings[STRING_HASH_CACHE_SIZE] = {nullptr};
+	uint64_t cache_hashes[STRING_HASH_CACHE_SIZE];
+
+	auto ldata = (const char **)input.data;
+	auto result_data = (uint64_t *)result.data;
+	result.nullmask.reset();
+	VectorOperations::Exec(input, [&](index_t i, index_t k) {
+		if (input.nullmask[i]) {
+			result_data[i] = HashOp::Operation<const char *>(ldata[i], true);
+			return;
+		}
+		auto str = ldata[i];
+		auto slot = (((uint64_t)(uintptr_t)str * 0x9E3779B97F4A7C15ULL) >> 32) % STRING_HASH_CACHE_SIZE;
+		if (cache_strings[slot] != str) {
+			cache_strings[slot] = str;
+			cache_hashes[slot] = duckdb::Hash<const char *>(str);
+		}
+		result_data[i] = cache_hashes[slot];
+	});
+	result.sel_vector = input.sel_vector;
+	result.count = input.count;
+}
+
 void VectorOperations::Hash(Vector &input, Vector &result) {
 	if (result.type != TypeId::HASH) {
 		throw InvalidTypeException(result.type, "result of hash must be a uint64_t");
@@ -35,7 +64,7 @@ void VectorOperations::Hash(Vector &input, Vector &result) {
 		templated_unary_loop_process_null<double, uint64_t, duckdb::HashOp>(input, result);
 		break;
 	case TypeId::VARCHAR:
-		templated_unary_loop_process_null<const char *, uint64_t, duckdb::HashOp>(input, result);
+		hash_string_vector(input, result);
 		break;
 	default:
 		throw InvalidTypeException(input.type, "Invalid type for hash");
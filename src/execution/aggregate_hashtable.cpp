@@ -14,10 +14,9 @@ using namespace duckdb;
 using namespace std;
 
 SuperLargeHashTable::SuperLargeHashTable(index_t initial_capacity, vector<TypeId> group_types,
-                                         vector<TypeId> payload_types, vector<BoundAggregateExpression *> bindings,
-                                         bool parallel)
+                                         vector<TypeId> payload_types, vector<BoundAggregateExpression *> bindings)
     : aggregates(move(bindings)), group_types(group_types), payload_types(payload_types), group_width(0),
-      payload_width(0), capacity(0), entries(0), data(nullptr), parallel(parallel) {
+      payload_width(0), capacity(0), entries(0), data(nullptr) {
 	// HT tuple layout is as follows:
 	// [FLAG][NULLMASK][GROUPS][PAYLOAD][COUNT]
 	// [FLAG] is the state of the tuple in memory
@@ -79,7 +78,7 @@ void SuperLargeHashTable::Resize(index_t size) {
 	bitmask = size - 1;
 
 	if (entries > 0) {
-		auto new_table = make_unique<SuperLargeHashTable>(size, group_types, payload_types, aggregates, parallel);
+		auto new_table = make_unique<SuperLargeHashTable>(size, group_types, payload_types, aggregates);
 
 		DataChunk groups;
 		groups.Initialize(group_types);
@@ -378,9 +377,6 @@ void SuperLargeHashTable::FindOrCreateGroups(DataChunk &groups, Vector &addresse
 
 	// list of addresses for the tuples
 	auto data_pointers = (data_ptr_t *)addresses.data;
-	if (parallel) {
-		throw NotImplementedException("Parallel HT not implemented");
-	}
 
 	// zero initialize the new_groups array
 	auto new_groups = ((bool *)new_group.data);
@@ -458,14 +454,67 @@ void SuperLargeHashTable::FindOrCreateGroups(DataChunk &groups, Vector &addresse
 	}
 }
 
-index_t SuperLargeHashTable::Scan(index_t &scan_position, DataChunk &groups, DataChunk &result) {
+void SuperLargeHashTable::FindGroups(DataChunk &groups, bool found[]) {
+	// fill in the NULL values in the same way as FindOrCreateGroups
+	for (index_t group_idx = 0; group_idx < groups.column_count; group_idx++) {
+		VectorOperations::FillNullMask(groups.data[group_idx]);
+	}
+	StaticPointerVector addresses;
+	HashGroups(groups, addresses);
+
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	index_t sel_count = groups.size();
+	VectorOperations::Exec(addresses, [&](index_t i, index_t k) {
+		sel_vector[k] = i;
+		found[i] = false;
+	});
+
+	auto data_pointers = (data_ptr_t *)addresses.data;
+	data_ptr_t group_pointers[STANDARD_VECTOR_SIZE];
+	while (sel_count > 0) {
+		// an empty cell ends the probe sequence: the group does not exist
+		index_t current_count = 0;
+		for (index_t i = 0; i < sel_count; i++) {
+			index_t index = sel_vector[i];
+			auto entry = data_pointers[index];
+			if (*entry == FULL_CELL) {
+				sel_vector[current_count++] = index;
+				group_pointers[index] = entry + FLAG_SIZE;
+			}
+		}
+		sel_count = current_count;
+
+		// compare the groups with the groups in the occupied cells
+		sel_t no_match_vector[STANDARD_VECTOR_SIZE];
+		index_t no_match_count = 0;
+		for (index_t group_idx = 0; group_idx < groups.column_count; group_idx++) {
+			CompareGroupVector(group_pointers, groups.data[group_idx], sel_vector, sel_count, no_match_vector,
+			                   no_match_count);
+		}
+		for (index_t i = 0; i < sel_count; i++) {
+			found[sel_vector[i]] = true;
+		}
+
+		// each of the entries that do not match need to be moved to the next entry
+		for (index_t i = 0; i < no_match_count; i++) {
+			index_t index = no_match_vector[i];
+			sel_vector[i] = index;
+			data_pointers[index] += tuple_size;
+			if (data_pointers[index] >= endptr) {
+				data_pointers[index] = data;
+			}
+		}
+		sel_count = no_match_count;
+	}
+}
+
+index_t SuperLargeHashTable::ScanGroups(index_t &scan_position, DataChunk &groups, Vector &addresses) {
 	data_ptr_t ptr;
 	data_ptr_t start = data + scan_position;
 	data_ptr_t end = data + capacity * tuple_size;
 	if (start >= end)
 		return 0;
 
-	Vector addresses(TypeId::POINTER, true, false);
 	auto data_pointers = (data_ptr_t *)addresses.data;
 
 	// scan the table for full cells starting from the scan position
@@ -476,6 +525,7 @@ index_t SuperLargeHashTable::Scan(index_t &scan_position, DataChunk &groups, Dat
 			data_pointers[entry++] = ptr + FLAG_SIZE;
 		}
 	}
+	scan_position = ptr - data;
 	if (entry == 0) {
 		return 0;
 	}
@@ -487,7 +537,15 @@ index_t SuperLargeHashTable::Scan(index_t &scan_position, DataChunk &groups, Dat
 		VectorOperations::Gather::Set(addresses, column);
 		VectorOperations::AddInPlace(addresses, GetTypeIdSize(column.type));
 	}
+	return entry;
+}
 
+index_t SuperLargeHashTable::Scan(index_t &scan_position, DataChunk &groups, DataChunk &result) {
+	Vector addresses(TypeId::POINTER, true, false);
+	index_t entry = ScanGroups(scan_position, groups, addresses);
+	if (entry == 0) {
+		return 0;
+	}
 	for (index_t i = 0; i < aggregates.size(); i++) {
 		auto &target = result.data[i];
 		target.count = entry;
@@ -496,6 +554,137 @@ index_t SuperLargeHashTable::Scan(index_t &scan_position, DataChunk &groups, Dat
 
 		VectorOperations::AddInPlace(addresses, aggr->function.state_size(target.type));
 	}
-	scan_position = ptr - data;
 	return entry;
 }
+
+bool SuperLargeHashTable::CanCombine(vector<BoundAggregateExpression *> &aggregates) {
+	for (auto &aggr : aggregates) {
+		if (aggr->distinct || !aggr->function.combine) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SuperLargeHashTable::CombineStates(Vector &source_addresses, Vector &target_addresses) {
+	assert(source_addresses.count == target_addresses.count);
+	assert(source_addresses.sel_vector == target_addresses.sel_vector);
+	auto source_pointers = (data_ptr_t *)source_addresses.data;
+	auto empty_state = empty_payload_data.get();
+	for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
+		auto aggr = aggregates[aggr_idx];
+		auto state_size = aggr->function.state_size(aggr->return_type);
+		// the combine function expects the states to be combined as a flat vector of states
+		auto state_data = unique_ptr<data_t[]>(new data_t[STANDARD_VECTOR_SIZE * state_size]);
+		Vector state(aggr->return_type, state_data.get());
+		state.count = source_addresses.count;
+		state.sel_vector = source_addresses.sel_vector;
+		VectorOperations::Exec(source_addresses, [&](index_t i, index_t k) {
+			memcpy(state_data.get() + i * state_size, source_pointers[i], state_size);
+			// a state that was never updated is NULL, combining it would not change the target state
+			state.nullmask[i] = memcmp(source_pointers[i], empty_state, state_size) == 0;
+		});
+		aggr->function.combine(state, target_addresses);
+
+		// move to the next aggregate
+		VectorOperations::AddInPlace(source_addresses, state_size);
+		VectorOperations::AddInPlace(target_addresses, state_size);
+		empty_state += state_size;
+	}
+}
+
+index_t SuperLargeHashTable::MemoryUsage() {
+	index_t memory_usage = capacity * tuple_size;
+	for (auto &distinct_hash : distinct_hashes) {
+		if (distinct_hash) {
+			memory_usage += distinct_hash->MemoryUsage();
+		}
+	}
+	return memory_usage;
+}
+
+void SuperLargeHashTable::ComputePartitions(DataChunk &groups, index_t radix_bits, index_t partitions[]) {
+	// the lower bits of the hash determine the position of a group within the HT, we use higher bits to determine
+	// the partition so the groups within a partition are still spread over the whole HT. Note that hashes of 32-bit
+	// values only use the lower 32 bits.
+	const index_t radix_shift = 32 - radix_bits;
+	const uint64_t radix_mask = ((uint64_t)1 << radix_bits) - 1;
+
+	// FindOrCreateGroups replaces the NULL values in the groups and clears their nullmask, we do this up front so the
+	// groups are hashed in the same way as in the HT
+	for (index_t i = 0; i < groups.column_count; i++) {
+		VectorOperations::FillNullMask(groups.data[i]);
+	}
+	StaticVector<uint64_t> hashes;
+	groups.Hash(hashes);
+	auto hash_data = (uint64_t *)hashes.data;
+	VectorOperations::Exec(hashes,
+	                       [&](index_t i, index_t k) { partitions[i] = (hash_data[i] >> radix_shift) & radix_mask; });
+}
+
+void SuperLargeHashTable::Partition(vector<SuperLargeHashTable *> &partitions, index_t radix_bits) {
+	assert(partitions.size() == (index_t)1 << radix_bits);
+
+	DataChunk groups;
+	groups.Initialize(group_types);
+	Vector addresses(TypeId::POINTER, true, false);
+	index_t scan_position = 0;
+	while (true) {
+		groups.Reset();
+		index_t entry = ScanGroups(scan_position, groups, addresses);
+		if (entry == 0) {
+			break;
+		}
+		// the addresses have been moved past the groups, i.e. they point to the aggregate states now
+		index_t group_partitions[STANDARD_VECTOR_SIZE];
+		ComputePartitions(groups, radix_bits, group_partitions);
+		for (index_t partition_idx = 0; partition_idx < partitions.size(); partition_idx++) {
+			// select the groups that belong to this partition
+			sel_t partition_sel[STANDARD_VECTOR_SIZE];
+			index_t partition_count = 0;
+			for (index_t i = 0; i < entry; i++) {
+				if (group_partitions[i] == partition_idx) {
+					partition_sel[partition_count++] = i;
+				}
+			}
+			if (partition_count == 0) {
+				continue;
+			}
+			groups.sel_vector = partition_sel;
+			for (index_t i = 0; i < groups.column_count; i++) {
+				groups.data[i].sel_vector = partition_sel;
+				groups.data[i].count = partition_count;
+			}
+			Vector source_addresses;
+			source_addresses.Reference(addresses);
+			source_addresses.sel_vector = partition_sel;
+			source_addresses.count = partition_count;
+
+			StaticPointerVector target_addresses;
+			StaticVector<bool> new_group_dummy;
+			partitions[partition_idx]->FindOrCreateGroups(groups, target_addresses, new_group_dummy);
+			partitions[partition_idx]->CombineStates(source_addresses, target_addresses);
+		}
+	}
+	partitions[0]->string_heap.MergeHeap(string_heap);
+}
+
+void SuperLargeHashTable::Combine(SuperLargeHashTable &other) {
+	assert(other.group_types == group_types && other.payload_width == payload_width);
+	DataChunk groups;
+	groups.Initialize(group_types);
+	Vector source_addresses(TypeId::POINTER, true, false);
+	index_t scan_position = 0;
+	while (true) {
+		groups.Reset();
+		index_t entry = other.ScanGroups(scan_position, groups, source_addresses);
+		if (entry == 0) {
+			break;
+		}
+		StaticPointerVector target_addresses;
+		StaticVector<bool> new_group_dummy;
+		FindOrCreateGroups(groups, target_addresses, new_group_dummy);
+		CombineStates(source_addresses, target_addresses);
+	}
+	string_heap.MergeHeap(other.string_heap);
+}
@@ -0,0 +1,45 @@
+#include "duckdb/execution/executor.hpp"
+
+#include "duckdb/execution/physical_sink.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+Executor::Executor(ClientContext &context) : context(context) {
+}
+
+Executor::~Executor() {
+}
+
+void Executor::Initialize(PhysicalOperator &plan) {
+	if (plan.IsSink()) {
+		GetPipeline((PhysicalSink &)plan);
+	}
+	for (auto &child : plan.children) {
+		Initialize(*child);
+	}
+}
+
+Pipeline &Executor::GetPipeline(PhysicalSink &sink) {
+	lock_guard<mutex> guard(executor_lock);
+	auto entry = pipelines.find(&sink);
+	if (entry != pipelines.end()) {
+		return *entry->second;
+	}
+	// the sink is not part of the plan the executor was initialized with (e.g. it is part of a subplan that is not a
+	// child of its parent operator): create its pipeline now
+	auto pipeline = make_unique<Pipeline>(*this, sink);
+	auto &result = *pipeline;
+	pipelines[&sink] = move(pipeline);
+	return result;
+}
+
+void Executor::ExecutePipeline(PhysicalSink &sink) {
+	GetPipeline(sink).Execute();
+}
+
+void Executor::Reset() {
+	lock_guard<mutex> guard(executor_lock);
+	pipelines.clear();
+}
@@ -0,0 +1,86 @@
+#include "duckdb/execution/external_chunk_collection.hpp"
+
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace duckdb;
+using namespace std;
+
+ExternalChunkCollection::ExternalChunkCollection(BufferManager &manager) : manager(manager), count(0), scan_buffer(0) {
+	serializer = make_unique<BufferedSerializer>((index_t)Storage::BLOCK_SIZE);
+}
+
+ExternalChunkCollection::~ExternalChunkCollection() {
+	// destroy the buffers that have not been read yet
+	scan_handle.reset();
+	for (index_t i = scan_buffer; i < buffers.size(); i++) {
+		manager.DestroyBuffer(buffers[i]);
+	}
+}
+
+void ExternalChunkCollection::Append(DataChunk &chunk) {
+	assert(serializer);
+	chunk.Serialize(*serializer);
+	if (serializer->blob.size >= Storage::BLOCK_SIZE) {
+		FlushBuffer();
+	}
+	count += chunk.size();
+}
+
+void ExternalChunkCollection::Finalize() {
+	if (serializer->blob.size > 0) {
+		FlushBuffer();
+	}
+	serializer.reset();
+}
+
+void ExternalChunkCollection::FlushBuffer() {
+	auto data = serializer->GetData();
+	auto handle = manager.Allocate(std::max((index_t)Storage::BLOCK_ALLOC_SIZE, data.size + Storage::BLOCK_HEADER_SIZE));
+	assert(handle->node->size >= data.size);
+	memcpy(handle->node->buffer, data.data.get(), data.size);
+	buffers.push_back(handle->block_id);
+	buffer_sizes.push_back(data.size);
+	// the buffer is unpinned when the handle goes out of scope, from then on it can be offloaded to disk
+	serializer = make_unique<BufferedSerializer>((index_t)Storage::BLOCK_SIZE);
+}
+
+bool ExternalChunkCollection::Scan(unique_ptr<DataChunk> &chunk) {
+	assert(!serializer);
+	while (!deserializer || deserializer->ptr == deserializer->endptr) {
+		if (deserializer) {
+			// the current buffer has been read entirely: destroy it and move to the next buffer
+			deserializer.reset();
+			scan_handle.reset();
+			manager.DestroyBuffer(buffers[scan_buffer]);
+			scan_buffer++;
+		}
+		if (scan_buffer >= buffers.size()) {
+			return false;
+		}
+		scan_handle = manager.Pin(buffers[scan_buffer]);
+		deserializer = make_unique<BufferedDeserializer>(scan_handle->node->buffer, buffer_sizes[scan_buffer]);
+	}
+	chunk = make_unique<DataChunk>();
+	chunk->Deserialize(*deserializer);
+	return true;
+}
+
+index_t ExternalChunkCollection::EstimateMemoryUsage(DataChunk &chunk) {
+	index_t memory_usage = 0;
+	for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+		auto &vector = chunk.data[col_idx];
+		memory_usage += vector.count * GetTypeIdSize(vector.type);
+		if (vector.type == TypeId::VARCHAR) {
+			auto strings = (const char **)vector.data;
+			VectorOperations::Exec(vector, [&](index_t i, index_t k) {
+				if (!vector.nullmask[i]) {
+					memory_usage += strlen(strings[i]) + 1;
+				}
+			});
+		}
+	}
+	return memory_usage;
+}
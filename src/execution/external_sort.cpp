@@ -0,0 +1,210 @@
+#include "duckdb/execution/external_sort.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <algorithm>
+
+using namespace duckdb;
+using namespace std;
+
+ExternalSortedRun::ExternalSortedRun(BufferManager &manager) : count(0), data(manager) {
+}
+
+void ExternalSortedRun::Append(ChunkCollection &payload, index_t payload_order[], ChunkCollection &keys,
+                               index_t key_order[], index_t row_count) {
+	for (index_t start = 0; start < row_count; start += STANDARD_VECTOR_SIZE) {
+		DataChunk payload_chunk, key_chunk;
+		payload_chunk.Initialize(payload.types);
+		key_chunk.Initialize(keys.types);
+		payload.MaterializeHeapChunk(payload_chunk, payload_order, start, row_count);
+		keys.MaterializeHeapChunk(key_chunk, key_order, start, row_count);
+		Append(payload_chunk, key_chunk);
+	}
+}
+
+void ExternalSortedRun::Append(DataChunk &payload, DataChunk &keys) {
+	assert(payload.size() == keys.size());
+	data.Append(payload);
+	data.Append(keys);
+	count += payload.size();
+}
+
+void ExternalSortedRun::Finalize() {
+	data.Finalize();
+}
+
+bool ExternalSortedRun::Scan(unique_ptr<DataChunk> &payload, unique_ptr<DataChunk> &keys) {
+	if (!data.Scan(payload)) {
+		return false;
+	}
+	bool has_keys = data.Scan(keys);
+	assert(has_keys);
+	return has_keys;
+}
+
+ExternalRunMerger::ExternalRunMerger(SortKeyLayout &layout, vector<unique_ptr<ExternalSortedRun>> runs)
+    : layout(layout), runs(move(runs)), initialized(false) {
+	states.resize(this->runs.size());
+}
+
+bool ExternalRunMerger::NextChunk(index_t run_idx) {
+	auto &state = states[run_idx];
+	unique_ptr<DataChunk> keys;
+	if (!runs[run_idx]->Scan(state.payload, keys)) {
+		state.payload.reset();
+		state.entries.reset();
+		return false;
+	}
+	// the encoded keys can point to the strings of the keys chunk, so the keys chunk is kept alive alongside them
+	assert(keys->size() > 0);
+	state.entries = unique_ptr<data_t[]>(new data_t[keys->size() * layout.entry_size]);
+	layout.Encode(*keys, state.entries.get(), 0);
+	state.keys = move(keys);
+	state.position = 0;
+	return true;
+}
+
+bool ExternalRunMerger::CompareRuns(index_t left, index_t right) {
+	auto &lstate = states[left];
+	auto &rstate = states[right];
+	auto comp_res = layout.Compare(lstate.entries.get() + lstate.position * layout.entry_size,
+	                               rstate.entries.get() + rstate.position * layout.entry_size);
+	// equal entries are emitted in the order of the runs
+	return comp_res == 0 ? left > right : comp_res > 0;
+}
+
+template <class T>
+static void templated_gather(Vector &result, DataChunk *sources[], index_t rows[], index_t col_idx, index_t count) {
+	auto result_data = (T *)result.data;
+	for (index_t i = 0; i < count; i++) {
+		auto &source = sources[i]->data[col_idx];
+		result.nullmask[i] = source.nullmask[rows[i]];
+		result_data[i] = ((T *)source.data)[rows[i]];
+	}
+}
+
+static void gather_strings(Vector &result, DataChunk *sources[], index_t rows[], index_t col_idx, index_t count) {
+	auto result_data = (const char **)result.data;
+	for (index_t i = 0; i < count; i++) {
+		auto &source = sources[i]->data[col_idx];
+		result.nullmask[i] = source.nullmask[rows[i]];
+		if (result.nullmask[i]) {
+			// do not leave a pointer into the string heap of a previous chunk behind, which may have been freed
+			result_data[i] = nullptr;
+		} else {
+			// the source chunk can be destroyed before the result is consumed: copy the string
+			result_data[i] = result.string_heap.AddString(((const char **)source.data)[rows[i]]);
+		}
+	}
+}
+
+static void gather_column(Vector &target, DataChunk *sources[], index_t rows[], index_t col_idx, index_t count) {
+	switch (target.type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		templated_gather<int8_t>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::SMALLINT:
+		templated_gather<int16_t>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::INTEGER:
+		templated_gather<int32_t>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::BIGINT:
+		templated_gather<int64_t>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::FLOAT:
+		templated_gather<float>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::DOUBLE:
+		templated_gather<double>(target, sources, rows, col_idx, count);
+		break;
+	case TypeId::VARCHAR:
+		gather_strings(target, sources, rows, col_idx, count);
+		break;
+	default:
+		throw NotImplementedException("Type for setting");
+	}
+	target.count = count;
+}
+
+index_t ExternalRunMerger::MaximumMergeWidth(BufferManager &manager) {
+	// every run that is merged keeps one buffer pinned, leave room for the output of the merge and other operators
+	return std::max((index_t)2, manager.GetLimit() / (4 * Storage::BLOCK_ALLOC_SIZE));
+}
+
+unique_ptr<ExternalSortedRun> ExternalRunMerger::MergeRuns(BufferManager &manager, vector<TypeId> &payload_types,
+                                                           vector<TypeId> &key_types) {
+	auto result = make_unique<ExternalSortedRun>(manager);
+	DataChunk payload, keys;
+	payload.Initialize(payload_types);
+	keys.Initialize(key_types);
+	while (true) {
+		payload.Reset();
+		keys.Reset();
+		GetChunk(payload, &keys);
+		if (payload.size() == 0) {
+			break;
+		}
+		result->Append(payload, keys);
+	}
+	result->Finalize();
+	return result;
+}
+
+void ExternalRunMerger::GetChunk(DataChunk &result) {
+	GetChunk(result, nullptr);
+}
+
+void ExternalRunMerger::GetChunk(DataChunk &result, DataChunk *keys) {
+	auto compare = [&](index_t left, index_t right) { return CompareRuns(left, right); };
+	if (!initialized) {
+		for (index_t run_idx = 0; run_idx < runs.size(); run_idx++) {
+			if (NextChunk(run_idx)) {
+				heap.push_back(run_idx);
+			}
+		}
+		std::make_heap(heap.begin(), heap.end(), compare);
+		initialized = true;
+	}
+
+	// first determine the rows that make up the result
+	DataChunk *sources[STANDARD_VECTOR_SIZE];
+	DataChunk *key_sources[STANDARD_VECTOR_SIZE];
+	index_t rows[STANDARD_VECTOR_SIZE];
+	// exhausted chunks that are still referenced by the result
+	vector<unique_ptr<DataChunk>> retired_chunks;
+	index_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && heap.size() > 0) {
+		std::pop_heap(heap.begin(), heap.end(), compare);
+		auto run_idx = heap.back();
+		auto &state = states[run_idx];
+		sources[count] = state.payload.get();
+		key_sources[count] = state.keys.get();
+		rows[count] = state.position;
+		count++;
+
+		state.position++;
+		if (state.position == state.payload->size()) {
+			retired_chunks.push_back(move(state.payload));
+			retired_chunks.push_back(move(state.keys));
+			if (!NextChunk(run_idx)) {
+				heap.pop_back();
+				continue;
+			}
+		}
+		std::push_heap(heap.begin(), heap.end(), compare);
+	}
+
+	// now gather the payload (and keys) of the rows
+	for (index_t col_idx = 0; col_idx < result.column_count; col_idx++) {
+		gather_column(result.data[col_idx], sources, rows, col_idx, count);
+	}
+	result.Verify();
+	if (keys) {
+		for (index_t col_idx = 0; col_idx < keys->column_count; col_idx++) {
+			gather_column(keys->data[col_idx], key_sources, rows, col_idx, count);
+		}
+		keys->Verify();
+	}
+}
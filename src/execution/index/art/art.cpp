@@ -2,6 +2,10 @@
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/checkpoint/row_id_map.hpp"
 #include <algorithm>
 #include <ctgmath>
 
@@ -10,7 +14,8 @@ using namespace std;
 
 ART::ART(DataTable &table, vector<column_t> column_ids, vector<unique_ptr<Expression>> unbound_expressions,
          bool is_unique)
-    : Index(IndexType::ART, table, column_ids, move(unbound_expressions)), is_unique(is_unique) {
+    : Index(IndexType::ART, table, column_ids, move(unbound_expressions)), is_unique(is_unique), full_block_count(0),
+      deleted_count(0) {
 	if (this->unbound_expressions.size() > 1) {
 		throw NotImplementedException("Multiple columns in ART index not supported");
 	}
@@ -282,6 +287,76 @@ bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth,
 	return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+BlockPointer ART::Serialize(MetaBlockWriter &writer, const RowIdMap &row_map) {
+	lock_guard<mutex> l(lock);
+	BlockPointer pointer;
+	pointer.block_id = INVALID_BLOCK;
+	pointer.offset = 0;
+	if (!tree) {
+		return pointer;
+	}
+	// the nodes that have not been loaded are kept if the row ids in them are unchanged: no rows were deleted since
+	// they were written, and the rows are not moved to remove the deleted rows
+	bool keep_unloaded = row_map.deleted_rows.size() == deleted_count && (!row_map.compacted || deleted_count == 0) &&
+	                     blocks.size() <= 2 * full_block_count;
+	NodeWriteState state(writer, row_map, keep_unloaded);
+	auto root = Node::Serialize(*this, tree, state);
+	if (root.block_id == INVALID_BLOCK) {
+		return pointer;
+	}
+	auto &written_blocks = state.blocks;
+	index_t written_full_count = written_blocks.size();
+	if (state.kept_unloaded) {
+		// the kept nodes are stored in the blocks of the index that was read
+		for (auto &block_id : blocks) {
+			writer.manager.MarkBlockAsUsed(block_id);
+		}
+		written_blocks.insert(written_blocks.end(), blocks.begin(), blocks.end());
+		written_full_count = full_block_count;
+	} else {
+		// all nodes have been loaded: the blocks of the index that was read are no longer used
+		blocks.clear();
+		full_block_count = written_full_count;
+	}
+	// finally write the location of the root node, together with the information needed to keep the stored nodes
+	pointer.block_id = writer.block->id;
+	pointer.offset = writer.offset;
+	writer.Write<index_t>(row_map.compacted ? 0 : row_map.deleted_rows.size());
+	writer.Write<index_t>(written_full_count);
+	writer.Write<index_t>(written_blocks.size());
+	for (auto &block_id : written_blocks) {
+		writer.Write<block_id_t>(block_id);
+	}
+	writer.Write<block_id_t>(root.block_id);
+	writer.Write<uint32_t>(root.offset);
+	return pointer;
+}
+
+void ART::Load(BlockPointer pointer) {
+	assert(!tree);
+	if (pointer.block_id == INVALID_BLOCK) {
+		return;
+	}
+	MetaBlockReader reader(*table.storage.buffer_manager, pointer.block_id);
+	reader.offset = pointer.offset;
+	deleted_count = reader.Read<index_t>();
+	full_block_count = reader.Read<index_t>();
+	auto block_count = reader.Read<index_t>();
+	blocks.reserve(block_count);
+	for (index_t i = 0; i < block_count; i++) {
+		blocks.push_back(reader.Read<block_id_t>());
+	}
+	BlockPointer root;
+	root.block_id = reader.Read<block_id_t>();
+	root.offset = reader.Read<uint32_t>();
+	// only the root node is read here
+	UnloadedNode root_node(*this, root);
+	tree = root_node.Load();
+}
+
 //===--------------------------------------------------------------------===//
 // Delete
 //===--------------------------------------------------------------------===//
@@ -579,17 +654,13 @@ static Leaf &FindMinimum(Iterator &it, Node &node) {
 		it.node = (Leaf *)&node;
 		return (Leaf &)node;
 	case NodeType::N4:
-		next = ((Node4 &)node).child[0].get();
-		break;
 	case NodeType::N16:
-		next = ((Node16 &)node).child[0].get();
 		break;
 	case NodeType::N48: {
 		auto &n48 = (Node48 &)node;
 		while (n48.childIndex[pos] == Node::EMPTY_MARKER) {
 			pos++;
 		}
-		next = n48.child[n48.childIndex[pos]].get();
 		break;
 	}
 	case NodeType::N256: {
@@ -597,10 +668,13 @@ static Leaf &FindMinimum(Iterator &it, Node &node) {
 		while (!n256.child[pos]) {
 			pos++;
 		}
-		next = n256.child[pos].get();
 		break;
 	}
+	default:
+		assert(0);
+		break;
 	}
+	next = node.GetChild(pos)->get();
 	it.stack[it.depth].node = &node;
 	it.stack[it.depth].pos = pos;
 	it.depth++;
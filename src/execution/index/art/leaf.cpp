@@ -12,6 +12,11 @@ Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t row_id) : Node(art, NodeType::
 	this->num_elements = 1;
 }
 
+Leaf::Leaf(ART &art, unique_ptr<Key> value, unique_ptr<row_t[]> row_ids, index_t num_elements)
+    : Node(art, NodeType::NLeaf), value(move(value)), capacity(num_elements), num_elements(num_elements),
+      row_ids(move(row_ids)) {
+}
+
 void Leaf::Insert(row_t row_id) {
 	// Grow array
 	if (num_elements == capacity) {
@@ -1,8 +1,12 @@
 #include "duckdb/execution/index/art/node.hpp"
 #include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
+#include "duckdb/storage/checkpoint/row_id_map.hpp"
 
 using namespace duckdb;
+using namespace std;
 
 Node::Node(ART &art, NodeType type) : prefix_length(0), count(0), type(type) {
 	this->prefix = unique_ptr<uint8_t[]>(new uint8_t[art.maxPrefix]);
@@ -74,3 +78,206 @@ void Node::Erase(ART &art, unique_ptr<Node> &node, index_t pos) {
 		break;
 	}
 }
+
+unique_ptr<Node> *Node::Load(unique_ptr<Node> &node) {
+	if (node && node->type == NodeType::NUnloaded) {
+		node = ((UnloadedNode &)*node).Load();
+	}
+	return &node;
+}
+
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+static uint8_t GetChildKeyByte(Node &node, index_t pos) {
+	switch (node.type) {
+	case NodeType::N4:
+		return ((Node4 &)node).key[pos];
+	case NodeType::N16:
+		return ((Node16 &)node).key[pos];
+	default:
+		// the positions of a Node48 and a Node256 are the key bytes themselves
+		return (uint8_t)pos;
+	}
+}
+
+//! Adds the block the writer is currently writing to to the blocks of the written nodes
+static void AddWrittenBlock(NodeWriteState &state) {
+	auto block_id = state.writer.block->id;
+	if (state.blocks.empty() || state.blocks.back() != block_id) {
+		state.blocks.push_back(block_id);
+	}
+}
+
+//! Returns the smallest type of inner node that can hold the given amount of children
+static NodeType GetInnerNodeType(index_t child_count) {
+	if (child_count <= 4) {
+		return NodeType::N4;
+	} else if (child_count <= 16) {
+		return NodeType::N16;
+	} else if (child_count <= 48) {
+		return NodeType::N48;
+	} else {
+		return NodeType::N256;
+	}
+}
+
+BlockPointer Node::Serialize(ART &art, unique_ptr<Node> &node_ptr, NodeWriteState &state) {
+	BlockPointer pointer;
+	pointer.block_id = INVALID_BLOCK;
+	pointer.offset = 0;
+	if (node_ptr->type == NodeType::NUnloaded && state.keep_unloaded) {
+		// the node and its children have not changed since they were written: refer to the stored node instead of
+		// reading it, the blocks it is stored in are kept by the ART
+		state.kept_unloaded = true;
+		return ((UnloadedNode &)*node_ptr).pointer;
+	}
+	auto &node = **Load(node_ptr);
+	auto &writer = state.writer;
+
+	// first write the children (or map the row ids of the leaf), the node stores the locations of its children
+	vector<uint8_t> child_keys;
+	vector<BlockPointer> child_pointers;
+	vector<row_t> row_ids;
+	if (node.type == NodeType::NLeaf) {
+		auto &leaf = (Leaf &)node;
+		for (index_t i = 0; i < leaf.num_elements; i++) {
+			auto row_id = state.row_map.Map(leaf.GetRowId(i));
+			if (row_id != RowIdMap::INVALID_ROW) {
+				row_ids.push_back(row_id);
+			}
+		}
+		if (row_ids.size() == 0) {
+			return pointer;
+		}
+	} else {
+		for (index_t pos = node.GetNextPos(INVALID_INDEX); pos != INVALID_INDEX; pos = node.GetNextPos(pos)) {
+			auto child_pointer = Serialize(art, *node.GetChild(pos), state);
+			if (child_pointer.block_id != INVALID_BLOCK) {
+				child_keys.push_back(GetChildKeyByte(node, pos));
+				child_pointers.push_back(child_pointer);
+			}
+		}
+		if (child_pointers.size() == 0) {
+			return pointer;
+		}
+	}
+	// now write the node itself, the children that remain are written as the smallest node type that can hold them
+	auto type = node.type == NodeType::NLeaf ? NodeType::NLeaf : GetInnerNodeType(child_keys.size());
+	pointer.block_id = writer.block->id;
+	pointer.offset = writer.offset;
+	AddWrittenBlock(state);
+
+	writer.Write<uint8_t>((uint8_t)type);
+	writer.Write<uint32_t>(node.prefix_length);
+	writer.WriteData(node.prefix.get(), std::min(node.prefix_length, art.maxPrefix));
+	AddWrittenBlock(state);
+	if (node.type == NodeType::NLeaf) {
+		auto &leaf = (Leaf &)node;
+		writer.Write<index_t>(leaf.value->len);
+		writer.WriteData(leaf.value->data.get(), leaf.value->len);
+		writer.Write<index_t>(row_ids.size());
+		AddWrittenBlock(state);
+		// the row ids are written one by one, so every block they are written to is recorded
+		for (auto &row_id : row_ids) {
+			writer.Write<row_t>(row_id);
+			AddWrittenBlock(state);
+		}
+	} else {
+		writer.Write<uint16_t>(child_keys.size());
+		for (index_t i = 0; i < child_keys.size(); i++) {
+			writer.Write<uint8_t>(child_keys[i]);
+			writer.Write<block_id_t>(child_pointers[i].block_id);
+			writer.Write<uint32_t>(child_pointers[i].offset);
+			AddWrittenBlock(state);
+		}
+	}
+	return pointer;
+}
+
+unique_ptr<Node> Node::Deserialize(ART &art, MetaBlockReader &reader) {
+	auto type = (NodeType)reader.Read<uint8_t>();
+	auto prefix_length = reader.Read<uint32_t>();
+	auto prefix = unique_ptr<uint8_t[]>(new uint8_t[art.maxPrefix]);
+	reader.ReadData(prefix.get(), std::min(prefix_length, art.maxPrefix));
+
+	unique_ptr<Node> result;
+	if (type == NodeType::NLeaf) {
+		auto key_length = reader.Read<index_t>();
+		auto key_data = unique_ptr<data_t[]>(new data_t[key_length]);
+		reader.ReadData(key_data.get(), key_length);
+		auto num_elements = reader.Read<index_t>();
+		auto row_ids = unique_ptr<row_t[]>(new row_t[num_elements]);
+		reader.ReadData((data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+		result = make_unique<Leaf>(art, make_unique<Key>(move(key_data), key_length), move(row_ids), num_elements);
+	} else {
+		switch (type) {
+		case NodeType::N4:
+			result = make_unique<Node4>(art);
+			break;
+		case NodeType::N16:
+			result = make_unique<Node16>(art);
+			break;
+		case NodeType::N48:
+			result = make_unique<Node48>(art);
+			break;
+		case NodeType::N256:
+			result = make_unique<Node256>(art);
+			break;
+		default:
+			throw Exception("Corrupt index: unrecognized node type");
+		}
+		// the children are only read from storage once they are accessed
+		auto count = reader.Read<uint16_t>();
+		assert(count > 0);
+		uint8_t key_byte;
+		BlockPointer pointer;
+		for (index_t i = 0; i < count; i++) {
+			key_byte = reader.Read<uint8_t>();
+			pointer.block_id = reader.Read<block_id_t>();
+			pointer.offset = reader.Read<uint32_t>();
+			unique_ptr<Node> child = make_unique<UnloadedNode>(art, pointer);
+			switch (type) {
+			case NodeType::N4: {
+				auto &n4 = (Node4 &)*result;
+				n4.key[i] = key_byte;
+				n4.child[i] = move(child);
+				break;
+			}
+			case NodeType::N16: {
+				auto &n16 = (Node16 &)*result;
+				n16.key[i] = key_byte;
+				n16.child[i] = move(child);
+				break;
+			}
+			case NodeType::N48: {
+				auto &n48 = (Node48 &)*result;
+				n48.childIndex[key_byte] = i;
+				n48.child[i] = move(child);
+				break;
+			}
+			default: {
+				auto &n256 = (Node256 &)*result;
+				n256.child[key_byte] = move(child);
+				break;
+			}
+			}
+		}
+		result->count = count;
+		if (count == 1) {
+			// the deleted rows are not written, which can leave a node with a single child: replace the node with the
+			// child, and put the prefix of the node and the key byte of the child in front of the prefix of the child
+			auto child = UnloadedNode(art, pointer).Load();
+			vector<uint8_t> path(prefix.get(), prefix.get() + std::min(prefix_length, art.maxPrefix));
+			path.push_back(key_byte);
+			path.insert(path.end(), child->prefix.get(),
+			            child->prefix.get() + std::min(child->prefix_length, art.maxPrefix));
+			child->prefix_length += prefix_length + 1;
+			memcpy(child->prefix.get(), path.data(), std::min((index_t)child->prefix_length, (index_t)art.maxPrefix));
+			return child;
+		}
+	}
+	result->prefix_length = prefix_length;
+	result->prefix = move(prefix);
+	return result;
+}
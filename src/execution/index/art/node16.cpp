@@ -37,7 +37,7 @@ index_t Node16::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node16::GetChild(index_t pos) {
 	assert(pos < count);
-	return &child[pos];
+	return Load(child[pos]);
 }
 
 void Node16::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -34,7 +34,7 @@ index_t Node256::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node256::GetChild(index_t pos) {
 	assert(child[pos]);
-	return &child[pos];
+	return Load(child[pos]);
 }
 
 void Node256::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -36,7 +36,7 @@ index_t Node4::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node4::GetChild(index_t pos) {
 	assert(pos < count);
-	return &child[pos];
+	return Load(child[pos]);
 }
 
 void Node4::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -86,7 +86,7 @@ void Node4::erase(ART &art, unique_ptr<Node> &node, int pos) {
 
 	// This is a one way node
 	if (n->count == 1) {
-		auto childref = n->child[0].get();
+		auto childref = n->GetChild(0)->get();
 		if (childref->type == NodeType::NLeaf) {
 			// Concantenate prefixes
 			uint32_t l1 = childref->prefix_length;
@@ -38,7 +38,7 @@ index_t Node48::GetNextPos(index_t pos) {
 
 unique_ptr<Node> *Node48::GetChild(index_t pos) {
 	assert(childIndex[pos] != Node::EMPTY_MARKER);
-	return &child[childIndex[pos]];
+	return Load(child[childIndex[pos]]);
 }
 
 void Node48::insert(ART &art, unique_ptr<Node> &node, uint8_t keyByte, unique_ptr<Node> &child) {
@@ -0,0 +1,17 @@
+#include "duckdb/execution/index/art/unloaded_node.hpp"
+#include "duckdb/execution/index/art/art.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+UnloadedNode::UnloadedNode(ART &art, BlockPointer pointer) : Node(art, NodeType::NUnloaded), art(art), pointer(pointer) {
+}
+
+unique_ptr<Node> UnloadedNode::Load() {
+	// the block is pinned through the buffer manager, so it can be evicted again once the node has been read
+	MetaBlockReader reader(*art.table.storage.buffer_manager, pointer.block_id);
+	reader.offset = pointer.offset;
+	return Node::Deserialize(art, reader);
+}
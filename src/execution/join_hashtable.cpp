@@ -23,20 +23,24 @@ static void SerializeChunk(DataChunk &source, data_ptr_t targets[]) {
 }
 
 static void DeserializeChunk(DataChunk &result, data_ptr_t source[], index_t count) {
-	Vector source_vector(TypeId::POINTER, (data_ptr_t)source);
+	// Gather::Set does not apply an offset, so we point to the location of each column ourselves
+	data_ptr_t column_locations[STANDARD_VECTOR_SIZE];
+	Vector source_vector(TypeId::POINTER, (data_ptr_t)column_locations);
 	source_vector.count = count;
 
 	index_t offset = 0;
 	for (index_t i = 0; i < result.column_count; i++) {
-		VectorOperations::Gather::Set(source_vector, result.data[i], false, offset);
+		for (index_t k = 0; k < count; k++) {
+			column_locations[k] = source[k] + offset;
+		}
+		VectorOperations::Gather::Set(source_vector, result.data[i], false);
 		offset += GetTypeIdSize(result.data[i].type);
 	}
 }
 
-JoinHashTable::JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type,
-                             index_t initial_capacity, bool parallel)
+JoinHashTable::JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type)
     : build_types(build_types), equality_size(0), condition_size(0), build_size(0), entry_size(0), tuple_size(0),
-      join_type(type), has_null(false), capacity(0), count(0), parallel(parallel) {
+      join_type(type), has_null(false), bitmask(0), capacity(0), count(0), node_count(0) {
 	for (auto &condition : conditions) {
 		assert(condition.left->return_type == condition.right->return_type);
 		auto type = condition.left->return_type;
@@ -72,7 +76,6 @@ JoinHashTable::JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> b
 	}
 	tuple_size = condition_size + build_size;
 	entry_size = tuple_size + sizeof(void *);
-	Resize(initial_capacity);
 }
 
 void JoinHashTable::ApplyBitmask(Vector &hashes) {
@@ -90,84 +93,92 @@ void JoinHashTable::InsertHashes(Vector &hashes, data_ptr_t key_locations[]) {
 	auto indices = (index_t *)hashes.data;
 	// now fill in the entries
 	VectorOperations::Exec(hashes, [&](index_t i, index_t k) {
-		auto index = indices[i];
+		auto &entry = pointers[indices[i]];
 		// set prev in current key to the value (NOTE: this will be nullptr if
-		// there is none)
+		// there is none), and then make the current key the head of the chain
+		// other threads can insert into the same chain concurrently: retry until the head has not changed
 		auto prev_pointer = (data_ptr_t *)(key_locations[i] + tuple_size);
-		*prev_pointer = pointers[index];
-
-		// set pointer to current tuple
-		pointers[index] = key_locations[i];
+		data_ptr_t head = entry.load();
+		do {
+			*prev_pointer = head;
+		} while (!entry.compare_exchange_weak(head, key_locations[i]));
 	});
 }
 
-void JoinHashTable::Resize(index_t size) {
-	if (size <= capacity) {
-		throw Exception("Cannot downsize a hash table!");
+void JoinHashTable::InitializePointerTable() {
+	// the hash map is kept at most 50% full
+	index_t size = 1024;
+	while (size < count * 2) {
+		size *= 2;
 	}
 	capacity = size;
+	bitmask = capacity - 1;
 
-	// size needs to be a power of 2
-	assert((size & (size - 1)) == 0);
-	bitmask = size - 1;
-
-	hashed_pointers = unique_ptr<data_ptr_t[]>(new data_ptr_t[capacity]);
-	memset(hashed_pointers.get(), 0, capacity * sizeof(data_ptr_t));
-
-	if (count > 0) {
-		// we have entries, need to rehash the pointers
-		// first reset all chain pointers to the nullptr
-		// we could do this by actually following the chains in the
-		// hashed_pointers as well might be more or less efficient depending on
-		// length of chains?
-		auto node = head.get();
-		while (node) {
-			// scan all the entries in this node
-			auto entry_pointer = (data_ptr_t)node->data.get() + tuple_size;
-			for (index_t i = 0; i < node->count; i++) {
-				// reset chain pointer
-				auto prev_pointer = (data_ptr_t *)entry_pointer;
-				*prev_pointer = nullptr;
-				// move to next entry
-				entry_pointer += entry_size;
-			}
-			node = node->prev.get();
+	hashed_pointers = unique_ptr<atomic<data_ptr_t>[]>(new atomic<data_ptr_t>[capacity]);
+	for (index_t i = 0; i < capacity; i++) {
+		hashed_pointers[i].store(nullptr, memory_order_relaxed);
+	}
+}
+
+void JoinHashTable::InsertNodes(index_t partition, index_t partition_count) {
+	assert(hashed_pointers);
+	DataChunk keys;
+	keys.Initialize(equality_types);
+
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+
+	index_t node_index = 0;
+	for (auto node = head.get(); node; node = node->prev.get(), node_index++) {
+		if (node_index % partition_count != partition) {
+			continue;
+		}
+		// scan all the entries in this node
+		auto dataptr = node->data.get();
+		for (index_t i = 0; i < node->count; i++) {
+			// key is stored at the start
+			key_locations[i] = dataptr;
+			// move to next entry
+			dataptr += entry_size;
 		}
 
-		// now rehash the entries
-		DataChunk keys;
-		keys.Initialize(equality_types);
-
-		data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
-
-		node = head.get();
-		while (node) {
-			// scan all the entries in this node
-			auto dataptr = node->data.get();
-			for (index_t i = 0; i < node->count; i++) {
-				// key is stored at the start
-				key_locations[i] = dataptr;
-				// move to next entry
-				dataptr += entry_size;
-			}
+		// reconstruct the keys chunk from the stored entries
+		// we only reconstruct the keys that are part of the equality
+		// comparison as these are the ones that are used to compute the
+		// hash
+		DeserializeChunk(keys, key_locations, node->count);
 
-			// reconstruct the keys chunk from the stored entries
-			// we only reconstruct the keys that are part of the equality
-			// comparison as these are the ones that are used to compute the
-			// hash
-			DeserializeChunk(keys, key_locations, node->count);
+		// create the hash
+		StaticVector<uint64_t> hashes;
+		Hash(keys, hashes);
 
-			// create the hash
-			StaticVector<uint64_t> hashes;
-			keys.Hash(hashes);
+		// insert the entries
+		InsertHashes(hashes, key_locations);
+	}
+}
 
-			// re-insert the entries
-			InsertHashes(hashes, key_locations);
+void JoinHashTable::Finalize() {
+	InitializePointerTable();
+	InsertNodes(0, 1);
+}
 
-			// move to the next node
-			node = node->prev.get();
+void JoinHashTable::Merge(JoinHashTable &other) {
+	if (other.head) {
+		// append our nodes to the end of the list of the other HT, and take over the list
+		auto tail = other.head.get();
+		while (tail->prev) {
+			tail = tail->prev.get();
 		}
+		tail->prev = move(head);
+		head = move(other.head);
 	}
+	// note that the other HT can contain (only) NULL keys without having any nodes
+	node_count += other.node_count;
+	count += other.count;
+	has_null = has_null || other.has_null;
+	string_heap.MergeHeap(other.string_heap);
+
+	other.node_count = 0;
+	other.count = 0;
 }
 
 void JoinHashTable::Hash(DataChunk &keys, Vector &hashes) {
@@ -177,6 +188,25 @@ void JoinHashTable::Hash(DataChunk &keys, Vector &hashes) {
 	}
 }
 
+void JoinHashTable::ComputePartitions(DataChunk &keys, index_t partition_bits, index_t partitions[]) {
+	assert(partition_bits > 0 && partition_bits < 64);
+	StaticVector<uint64_t> hashes;
+	Hash(keys, hashes);
+	// the lower bits of the hash determine the position in the hash map, so we use the upper bits for the partition
+	auto hash_data = (uint64_t *)hashes.data;
+	VectorOperations::Exec(hashes, [&](index_t i, index_t k) { partitions[i] = hash_data[i] >> (64 - partition_bits); });
+}
+
+bool JoinHashTable::KeysContainNull(DataChunk &keys) {
+	assert(keys.column_count == null_values_are_equal.size());
+	for (index_t i = 0; i < keys.column_count; i++) {
+		if (!null_values_are_equal[i] && VectorOperations::HasNull(keys.data[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
 static index_t CreateNotNullSelVector(DataChunk &keys, sel_t *not_null_sel_vector) {
 	sel_t *sel_vector = keys.data[0].sel_vector;
 	index_t result_count = keys.size();
@@ -200,22 +230,11 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	if (keys.size() == 0) {
 		return;
 	}
-	// resize at 50% capacity, also need to fit the entire vector
-	if (parallel) {
-		parallel_lock.lock();
-	}
-	if (count + keys.size() > capacity / 2) {
-		Resize(capacity * 2);
-	}
 	count += keys.size();
 	// move strings to the string heap
 	keys.MoveStringsToHeap(string_heap);
 	payload.MoveStringsToHeap(string_heap);
 
-	if (parallel) {
-		parallel_lock.unlock();
-	}
-
 	// for any columns for which null values are equal, fill the NullMask
 	assert(keys.column_count == null_values_are_equal.size());
 	bool null_values_equal_for_all = true;
@@ -288,22 +307,10 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 		SerializeChunk(payload, tuple_locations);
 	}
 
-	// hash the keys and obtain an entry in the list
-	// note that we only hash the keys used in the equality comparison
-	StaticVector<uint64_t> hashes;
-	Hash(keys, hashes);
-
-	if (parallel) {
-		// obtain lock
-		parallel_lock.lock();
-	}
-	InsertHashes(hashes, key_locations);
-	// store the new node as the head
+	// store the new node as the head, the entries are inserted into the hash map in Finalize
 	node->prev = move(head);
 	head = move(node);
-	if (parallel) {
-		parallel_lock.unlock();
-	}
+	node_count++;
 }
 
 unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
@@ -329,7 +336,7 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 	auto indices = (uint64_t *)hashes.data;
 	for (index_t i = 0; i < hashes.count; i++) {
 		auto index = indices[i];
-		ptrs[i] = hashed_pointers[index];
+		ptrs[i] = hashed_pointers[index].load(memory_order_relaxed);
 	}
 	ss->pointers.count = hashes.count;
 
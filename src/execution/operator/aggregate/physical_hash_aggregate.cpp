@@ -2,30 +2,153 @@
 
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/external_chunk_collection.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/planner/expression/bound_aggregate_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/catalog/catalog_entry/aggregate_function_catalog_entry.hpp"
+#include "duckdb/storage/storage_manager.hpp"
 
 using namespace duckdb;
 using namespace std;
 
+//! The amount of bits of the group hash that are used to radix partition the input that does not fit in memory
+#define HASH_AGGREGATE_PARTITION_BITS 4
+#define HASH_AGGREGATE_PARTITION_COUNT (1 << HASH_AGGREGATE_PARTITION_BITS)
+
+namespace duckdb {
+
+//! The spill state of a HT. Once the HT has reached the memory limit it no longer creates new groups: the rows of
+//! groups that are not in the HT yet are spilled to radix partitions instead, which are aggregated separately.
+struct AggregateSpillState {
+	AggregateSpillState(QueryMemory &query_memory) : heap_usage(0), reservation(query_memory) {
+	}
+
+	//! The (estimated) amount of memory used by the string heap of the HT
+	index_t heap_usage;
+	//! The memory reserved for the HT
+	MemoryReservation reservation;
+	//! The partitions the rows with new groups are spilled to as (groups, payload) pairs, empty while the HT is still
+	//! below the memory limit
+	vector<unique_ptr<ExternalChunkCollection>> partitions;
+};
+
 class PhysicalHashAggregateOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalHashAggregateOperatorState(PhysicalHashAggregate *parent, PhysicalOperator *child);
+	PhysicalHashAggregateOperatorState(PhysicalHashAggregate *parent);
 
 	//! Materialized GROUP BY expression
 	DataChunk group_chunk;
 	//! Materialized aggregates
 	DataChunk aggregate_chunk;
+	//! The index of the finalized HT that is currently being scanned
+	index_t ht_index;
 	//! The current position to scan the HT for output tuples
 	index_t ht_scan_position;
-	index_t tuples_scanned;
-	//! The HT
+};
+
+class HashAggregateGlobalState : public GlobalOperatorState {
+public:
+	HashAggregateGlobalState(BufferManager &buffer_manager, QueryMemory &query_memory, index_t memory_limit)
+	    : ht_spill(query_memory), buffer_manager(buffer_manager), memory_limit(memory_limit), reservation(query_memory),
+	      tuples_scanned(0) {
+	}
+
+	//! Lock held while adding to the HT
+	std::mutex lock;
+	//! The HT that all threads aggregate into if the aggregates cannot be combined, otherwise unused
 	unique_ptr<SuperLargeHashTable> ht;
-	//! The payload chunk, only used while filling the HT
+	//! The spill state of the HT that all threads aggregate into
+	AggregateSpillState ht_spill;
+	//! The buffer manager that holds the spilled input
+	BufferManager &buffer_manager;
+	//! The amount of memory (in bytes) a HT can use before it starts spilling its input, or INVALID_INDEX if the input
+	//! is never spilled
+	index_t memory_limit;
+	//! The memory reserved for the thread-local HTs that have been added in Combine
+	MemoryReservation reservation;
+	//! The spilled input of every radix partition, collected from all threads
+	vector<vector<unique_ptr<ExternalChunkCollection>>> partition_input;
+	//! The spilled input that still has to be aggregated into each of the finalized HTs before it is scanned, empty
+	//! if no input was spilled
+	vector<vector<unique_ptr<ExternalChunkCollection>>> finalized_input;
+	//! The thread-local HTs that have been added in Combine
+	vector<unique_ptr<SuperLargeHashTable>> intermediate_hts;
+	//! The radix partitions of every intermediate HT
+	vector<vector<unique_ptr<SuperLargeHashTable>>> partitioned_hts;
+	//! The HTs that hold the final aggregates; the groups in these HTs are disjoint
+	vector<unique_ptr<SuperLargeHashTable>> finalized_hts;
+	//! The total amount of tuples that were aggregated
+	std::atomic<index_t> tuples_scanned;
+};
+
+class HashAggregateLocalState : public LocalSinkState {
+public:
+	HashAggregateLocalState(QueryMemory &query_memory) : ht_spill(query_memory) {
+	}
+
+	//! Materialized GROUP BY expression
+	DataChunk group_chunk;
+	//! The payload chunk
 	DataChunk payload_chunk;
+	//! The thread-local HT used to pre-aggregate the input (if the aggregates can be combined)
+	unique_ptr<SuperLargeHashTable> ht;
+	//! The spill state of the thread-local HT
+	AggregateSpillState ht_spill;
+};
+
+//! Splits an intermediate HT into radix partitions
+class HashAggregatePartitionTask : public Task {
+public:
+	HashAggregatePartitionTask(HashAggregateGlobalState &state, index_t ht_index, index_t radix_bits)
+	    : state(state), ht_index(ht_index), radix_bits(radix_bits) {
+	}
+
+	HashAggregateGlobalState &state;
+	index_t ht_index;
+	index_t radix_bits;
+
+public:
+	void Execute() override {
+		auto &ht = *state.intermediate_hts[ht_index];
+		auto &partitions = state.partitioned_hts[ht_index];
+		vector<SuperLargeHashTable *> partition_pointers;
+		for (auto &partition : partitions) {
+			partition_pointers.push_back(partition.get());
+		}
+		ht.Partition(partition_pointers, radix_bits);
+		// free the intermediate HT, its contents have been moved into the partitions
+		state.intermediate_hts[ht_index].reset();
+	}
 };
 
+//! Merges the same radix partition of all intermediate HTs into a finalized HT
+class HashAggregateMergeTask : public Task {
+public:
+	HashAggregateMergeTask(HashAggregateGlobalState &state, index_t partition) : state(state), partition(partition) {
+	}
+
+	HashAggregateGlobalState &state;
+	index_t partition;
+
+public:
+	void Execute() override {
+		auto &finalized_ht = state.finalized_hts[partition];
+		for (auto &partitions : state.partitioned_hts) {
+			if (!finalized_ht) {
+				finalized_ht = move(partitions[partition]);
+			} else {
+				finalized_ht->Combine(*partitions[partition]);
+				partitions[partition].reset();
+			}
+		}
+	}
+};
+
+} // namespace duckdb
+
 PhysicalHashAggregate::PhysicalHashAggregate(vector<TypeId> types, vector<unique_ptr<Expression>> expressions,
                                              PhysicalOperatorType type)
     : PhysicalHashAggregate(types, move(expressions), {}, type) {
@@ -33,7 +156,7 @@ PhysicalHashAggregate::PhysicalHashAggregate(vector<TypeId> types, vector<unique
 
 PhysicalHashAggregate::PhysicalHashAggregate(vector<TypeId> types, vector<unique_ptr<Expression>> expressions,
                                              vector<unique_ptr<Expression>> groups, PhysicalOperatorType type)
-    : PhysicalOperator(type, types), groups(move(groups)) {
+    : PhysicalSink(type, types), groups(move(groups)) {
 	// get a list of all aggregates to be computed
 	// fake a single group with a constant value for aggregation without groups
 	if (this->groups.size() == 0) {
@@ -50,58 +173,310 @@ PhysicalHashAggregate::PhysicalHashAggregate(vector<TypeId> types, vector<unique
 	}
 }
 
-void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalHashAggregateOperatorState *>(state_);
-	do {
-		if (children.size() > 0) {
-			// resolve the child chunk if there is one
-			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-			if (state->child_chunk.size() == 0) {
-				break;
+void PhysicalHashAggregate::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
+                                 DataChunk &input) {
+	auto &gstate = (HashAggregateGlobalState &)state;
+	auto &lstate = (HashAggregateLocalState &)lstate_;
+
+	index_t payload_idx = 0;
+	ExpressionExecutor executor(input);
+	// aggregation with groups
+	DataChunk &group_chunk = lstate.group_chunk;
+	DataChunk &payload_chunk = lstate.payload_chunk;
+	executor.Execute(groups, group_chunk);
+	payload_chunk.Reset();
+	for (index_t i = 0; i < aggregates.size(); i++) {
+		auto &aggr = (BoundAggregateExpression &)*aggregates[i];
+		if (aggr.children.size()) {
+			for (index_t j = 0; j < aggr.children.size(); ++j) {
+				executor.ExecuteExpression(*aggr.children[j], payload_chunk.data[payload_idx]);
+				payload_chunk.heap.MergeHeap(payload_chunk.data[payload_idx].string_heap);
+				++payload_idx;
 			}
+		} else {
+			payload_chunk.data[payload_idx].count = group_chunk.size();
+			payload_chunk.data[payload_idx].sel_vector = group_chunk.sel_vector;
+			++payload_idx;
 		}
-		index_t payload_idx = 0;
-		ExpressionExecutor executor(state->child_chunk);
-		// aggregation with groups
-		DataChunk &group_chunk = state->group_chunk;
-		DataChunk &payload_chunk = state->payload_chunk;
-		executor.Execute(groups, group_chunk);
-		payload_chunk.Reset();
-		for (index_t i = 0; i < aggregates.size(); i++) {
-			auto &aggr = (BoundAggregateExpression &)*aggregates[i];
-			if (aggr.children.size()) {
-				for (index_t j = 0; j < aggr.children.size(); ++j) {
-					executor.ExecuteExpression(*aggr.children[j], payload_chunk.data[payload_idx]);
-					payload_chunk.heap.MergeHeap(payload_chunk.data[payload_idx].string_heap);
-					++payload_idx;
-				}
-			} else {
-				payload_chunk.data[payload_idx].count = group_chunk.size();
-				payload_chunk.data[payload_idx].sel_vector = group_chunk.sel_vector;
-				++payload_idx;
+	}
+	payload_chunk.sel_vector = group_chunk.sel_vector;
+
+	group_chunk.Verify();
+	payload_chunk.Verify();
+	assert(payload_chunk.column_count == 0 || group_chunk.size() == payload_chunk.size());
+
+	gstate.tuples_scanned += input.size();
+	if (lstate.ht) {
+		// pre-aggregate in the thread-local HT
+		AddChunk(gstate, *lstate.ht, lstate.ht_spill, group_chunk, payload_chunk);
+	} else {
+		lock_guard<mutex> guard(gstate.lock);
+		AddChunk(gstate, *gstate.ht, gstate.ht_spill, group_chunk, payload_chunk);
+	}
+}
+
+//! Returns the amount of memory the strings of the chunk use once they are moved to a string heap
+static index_t StringHeapUsage(DataChunk &chunk) {
+	index_t heap_usage = 0;
+	for (index_t col_idx = 0; col_idx < chunk.column_count; col_idx++) {
+		auto &vector = chunk.data[col_idx];
+		if (vector.type != TypeId::VARCHAR) {
+			continue;
+		}
+		auto strings = (const char **)vector.data;
+		VectorOperations::Exec(vector, [&](index_t i, index_t k) {
+			if (!vector.nullmask[i]) {
+				heap_usage += strlen(strings[i]) + 1;
 			}
+		});
+	}
+	return heap_usage;
+}
+
+//! Restricts a flat chunk to the rows in the given selection vector
+static void SliceChunk(DataChunk &chunk, sel_t *sel_vector, index_t count) {
+	chunk.sel_vector = sel_vector;
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].sel_vector = sel_vector;
+		chunk.data[i].count = count;
+	}
+}
+
+void PhysicalHashAggregate::AddChunk(HashAggregateGlobalState &gstate, SuperLargeHashTable &ht,
+                                     AggregateSpillState &spill, DataChunk &group_chunk, DataChunk &payload_chunk) {
+	if (spill.partitions.size() == 0) {
+		if (gstate.memory_limit != INVALID_INDEX) {
+			spill.heap_usage += StringHeapUsage(group_chunk) + StringHeapUsage(payload_chunk);
+		}
+		AddChunk(ht, group_chunk, payload_chunk);
+		if (gstate.memory_limit == INVALID_INDEX) {
+			return;
 		}
-		payload_chunk.sel_vector = group_chunk.sel_vector;
+		auto memory_usage = ht.MemoryUsage() + spill.heap_usage;
+		if (memory_usage > gstate.memory_limit || !spill.reservation.TryResize(memory_usage)) {
+			// the HT has reached the memory limit or its memory cannot be reserved: from now on the rows of new groups
+			// are spilled
+			for (index_t i = 0; i < HASH_AGGREGATE_PARTITION_COUNT; i++) {
+				spill.partitions.push_back(make_unique<ExternalChunkCollection>(gstate.buffer_manager));
+			}
+		}
+		return;
+	}
+	if (group_chunk.sel_vector) {
+		// the rows are split over the partitions with selection vectors, so we remove any existing selection vector
+		group_chunk.Flatten();
+		payload_chunk.Flatten();
+	}
+	index_t count = group_chunk.size();
+	// the groups that are already in the HT are aggregated in the HT
+	bool found[STANDARD_VECTOR_SIZE];
+	ht.FindGroups(group_chunk, found);
+	// the other rows are sorted by their partition and spilled
+	index_t partitions[STANDARD_VECTOR_SIZE];
+	SuperLargeHashTable::ComputePartitions(group_chunk, HASH_AGGREGATE_PARTITION_BITS, partitions);
+	index_t partition_offsets[HASH_AGGREGATE_PARTITION_COUNT + 1];
+	memset(partition_offsets, 0, sizeof(partition_offsets));
+	sel_t found_sel[STANDARD_VECTOR_SIZE];
+	index_t found_count = 0;
+	for (index_t i = 0; i < count; i++) {
+		if (found[i]) {
+			found_sel[found_count++] = i;
+		} else {
+			partition_offsets[partitions[i] + 1]++;
+		}
+	}
+	for (index_t partition_idx = 0; partition_idx < HASH_AGGREGATE_PARTITION_COUNT; partition_idx++) {
+		partition_offsets[partition_idx + 1] += partition_offsets[partition_idx];
+	}
+	sel_t spill_sel[STANDARD_VECTOR_SIZE];
+	index_t spill_positions[HASH_AGGREGATE_PARTITION_COUNT];
+	memcpy(spill_positions, partition_offsets, sizeof(spill_positions));
+	for (index_t i = 0; i < count; i++) {
+		if (!found[i]) {
+			spill_sel[spill_positions[partitions[i]]++] = i;
+		}
+	}
+	for (index_t partition_idx = 0; partition_idx < HASH_AGGREGATE_PARTITION_COUNT; partition_idx++) {
+		auto partition_sel = spill_sel + partition_offsets[partition_idx];
+		auto partition_count = partition_offsets[partition_idx + 1] - partition_offsets[partition_idx];
+		if (partition_count == 0) {
+			continue;
+		}
+		SliceChunk(group_chunk, partition_sel, partition_count);
+		SliceChunk(payload_chunk, partition_sel, partition_count);
+		spill.partitions[partition_idx]->Append(group_chunk);
+		if (payload_chunk.column_count > 0) {
+			spill.partitions[partition_idx]->Append(payload_chunk);
+		}
+	}
+	if (found_count > 0) {
+		SliceChunk(group_chunk, found_sel, found_count);
+		SliceChunk(payload_chunk, found_sel, found_count);
+		// no new groups are created, so only the strings of the payload have to be moved to the string heap
+		payload_chunk.MoveStringsToHeap(ht.string_heap);
+		ht.AddChunk(group_chunk, payload_chunk);
+		for (index_t i = 0; i < payload_chunk.column_count; i++) {
+			ht.string_heap.MergeHeap(payload_chunk.data[i].string_heap);
+		}
+	}
+}
+
+void PhysicalHashAggregate::AddChunk(SuperLargeHashTable &ht, DataChunk &group_chunk, DataChunk &payload_chunk) {
+	// move the strings inside the groups to the string heap
+	group_chunk.MoveStringsToHeap(ht.string_heap);
+	payload_chunk.MoveStringsToHeap(ht.string_heap);
+
+	ht.AddChunk(group_chunk, payload_chunk);
+	// aggregate states can reference strings that were allocated in the payload heaps during the update, these
+	// have to outlive the local state
+	for (index_t i = 0; i < payload_chunk.column_count; i++) {
+		ht.string_heap.MergeHeap(payload_chunk.data[i].string_heap);
+	}
+}
+
+void PhysicalHashAggregate::Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate_) {
+	auto &gstate = (HashAggregateGlobalState &)state;
+	auto &lstate = (HashAggregateLocalState &)lstate_;
+	if (lstate.ht) {
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.intermediate_hts.push_back(move(lstate.ht));
+		gstate.reservation.Merge(lstate.ht_spill.reservation);
+		CollectSpilledInput(gstate, lstate.ht_spill);
+	}
+}
+
+void PhysicalHashAggregate::CollectSpilledInput(HashAggregateGlobalState &gstate, AggregateSpillState &spill) {
+	if (spill.partitions.size() == 0) {
+		return;
+	}
+	gstate.partition_input.resize(HASH_AGGREGATE_PARTITION_COUNT);
+	for (index_t partition_idx = 0; partition_idx < HASH_AGGREGATE_PARTITION_COUNT; partition_idx++) {
+		auto &partition = spill.partitions[partition_idx];
+		partition->Finalize();
+		gstate.partition_input[partition_idx].push_back(move(partition));
+	}
+	spill.partitions.clear();
+}
+
+void PhysicalHashAggregate::Finalize(ClientContext &context, GlobalOperatorState &state) {
+	auto &gstate = (HashAggregateGlobalState &)state;
+	vector<TypeId> group_types, payload_types;
+	vector<BoundAggregateExpression *> aggregate_kind;
+	GetPayloadTypes(group_types, payload_types, aggregate_kind);
+	if (gstate.ht) {
+		// the input was aggregated into a single HT
+		gstate.finalized_hts.push_back(move(gstate.ht));
+		CollectSpilledInput(gstate, gstate.ht_spill);
+		if (gstate.partition_input.size() > 0) {
+			// the HT stopped creating new groups when it reached the memory limit, so the groups of the spilled input
+			// are disjoint from the groups in the HT: every partition is aggregated into a new HT
+			gstate.finalized_input.resize(1);
+			for (auto &input : gstate.partition_input) {
+				gstate.finalized_hts.push_back(
+				    make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind));
+				gstate.finalized_input.push_back(move(input));
+			}
+			gstate.partition_input.clear();
+		}
+		return;
+	}
+	bool spilled = gstate.partition_input.size() > 0;
+	if (gstate.intermediate_hts.size() <= 1 && !spilled) {
+		// only a single thread aggregated the input: its HT holds the final aggregates
+		for (auto &ht : gstate.intermediate_hts) {
+			gstate.finalized_hts.push_back(move(ht));
+		}
+		return;
+	}
+	// multiple threads pre-aggregated the input, or input was spilled
+	// first split the thread-local HTs into radix partitions, one partition for every thread. If input was spilled
+	// the HTs are split into the partitions of the spilled input instead, so the spilled input of every partition
+	// can be aggregated into the partition later on.
+	auto &scheduler = *context.db.scheduler;
+	index_t radix_bits = 0;
+	if (spilled) {
+		radix_bits = HASH_AGGREGATE_PARTITION_BITS;
+	} else {
+		while (((index_t)1 << radix_bits) < scheduler.NumberOfThreads()) {
+			radix_bits++;
+		}
+	}
+	index_t partition_count = (index_t)1 << radix_bits;
+
+	vector<unique_ptr<Task>> partition_tasks;
+	gstate.partitioned_hts.resize(gstate.intermediate_hts.size());
+	for (index_t ht_idx = 0; ht_idx < gstate.intermediate_hts.size(); ht_idx++) {
+		for (index_t partition = 0; partition < partition_count; partition++) {
+			gstate.partitioned_hts[ht_idx].push_back(
+			    make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind));
+		}
+		partition_tasks.push_back(make_unique<HashAggregatePartitionTask>(gstate, ht_idx, radix_bits));
+	}
+	scheduler.ExecuteTasks(move(partition_tasks), TaskPriority::NORMAL, &context.interrupted);
+	gstate.intermediate_hts.clear();
 
-		group_chunk.Verify();
-		payload_chunk.Verify();
-		assert(payload_chunk.column_count == 0 || group_chunk.size() == payload_chunk.size());
+	// now merge the partitions, every partition is merged independently
+	vector<unique_ptr<Task>> merge_tasks;
+	gstate.finalized_hts.resize(partition_count);
+	for (index_t partition = 0; partition < partition_count; partition++) {
+		merge_tasks.push_back(make_unique<HashAggregateMergeTask>(gstate, partition));
+	}
+	scheduler.ExecuteTasks(move(merge_tasks), TaskPriority::NORMAL, &context.interrupted);
+	gstate.partitioned_hts.clear();
+	gstate.finalized_input = move(gstate.partition_input);
+}
 
-		// move the strings inside the groups to the string heap
-		group_chunk.MoveStringsToHeap(state->ht->string_heap);
-		payload_chunk.MoveStringsToHeap(state->ht->string_heap);
+void PhysicalHashAggregate::AggregateSpilledInput(HashAggregateGlobalState &gstate, index_t ht_index) {
+	if (ht_index >= gstate.finalized_input.size()) {
+		return;
+	}
+	auto &ht = *gstate.finalized_hts[ht_index];
+	for (auto &input : gstate.finalized_input[ht_index]) {
+		unique_ptr<DataChunk> group_chunk, payload_chunk;
+		while (input->Scan(group_chunk)) {
+			if (aggregates.size() > 0) {
+				input->Scan(payload_chunk);
+			} else {
+				payload_chunk = make_unique<DataChunk>();
+			}
+			AddChunk(ht, *group_chunk, *payload_chunk);
+		}
+	}
+	gstate.finalized_input[ht_index].clear();
+}
 
-		state->ht->AddChunk(group_chunk, payload_chunk);
-		state->tuples_scanned += state->child_chunk.size();
-	} while (state->child_chunk.size() > 0);
+void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashAggregateOperatorState *>(state_);
+	// first aggregate the entire input
+	ExecutePipeline(context);
+	auto &gstate = (HashAggregateGlobalState &)*sink_state;
 
 	state->group_chunk.Reset();
 	state->aggregate_chunk.Reset();
-	index_t elements_found = state->ht->Scan(state->ht_scan_position, state->group_chunk, state->aggregate_chunk);
+	index_t elements_found = 0;
+	while (state->ht_index < gstate.finalized_hts.size()) {
+		if (state->ht_scan_position == 0) {
+			// the spilled input of the HT is aggregated right before the HT is scanned
+			AggregateSpilledInput(gstate, state->ht_index);
+		}
+		elements_found = gstate.finalized_hts[state->ht_index]->Scan(state->ht_scan_position, state->group_chunk,
+		                                                              state->aggregate_chunk);
+		if (elements_found > 0) {
+			break;
+		}
+		if (gstate.finalized_input.size() > 0 && state->ht_index > 0) {
+			// input was spilled: free the HTs as soon as they have been scanned, so only one partition is kept in
+			// memory at a time. The first HT holds the string heaps of the intermediate HTs, so it is kept.
+			gstate.finalized_hts[state->ht_index].reset();
+		}
+		// move to the next HT
+		state->ht_index++;
+		state->ht_scan_position = 0;
+	}
 
 	// special case hack to sort out aggregating from empty intermediates
 	// for aggregations without groups
-	if (elements_found == 0 && state->tuples_scanned == 0 && is_implicit_aggr) {
+	if (elements_found == 0 && gstate.tuples_scanned == 0 && is_implicit_aggr) {
 		assert(state->aggregate_chunk.column_count == aggregates.size());
 		// for each column in the aggregates, seit either to NULL or 0
 		for (index_t i = 0; i < state->aggregate_chunk.column_count; i++) {
@@ -134,11 +509,11 @@ void PhysicalHashAggregate::GetChunkInternal(ClientContext &context, DataChunk &
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
-	auto state =
-	    make_unique<PhysicalHashAggregateOperatorState>(this, children.size() == 0 ? nullptr : children[0].get());
-	state->tuples_scanned = 0;
-	vector<TypeId> group_types, payload_types;
-	vector<BoundAggregateExpression *> aggregate_kind;
+	return make_unique<PhysicalHashAggregateOperatorState>(this);
+}
+
+void PhysicalHashAggregate::GetPayloadTypes(vector<TypeId> &group_types, vector<TypeId> &payload_types,
+                                            vector<BoundAggregateExpression *> &aggregate_kind) {
 	for (auto &expr : groups) {
 		group_types.push_back(expr->return_type);
 	}
@@ -155,17 +530,49 @@ unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
 			payload_types.push_back(TypeId::BIGINT);
 		}
 	}
+}
+
+unique_ptr<GlobalOperatorState> PhysicalHashAggregate::GetGlobalState(ClientContext &context) {
+	vector<TypeId> group_types, payload_types;
+	vector<BoundAggregateExpression *> aggregate_kind;
+	GetPayloadTypes(group_types, payload_types, aggregate_kind);
+	bool can_combine = SuperLargeHashTable::CanCombine(aggregate_kind);
+	auto &buffer_manager = *context.db.storage->buffer_manager;
+	index_t memory_limit = INVALID_INDEX;
+	auto query_limit = context.query_memory.GetLimit();
+	if (query_limit != INVALID_INDEX && !is_implicit_aggr) {
+		// half of the memory limit of the query is available for the HTs, which is shared among the threads if every
+		// thread aggregates into its own HT
+		memory_limit = query_limit / 2;
+		if (can_combine) {
+			memory_limit /= context.db.scheduler->NumberOfThreads();
+		}
+	}
+	auto state = make_unique<HashAggregateGlobalState>(buffer_manager, context.query_memory, memory_limit);
+	if (!can_combine) {
+		// the aggregates cannot be computed in thread-local HTs, aggregate everything in one HT instead
+		state->ht = make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind);
+	}
+	return move(state);
+}
+
+unique_ptr<LocalSinkState> PhysicalHashAggregate::GetLocalSinkState(ClientContext &context) {
+	auto state = make_unique<HashAggregateLocalState>(context.query_memory);
+	vector<TypeId> group_types, payload_types;
+	vector<BoundAggregateExpression *> aggregate_kind;
+	GetPayloadTypes(group_types, payload_types, aggregate_kind);
+	state->group_chunk.Initialize(group_types);
 	if (payload_types.size() > 0) {
 		state->payload_chunk.Initialize(payload_types);
 	}
-
-	state->ht = make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind);
+	if (SuperLargeHashTable::CanCombine(aggregate_kind)) {
+		state->ht = make_unique<SuperLargeHashTable>(1024, group_types, payload_types, aggregate_kind);
+	}
 	return move(state);
 }
 
-PhysicalHashAggregateOperatorState::PhysicalHashAggregateOperatorState(PhysicalHashAggregate *parent,
-                                                                       PhysicalOperator *child)
-    : PhysicalOperatorState(child), ht_scan_position(0), tuples_scanned(0) {
+PhysicalHashAggregateOperatorState::PhysicalHashAggregateOperatorState(PhysicalHashAggregate *parent)
+    : PhysicalOperatorState(nullptr), ht_index(0), ht_scan_position(0) {
 	vector<TypeId> group_types, aggregate_types;
 	for (auto &expr : parent->groups) {
 		group_types.push_back(expr->return_type);
@@ -8,85 +8,119 @@
 using namespace duckdb;
 using namespace std;
 
-class PhysicalSimpleAggregateOperatorState : public PhysicalOperatorState {
+class SimpleAggregateGlobalState : public GlobalOperatorState {
 public:
-	PhysicalSimpleAggregateOperatorState(PhysicalSimpleAggregate *parent, PhysicalOperator *child);
+	SimpleAggregateGlobalState(vector<unique_ptr<Expression>> &aggregates) {
+		for (auto &aggregate : aggregates) {
+			assert(aggregate->GetExpressionClass() == ExpressionClass::BOUND_AGGREGATE);
+			auto &aggr = (BoundAggregateExpression &)*aggregate;
+			// initialize the aggregate values
+			assert(aggr.function.simple_initialize);
+			this->aggregates.push_back(aggr.function.simple_initialize());
+		}
+	}
 
+	//! Lock held while combining thread-local aggregates
+	std::mutex lock;
 	//! The aggregate values
 	vector<Value> aggregates;
+};
+
+class SimpleAggregateLocalState : public LocalSinkState {
+public:
+	SimpleAggregateLocalState(vector<unique_ptr<Expression>> &aggregates) {
+		vector<TypeId> payload_types;
+		for (auto &aggregate : aggregates) {
+			assert(aggregate->GetExpressionClass() == ExpressionClass::BOUND_AGGREGATE);
+			auto &aggr = (BoundAggregateExpression &)*aggregate;
+			// initialize the payload chunk
+			if (aggr.children.size()) {
+				for (index_t i = 0; i < aggr.children.size(); ++i) {
+					payload_types.push_back(aggr.children[i]->return_type);
+				}
+			} else {
+				// COUNT(*)
+				payload_types.push_back(TypeId::BIGINT);
+			}
+			// initialize the aggregate values
+			assert(aggr.function.simple_initialize);
+			this->aggregates.push_back(aggr.function.simple_initialize());
+		}
+		payload_chunk.Initialize(payload_types);
+	}
+
+	//! The aggregate values of this thread
+	vector<Value> aggregates;
 	//! The payload chunk
 	DataChunk payload_chunk;
 };
 
 PhysicalSimpleAggregate::PhysicalSimpleAggregate(vector<TypeId> types, vector<unique_ptr<Expression>> expressions)
-    : PhysicalOperator(PhysicalOperatorType::SIMPLE_AGGREGATE, types), aggregates(move(expressions)) {
+    : PhysicalSink(PhysicalOperatorType::SIMPLE_AGGREGATE, types), aggregates(move(expressions)) {
 }
 
-void PhysicalSimpleAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk,
-                                               PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalSimpleAggregateOperatorState *>(state_);
-	while (true) {
-		// iterate over the child
-		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-		if (state->child_chunk.size() == 0) {
-			break;
-		}
-		ExpressionExecutor executor(state->child_chunk);
-		// now resolve the aggregates for each of the children
-		index_t payload_idx = 0;
-		DataChunk &payload_chunk = state->payload_chunk;
-		payload_chunk.Reset();
-		for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
-			auto &aggregate = (BoundAggregateExpression &)*aggregates[aggr_idx];
-			index_t payload_cnt = 0;
-			// resolve the child expression of the aggregate (if any)
-			if (aggregate.children.size()) {
-				for (index_t i = 0; i < aggregate.children.size(); ++i) {
-					executor.ExecuteExpression(*aggregate.children[i], payload_chunk.data[payload_idx + payload_cnt]);
-					++payload_cnt;
-				}
-			} else {
-				payload_chunk.data[payload_idx + payload_cnt].count = state->child_chunk.size();
+void PhysicalSimpleAggregate::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+                                   DataChunk &input) {
+	auto &sink = (SimpleAggregateLocalState &)lstate;
+	ExpressionExecutor executor(input);
+	// now resolve the aggregates for each of the children
+	index_t payload_idx = 0;
+	DataChunk &payload_chunk = sink.payload_chunk;
+	payload_chunk.Reset();
+	for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
+		auto &aggregate = (BoundAggregateExpression &)*aggregates[aggr_idx];
+		index_t payload_cnt = 0;
+		// resolve the child expression of the aggregate (if any)
+		if (aggregate.children.size()) {
+			for (index_t i = 0; i < aggregate.children.size(); ++i) {
+				executor.ExecuteExpression(*aggregate.children[i], payload_chunk.data[payload_idx + payload_cnt]);
 				++payload_cnt;
 			}
-			// perform the actual aggregation
-			assert(aggregate.function.simple_update);
-			aggregate.function.simple_update(&payload_chunk.data[payload_idx], payload_cnt, state->aggregates[aggr_idx]);
-
-			payload_idx += payload_cnt;
+		} else {
+			payload_chunk.data[payload_idx + payload_cnt].count = input.size();
+			++payload_cnt;
 		}
+		// perform the actual aggregation
+		assert(aggregate.function.simple_update);
+		aggregate.function.simple_update(&payload_chunk.data[payload_idx], payload_cnt, sink.aggregates[aggr_idx]);
+
+		payload_idx += payload_cnt;
+	}
+}
+
+void PhysicalSimpleAggregate::Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	auto &gstate = (SimpleAggregateGlobalState &)state;
+	auto &source = (SimpleAggregateLocalState &)lstate;
+	// combine the aggregates of this thread into the global state
+	lock_guard<mutex> glock(gstate.lock);
+	for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
+		auto &aggregate = (BoundAggregateExpression &)*aggregates[aggr_idx];
+		assert(aggregate.function.simple_combine);
+		aggregate.function.simple_combine(source.aggregates[aggr_idx], gstate.aggregates[aggr_idx]);
 	}
+}
+
+void PhysicalSimpleAggregate::GetChunkInternal(ClientContext &context, DataChunk &chunk,
+                                               PhysicalOperatorState *state) {
+	// aggregate the entire input
+	ExecutePipeline(context);
+	auto &gstate = (SimpleAggregateGlobalState &)*sink_state;
 	// initialize the result chunk with the aggregate values
 	for (index_t aggr_idx = 0; aggr_idx < aggregates.size(); aggr_idx++) {
 		chunk.data[aggr_idx].count = 1;
-		chunk.data[aggr_idx].SetValue(0, state->aggregates[aggr_idx]);
+		chunk.data[aggr_idx].SetValue(0, gstate.aggregates[aggr_idx]);
 	}
 	state->finished = true;
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalSimpleAggregate::GetOperatorState() {
-	return make_unique<PhysicalSimpleAggregateOperatorState>(this, children[0].get());
+	return make_unique<PhysicalOperatorState>(nullptr);
 }
 
-PhysicalSimpleAggregateOperatorState::PhysicalSimpleAggregateOperatorState(PhysicalSimpleAggregate *parent,
-                                                                           PhysicalOperator *child)
-    : PhysicalOperatorState(child) {
-	vector<TypeId> payload_types;
-	for (auto &aggregate : parent->aggregates) {
-		assert(aggregate->GetExpressionClass() == ExpressionClass::BOUND_AGGREGATE);
-		auto &aggr = (BoundAggregateExpression &)*aggregate;
-		// initialize the payload chunk
-		if (aggr.children.size()) {
-			for (index_t i = 0; i < aggr.children.size(); ++i) {
-				payload_types.push_back(aggr.children[i]->return_type);
-			}
-		} else {
-			// COUNT(*)
-			payload_types.push_back(TypeId::BIGINT);
-		}
-		// initialize the aggregate values
-		assert(aggr.function.simple_initialize);
-		aggregates.push_back(aggr.function.simple_initialize());
-	}
-	payload_chunk.Initialize(payload_types);
+unique_ptr<GlobalOperatorState> PhysicalSimpleAggregate::GetGlobalState(ClientContext &context) {
+	return make_unique<SimpleAggregateGlobalState>(aggregates);
+}
+
+unique_ptr<LocalSinkState> PhysicalSimpleAggregate::GetLocalSinkState(ClientContext &context) {
+	return make_unique<SimpleAggregateLocalState>(aggregates);
 }
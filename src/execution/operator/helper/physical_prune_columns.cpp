@@ -5,16 +5,15 @@
 using namespace duckdb;
 using namespace std;
 
-void PhysicalPruneColumns::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalOperatorState *>(state_);
+void PhysicalPruneColumns::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
+	GetStreamingChunk(context, chunk, state);
+}
 
-	children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-	if (state->child_chunk.size() == 0) {
-		return;
-	}
+bool PhysicalPruneColumns::ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
 	assert(column_limit <= state->child_chunk.column_count);
 	for (index_t i = 0; i < column_limit; i++) {
 		chunk.data[i].Reference(state->child_chunk.data[i]);
 	}
 	chunk.sel_vector = state->child_chunk.sel_vector;
+	return false;
 }
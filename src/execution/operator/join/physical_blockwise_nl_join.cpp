@@ -9,23 +9,31 @@ using namespace std;
 
 class PhysicalBlockwiseNLJoinState : public PhysicalOperatorState {
 public:
-	PhysicalBlockwiseNLJoinState(PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(left), left_position(0), right_position(0), fill_in_rhs(false),
+	PhysicalBlockwiseNLJoinState(PhysicalOperator *left)
+	    : PhysicalOperatorState(left), initialized(false), left_position(0), right_position(0), fill_in_rhs(false),
 	      checked_found_match(false) {
-		assert(left && right);
+		assert(left);
 	}
 
+	bool initialized;
 	//! Whether or not a tuple on the LHS has found a match, only used for LEFT OUTER and FULL OUTER joins
 	unique_ptr<bool[]> lhs_found_match;
 	//! Whether or not a tuple on the RHS has found a match, only used for FULL OUTER joins
 	unique_ptr<bool[]> rhs_found_match;
-	ChunkCollection right_chunks;
 	index_t left_position;
 	index_t right_position;
 	bool fill_in_rhs;
 	bool checked_found_match;
 };
 
+class BlockwiseNLJoinGlobalState : public GlobalOperatorState {
+public:
+	//! Lock held while appending to the materialized right side
+	std::mutex lock;
+	//! Materialized data of the RHS
+	ChunkCollection right_chunks;
+};
+
 PhysicalBlockwiseNLJoin::PhysicalBlockwiseNLJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
                                                  unique_ptr<PhysicalOperator> right, unique_ptr<Expression> condition,
                                                  JoinType join_type)
@@ -38,43 +46,43 @@ PhysicalBlockwiseNLJoin::PhysicalBlockwiseNLJoin(LogicalOperator &op, unique_ptr
 	assert(join_type != JoinType::SINGLE);
 }
 
+unique_ptr<GlobalOperatorState> PhysicalBlockwiseNLJoin::GetGlobalState(ClientContext &context) {
+	return make_unique<BlockwiseNLJoinGlobalState>();
+}
+
+void PhysicalBlockwiseNLJoin::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+                                   DataChunk &input) {
+	auto &gstate = (BlockwiseNLJoinGlobalState &)state;
+	lock_guard<mutex> guard(gstate.lock);
+	gstate.right_chunks.Append(input);
+}
+
 void PhysicalBlockwiseNLJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk,
                                                PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalBlockwiseNLJoinState *>(state_);
 
 	// first we fully materialize the right child, if we haven't done that yet
-	if (state->right_chunks.column_count() == 0) {
-		auto right_state = children[1]->GetOperatorState();
-		auto left_types = children[0]->GetTypes();
-		auto right_types = children[1]->GetTypes();
-
-		DataChunk right_chunk;
-		right_chunk.Initialize(right_types);
-		while (true) {
-			children[1]->GetChunk(context, right_chunk, right_state.get());
-			if (right_chunk.size() == 0) {
-				break;
-			}
-			state->right_chunks.Append(right_chunk);
-		}
-
-		if (state->right_chunks.count == 0) {
-			if ((type == JoinType::INNER || type == JoinType::SEMI)) {
-				// empty RHS with INNER or SEMI join means empty result set
-				return;
-			}
-		}
+	if (!state->initialized) {
+		ExecutePipeline(context);
+		auto &gstate = (BlockwiseNLJoinGlobalState &)*sink_state;
 		// initialize the found_match vectors for the left and right sides
 		if (type == JoinType::LEFT || type == JoinType::OUTER) {
 			state->lhs_found_match = unique_ptr<bool[]>(new bool[STANDARD_VECTOR_SIZE]);
 		}
 		if (type == JoinType::OUTER) {
-			state->rhs_found_match = unique_ptr<bool[]>(new bool[state->right_chunks.count]);
-			memset(state->rhs_found_match.get(), 0, sizeof(bool) * state->right_chunks.count);
+			state->rhs_found_match = unique_ptr<bool[]>(new bool[gstate.right_chunks.count]);
+			memset(state->rhs_found_match.get(), 0, sizeof(bool) * gstate.right_chunks.count);
 		}
+		state->initialized = true;
+	}
+	auto &gstate = (BlockwiseNLJoinGlobalState &)*sink_state;
+
+	if (gstate.right_chunks.count == 0 && (type == JoinType::INNER || type == JoinType::SEMI)) {
+		// empty RHS with INNER or SEMI join means empty result set
+		return;
 	}
 
-	if (state->right_chunks.count == 0) {
+	if (gstate.right_chunks.count == 0) {
 		// empty join
 		assert(type == JoinType::LEFT || type == JoinType::OUTER || type == JoinType::ANTI);
 		// pull a chunk from the LHS
@@ -158,7 +166,7 @@ void PhysicalBlockwiseNLJoin::GetChunkInternal(ClientContext &context, DataChunk
 			}
 		}
 		auto &lchunk = state->child_chunk;
-		auto &rchunk = *state->right_chunks.chunks[state->right_position];
+		auto &rchunk = *gstate.right_chunks.chunks[state->right_position];
 		for (index_t i = 0; i < chunk.column_count; i++) {
 			assert(!chunk.data[i].sel_vector);
 			chunk.data[i].count = rchunk.size();
@@ -207,7 +215,7 @@ void PhysicalBlockwiseNLJoin::GetChunkInternal(ClientContext &context, DataChunk
 		if (state->left_position >= state->child_chunk.size()) {
 			// exhausted the current chunk, move to the next RHS chunk
 			state->right_position++;
-			if (state->right_position < state->right_chunks.chunks.size()) {
+			if (state->right_position < gstate.right_chunks.chunks.size()) {
 				// we still have chunks left! start over on the LHS
 				state->left_position = 0;
 			}
@@ -216,7 +224,7 @@ void PhysicalBlockwiseNLJoin::GetChunkInternal(ClientContext &context, DataChunk
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalBlockwiseNLJoin::GetOperatorState() {
-	return make_unique<PhysicalBlockwiseNLJoinState>(children[0].get(), children[1].get());
+	return make_unique<PhysicalBlockwiseNLJoinState>(children[0].get());
 }
 
 string PhysicalBlockwiseNLJoin::ExtraRenderInformation() const {
@@ -2,65 +2,467 @@
 
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/external_chunk_collection.hpp"
+#include "duckdb/function/aggregate/distributive_functions.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+#include <algorithm>
 
 using namespace duckdb;
 using namespace std;
 
+//! The amount of bits of the hash that are used to radix partition the join when the build side does not fit in memory
+#define HASH_JOIN_PARTITION_BITS 4
+#define HASH_JOIN_PARTITION_COUNT (1 << HASH_JOIN_PARTITION_BITS)
+
+namespace duckdb {
+
 class PhysicalHashJoinOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalHashJoinOperatorState(PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(left), initialized(false) {
-		assert(left && right);
+	PhysicalHashJoinOperatorState(PhysicalOperator *left)
+	    : PhysicalOperatorState(left), initialized(false), partition_idx(INVALID_INDEX) {
+		assert(left);
 	}
 
 	bool initialized;
 	DataChunk join_keys;
 	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+
+	//! The probe side of the spilled partitions as pairs of (join keys, left chunk). Only used if the build side was
+	//! spilled, in which case the rows of the spilled partitions are joined after the left side is exhausted.
+	vector<unique_ptr<ExternalChunkCollection>> probe_partitions;
+	//! The spilled partition that is currently being joined, or INVALID_INDEX while the left side is being read
+	index_t partition_idx;
+	//! The HT of the spilled partition that is currently being joined
+	unique_ptr<JoinHashTable> partition_table;
+	//! The chunks read from the current probe partition, referenced by join_keys and child_chunk
+	unique_ptr<DataChunk> partition_keys;
+	unique_ptr<DataChunk> partition_child;
+};
+
+//! A radix partition of the build side that is collected by a single thread, while the partition fits in memory it
+//! is kept in a pair of ChunkCollections, after that it is appended to an ExternalChunkCollection as (keys, payload)
+//! pairs
+struct HashJoinPartition {
+	HashJoinPartition() : memory_usage(0) {
+	}
+
+	//! The join keys of the in-memory data
+	ChunkCollection keys;
+	//! The build side data of the in-memory data
+	ChunkCollection payload;
+	//! The (estimated) amount of memory used by the in-memory data
+	index_t memory_usage;
+	//! The spilled data of the partition
+	vector<unique_ptr<ExternalChunkCollection>> spilled_data;
+};
+
+class HashJoinGlobalState : public GlobalOperatorState {
+public:
+	HashJoinGlobalState(BufferManager &buffer_manager, QueryMemory &query_memory, index_t memory_limit)
+	    : buffer_manager(buffer_manager), memory_limit(memory_limit), reservation(query_memory), spilled(false),
+	      has_null(false) {
+	}
+
+	//! The HT used by the join, if the build side was spilled this only holds the partitions that were kept in memory
+	unique_ptr<JoinHashTable> hash_table;
+	//! Lock held while merging thread-local data into the HT
+	std::mutex build_lock;
+
+	//! The buffer manager that holds the spilled partitions
+	BufferManager &buffer_manager;
+	//! The amount of memory (in bytes) a thread can use to collect the build side before it has to spill partitions
+	//! to the buffer manager, or INVALID_INDEX if the build side is never partitioned
+	index_t memory_limit;
+	//! The memory reserved for the in-memory partitions of all threads
+	MemoryReservation reservation;
+	//! The partitions collected by every thread, only used if the build side is partitioned
+	vector<vector<HashJoinPartition>> thread_partitions;
+	//! The spilled build side of every partition, partitions without spilled data are part of the in-memory HT
+	vector<vector<unique_ptr<ExternalChunkCollection>>> spilled_partitions;
+	//! Whether or not any partition of the build side was spilled
+	bool spilled;
+	//! Whether or not the keys of the build side contain NULL values, only used if the build side is partitioned
+	bool has_null;
+};
+
+class HashJoinLocalState : public LocalSinkState {
+public:
+	HashJoinLocalState(QueryMemory &query_memory) : memory_usage(0), reservation(query_memory), has_null(false) {
+	}
+
+	//! The join keys of the current chunk of the right side
+	DataChunk join_keys;
+	//! The thread-local HT that the right side is materialized in, merged into the global HT in Combine. Not used for
+	//! the correlated MARK join, which is always built by a single thread directly into the global HT.
+	unique_ptr<JoinHashTable> hash_table;
+
+	//! The partitions of the right side collected by this thread, used instead of the HT if the build side is
+	//! partitioned
+	vector<HashJoinPartition> partitions;
+	//! The (estimated) amount of memory used by the in-memory partitions
+	index_t memory_usage;
+	//! The memory reserved for the in-memory partitions
+	MemoryReservation reservation;
+	//! Whether or not the keys collected by this thread contain NULL values
+	bool has_null;
+};
+
+} // namespace duckdb
+
+//! The selection vectors that split a chunk into its radix partitions
+struct PartitionSelection {
+	sel_t sel_vector[HASH_JOIN_PARTITION_COUNT][STANDARD_VECTOR_SIZE];
+	index_t count[HASH_JOIN_PARTITION_COUNT];
+
+	void Initialize(JoinHashTable &hash_table, DataChunk &keys) {
+		assert(!keys.sel_vector);
+		index_t partitions[STANDARD_VECTOR_SIZE];
+		hash_table.ComputePartitions(keys, HASH_JOIN_PARTITION_BITS, partitions);
+		memset(count, 0, sizeof(count));
+		for (index_t i = 0; i < keys.size(); i++) {
+			auto partition = partitions[i];
+			sel_vector[partition][count[partition]++] = i;
+		}
+	}
+};
+
+//! Restricts a flat chunk to the rows in the given selection vector
+static void SliceChunk(DataChunk &chunk, sel_t *sel_vector, index_t count) {
+	chunk.sel_vector = sel_vector;
+	for (index_t i = 0; i < chunk.column_count; i++) {
+		chunk.data[i].sel_vector = sel_vector;
+		chunk.data[i].count = count;
+	}
+}
+
+//! Moves the in-memory data of a partition to a new ExternalChunkCollection, the rows that are collected for the
+//! partition afterwards are appended to that collection as well
+static void SpillPartition(BufferManager &buffer_manager, HashJoinPartition &partition) {
+	assert(partition.keys.chunks.size() == partition.payload.chunks.size());
+	auto data = make_unique<ExternalChunkCollection>(buffer_manager);
+	for (index_t i = 0; i < partition.keys.chunks.size(); i++) {
+		data->Append(*partition.keys.chunks[i]);
+		data->Append(*partition.payload.chunks[i]);
+	}
+	partition.keys = ChunkCollection();
+	partition.payload = ChunkCollection();
+	partition.memory_usage = 0;
+	partition.spilled_data.push_back(move(data));
+}
+
+//! Inserts a partition of the materialized build side into the hash map of the HT
+class HashJoinFinalizeTask : public Task {
+public:
+	HashJoinFinalizeTask(JoinHashTable &hash_table, index_t partition, index_t partition_count)
+	    : hash_table(hash_table), partition(partition), partition_count(partition_count) {
+	}
+
+	JoinHashTable &hash_table;
+	index_t partition;
+	index_t partition_count;
+
+public:
+	void Execute() override {
+		hash_table.InsertNodes(partition, partition_count);
+	}
 };
 
 PhysicalHashJoin::PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
                                    unique_ptr<PhysicalOperator> right, vector<JoinCondition> cond, JoinType join_type)
     : PhysicalComparisonJoin(op, PhysicalOperatorType::HASH_JOIN, move(cond), join_type) {
-	hash_table = make_unique<JoinHashTable>(conditions, right->GetTypes(), join_type);
-
 	children.push_back(move(left));
 	children.push_back(move(right));
 }
 
-void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalHashJoinOperatorState *>(state_);
-	if (!state->initialized) {
-		// build the HT
-		auto right_state = children[1]->GetOperatorState();
-		auto types = children[1]->GetTypes();
-
-		DataChunk right_chunk;
-		right_chunk.Initialize(types);
-
-		state->join_keys.Initialize(hash_table->condition_types);
-		while (true) {
-			// get the child chunk
-			children[1]->GetChunk(context, right_chunk, right_state.get());
-			if (right_chunk.size() == 0) {
-				break;
+unique_ptr<GlobalOperatorState> PhysicalHashJoin::GetGlobalState(ClientContext &context) {
+	// if the query has a memory limit the build side is radix partitioned, and every thread can use a share of (half)
+	// the limit before it spills partitions to the buffer manager. The threads also spill partitions when the memory
+	// for the in-memory partitions cannot be reserved. The correlated MARK join updates the group counts while
+	// building, so it is always built in memory.
+	auto &buffer_manager = *context.db.storage->buffer_manager;
+	index_t memory_limit = INVALID_INDEX;
+	auto query_limit = context.query_memory.GetLimit();
+	if (query_limit != INVALID_INDEX && delim_types.size() == 0) {
+		memory_limit = query_limit / 2 / context.db.scheduler->NumberOfThreads();
+	}
+	auto state = make_unique<HashJoinGlobalState>(buffer_manager, context.query_memory, memory_limit);
+	state->hash_table = make_unique<JoinHashTable>(conditions, children[1]->GetTypes(), type);
+	if (delim_types.size() > 0 && type == JoinType::MARK) {
+		// correlated MARK join
+		if (delim_types.size() + 1 == conditions.size()) {
+			// the correlated MARK join has one more condition than the amount of correlated columns
+			// this is the case in a correlated ANY() expression
+			// in this case we need to keep track of additional entries, namely:
+			// - (1) the total amount of elements per group
+			// - (2) the amount of non-null elements per group
+			// we need these to correctly deal with the cases of either:
+			// - (1) the group being empty [in which case the result is always false, even if the comparison is NULL]
+			// - (2) the group containing a NULL value [in which case FALSE becomes NULL]
+			auto &info = state->hash_table->correlated_mark_join_info;
+
+			vector<TypeId> payload_types = {TypeId::BIGINT, TypeId::BIGINT}; // COUNT types
+			vector<AggregateFunction> aggregate_functions = {CountStarFun::GetFunction(), CountFun::GetFunction()};
+			vector<BoundAggregateExpression *> correlated_aggregates;
+			for (index_t i = 0; i < aggregate_functions.size(); ++i) {
+				auto aggr = make_unique<BoundAggregateExpression>(payload_types[i], aggregate_functions[i], false);
+				correlated_aggregates.push_back(&*aggr);
+				info.correlated_aggregates.push_back(move(aggr));
 			}
-			// resolve the join keys for the right chunk
-			state->join_keys.Reset();
-			ExpressionExecutor executor(right_chunk);
-			for (index_t i = 0; i < conditions.size(); i++) {
-				executor.ExecuteExpression(*conditions[i].right, state->join_keys.data[i]);
+			info.correlated_counts =
+			    make_unique<SuperLargeHashTable>(1024, delim_types, payload_types, correlated_aggregates);
+			info.correlated_types = delim_types;
+			// FIXME: these can be initialized "empty" (without allocating empty vectors)
+			info.group_chunk.Initialize(delim_types);
+			info.payload_chunk.Initialize(payload_types);
+			info.result_chunk.Initialize(payload_types);
+		}
+	}
+	return move(state);
+}
+
+unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ClientContext &context) {
+	auto state = make_unique<HashJoinLocalState>(context.query_memory);
+	vector<TypeId> condition_types;
+	for (auto &cond : conditions) {
+		condition_types.push_back(cond.right->return_type);
+	}
+	state->join_keys.Initialize(condition_types);
+	auto &gstate = (HashJoinGlobalState &)*sink_state;
+	if (gstate.memory_limit != INVALID_INDEX) {
+		state->partitions.resize(HASH_JOIN_PARTITION_COUNT);
+	} else if (delim_types.size() == 0) {
+		state->hash_table = make_unique<JoinHashTable>(conditions, children[1]->GetTypes(), type);
+	}
+	return move(state);
+}
+
+void PhysicalHashJoin::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
+                            DataChunk &input) {
+	auto &gstate = (HashJoinGlobalState &)state;
+	auto &lstate = (HashJoinLocalState &)lstate_;
+	if (gstate.memory_limit != INVALID_INDEX) {
+		// the rows are split over the partitions with selection vectors, so we remove any existing selection vector
+		input.Flatten();
+	}
+	// resolve the join keys for the right chunk
+	lstate.join_keys.Reset();
+	ExpressionExecutor executor(input);
+	for (index_t i = 0; i < conditions.size(); i++) {
+		executor.ExecuteExpression(*conditions[i].right, lstate.join_keys.data[i]);
+	}
+	// materialize the chunk in the HT
+	if (gstate.memory_limit != INVALID_INDEX) {
+		SinkPartitioned(gstate, lstate, input);
+	} else if (lstate.hash_table) {
+		lstate.hash_table->Build(lstate.join_keys, input);
+	} else {
+		lock_guard<mutex> guard(gstate.build_lock);
+		gstate.hash_table->Build(lstate.join_keys, input);
+	}
+}
+
+void PhysicalHashJoin::SinkPartitioned(HashJoinGlobalState &gstate, HashJoinLocalState &lstate, DataChunk &input) {
+	auto &keys = lstate.join_keys;
+	lstate.has_null = lstate.has_null || gstate.hash_table->KeysContainNull(keys);
+
+	PartitionSelection selection;
+	selection.Initialize(*gstate.hash_table, keys);
+	for (index_t partition_idx = 0; partition_idx < HASH_JOIN_PARTITION_COUNT; partition_idx++) {
+		auto count = selection.count[partition_idx];
+		if (count == 0) {
+			continue;
+		}
+		auto &partition = lstate.partitions[partition_idx];
+		SliceChunk(keys, selection.sel_vector[partition_idx], count);
+		SliceChunk(input, selection.sel_vector[partition_idx], count);
+		if (partition.spilled_data.size() > 0) {
+			partition.spilled_data.back()->Append(keys);
+			partition.spilled_data.back()->Append(input);
+		} else {
+			auto memory_usage = ExternalChunkCollection::EstimateMemoryUsage(keys) +
+			                    ExternalChunkCollection::EstimateMemoryUsage(input);
+			partition.keys.Append(keys);
+			partition.payload.Append(input);
+			partition.memory_usage += memory_usage;
+			lstate.memory_usage += memory_usage;
+		}
+	}
+	// spill partitions until the in-memory data fits in the memory limit again and its memory can be reserved,
+	// starting with the last partition. Partition 0 is never spilled: it is the partition that is kept hot when
+	// everything else is spilled.
+	index_t partition_idx = HASH_JOIN_PARTITION_COUNT - 1;
+	while (lstate.memory_usage > gstate.memory_limit || !lstate.reservation.TryResize(lstate.memory_usage)) {
+		while (partition_idx > 0 && lstate.partitions[partition_idx].spilled_data.size() > 0) {
+			partition_idx--;
+		}
+		if (partition_idx == 0) {
+			// nothing left to spill: the query fails if the memory of the remaining partition cannot be reserved
+			lstate.reservation.Resize(lstate.memory_usage);
+			break;
+		}
+		auto &partition = lstate.partitions[partition_idx];
+		lstate.memory_usage -= partition.memory_usage;
+		SpillPartition(gstate.buffer_manager, partition);
+	}
+}
+
+void PhysicalHashJoin::Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate_) {
+	auto &gstate = (HashJoinGlobalState &)state;
+	auto &lstate = (HashJoinLocalState &)lstate_;
+	if (lstate.partitions.size() > 0) {
+		// the partitions are resolved in Finalize, when it is known which partitions have been spilled by any thread
+		lock_guard<mutex> guard(gstate.build_lock);
+		gstate.thread_partitions.push_back(move(lstate.partitions));
+		gstate.reservation.Merge(lstate.reservation);
+		gstate.has_null = gstate.has_null || lstate.has_null;
+	} else if (lstate.hash_table) {
+		lock_guard<mutex> guard(gstate.build_lock);
+		gstate.hash_table->Merge(*lstate.hash_table);
+	}
+}
+
+void PhysicalHashJoin::Finalize(ClientContext &context, GlobalOperatorState &state) {
+	auto &gstate = (HashJoinGlobalState &)state;
+	auto &hash_table = *gstate.hash_table;
+	auto &scheduler = *context.db.scheduler;
+	if (gstate.memory_limit != INVALID_INDEX) {
+		FinalizePartitions(gstate);
+	}
+	// build the hash map, splitting the insertion over the available threads
+	index_t partition_count = std::min(scheduler.NumberOfThreads(), hash_table.NodeCount());
+	if (partition_count <= 1) {
+		hash_table.Finalize();
+		return;
+	}
+	hash_table.InitializePointerTable();
+	vector<unique_ptr<Task>> tasks;
+	for (index_t i = 0; i < partition_count; i++) {
+		tasks.push_back(make_unique<HashJoinFinalizeTask>(hash_table, i, partition_count));
+	}
+	scheduler.ExecuteTasks(move(tasks), TaskPriority::NORMAL, &context.interrupted);
+}
+
+void PhysicalHashJoin::FinalizePartitions(HashJoinGlobalState &gstate) {
+	auto &hash_table = *gstate.hash_table;
+	gstate.spilled_partitions.resize(HASH_JOIN_PARTITION_COUNT);
+	for (index_t partition_idx = 0; partition_idx < HASH_JOIN_PARTITION_COUNT; partition_idx++) {
+		// if any thread spilled the partition, the partition is spilled entirely
+		bool spilled = false;
+		for (auto &partitions : gstate.thread_partitions) {
+			spilled = spilled || partitions[partition_idx].spilled_data.size() > 0;
+		}
+		for (auto &partitions : gstate.thread_partitions) {
+			auto &partition = partitions[partition_idx];
+			if (spilled) {
+				if (partition.spilled_data.size() == 0) {
+					auto memory_usage = partition.memory_usage;
+					SpillPartition(gstate.buffer_manager, partition);
+					gstate.reservation.Resize(gstate.reservation.GetSize() - memory_usage);
+				}
+				for (auto &data : partition.spilled_data) {
+					data->Finalize();
+					gstate.spilled_partitions[partition_idx].push_back(move(data));
+				}
+			} else {
+				// the partition is kept in memory: materialize it in the HT
+				for (index_t i = 0; i < partition.keys.chunks.size(); i++) {
+					hash_table.Build(*partition.keys.chunks[i], *partition.payload.chunks[i]);
+				}
+				partition.keys = ChunkCollection();
+				partition.payload = ChunkCollection();
 			}
-			// build the HT
-			hash_table->Build(state->join_keys, right_chunk);
 		}
+		gstate.spilled = gstate.spilled || spilled;
+	}
+	gstate.thread_partitions.clear();
+	hash_table.has_null = hash_table.has_null || gstate.has_null;
+}
 
-		if (hash_table->size() == 0 &&
-		    (hash_table->join_type == JoinType::INNER || hash_table->join_type == JoinType::SEMI)) {
-			// empty hash table with INNER or SEMI join means empty result set
-			return;
+unique_ptr<JoinHashTable> PhysicalHashJoin::BuildPartition(HashJoinGlobalState &gstate, index_t partition_idx) {
+	auto partition_table = make_unique<JoinHashTable>(conditions, children[1]->GetTypes(), type);
+	for (auto &data : gstate.spilled_partitions[partition_idx]) {
+		unique_ptr<DataChunk> keys, payload;
+		while (data->Scan(keys)) {
+			data->Scan(payload);
+			partition_table->Build(*keys, *payload);
+		}
+	}
+	gstate.spilled_partitions[partition_idx].clear();
+	partition_table->Finalize();
+	// the result of the MARK join depends on the NULL values in the entire build side
+	partition_table->has_null = partition_table->has_null || gstate.has_null;
+	return partition_table;
+}
+
+bool PhysicalHashJoin::CanProbeInParallel() {
+	// the spilled partitions are joined one at a time after the probe side has been read entirely
+	return !sink_state || !((HashJoinGlobalState &)*sink_state).spilled;
+}
+
+void PhysicalHashJoin::InitializeProbe(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	// build the HT
+	ExecutePipeline(context);
+	auto &gstate = (HashJoinGlobalState &)*sink_state;
+	state.join_keys.Initialize(gstate.hash_table->condition_types);
+	if (gstate.spilled) {
+		// the rows of the probe side that belong to a spilled partition are spilled as well
+		state.probe_partitions.resize(HASH_JOIN_PARTITION_COUNT);
+		for (index_t i = 0; i < HASH_JOIN_PARTITION_COUNT; i++) {
+			if (gstate.spilled_partitions[i].size() > 0) {
+				state.probe_partitions[i] = make_unique<ExternalChunkCollection>(gstate.buffer_manager);
+			}
 		}
+	}
+	state.initialized = true;
+}
 
-		state->initialized = true;
+bool PhysicalHashJoin::ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinOperatorState *>(state_);
+	if (!state->initialized) {
+		InitializeProbe(context, *state);
+	}
+	auto &gstate = (HashJoinGlobalState &)*sink_state;
+	// the spilled partitions can only be joined after the entire left side has been read, which requires GetChunk
+	assert(!gstate.spilled);
+	auto &hash_table = *gstate.hash_table;
+	if (state->scan_structure) {
+		// still have elements remaining from the previous probe (i.e. we got >1024 elements in the previous probe)
+		state->scan_structure->Next(state->join_keys, state->child_chunk, chunk);
+		if (chunk.size() > 0) {
+			return true;
+		}
+		state->scan_structure = nullptr;
+		return false;
+	}
+	if (hash_table.size() == 0 && (hash_table.join_type == JoinType::INNER || hash_table.join_type == JoinType::SEMI)) {
+		// empty hash table with INNER or SEMI join means empty result set: the left side is not needed
+		state->finished = true;
+		return false;
+	}
+	ResolveJoinKeys(*state);
+	ProbeHashTable(hash_table, *state, chunk);
+	if (chunk.size() == 0) {
+		state->scan_structure = nullptr;
+	}
+	return state->scan_structure != nullptr;
+}
+
+void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinOperatorState *>(state_);
+	if (!state->initialized) {
+		InitializeProbe(context, *state);
+	}
+	auto &gstate = (HashJoinGlobalState &)*sink_state;
+	auto hash_table = gstate.hash_table.get();
+	if (!gstate.spilled && hash_table->size() == 0 &&
+	    (hash_table->join_type == JoinType::INNER || hash_table->join_type == JoinType::SEMI)) {
+		// empty hash table with INNER or SEMI join means empty result set
+		return;
 	}
 	if (state->child_chunk.size() > 0 && state->scan_structure) {
 		// still have elements remaining from the previous probe (i.e. we got
@@ -74,61 +476,160 @@ void PhysicalHashJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk
 
 	// probe the HT
 	do {
-		// fetch the chunk from the left side
-		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-		if (state->child_chunk.size() == 0) {
+		// fetch the next chunk from the left side and the HT to probe it with
+		if (gstate.spilled) {
+			hash_table = FetchPartitionedChunk(context, gstate, *state);
+		} else {
+			hash_table = FetchChunk(context, *state) ? gstate.hash_table.get() : nullptr;
+		}
+		if (!hash_table) {
 			return;
 		}
-		// remove any selection vectors
-		state->child_chunk.Flatten();
-		if (hash_table->size() == 0) {
-			// empty hash table, special case
-			if (hash_table->join_type == JoinType::ANTI) {
-				// anti join with empty hash table, NOP join
-				// return the input
-				assert(chunk.column_count == state->child_chunk.column_count);
-				for (index_t i = 0; i < chunk.column_count; i++) {
-					chunk.data[i].Reference(state->child_chunk.data[i]);
-				}
-				return;
-			} else if (hash_table->join_type == JoinType::MARK) {
-				// MARK join with empty hash table
-				assert(hash_table->join_type == JoinType::MARK);
-				assert(chunk.column_count == state->child_chunk.column_count + 1);
-				auto &result_vector = chunk.data[state->child_chunk.column_count];
-				assert(result_vector.type == TypeId::BOOLEAN);
-				result_vector.count = state->child_chunk.size();
-				// for every data vector, we just reference the child chunk
-				for (index_t i = 0; i < state->child_chunk.column_count; i++) {
-					chunk.data[i].Reference(state->child_chunk.data[i]);
+		ProbeHashTable(*hash_table, *state, chunk);
+	} while (chunk.size() == 0);
+}
+
+bool PhysicalHashJoin::FetchChunk(ClientContext &context, PhysicalHashJoinOperatorState &state) {
+	// fetch the chunk from the left side
+	children[0]->GetChunk(context, state.child_chunk, state.child_state.get());
+	if (state.child_chunk.size() == 0) {
+		return false;
+	}
+	ResolveJoinKeys(state);
+	return true;
+}
+
+void PhysicalHashJoin::ResolveJoinKeys(PhysicalHashJoinOperatorState &state) {
+	// remove any selection vectors
+	state.child_chunk.Flatten();
+	// resolve the join keys for the left chunk
+	state.join_keys.Reset();
+	ExpressionExecutor executor(state.child_chunk);
+	for (index_t i = 0; i < conditions.size(); i++) {
+		executor.ExecuteExpression(*conditions[i].left, state.join_keys.data[i]);
+	}
+}
+
+JoinHashTable *PhysicalHashJoin::FetchPartitionedChunk(ClientContext &context, HashJoinGlobalState &gstate,
+                                                       PhysicalHashJoinOperatorState &state) {
+	state.scan_structure = nullptr;
+	if (state.partition_idx == INVALID_INDEX) {
+		// first read the left side: the rows of the in-memory partitions are probed right away, the rows of the
+		// spilled partitions are written to the probe partitions
+		PartitionSelection selection;
+		while (FetchChunk(context, state)) {
+			auto &keys = state.join_keys;
+			auto &left = state.child_chunk;
+			selection.Initialize(*gstate.hash_table, keys);
+			index_t in_memory_count = 0;
+			sel_t in_memory_sel[STANDARD_VECTOR_SIZE];
+			for (index_t partition_idx = 0; partition_idx < HASH_JOIN_PARTITION_COUNT; partition_idx++) {
+				auto count = selection.count[partition_idx];
+				auto sel_vector = selection.sel_vector[partition_idx];
+				if (count == 0) {
+					continue;
 				}
-				// for the MARK vector:
-				// if the HT has no NULL values (i.e. empty result set), return a vector that has false for every input
-				// entry if the HT has NULL values (i.e. result set had values, but all were NULL), return a vector that
-				// has NULL for every input entry
-				if (!hash_table->has_null) {
-					auto bool_result = (bool *)result_vector.data;
-					for (index_t i = 0; i < result_vector.count; i++) {
-						bool_result[i] = false;
+				if (!state.probe_partitions[partition_idx]) {
+					for (index_t i = 0; i < count; i++) {
+						in_memory_sel[in_memory_count++] = sel_vector[i];
 					}
-				} else {
-					result_vector.nullmask.set();
+					continue;
 				}
-				return;
+				SliceChunk(keys, sel_vector, count);
+				SliceChunk(left, sel_vector, count);
+				state.probe_partitions[partition_idx]->Append(keys);
+				state.probe_partitions[partition_idx]->Append(left);
+			}
+			if (in_memory_count > 0) {
+				std::sort(in_memory_sel, in_memory_sel + in_memory_count);
+				SliceChunk(keys, in_memory_sel, in_memory_count);
+				SliceChunk(left, in_memory_sel, in_memory_count);
+				keys.Flatten();
+				left.Flatten();
+				return gstate.hash_table.get();
 			}
 		}
-		// resolve the join keys for the left chunk
-		state->join_keys.Reset();
-		ExpressionExecutor executor(state->child_chunk);
-		for (index_t i = 0; i < conditions.size(); i++) {
-			executor.ExecuteExpression(*conditions[i].left, state->join_keys.data[i]);
+		for (auto &probe_partition : state.probe_partitions) {
+			if (probe_partition) {
+				probe_partition->Finalize();
+			}
 		}
-		// perform the actual probe
-		state->scan_structure = hash_table->Probe(state->join_keys);
-		state->scan_structure->Next(state->join_keys, state->child_chunk, chunk);
-	} while (chunk.size() == 0);
+		state.partition_idx = 0;
+	}
+	// now join the spilled partitions one at a time
+	for (; state.partition_idx < HASH_JOIN_PARTITION_COUNT; state.partition_idx++) {
+		auto &probe_partition = state.probe_partitions[state.partition_idx];
+		if (!probe_partition) {
+			continue;
+		}
+		if (!state.partition_table) {
+			state.partition_table = BuildPartition(gstate, state.partition_idx);
+		}
+		if (probe_partition->Scan(state.partition_keys)) {
+			probe_partition->Scan(state.partition_child);
+			state.join_keys.Reset();
+			state.child_chunk.Reset();
+			for (index_t i = 0; i < state.join_keys.column_count; i++) {
+				state.join_keys.data[i].Reference(state.partition_keys->data[i]);
+			}
+			for (index_t i = 0; i < state.child_chunk.column_count; i++) {
+				state.child_chunk.data[i].Reference(state.partition_child->data[i]);
+			}
+			return state.partition_table.get();
+		}
+		// the partition has been joined entirely
+		probe_partition.reset();
+		state.partition_table.reset();
+	}
+	return nullptr;
+}
+
+void PhysicalHashJoin::ProbeHashTable(JoinHashTable &hash_table, PhysicalHashJoinOperatorState &state,
+                                      DataChunk &chunk) {
+	if (hash_table.size() == 0) {
+		// empty hash table, special case
+		if (hash_table.join_type == JoinType::INNER || hash_table.join_type == JoinType::SEMI) {
+			// INNER or SEMI join with empty hash table, no result for this chunk
+			return;
+		} else if (hash_table.join_type == JoinType::ANTI) {
+			// anti join with empty hash table, NOP join
+			// return the input
+			assert(chunk.column_count == state.child_chunk.column_count);
+			for (index_t i = 0; i < chunk.column_count; i++) {
+				chunk.data[i].Reference(state.child_chunk.data[i]);
+			}
+			return;
+		} else if (hash_table.join_type == JoinType::MARK) {
+			// MARK join with empty hash table
+			assert(hash_table.join_type == JoinType::MARK);
+			assert(chunk.column_count == state.child_chunk.column_count + 1);
+			auto &result_vector = chunk.data[state.child_chunk.column_count];
+			assert(result_vector.type == TypeId::BOOLEAN);
+			result_vector.count = state.child_chunk.size();
+			// for every data vector, we just reference the child chunk
+			for (index_t i = 0; i < state.child_chunk.column_count; i++) {
+				chunk.data[i].Reference(state.child_chunk.data[i]);
+			}
+			// for the MARK vector:
+			// if the HT has no NULL values (i.e. empty result set), return a vector that has false for every input
+			// entry if the HT has NULL values (i.e. result set had values, but all were NULL), return a vector that
+			// has NULL for every input entry
+			if (!hash_table.has_null) {
+				auto bool_result = (bool *)result_vector.data;
+				for (index_t i = 0; i < result_vector.count; i++) {
+					bool_result[i] = false;
+				}
+			} else {
+				result_vector.nullmask.set();
+			}
+			return;
+		}
+	}
+	// perform the actual probe
+	state.scan_structure = hash_table.Probe(state.join_keys);
+	state.scan_structure->Next(state.join_keys, state.child_chunk, chunk);
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalHashJoin::GetOperatorState() {
-	return make_unique<PhysicalHashJoinOperatorState>(children[0].get(), children[1].get());
+	return make_unique<PhysicalHashJoinOperatorState>(children[0].get());
 }
@@ -4,5 +4,5 @@ using namespace duckdb;
 using namespace std;
 
 PhysicalJoin::PhysicalJoin(LogicalOperator &op, PhysicalOperatorType type, JoinType join_type)
-    : PhysicalOperator(type, op.types), type(join_type) {
+    : PhysicalSink(type, op.types), type(join_type) {
 }
@@ -13,20 +13,42 @@ namespace duckdb {
 
 class PhysicalNestedLoopJoinOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalNestedLoopJoinOperatorState(PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(left), right_chunk(0), has_null(false), left_tuple(0), right_tuple(0) {
-		assert(left && right);
+	PhysicalNestedLoopJoinOperatorState(PhysicalOperator *left)
+	    : PhysicalOperatorState(left), initialized(false), right_chunk(0), left_tuple(0), right_tuple(0) {
+		assert(left);
 	}
 
+	bool initialized;
 	index_t right_chunk;
 	DataChunk left_join_condition;
+
+	index_t left_tuple;
+	index_t right_tuple;
+};
+
+class NestedLoopJoinGlobalState : public GlobalOperatorState {
+public:
+	NestedLoopJoinGlobalState() : has_null(false) {
+	}
+
+	//! Lock held while appending to the materialized right side
+	std::mutex lock;
+	//! Materialized data of the RHS
 	ChunkCollection right_data;
+	//! Materialized join condition of the RHS
 	ChunkCollection right_chunks;
 	//! Whether or not the RHS of the nested loop join has NULL values
 	bool has_null;
+};
 
-	index_t left_tuple;
-	index_t right_tuple;
+class NestedLoopJoinLocalState : public LocalSinkState {
+public:
+	NestedLoopJoinLocalState(vector<TypeId> condition_types) {
+		right_condition.Initialize(condition_types);
+	}
+
+	//! The join condition of the current chunk of the RHS
+	DataChunk right_condition;
 };
 
 PhysicalNestedLoopJoin::PhysicalNestedLoopJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
@@ -101,54 +123,69 @@ static void ConstructSemiOrAntiJoinResult(DataChunk &left, DataChunk &result, bo
 	}
 }
 
-void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalNestedLoopJoinOperatorState *>(state_);
+static vector<TypeId> GetConditionTypes(vector<JoinCondition> &conditions) {
+	vector<TypeId> condition_types;
+	for (auto &cond : conditions) {
+		assert(cond.left->return_type == cond.right->return_type);
+		condition_types.push_back(cond.left->return_type);
+	}
+	return condition_types;
+}
 
-	// first we fully materialize the right child, if we haven't done that yet
-	if (state->right_chunks.column_count() == 0) {
-		vector<TypeId> condition_types;
-		for (auto &cond : conditions) {
-			assert(cond.left->return_type == cond.right->return_type);
-			condition_types.push_back(cond.left->return_type);
-		}
+unique_ptr<GlobalOperatorState> PhysicalNestedLoopJoin::GetGlobalState(ClientContext &context) {
+	return make_unique<NestedLoopJoinGlobalState>();
+}
 
-		auto right_state = children[1]->GetOperatorState();
-		auto types = children[1]->GetTypes();
+unique_ptr<LocalSinkState> PhysicalNestedLoopJoin::GetLocalSinkState(ClientContext &context) {
+	return make_unique<NestedLoopJoinLocalState>(GetConditionTypes(conditions));
+}
 
-		DataChunk new_chunk, right_condition;
-		new_chunk.Initialize(types);
-		right_condition.Initialize(condition_types);
-		do {
-			children[1]->GetChunk(context, new_chunk, right_state.get());
-			if (new_chunk.size() == 0) {
-				break;
-			}
-			// resolve the join expression of the right side
-			ExpressionExecutor executor(new_chunk);
-			executor.Execute(right_expressions, right_condition);
+void PhysicalNestedLoopJoin::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
+                                  DataChunk &input) {
+	auto &gstate = (NestedLoopJoinGlobalState &)state;
+	auto &lstate = (NestedLoopJoinLocalState &)lstate_;
+	// resolve the join expression of the right side
+	lstate.right_condition.Reset();
+	ExpressionExecutor executor(input);
+	executor.Execute(right_expressions, lstate.right_condition);
 
-			state->right_data.Append(new_chunk);
-			state->right_chunks.Append(right_condition);
-		} while (new_chunk.size() > 0);
+	lock_guard<mutex> guard(gstate.lock);
+	gstate.right_data.Append(input);
+	gstate.right_chunks.Append(lstate.right_condition);
+}
 
-		if (state->right_chunks.count == 0) {
-			if ((type == JoinType::INNER || type == JoinType::SEMI)) {
-				// empty RHS with INNER or SEMI join means empty result set
-				return;
-			}
-		} else {
-			// disqualify tuples from the RHS that have NULL values
-			for (index_t i = 0; i < state->right_chunks.chunks.size(); i++) {
-				state->has_null = state->has_null || RemoveNullValues(*state->right_chunks.chunks[i]);
-			}
+void PhysicalNestedLoopJoin::Finalize(ClientContext &context, GlobalOperatorState &state) {
+	auto &gstate = (NestedLoopJoinGlobalState &)state;
+	// disqualify tuples from the RHS that have NULL values
+	for (index_t i = 0; i < gstate.right_chunks.chunks.size(); i++) {
+		gstate.has_null = gstate.has_null || RemoveNullValues(*gstate.right_chunks.chunks[i]);
+	}
+}
+
+void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalNestedLoopJoinOperatorState *>(state_);
+
+	// first we fully materialize the right child, if we haven't done that yet
+	if (!state->initialized) {
+		ExecutePipeline(context);
+		auto &gstate = (NestedLoopJoinGlobalState &)*sink_state;
+		if (gstate.right_chunks.count > 0) {
 			// initialize the chunks for the join conditions
+			auto condition_types = GetConditionTypes(conditions);
 			state->left_join_condition.Initialize(condition_types);
-			state->right_chunk = state->right_chunks.chunks.size() - 1;
-			state->right_tuple = state->right_chunks.chunks[state->right_chunk]->size();
+			state->right_chunk = gstate.right_chunks.chunks.size() - 1;
+			state->right_tuple = gstate.right_chunks.chunks[state->right_chunk]->size();
 		}
+		state->initialized = true;
+	}
+	auto &gstate = (NestedLoopJoinGlobalState &)*sink_state;
+
+	if (gstate.right_chunks.count == 0 && (type == JoinType::INNER || type == JoinType::SEMI)) {
+		// empty RHS with INNER or SEMI join means empty result set
+		return;
 	}
 
-	if (state->right_chunks.count == 0) {
+	if (gstate.right_chunks.count == 0) {
 		// empty join, switch on type
 		if (type == JoinType::MARK) {
 			// pull a chunk from the LHS
@@ -159,25 +196,25 @@ void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk
 			// RHS empty: just set found_match to false
 			bool found_match[STANDARD_VECTOR_SIZE] = {false};
 			ConstructMarkJoinResult(state->left_join_condition, state->child_chunk, chunk, found_match,
-			                        state->has_null);
+			                        gstate.has_null);
 		} else {
 			throw Exception("Unhandled type for empty NL join");
 		}
 		return;
 	}
 
-	if (state->right_chunk >= state->right_chunks.chunks.size()) {
+	if (state->right_chunk >= gstate.right_chunks.chunks.size()) {
 		return;
 	}
 	// now that we have fully materialized the right child
 	// we have to perform the nested loop join
 	do {
 		// first check if we have to move to the next child on the right isde
-		assert(state->right_chunk < state->right_chunks.chunks.size());
-		if (state->right_tuple >= state->right_chunks.chunks[state->right_chunk]->size()) {
+		assert(state->right_chunk < gstate.right_chunks.chunks.size());
+		if (state->right_tuple >= gstate.right_chunks.chunks[state->right_chunk]->size()) {
 			// we exhausted the chunk on the right
 			state->right_chunk++;
-			if (state->right_chunk >= state->right_chunks.chunks.size()) {
+			if (state->right_chunk >= gstate.right_chunks.chunks.size()) {
 				// we exhausted all right chunks!
 				// move to the next left chunk
 				do {
@@ -212,11 +249,11 @@ void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk
 		case JoinType::MARK: {
 			// MARK, SEMI and ANTI joins are handled separately because they scan the whole RHS in one go
 			bool found_match[STANDARD_VECTOR_SIZE] = {false};
-			NestedLoopJoinMark::Perform(state->left_join_condition, state->right_chunks, found_match, conditions);
+			NestedLoopJoinMark::Perform(state->left_join_condition, gstate.right_chunks, found_match, conditions);
 			if (type == JoinType::MARK) {
 				// now construct the mark join result from the found matches
 				ConstructMarkJoinResult(state->left_join_condition, state->child_chunk, chunk, found_match,
-				                        state->has_null);
+				                        gstate.has_null);
 			} else if (type == JoinType::SEMI) {
 				// construct the semi join result from the found matches
 				ConstructSemiOrAntiJoinResult<true>(state->child_chunk, chunk, found_match);
@@ -224,7 +261,7 @@ void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk
 				ConstructSemiOrAntiJoinResult<false>(state->child_chunk, chunk, found_match);
 			}
 			// move to the next LHS chunk in the next iteration
-			state->right_chunk = state->right_chunks.chunks.size();
+			state->right_chunk = gstate.right_chunks.chunks.size();
 			return;
 		}
 		default:
@@ -232,8 +269,8 @@ void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk
 		}
 
 		auto &left_chunk = state->child_chunk;
-		auto &right_chunk = *state->right_chunks.chunks[state->right_chunk];
-		auto &right_data = *state->right_data.chunks[state->right_chunk];
+		auto &right_chunk = *gstate.right_chunks.chunks[state->right_chunk];
+		auto &right_data = *gstate.right_data.chunks[state->right_chunk];
 
 		// sanity check
 		left_chunk.Verify();
@@ -279,7 +316,7 @@ void PhysicalNestedLoopJoin::GetChunkInternal(ClientContext &context, DataChunk
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalNestedLoopJoin::GetOperatorState() {
-	return make_unique<PhysicalNestedLoopJoinOperatorState>(children[0].get(), children[1].get());
+	return make_unique<PhysicalNestedLoopJoinOperatorState>(children[0].get());
 }
 
 } // namespace duckdb
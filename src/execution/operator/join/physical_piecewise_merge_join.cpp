@@ -9,10 +9,9 @@ using namespace std;
 
 class PhysicalPiecewiseMergeJoinOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalPiecewiseMergeJoinOperatorState(PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(left), initialized(false), left_position(0), right_position(0), right_chunk_index(0),
-	      has_null(false) {
-		assert(left && right);
+	PhysicalPiecewiseMergeJoinOperatorState(PhysicalOperator *left)
+	    : PhysicalOperatorState(left), initialized(false), left_position(0), right_position(0), right_chunk_index(0) {
+		assert(left);
 	}
 
 	bool initialized;
@@ -22,6 +21,15 @@ public:
 	DataChunk left_chunk;
 	DataChunk join_keys;
 	MergeOrder left_orders;
+};
+
+class MergeJoinGlobalState : public GlobalOperatorState {
+public:
+	MergeJoinGlobalState() : has_null(false) {
+	}
+
+	//! Lock held while appending to the materialized right side
+	std::mutex lock;
 	ChunkCollection right_chunks;
 	ChunkCollection right_conditions;
 	vector<MergeOrder> right_orders;
@@ -54,58 +62,69 @@ static void OrderVector(Vector &vector, MergeOrder &order) {
 	VectorOperations::Sort(vector, result_vector, order.count, order.order);
 }
 
+unique_ptr<GlobalOperatorState> PhysicalPiecewiseMergeJoin::GetGlobalState(ClientContext &context) {
+	return make_unique<MergeJoinGlobalState>();
+}
+
+void PhysicalPiecewiseMergeJoin::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+                                      DataChunk &input) {
+	auto &gstate = (MergeJoinGlobalState &)state;
+	// first fetch the entire right side
+	lock_guard<mutex> guard(gstate.lock);
+	gstate.right_chunks.Append(input);
+}
+
+void PhysicalPiecewiseMergeJoin::Finalize(ClientContext &context, GlobalOperatorState &state) {
+	auto &gstate = (MergeJoinGlobalState &)state;
+	if (gstate.right_chunks.count == 0) {
+		return;
+	}
+	// now order all the chunks
+	DataChunk join_keys;
+	join_keys.Initialize(join_key_types);
+	gstate.right_orders.resize(gstate.right_chunks.chunks.size());
+	for (index_t i = 0; i < gstate.right_chunks.chunks.size(); i++) {
+		auto &chunk_to_order = *gstate.right_chunks.chunks[i];
+		// create a new selection vector
+		// resolve the join keys for the right chunk
+		join_keys.Reset();
+		ExpressionExecutor executor(chunk_to_order);
+		for (index_t k = 0; k < conditions.size(); k++) {
+			// resolve the join key
+			executor.ExecuteExpression(*conditions[k].right, join_keys.data[k]);
+			OrderVector(join_keys.data[k], gstate.right_orders[i]);
+			if (gstate.right_orders[i].count < join_keys.data[k].count) {
+				// the amount of entries in the order vector is smaller than the amount of entries in the vector
+				// this only happens if there are NULL values in the right-hand side
+				// hence we set the has_null to true (this is required for the MARK join)
+				gstate.has_null = true;
+			}
+		}
+		gstate.right_conditions.Append(join_keys);
+	}
+}
+
 void PhysicalPiecewiseMergeJoin::GetChunkInternal(ClientContext &context, DataChunk &chunk,
                                                   PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalPiecewiseMergeJoinOperatorState *>(state_);
 	assert(conditions.size() == 1);
 	if (!state->initialized) {
 		// create the sorted pieces
-		auto right_state = children[1]->GetOperatorState();
-		auto types = children[1]->GetTypes();
-
-		DataChunk right_chunk;
-		right_chunk.Initialize(types);
+		ExecutePipeline(context);
+		auto &gstate = (MergeJoinGlobalState &)*sink_state;
 		state->join_keys.Initialize(join_key_types);
-		// first fetch the entire right side
-		while (true) {
-			children[1]->GetChunk(context, right_chunk, right_state.get());
-			if (right_chunk.size() == 0) {
-				break;
-			}
-			state->right_chunks.Append(right_chunk);
-		}
-		if (state->right_chunks.count == 0 && (type == JoinType::INNER || type == JoinType::SEMI)) {
-			// empty RHS with INNER or SEMI join means empty result set
-			return;
-		}
-		// now order all the chunks
-		state->right_orders.resize(state->right_chunks.chunks.size());
-		for (index_t i = 0; i < state->right_chunks.chunks.size(); i++) {
-			auto &chunk_to_order = *state->right_chunks.chunks[i];
-			// create a new selection vector
-			// resolve the join keys for the right chunk
-			state->join_keys.Reset();
-			ExpressionExecutor executor(chunk_to_order);
-			for (index_t k = 0; k < conditions.size(); k++) {
-				// resolve the join key
-				executor.ExecuteExpression(*conditions[k].right, state->join_keys.data[k]);
-				OrderVector(state->join_keys.data[k], state->right_orders[i]);
-				if (state->right_orders[i].count < state->join_keys.data[k].count) {
-					// the amount of entries in the order vector is smaller than the amount of entries in the vector
-					// this only happens if there are NULL values in the right-hand side
-					// hence we set the has_null to true (this is required for the MARK join)
-					state->has_null = true;
-				}
-			}
-			state->right_conditions.Append(state->join_keys);
-		}
-		state->right_chunk_index = state->right_orders.size();
+		state->right_chunk_index = gstate.right_orders.size();
 		state->initialized = true;
 	}
+	auto &gstate = (MergeJoinGlobalState &)*sink_state;
+	if (gstate.right_chunks.count == 0 && (type == JoinType::INNER || type == JoinType::SEMI)) {
+		// empty RHS with INNER or SEMI join means empty result set
+		return;
+	}
 
 	do {
 		// check if we have to fetch a child from the left side
-		if (state->right_chunk_index == state->right_orders.size()) {
+		if (state->right_chunk_index == gstate.right_orders.size()) {
 			// fetch the chunk from the left side
 			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
 			if (state->child_chunk.size() == 0) {
@@ -135,23 +154,23 @@ void PhysicalPiecewiseMergeJoin::GetChunkInternal(ClientContext &context, DataCh
 		switch (type) {
 		case JoinType::MARK: {
 			// MARK join
-			if (state->right_chunks.count > 0) {
-				ChunkMergeInfo right_info(state->right_conditions, state->right_orders);
+			if (gstate.right_chunks.count > 0) {
+				ChunkMergeInfo right_info(gstate.right_conditions, gstate.right_orders);
 				// first perform the MARK join
 				// this method uses the LHS to loop over the entire RHS looking for matches
 				MergeJoinMark::Perform(left_info, right_info, conditions[0].comparison);
 				// now construct the mark join result from the found matches
 				ConstructMarkJoinResult(state->join_keys, state->child_chunk, chunk, right_info.found_match,
-				                        state->has_null);
+				                        gstate.has_null);
 				// move to the next LHS chunk in the next iteration
 			} else {
 				// RHS empty: just set found_match to false
 				bool found_match[STANDARD_VECTOR_SIZE] = {false};
-				ConstructMarkJoinResult(state->join_keys, state->child_chunk, chunk, found_match, state->has_null);
+				ConstructMarkJoinResult(state->join_keys, state->child_chunk, chunk, found_match, gstate.has_null);
 				// RHS empty: result is not NULL but just false
 				chunk.data[chunk.column_count - 1].nullmask.reset();
 			}
-			state->right_chunk_index = state->right_orders.size();
+			state->right_chunk_index = gstate.right_orders.size();
 			return;
 		}
 		default:
@@ -160,9 +179,9 @@ void PhysicalPiecewiseMergeJoin::GetChunkInternal(ClientContext &context, DataCh
 		}
 
 		// perform the actual merge join
-		auto &right_chunk = *state->right_chunks.chunks[state->right_chunk_index];
-		auto &right_condition_chunk = *state->right_conditions.chunks[state->right_chunk_index];
-		auto &right_orders = state->right_orders[state->right_chunk_index];
+		auto &right_chunk = *gstate.right_chunks.chunks[state->right_chunk_index];
+		auto &right_condition_chunk = *gstate.right_conditions.chunks[state->right_chunk_index];
+		auto &right_orders = gstate.right_orders[state->right_chunk_index];
 
 		ScalarMergeInfo right(right_condition_chunk.data[0], right_orders.count, right_orders.order,
 		                      state->right_position);
@@ -201,5 +220,5 @@ void PhysicalPiecewiseMergeJoin::GetChunkInternal(ClientContext &context, DataCh
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalPiecewiseMergeJoin::GetOperatorState() {
-	return make_unique<PhysicalPiecewiseMergeJoinOperatorState>(children[0].get(), children[1].get());
+	return make_unique<PhysicalPiecewiseMergeJoinOperatorState>(children[0].get());
 }
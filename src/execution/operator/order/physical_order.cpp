@@ -1,71 +1,259 @@
 #include "duckdb/execution/operator/order/physical_order.hpp"
 
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/types/sorted_run.hpp"
 #include "duckdb/common/value_operations/value_operations.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/external_sort.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/storage_manager.hpp"
 
 using namespace duckdb;
 using namespace std;
 
 class PhysicalOrderOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalOrderOperatorState(PhysicalOperator *child) : PhysicalOperatorState(child), position(0) {
+	PhysicalOrderOperatorState() : PhysicalOperatorState(nullptr), position(0) {
 	}
 
 	index_t position;
+};
+
+class OrderByGlobalOperatorState : public GlobalOperatorState {
+public:
+	OrderByGlobalOperatorState(BufferManager &buffer_manager, QueryMemory &query_memory, SortKeyLayout layout,
+	                           index_t memory_limit)
+	    : buffer_manager(buffer_manager), layout(move(layout)), memory_limit(memory_limit), reservation(query_memory) {
+	}
+
+	//! Lock held while merging thread-local data into the global collection
+	std::mutex lock;
+	//! The buffer manager that holds the external runs
+	BufferManager &buffer_manager;
+	//! The layout of the sort keys
+	SortKeyLayout layout;
+	//! The amount of memory (in bytes) a thread can use to collect data before it has to write it to an external
+	//! run, or INVALID_INDEX if the data is never written to external runs
+	index_t memory_limit;
+	//! The memory reserved for the collected input data
+	MemoryReservation reservation;
+	//! The collected input data
 	ChunkCollection sorted_data;
+	//! The evaluated ORDER BY expressions of every thread, referenced by the sorted runs
+	vector<unique_ptr<ChunkCollection>> sort_collections;
+	//! The sorted runs of every thread
+	vector<unique_ptr<SortedRun>> sorted_runs;
+	//! The offset of the rows of every sorted run within the collected input data
+	vector<index_t> run_offsets;
+	//! The sorted order of the collected data
 	unique_ptr<index_t[]> sorted_vector;
+	//! The runs that have been written to the buffer manager
+	vector<unique_ptr<ExternalSortedRun>> external_runs;
+	//! Merges the external runs while the result is scanned (if there are any external runs)
+	unique_ptr<ExternalRunMerger> merger;
 };
 
-void PhysicalOrder::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
-	auto state = reinterpret_cast<PhysicalOrderOperatorState *>(state_);
-	ChunkCollection &big_data = state->sorted_data;
-	if (state->position == 0) {
-		// first concatenate all the data of the child chunks
-		do {
-			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-			big_data.Append(state->child_chunk);
-		} while (state->child_chunk.size() != 0);
-
-		// now perform the actual ordering of the data
-		// compute the sorting columns from the input data
-		vector<TypeId> sort_types;
-		vector<Expression *> order_expressions;
-		vector<OrderType> order_types;
-		for (index_t i = 0; i < orders.size(); i++) {
-			auto &expr = orders[i].expression;
-			sort_types.push_back(expr->return_type);
-			order_expressions.push_back(expr.get());
-			order_types.push_back(orders[i].type);
+class OrderByLocalOperatorState : public LocalSinkState {
+public:
+	OrderByLocalOperatorState(QueryMemory &query_memory) : memory_usage(0), reservation(query_memory) {
+	}
+
+	//! The data collected by this thread
+	ChunkCollection local_data;
+	//! The evaluated ORDER BY expressions of the data collected by this thread
+	unique_ptr<ChunkCollection> sort_collection;
+	//! The (estimated) amount of memory used by the collected data
+	index_t memory_usage;
+	//! The memory reserved for the collected data
+	MemoryReservation reservation;
+	//! The runs that this thread has written to the buffer manager
+	vector<unique_ptr<ExternalSortedRun>> external_runs;
+};
+
+//! Sorts the data that has been collected in the local state and writes it to a new external run
+static void WriteExternalRun(OrderByGlobalOperatorState &gstate, OrderByLocalOperatorState &local) {
+	SortedRun run(gstate.layout, *local.sort_collection);
+	auto order = unique_ptr<index_t[]>(new index_t[run.count]);
+	run.GetOrder(order.get());
+
+	auto external_run = make_unique<ExternalSortedRun>(gstate.buffer_manager);
+	external_run->Append(local.local_data, order.get(), *local.sort_collection, order.get(), run.count);
+	external_run->Finalize();
+	local.external_runs.push_back(move(external_run));
+
+	local.local_data = ChunkCollection();
+	local.sort_collection = make_unique<ChunkCollection>();
+	local.memory_usage = 0;
+	local.reservation.Resize(0);
+}
+
+void PhysicalOrder::Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+                         DataChunk &input) {
+	auto &local = (OrderByLocalOperatorState &)lstate;
+	// compute the sorting columns from the input data
+	vector<TypeId> sort_types;
+	vector<Expression *> order_expressions;
+	for (index_t i = 0; i < orders.size(); i++) {
+		auto &expr = orders[i].expression;
+		sort_types.push_back(expr->return_type);
+		order_expressions.push_back(expr.get());
+	}
+	DataChunk sort_chunk;
+	sort_chunk.Initialize(sort_types);
+
+	ExpressionExecutor executor(input);
+	executor.Execute(order_expressions, sort_chunk);
+
+	local.sort_collection->Append(sort_chunk);
+	local.local_data.Append(input);
+	assert(local.sort_collection->count == local.local_data.count);
+
+	auto &gstate = (OrderByGlobalOperatorState &)state;
+	if (gstate.memory_limit != INVALID_INDEX) {
+		local.memory_usage +=
+		    ExternalChunkCollection::EstimateMemoryUsage(input) + ExternalChunkCollection::EstimateMemoryUsage(sort_chunk);
+		if (local.memory_usage > gstate.memory_limit || !local.reservation.TryResize(local.memory_usage)) {
+			// the collected data exceeds the memory limit or its memory cannot be reserved: sort it and hand it to the
+			// buffer manager
+			WriteExternalRun(gstate, local);
+		}
+	}
+}
+
+void PhysicalOrder::Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	auto &gstate = (OrderByGlobalOperatorState &)state;
+	auto &local = (OrderByLocalOperatorState &)lstate;
+	if (local.external_runs.size() > 0) {
+		// this thread has written external runs already, write the remaining data to an external run as well
+		if (local.local_data.count > 0) {
+			WriteExternalRun(gstate, local);
+		}
+		lock_guard<mutex> glock(gstate.lock);
+		for (auto &run : local.external_runs) {
+			gstate.external_runs.push_back(move(run));
 		}
+		return;
+	}
+	if (local.local_data.count == 0) {
+		return;
+	}
+	// sort the data of this thread before merging it into the global state, every thread sorts its own run
+	auto run = make_unique<SortedRun>(gstate.layout, *local.sort_collection);
 
-		ChunkCollection sort_collection;
-		for (index_t i = 0; i < big_data.chunks.size(); i++) {
-			DataChunk sort_chunk;
-			sort_chunk.Initialize(sort_types);
+	lock_guard<mutex> glock(gstate.lock);
+	gstate.run_offsets.push_back(gstate.sorted_data.count);
+	gstate.sorted_data.Append(local.local_data);
+	gstate.reservation.Merge(local.reservation);
+	gstate.sorted_runs.push_back(move(run));
+	gstate.sort_collections.push_back(move(local.sort_collection));
+}
 
-			ExpressionExecutor executor(*big_data.chunks[i]);
-			executor.Execute(order_expressions, sort_chunk);
-			sort_collection.Append(sort_chunk);
+void PhysicalOrder::Finalize(ClientContext &context, GlobalOperatorState &state) {
+	auto &gstate = (OrderByGlobalOperatorState &)state;
+	if (gstate.external_runs.size() > 0) {
+		// some of the data was written to external runs: write the runs that were kept in memory to external runs as
+		// well, and merge all of them while the result is scanned
+		for (index_t run_idx = 0; run_idx < gstate.sorted_runs.size(); run_idx++) {
+			auto &run = *gstate.sorted_runs[run_idx];
+			auto key_order = unique_ptr<index_t[]>(new index_t[run.count]);
+			auto payload_order = unique_ptr<index_t[]>(new index_t[run.count]);
+			run.GetOrder(key_order.get());
+			for (index_t i = 0; i < run.count; i++) {
+				payload_order[i] = gstate.run_offsets[run_idx] + key_order[i];
+			}
+			auto external_run = make_unique<ExternalSortedRun>(gstate.buffer_manager);
+			external_run->Append(gstate.sorted_data, payload_order.get(), *gstate.sort_collections[run_idx],
+			                     key_order.get(), run.count);
+			external_run->Finalize();
+			gstate.external_runs.push_back(move(external_run));
 		}
+		gstate.sorted_data = ChunkCollection();
+		gstate.sorted_runs.clear();
+		gstate.sort_collections.clear();
+		gstate.reservation.Resize(0);
 
-		assert(sort_collection.count == big_data.count);
+		// every run that is being merged has a buffer pinned: if there are too many runs to merge at once we first
+		// merge groups of runs into bigger runs
+		auto merge_width = ExternalRunMerger::MaximumMergeWidth(gstate.buffer_manager);
+		auto payload_types = types;
+		auto key_types = gstate.layout.types;
+		auto &runs = gstate.external_runs;
+		while (runs.size() > merge_width) {
+			vector<unique_ptr<ExternalSortedRun>> merge_runs;
+			for (index_t run_idx = 0; run_idx < merge_width; run_idx++) {
+				merge_runs.push_back(move(runs[run_idx]));
+			}
+			runs.erase(runs.begin(), runs.begin() + merge_width);
+			ExternalRunMerger merger(gstate.layout, move(merge_runs));
+			runs.push_back(merger.MergeRuns(gstate.buffer_manager, payload_types, key_types));
+		}
+		gstate.merger = make_unique<ExternalRunMerger>(gstate.layout, move(runs));
+		return;
+	}
 
-		// now perform the actual sort
-		state->sorted_vector = unique_ptr<index_t[]>(new index_t[sort_collection.count]);
-		sort_collection.Sort(order_types, state->sorted_vector.get());
+	// merge the sorted runs of the threads into the final order
+	vector<SortedRun *> runs;
+	for (auto &run : gstate.sorted_runs) {
+		runs.push_back(run.get());
 	}
+	gstate.sorted_vector = unique_ptr<index_t[]>(new index_t[gstate.sorted_data.count]);
+	SortedRun::Merge(runs, gstate.run_offsets, gstate.sorted_vector.get());
+
+	// the sort keys are no longer needed
+	gstate.sorted_runs.clear();
+	gstate.sort_collections.clear();
+}
 
+void PhysicalOrder::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalOrderOperatorState *>(state_);
+	if (state->position == 0) {
+		// collect and sort the input
+		ExecutePipeline(context);
+	}
+	auto &gstate = (OrderByGlobalOperatorState &)*sink_state;
+	if (gstate.merger) {
+		gstate.merger->GetChunk(chunk);
+		state->position += chunk.size();
+		return;
+	}
+	ChunkCollection &big_data = gstate.sorted_data;
 	if (state->position >= big_data.count) {
 		return;
 	}
 
-	big_data.MaterializeSortedChunk(chunk, state->sorted_vector.get(), state->position);
+	big_data.MaterializeSortedChunk(chunk, gstate.sorted_vector.get(), state->position);
 	state->position += STANDARD_VECTOR_SIZE;
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalOrder::GetOperatorState() {
-	return make_unique<PhysicalOrderOperatorState>(children[0].get());
+	return make_unique<PhysicalOrderOperatorState>();
+}
+
+unique_ptr<GlobalOperatorState> PhysicalOrder::GetGlobalState(ClientContext &context) {
+	vector<TypeId> sort_types;
+	vector<OrderType> order_types;
+	for (index_t i = 0; i < orders.size(); i++) {
+		sort_types.push_back(orders[i].expression->return_type);
+		order_types.push_back(orders[i].type);
+	}
+	// if the query has a memory limit every thread can use a share of (half) the limit to collect its data, the
+	// external runs are kept in the buffer manager itself
+	auto &buffer_manager = *context.db.storage->buffer_manager;
+	index_t memory_limit = INVALID_INDEX;
+	auto query_limit = context.query_memory.GetLimit();
+	if (query_limit != INVALID_INDEX) {
+		memory_limit = query_limit / 2 / context.db.scheduler->NumberOfThreads();
+	}
+	return make_unique<OrderByGlobalOperatorState>(buffer_manager, context.query_memory,
+	                                               SortKeyLayout(sort_types, order_types), memory_limit);
+}
+
+unique_ptr<LocalSinkState> PhysicalOrder::GetLocalSinkState(ClientContext &context) {
+	auto state = make_unique<OrderByLocalOperatorState>(context.query_memory);
+	state->sort_collection = make_unique<ChunkCollection>();
+	return move(state);
 }
@@ -6,16 +6,16 @@ using namespace duckdb;
 using namespace std;
 
 void PhysicalProjection::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
+	GetStreamingChunk(context, chunk, state);
+}
+
+bool PhysicalProjection::ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
 	assert(select_list.size() > 0);
 	assert(children.size() == 1);
-	// get the next chunk from the child
-	children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-	if (state->child_chunk.size() == 0) {
-		return;
-	}
 
 	ExpressionExecutor executor(state->child_chunk);
 	executor.Execute(select_list, chunk);
+	return false;
 }
 
 string PhysicalProjection::ExtraRenderInformation() const {
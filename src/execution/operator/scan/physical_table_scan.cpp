@@ -6,15 +6,25 @@
 using namespace duckdb;
 using namespace std;
 
+class TableScanParallelState : public ParallelState {
+public:
+	//! Lock held while fetching the next row range of the scan
+	std::mutex lock;
+	//! The shared state of the scan
+	ParallelTableScanState state;
+};
+
 class PhysicalTableScanOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalTableScanOperatorState() : PhysicalOperatorState(nullptr), initialized(false) {
+	PhysicalTableScanOperatorState() : PhysicalOperatorState(nullptr), initialized(false), parallel_state(nullptr) {
 	}
 
 	//! Whether or not the scan has been initialized
 	bool initialized;
 	//! The current position in the scan
 	TableScanState scan_offset;
+	//! The shared scan state, if this scan is part of a parallel pipeline
+	TableScanParallelState *parallel_state;
 };
 
 void PhysicalTableScan::GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
@@ -23,6 +33,21 @@ void PhysicalTableScan::GetChunkInternal(ClientContext &context, DataChunk &chun
 		return;
 	}
 	auto &transaction = context.ActiveTransaction();
+	if (state->parallel_state) {
+		// parallel scan: scan the current row range, and fetch the next one from the shared state once it is done
+		auto &pstate = *state->parallel_state;
+		do {
+			if (state->initialized) {
+				table.Scan(transaction, chunk, state->scan_offset);
+				if (chunk.size() > 0) {
+					return;
+				}
+			}
+			lock_guard<mutex> parallel_lock(pstate.lock);
+			state->initialized = table.NextParallelScan(transaction, pstate.state, state->scan_offset, column_ids);
+		} while (state->initialized);
+		return;
+	}
 	if (!state->initialized) {
 		table.InitializeScan(transaction, state->scan_offset, column_ids);
 		state->initialized = true;
@@ -32,9 +57,29 @@ void PhysicalTableScan::GetChunkInternal(ClientContext &context, DataChunk &chun
 }
 
 string PhysicalTableScan::ExtraRenderInformation() const {
-	return tableref.name;
+	string extra_info = tableref.name;
+	for (auto &filter : table_filters) {
+		extra_info += "\n" + tableref.columns[column_ids[filter.column_index]].name + " " +
+		              ExpressionTypeToOperator(filter.comparison_type) + " " + filter.constant.ToString();
+	}
+	return extra_info;
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalTableScan::GetOperatorState() {
-	return make_unique<PhysicalTableScanOperatorState>();
+	auto state = make_unique<PhysicalTableScanOperatorState>();
+	if (table_filters.size() > 0) {
+		state->scan_offset.table_filters = &table_filters;
+	}
+	return move(state);
+}
+
+unique_ptr<ParallelState> PhysicalTableScan::GetParallelState(ClientContext &context) {
+	auto state = make_unique<TableScanParallelState>();
+	table.InitializeParallelScan(state->state);
+	return move(state);
+}
+
+void PhysicalTableScan::SetParallelState(PhysicalOperatorState &state, ParallelState &parallel_state) {
+	auto &scan_state = (PhysicalTableScanOperatorState &)state;
+	scan_state.parallel_state = (TableScanParallelState *)&parallel_state;
 }
@@ -1,5 +1,6 @@
 #include "duckdb/execution/operator/schema/physical_create_index.hpp"
 
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/execution/expression_executor.hpp"
@@ -8,8 +9,10 @@
 using namespace duckdb;
 using namespace std;
 
-void PhysicalCreateIndex::CreateARTIndex() {
+void PhysicalCreateIndex::CreateARTIndex(IndexCatalogEntry &index) {
 	auto art = make_unique<ART>(*table.storage, column_ids, move(unbound_expressions));
+	index.index = art.get();
+	index.storage = table.storage;
 
 	table.storage->AddIndex(move(art), expressions);
 }
@@ -20,7 +23,8 @@ void PhysicalCreateIndex::GetChunkInternal(ClientContext &context, DataChunk &ch
 	}
 
 	auto &schema = *table.schema;
-	if (!schema.CreateIndex(context.ActiveTransaction(), info.get())) {
+	auto index_entry = schema.CreateIndex(context.ActiveTransaction(), info.get());
+	if (!index_entry) {
 		// index already exists, but error ignored because of CREATE ... IF NOT
 		// EXISTS
 		return;
@@ -32,7 +36,7 @@ void PhysicalCreateIndex::GetChunkInternal(ClientContext &context, DataChunk &ch
 
 	switch (info->index_type) {
 	case IndexType::ART: {
-		CreateARTIndex();
+		CreateARTIndex(*index_entry);
 		break;
 	}
 	default:
@@ -24,7 +24,7 @@ string PhysicalOperator::ToString(index_t depth) const {
 	return result;
 }
 
-PhysicalOperatorState::PhysicalOperatorState(PhysicalOperator *child) : finished(false) {
+PhysicalOperatorState::PhysicalOperatorState(PhysicalOperator *child) : finished(false), has_more_output(false) {
 	if (child) {
 		child->InitializeChunk(child_chunk);
 		child_state = child->GetOperatorState();
@@ -48,6 +48,35 @@ void PhysicalOperator::GetChunk(ClientContext &context, DataChunk &chunk, Physic
 	chunk.Verify();
 }
 
+bool PhysicalOperator::Execute(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
+	assert(IsStreaming());
+	if (context.interrupted) {
+		throw InterruptException();
+	}
+	chunk.Reset();
+
+	context.profiler.StartOperator(this);
+	state->has_more_output = ExecuteInternal(context, chunk, state);
+	context.profiler.EndOperator(chunk);
+
+	chunk.Verify();
+	return state->has_more_output;
+}
+
+void PhysicalOperator::GetStreamingChunk(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
+	do {
+		if (!state->has_more_output) {
+			// the previous input has been transformed entirely: fetch the next chunk from the child
+			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+			if (state->child_chunk.size() == 0) {
+				return;
+			}
+		}
+		chunk.Reset();
+		state->has_more_output = ExecuteInternal(context, chunk, state);
+	} while (chunk.size() == 0 && !state->finished);
+}
+
 void PhysicalOperator::Print() {
 	Printer::Print(ToString());
 }
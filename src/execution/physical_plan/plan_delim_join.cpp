@@ -1,12 +1,9 @@
-#include "duckdb/execution/aggregate_hashtable.hpp"
 #include "duckdb/execution/operator/join/physical_delim_join.hpp"
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
 #include "duckdb/execution/operator/projection/physical_projection.hpp"
 #include "duckdb/execution/operator/scan/physical_chunk_scan.hpp"
 #include "duckdb/execution/physical_plan_generator.hpp"
-#include "duckdb/function/aggregate/distributive_functions.hpp"
 #include "duckdb/planner/operator/logical_delim_join.hpp"
-#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
 #include "duckdb/main/client_context.hpp"
 
 using namespace duckdb;
@@ -44,34 +41,8 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalDelimJoin
 	if (op.type == JoinType::MARK) {
 		assert(plan->type == PhysicalOperatorType::HASH_JOIN);
 		auto &hash_join = (PhysicalHashJoin &)*plan;
-		// correlated MARK join
-		if (delim_types.size() + 1 == hash_join.conditions.size()) {
-			// the correlated MARK join has one more condition than the amount of correlated columns
-			// this is the case in a correlated ANY() expression
-			// in this case we need to keep track of additional entries, namely:
-			// - (1) the total amount of elements per group
-			// - (2) the amount of non-null elements per group
-			// we need these to correctly deal with the cases of either:
-			// - (1) the group being empty [in which case the result is always false, even if the comparison is NULL]
-			// - (2) the group containing a NULL value [in which case FALSE becomes NULL]
-			auto &info = hash_join.hash_table->correlated_mark_join_info;
-
-			vector<TypeId> payload_types = {TypeId::BIGINT, TypeId::BIGINT}; // COUNT types
-			vector<AggregateFunction> aggregate_functions = {CountStarFun::GetFunction(), CountFun::GetFunction()};
-			vector<BoundAggregateExpression *> correlated_aggregates;
-			for (index_t i = 0; i < aggregate_functions.size(); ++i) {
-				auto aggr = make_unique<BoundAggregateExpression>(payload_types[i], aggregate_functions[i], false);
-				correlated_aggregates.push_back(&*aggr);
-				info.correlated_aggregates.push_back(move(aggr));
-			}
-			info.correlated_counts =
-			    make_unique<SuperLargeHashTable>(1024, delim_types, payload_types, correlated_aggregates);
-			info.correlated_types = delim_types;
-			// FIXME: these can be initialized "empty" (without allocating empty vectors)
-			info.group_chunk.Initialize(delim_types);
-			info.payload_chunk.Initialize(payload_types);
-			info.result_chunk.Initialize(payload_types);
-		}
+		// correlated MARK join: the HT keeps track of the counts of the correlated columns
+		hash_join.delim_types = delim_types;
 	}
 	// now create the duplicate eliminated join
 	auto delim_join = make_unique<PhysicalDelimJoin>(op, move(plan), delim_scans);
@@ -0,0 +1,10 @@
+#include "duckdb/execution/physical_sink.hpp"
+
+#include "duckdb/main/client_context.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+void PhysicalSink::ExecutePipeline(ClientContext &context) {
+	context.execution_context.executor.ExecutePipeline(*this);
+}
@@ -33,18 +33,22 @@ static void count_simple_update(Vector inputs[], index_t input_count, Value &res
 	result = result + count;
 }
 
+static void count_simple_combine(Value &state, Value &combined) {
+	combined = combined + state;
+}
+
 namespace duckdb {
 
 AggregateFunction CountFun::GetFunction() {
 	return AggregateFunction({SQLType(SQLTypeId::ANY)}, SQLType::BIGINT, get_bigint_type_size,
 	                         bigint_payload_initialize, count_update, count_combine, gather_finalize,
-	                         bigint_simple_initialize, count_simple_update);
+	                         bigint_simple_initialize, count_simple_update, count_simple_combine);
 }
 
 AggregateFunction CountStarFun::GetFunction() {
 	return AggregateFunction("count_star", {SQLType(SQLTypeId::ANY)}, SQLType::BIGINT, get_bigint_type_size,
 	                         bigint_payload_initialize, countstar_update, count_combine, gather_finalize,
-	                         bigint_simple_initialize, countstar_simple_update);
+	                         bigint_simple_initialize, countstar_simple_update, count_simple_combine);
 }
 
 void CountFun::RegisterFunction(BuiltinFunctions &set) {
@@ -26,13 +26,23 @@ static void max_simple_update(Vector inputs[], index_t input_count, Value &resul
 	}
 }
 
+static void max_simple_combine(Value &state, Value &combined) {
+	if (state.is_null) {
+		return;
+	}
+	if (combined.is_null || combined < state) {
+		combined = state;
+	}
+}
+
 namespace duckdb {
 
 void MaxFun::RegisterFunction(BuiltinFunctions &set) {
 	AggregateFunctionSet max("max");
 	for (auto type : SQLType::ALL_TYPES) {
 		max.AddFunction(AggregateFunction({type}, type, get_return_type_size, null_state_initialize, max_update,
-		                                  max_combine, gather_finalize, null_simple_initialize, max_simple_update));
+		                                  max_combine, gather_finalize, null_simple_initialize, max_simple_update,
+		                                  max_simple_combine));
 	}
 	set.AddFunction(max);
 }
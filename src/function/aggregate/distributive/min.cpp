@@ -26,13 +26,23 @@ static void min_simple_update(Vector inputs[], index_t input_count, Value &resul
 	}
 }
 
+static void min_simple_combine(Value &state, Value &combined) {
+	if (state.is_null) {
+		return;
+	}
+	if (combined.is_null || combined > state) {
+		combined = state;
+	}
+}
+
 namespace duckdb {
 
 void MinFun::RegisterFunction(BuiltinFunctions &set) {
 	AggregateFunctionSet min("min");
 	for (auto type : SQLType::ALL_TYPES) {
 		min.AddFunction(AggregateFunction({type}, type, get_return_type_size, null_state_initialize, min_update,
-		                                  min_combine, gather_finalize, null_simple_initialize, min_simple_update));
+		                                  min_combine, gather_finalize, null_simple_initialize, min_simple_update,
+		                                  min_simple_combine));
 	}
 	set.AddFunction(min);
 }
@@ -28,6 +28,17 @@ static void sum_simple_update(Vector inputs[], index_t input_count, Value &resul
 	}
 }
 
+static void sum_simple_combine(Value &state, Value &combined) {
+	if (state.is_null) {
+		return;
+	}
+	if (combined.is_null) {
+		combined = state;
+	} else {
+		combined = combined + state;
+	}
+}
+
 namespace duckdb {
 
 void SumFun::RegisterFunction(BuiltinFunctions &set) {
@@ -35,11 +46,11 @@ void SumFun::RegisterFunction(BuiltinFunctions &set) {
 	// integer sums to bigint
 	sum.AddFunction(AggregateFunction({SQLType::BIGINT}, SQLType::BIGINT, get_return_type_size, null_state_initialize,
 	                                  sum_update, sum_combine, gather_finalize, null_simple_initialize,
-	                                  sum_simple_update));
+	                                  sum_simple_update, sum_simple_combine));
 	// float sums to float
 	sum.AddFunction(AggregateFunction({SQLType::DOUBLE}, SQLType::DOUBLE, get_return_type_size, null_state_initialize,
 	                                  sum_update, sum_combine, gather_finalize, null_simple_initialize,
-	                                  sum_simple_update));
+	                                  sum_simple_update, sum_simple_combine));
 
 	set.AddFunction(sum);
 }
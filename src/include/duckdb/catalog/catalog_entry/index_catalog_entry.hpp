@@ -13,18 +13,33 @@
 
 namespace duckdb {
 
+class DataTable;
+class Index;
 class SchemaCatalogEntry;
 
 //! An index catalog entry
 class IndexCatalogEntry : public CatalogEntry {
 public:
 	//! Create a real TableCatalogEntry and initialize storage for it
-	IndexCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schema, CreateIndexInfo *info)
-	    : CatalogEntry(CatalogType::INDEX, catalog, info->index_name), schema(schema) {
-		// FIXME: add more information for drop index support
-	}
+	IndexCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schema, CreateIndexInfo *info);
 
 	//! The schema the table belongs to
 	SchemaCatalogEntry *schema;
+	//! The type of the index
+	IndexType index_type;
+	//! The name of the indexed table
+	string table;
+	//! The (unbound) expressions the index is built on
+	vector<unique_ptr<ParsedExpression>> expressions;
+	//! The index itself, set once the index has been built
+	Index *index;
+	//! The storage of the indexed table, which owns the index
+	std::shared_ptr<DataTable> storage;
+
+public:
+	//! Serialize the meta information of the IndexCatalogEntry to a serializer
+	virtual void Serialize(Serializer &serializer);
+	//! Deserializes to a CreateIndexInfo
+	static unique_ptr<CreateIndexInfo> Deserialize(Deserializer &source);
 };
 } // namespace duckdb
@@ -14,6 +14,7 @@
 namespace duckdb {
 class FunctionExpression;
 
+class IndexCatalogEntry;
 class TableCatalogEntry;
 class TableFunctionCatalogEntry;
 class SequenceCatalogEntry;
@@ -69,7 +70,7 @@ public:
 	void DropSequence(Transaction &transaction, DropInfo *info);
 
 	//! Creates an index with the given name in the schema
-	bool CreateIndex(Transaction &transaction, CreateIndexInfo *info);
+	IndexCatalogEntry *CreateIndex(Transaction &transaction, CreateIndexInfo *info);
 	//! Drops a index with the given name
 	void DropIndex(Transaction &transaction, DropInfo *info);
 	//! Drops a table with the given name
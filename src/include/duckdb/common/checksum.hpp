@@ -12,7 +12,13 @@
 
 namespace duckdb {
 
-//! Compute a checksum over a buffer of size size
+//! Compute a checksum over a buffer of size size. The checksum is the CRC32C of the buffer, which is computed with the
+//! crc32 instruction of SSE 4.2 when the CPU supports it.
 uint64_t Checksum(uint8_t *buffer, size_t size);
 
+//! Extend the CRC32C (Castagnoli) checksum crc with the given buffer, using the fastest available implementation
+uint32_t Crc32c(uint32_t crc, const uint8_t *buffer, size_t size);
+//! Extend the CRC32C checksum crc with the given buffer, using the portable (table-driven) implementation
+uint32_t Crc32cPortable(uint32_t crc, const uint8_t *buffer, size_t size);
+
 } // namespace duckdb
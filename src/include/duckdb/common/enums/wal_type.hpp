@@ -29,6 +29,9 @@ enum class WALType : uint8_t {
 	CREATE_SEQUENCE = 8,
 	DROP_SEQUENCE = 9,
 	SEQUENCE_VALUE = 10,
+
+	CREATE_INDEX = 11,
+	DROP_INDEX = 12,
 	// -----------------------------
 	// Data
 	// -----------------------------
@@ -41,6 +44,10 @@ enum class WALType : uint8_t {
 	// -----------------------------
 	QUERY = 50,
 	// -----------------------------
+	// Checkpoint
+	// -----------------------------
+	CHECKPOINT = 75,
+	// -----------------------------
 	// Flush
 	// -----------------------------
 	WAL_FLUSH = 100
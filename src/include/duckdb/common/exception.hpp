@@ -54,7 +54,9 @@ enum class ExceptionType {
 	OPTIMIZER = 26,       // optimizer related
 	NULL_POINTER = 27,    // nullptr exception
 	IO = 28,              // IO exception
-	INTERRUPT = 29        // interrupt
+	INTERRUPT = 29,       // interrupt
+	OUT_OF_MEMORY = 30,   // out of memory
+	FATAL = 31            // fatal error, the database cannot be used anymore
 };
 
 class Exception : public std::exception {
@@ -167,4 +169,14 @@ public:
 	InterruptException();
 };
 
+class OutOfMemoryException : public Exception {
+public:
+	OutOfMemoryException(string msg, ...);
+};
+
+class FatalException : public Exception {
+public:
+	FatalException(string msg, ...);
+};
+
 } // namespace duckdb
@@ -23,6 +23,9 @@ public:
 	//! been opened with DIRECT_IO on all operating systems, however, the entire buffer must be written to the file.
 	//! Note that the returned size is 8 bytes less than the allocation size to account for the checksum.
 	FileBuffer(FileBufferType type, uint64_t bufsiz);
+	//! Creates a FileBuffer that refers to bufsiz bytes of existing memory (e.g. a memory-mapped file) including the
+	//! buffer header, instead of allocating its own. The memory is not freed when the FileBuffer is destroyed.
+	FileBuffer(FileBufferType type, data_ptr_t internal_buffer, uint64_t bufsiz);
 	virtual ~FileBuffer();
 
 	//! The type of the buffer
@@ -39,12 +42,18 @@ public:
 	//! Write the contents of the FileBuffer to the specified location. Automatically adds a checksum of the contents of
 	//! the filebuffer in front of the written data.
 	void Write(FileHandle &handle, uint64_t location);
+	//! Verify the checksum stored in the buffer header, throws an exception if it does not match the contents
+	void VerifyChecksum();
 
 	void Clear();
 
 	uint64_t AllocSize() {
 		return internal_size;
 	}
+	//! Returns the buffer including the buffer header, i.e. the memory that is read or written to disk
+	data_ptr_t InternalBuffer() {
+		return internal_buffer;
+	}
 
 private:
 	//! The pointer to the internal buffer that will be read or written, including the buffer header
@@ -53,6 +62,7 @@ private:
 	uint64_t internal_size;
 
 	//! The buffer that was actually malloc'd, i.e. the pointer that must be freed when the FileBuffer is destroyed
+	//! (nullptr if the FileBuffer does not own its memory)
 	data_ptr_t malloced_buffer;
 };
 
@@ -73,6 +73,10 @@ public:
 	virtual int64_t Read(FileHandle &handle, void *buffer, int64_t nr_bytes);
 	//! Write nr_bytes from the buffer into the file, moving the file pointer forward by nr_bytes.
 	virtual int64_t Write(FileHandle &handle, void *buffer, int64_t nr_bytes);
+	//! Read buffer_size bytes into each of the buffers from consecutive ranges of the file, starting at the specified
+	//! location. The ranges are read with as few (vectored) read requests as possible. Fails if not all bytes could be
+	//! read.
+	virtual void ReadBuffers(FileHandle &handle, vector<data_ptr_t> &buffers, index_t buffer_size, index_t location);
 
 	//! Returns the file size of a file handle, returns -1 on error
 	virtual int64_t GetFileSize(FileHandle &handle);
@@ -98,6 +102,11 @@ public:
 	virtual string JoinPath(const string &a, const string &path);
 	//! Sync a file handle to disk
 	virtual void FileSync(FileHandle &handle);
+	//! Map the first [size] bytes of a file into memory for reading. The mapping remains valid until it is unmapped,
+	//! even after the file handle is closed. Writing to the mapped memory is not allowed.
+	virtual data_ptr_t MapFile(FileHandle &handle, index_t size);
+	//! Remove a mapping that was created by MapFile
+	virtual void UnmapFile(data_ptr_t mapping, index_t size);
 
 private:
 	//! Set the file pointer of a file handle to a specified location. Reads and writes will happen from this location
@@ -21,7 +21,8 @@ struct Equals {
 	}
 };
 template <> inline bool Equals::Operation(const char *left, const char *right) {
-	return strcmp(left, right) == 0;
+	// strings that are read from the same dictionary entry point to the same memory
+	return left == right || strcmp(left, right) == 0;
 }
 struct NotEquals {
 	template <class T> static inline bool Operation(T left, T right) {
@@ -29,7 +30,7 @@ struct NotEquals {
 	}
 };
 template <> inline bool NotEquals::Operation(const char *left, const char *right) {
-	return strcmp(left, right) != 0;
+	return left != right && strcmp(left, right) != 0;
 }
 struct GreaterThan {
 	template <class T> static inline bool Operation(T left, T right) {
@@ -14,7 +14,8 @@ namespace duckdb {
 
 class BufferedFileReader : public Deserializer {
 public:
-	BufferedFileReader(FileSystem &fs, const char *path);
+	//! Read the file in blocks of [buffer_size] bytes
+	BufferedFileReader(FileSystem &fs, const char *path, index_t buffer_size = FILE_BUFFER_SIZE);
 
 	FileSystem &fs;
 	unique_ptr<data_t[]> data;
@@ -32,6 +33,7 @@ public:
 	}
 
 private:
+	index_t buffer_size;
 	index_t file_size;
 	index_t total_read;
 };
@@ -30,9 +30,7 @@ public:
 	void WriteData(const_data_ptr_t buffer, uint64_t write_size) override;
 	//! Flush the buffer to disk and sync the file to ensure writing is completed
 	void Sync();
-
-private:
-	//! Flush the buffer to the file
+	//! Flush the buffer to the file, without syncing the file
 	void Flush();
 };
 
@@ -40,6 +40,8 @@ public:
 
 	//! Append a new DataChunk directly to this ChunkCollection
 	void Append(DataChunk &new_chunk);
+	//! Append the contents of another ChunkCollection to this ChunkCollection
+	void Append(ChunkCollection &other);
 
 	//! Gets the value of the column at the specified index
 	Value GetValue(index_t column, index_t index);
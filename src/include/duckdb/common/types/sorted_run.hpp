@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/types/sorted_run.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/enums/order_type.hpp"
+#include "duckdb/common/types/chunk_collection.hpp"
+
+namespace duckdb {
+
+//! The SortKeyLayout describes how the ORDER BY columns of a row are encoded into a normalized key: a fixed-size
+//! byte string that compares with memcmp the same way the row compares in the ORDER BY. NULL values sort before all
+//! other values in ascending order. Every entry of a sorted run consists of the normalized key followed by the
+//! index of the row it belongs to.
+/*!
+    Strings only store a prefix of the string in the key, followed by a pointer to the full string. Keys that
+   contain strings therefore cannot be compared with a single memcmp, Compare falls back to comparing the full
+   strings if the prefixes are equal.
+*/
+class SortKeyLayout {
+public:
+	SortKeyLayout(vector<TypeId> types, vector<OrderType> order_types);
+
+	//! The types of the ORDER BY columns
+	vector<TypeId> types;
+	//! The order of each of the ORDER BY columns
+	vector<OrderType> order_types;
+	//! The offset of each column within the key
+	vector<index_t> offsets;
+	//! The indices of the VARCHAR columns
+	vector<index_t> string_columns;
+	//! The size of the key
+	index_t key_size;
+	//! The size of an entry: the key followed by the row index
+	index_t entry_size;
+
+public:
+	//! Encodes the keys of the rows in the chunk into consecutive entries at target, the rows are numbered starting
+	//! from row_offset
+	void Encode(DataChunk &keys, data_ptr_t target, index_t row_offset);
+	//! Compares two entries, returns a negative number if left sorts before right, 0 if they are equal and a
+	//! positive number otherwise
+	int32_t Compare(data_ptr_t left, data_ptr_t right);
+	//! Returns the row index stored in an entry
+	index_t GetRowIndex(data_ptr_t entry);
+
+	//! Whether or not the keys can be compared with a single memcmp
+	bool IsFixedWidth() {
+		return string_columns.size() == 0;
+	}
+};
+
+//! A SortedRun holds the normalized keys of a set of rows in sorted order
+/*!
+    The run only references the strings of the keys. The collection the run is created from has to outlive it.
+*/
+class SortedRun {
+public:
+	//! Encodes the keys in the collection and sorts them. Fixed-width keys are sorted with a radix sort, keys with
+	//! strings with a comparison sort.
+	SortedRun(SortKeyLayout &layout, ChunkCollection &keys);
+
+	SortKeyLayout &layout;
+	//! The amount of entries in the run
+	index_t count;
+	//! The sorted entries
+	unique_ptr<data_t[]> entries;
+
+public:
+	//! Returns a pointer to the entry at the given position
+	data_ptr_t GetEntry(index_t position) {
+		return entries.get() + position * layout.entry_size;
+	}
+	//! Writes the row indices of the run in sorted order to result
+	void GetOrder(index_t result[]);
+
+	//! Merges the sorted runs into a single order. The row indices of the i-th run are offset by row_offsets[i].
+	static void Merge(vector<SortedRun *> &runs, vector<index_t> &row_offsets, index_t result[]);
+
+private:
+	void RadixSort(data_ptr_t data, data_ptr_t temp, index_t count, index_t offset);
+	void InsertionSort(data_ptr_t data, data_ptr_t temp, index_t count, index_t offset);
+	void ComparisonSort();
+};
+
+} // namespace duckdb
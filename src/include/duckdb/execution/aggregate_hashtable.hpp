@@ -21,13 +21,23 @@ class BoundAggregateExpression;
 /*!
     SuperLargeHashTable is a HT that is used for computing aggregates. It takes
    as input the set of groups and the types of the aggregates to compute and
-   stores them in the HT. It uses linear probing for collision resolution, and
-   supports both parallel and sequential modes.
+   stores them in the HT. It uses linear probing for collision resolution.
+
+    The HT itself is not thread-safe. For parallel aggregation every thread
+   pre-aggregates its input in a thread-local HT. These HTs are then split into
+   radix partitions using Partition, and all HTs of the same partition are
+   merged using Combine. Since the partitions are disjoint, they can be merged
+   in parallel.
+
+    Under memory pressure the HT can stop creating new groups: FindGroups
+   determines which rows belong to groups that already exist, the other rows can
+   then be spilled by their radix partition (see ComputePartitions) and
+   aggregated into the partition later on.
 */
 class SuperLargeHashTable {
 public:
 	SuperLargeHashTable(index_t initial_capacity, vector<TypeId> group_types, vector<TypeId> payload_types,
-	                    vector<BoundAggregateExpression *> aggregates, bool parallel = false);
+	                    vector<BoundAggregateExpression *> aggregates);
 	~SuperLargeHashTable();
 
 	//! Resize the HT to the specified size. Must be larger than the current
@@ -46,12 +56,38 @@ public:
 	void FetchAggregates(DataChunk &groups, DataChunk &result);
 
 	void FindOrCreateGroups(DataChunk &groups, Vector &addresses, Vector &new_group);
+	//! Look up the groups in the HT without creating any new groups, found is set to whether or not each group exists
+	void FindGroups(DataChunk &groups, bool found[]);
+
+	//! Move the groups of this HT into 2^radix_bits partitions based on the hash of the groups, combining their
+	//! aggregate states with any states already present in the partitions. The strings of the groups are not
+	//! copied: instead, the string heap of this HT is moved into the first partition.
+	void Partition(vector<SuperLargeHashTable *> &partitions, index_t radix_bits);
+	//! Combine the groups and aggregate states of the other HT into this HT. Takes over the string heap of the other
+	//! HT.
+	void Combine(SuperLargeHashTable &other);
+	//! Returns the amount of groups in the HT
+	index_t Size() {
+		return entries;
+	}
+	//! Returns the amount of memory (in bytes) used by the HT, excluding the string heap
+	index_t MemoryUsage();
+	//! Compute the radix partition of every group in the same way as Partition does
+	static void ComputePartitions(DataChunk &groups, index_t radix_bits, index_t partitions[]);
+	//! Whether or not the given aggregates can be computed by combining thread-local HTs, i.e. all of them have a
+	//! combine function and none of them are DISTINCT
+	static bool CanCombine(vector<BoundAggregateExpression *> &aggregates);
 
 	//! The stringheap of the AggregateHashTable
 	StringHeap string_heap;
 
 private:
 	void HashGroups(DataChunk &groups, Vector &addresses);
+	//! Scan the HT starting from the scan_position, fetching the groups into the group chunk and pointing the
+	//! addresses to their aggregate states. Returns the amount of groups found.
+	index_t ScanGroups(index_t &scan_position, DataChunk &groups, Vector &addresses);
+	//! Combine the aggregate states that the source addresses point to into the states at the target addresses
+	void CombineStates(Vector &source_addresses, Vector &target_addresses);
 
 	//! The aggregates to be computed
 	vector<BoundAggregateExpression *> aggregates;
@@ -74,8 +110,6 @@ private:
 	data_ptr_t data;
 	//! The endptr of the hashtable
 	data_ptr_t endptr;
-	//! Whether or not the HT has to support parallel insertion operations
-	bool parallel = false;
 	//! The empty payload data
 	unique_ptr<data_t[]> empty_payload_data;
 	//! Bitmask for getting relevant bits from the hashes to determine the position
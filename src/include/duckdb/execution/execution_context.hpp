@@ -9,19 +9,27 @@
 #pragma once
 
 #include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/execution/executor.hpp"
 #include "duckdb/execution/physical_operator.hpp"
 #include "duckdb/main/query_result.hpp"
 
 namespace duckdb {
+class ClientContext;
 class DuckDB;
 
 class ExecutionContext {
 public:
+	ExecutionContext(ClientContext &context) : executor(context) {
+	}
+
 	unique_ptr<PhysicalOperator> physical_plan;
 	unique_ptr<PhysicalOperatorState> physical_state;
+	//! The executor that keeps track of the pipelines of the physical plan
+	Executor executor;
 
 public:
 	void Reset() {
+		executor.Reset();
 		physical_plan = nullptr;
 		physical_state = nullptr;
 	}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/executor.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include <mutex>
+
+namespace duckdb {
+class ClientContext;
+class Pipeline;
+class PhysicalOperator;
+class PhysicalSink;
+
+//! The Executor keeps track of the pipelines of the query that is currently running. The pipelines are created when
+//! the physical plan is initialized, one for every sink in the plan, and a pipeline is executed the first time its
+//! sink is pulled from, after which the sink can produce its output.
+class Executor {
+public:
+	Executor(ClientContext &context);
+	~Executor();
+
+	ClientContext &context;
+
+public:
+	//! Create the pipelines of the given physical plan
+	void Initialize(PhysicalOperator &plan);
+	//! Execute the pipeline that feeds the given sink, if it has not been executed yet for the current query
+	void ExecutePipeline(PhysicalSink &sink);
+	//! Clear all pipelines of the previous query
+	void Reset();
+
+private:
+	//! Returns the pipeline of the given sink, creating it if it does not exist yet
+	Pipeline &GetPipeline(PhysicalSink &sink);
+
+	//! Lock protecting the set of pipelines
+	std::mutex executor_lock;
+	//! The pipelines of the current query
+	unordered_map<PhysicalSink *, unique_ptr<Pipeline>> pipelines;
+};
+
+} // namespace duckdb
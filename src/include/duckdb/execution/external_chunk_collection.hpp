@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/external_chunk_collection.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/serializer/buffered_deserializer.hpp"
+#include "duckdb/common/serializer/buffered_serializer.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+//! An ExternalChunkCollection is an append-only sequence of DataChunks that is stored in managed buffers of the
+//! buffer manager. The buffers are unpinned while the collection is not being read, so the buffer manager can offload
+//! them to the temporary directory when memory runs low.
+/*!
+    The chunks are serialized into buffers of (at least) a block. The collection can be scanned once, in the order in
+   which the chunks were appended, and every buffer is destroyed as soon as it has been read.
+*/
+class ExternalChunkCollection {
+public:
+	ExternalChunkCollection(BufferManager &manager);
+	~ExternalChunkCollection();
+
+	BufferManager &manager;
+	//! The total amount of rows in the chunks of the collection
+	index_t count;
+
+public:
+	//! Appends a chunk to the collection
+	void Append(DataChunk &chunk);
+	//! Writes the last partially filled buffer, has to be called before the collection can be scanned
+	void Finalize();
+
+	//! Reads the next chunk from the collection, returns false if the collection is exhausted
+	bool Scan(unique_ptr<DataChunk> &chunk);
+
+	//! Estimates the amount of memory a chunk uses once it is materialized in memory (e.g. in a ChunkCollection)
+	static index_t EstimateMemoryUsage(DataChunk &chunk);
+
+private:
+	//! Writes the serialized chunks to a new managed buffer
+	void FlushBuffer();
+
+	//! The chunks that have been serialized but not yet written to a buffer
+	unique_ptr<BufferedSerializer> serializer;
+	//! The managed buffers that hold the collection
+	vector<block_id_t> buffers;
+	//! The amount of serialized data in each buffer
+	vector<index_t> buffer_sizes;
+	//! The index of the buffer that is currently being scanned
+	index_t scan_buffer;
+	//! The handle of the buffer that is currently being scanned
+	unique_ptr<BufferHandle> scan_handle;
+	//! The deserializer of the buffer that is currently being scanned
+	unique_ptr<BufferedDeserializer> deserializer;
+};
+
+} // namespace duckdb
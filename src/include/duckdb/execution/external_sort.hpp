@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/external_sort.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/types/sorted_run.hpp"
+#include "duckdb/execution/external_chunk_collection.hpp"
+
+namespace duckdb {
+
+//! An ExternalSortedRun is a sorted run of which the data is stored in managed buffers of the buffer manager. The
+//! buffers are unpinned while the run is not being read, so the buffer manager can offload them to the temporary
+//! directory when memory runs low.
+/*!
+    The run stores the payload and the sort keys of the rows in sorted order as pairs of DataChunks in an
+   ExternalChunkCollection.
+*/
+class ExternalSortedRun {
+public:
+	ExternalSortedRun(BufferManager &manager);
+
+	//! The amount of rows in the run
+	index_t count;
+
+public:
+	//! Appends the rows of the payload and keys collections in the given order to the run, payload_order and
+	//! key_order hold the row indices of the same row in the payload and keys collections respectively
+	void Append(ChunkCollection &payload, index_t payload_order[], ChunkCollection &keys, index_t key_order[],
+	            index_t row_count);
+	//! Appends a chunk of payload data and the corresponding keys to the run, the rows have to be sorted already
+	void Append(DataChunk &payload, DataChunk &keys);
+	//! Writes the last partially filled buffer, has to be called before the run can be scanned
+	void Finalize();
+
+	//! Reads the next pair of payload and keys chunks from the run, returns false if the run is exhausted
+	bool Scan(unique_ptr<DataChunk> &payload, unique_ptr<DataChunk> &keys);
+
+private:
+	//! The payload and keys chunks of the run
+	ExternalChunkCollection data;
+};
+
+//! The ExternalRunMerger merges a set of external sorted runs, reading only one chunk at a time from every run
+class ExternalRunMerger {
+public:
+	ExternalRunMerger(SortKeyLayout &layout, vector<unique_ptr<ExternalSortedRun>> runs);
+
+	SortKeyLayout &layout;
+	vector<unique_ptr<ExternalSortedRun>> runs;
+
+public:
+	//! Fetches the next chunk of payload data in sorted order, result is empty if all runs are exhausted
+	void GetChunk(DataChunk &result);
+	//! Merges all runs into a single new run
+	unique_ptr<ExternalSortedRun> MergeRuns(BufferManager &manager, vector<TypeId> &payload_types,
+	                                        vector<TypeId> &key_types);
+
+	//! Returns the maximum amount of runs that can be merged at once within the memory limit of the buffer manager
+	static index_t MaximumMergeWidth(BufferManager &manager);
+
+private:
+	//! Fetches the next chunk of payload data and (optionally) the corresponding keys in sorted order
+	void GetChunk(DataChunk &result, DataChunk *keys);
+	//! Reads the next chunk of a run and encodes its keys, returns false if the run is exhausted
+	bool NextChunk(index_t run_idx);
+	//! Compares the current entries of two runs
+	bool CompareRuns(index_t left, index_t right);
+
+	struct RunScanState {
+		//! The payload of the current chunk
+		unique_ptr<DataChunk> payload;
+		//! The sort keys of the current chunk
+		unique_ptr<DataChunk> keys;
+		//! The encoded sort keys of the current chunk
+		unique_ptr<data_t[]> entries;
+		//! The position within the current chunk
+		index_t position = 0;
+	};
+
+	bool initialized;
+	//! The scan state of every run
+	vector<RunScanState> states;
+	//! A heap of the runs that are not exhausted yet with the run that holds the smallest entry on top
+	vector<index_t> heap;
+};
+
+} // namespace duckdb
@@ -23,6 +23,7 @@
 #include "duckdb/execution/index/art/node16.hpp"
 #include "duckdb/execution/index/art/node48.hpp"
 #include "duckdb/execution/index/art/node256.hpp"
+#include "duckdb/execution/index/art/unloaded_node.hpp"
 
 namespace duckdb {
 struct IteratorEntry {
@@ -68,6 +69,15 @@ public:
 	uint32_t maxPrefix;
 	//! Whether or not the ART is an index built to enforce a UNIQUE constraint
 	bool is_unique;
+	//! The blocks that contain the nodes of the index that was read from storage. A checkpoint keeps the nodes that
+	//! have not been loaded yet as they are, and with them these blocks.
+	vector<block_id_t> blocks;
+	//! The amount of blocks of the last checkpoint that wrote all nodes of the index. Once the kept blocks grow beyond
+	//! twice this amount, all nodes are loaded and written again to remove the replaced nodes from the kept blocks.
+	index_t full_block_count;
+	//! The amount of deleted rows of the table when the index was written. If rows were deleted since, the nodes that
+	//! have not been loaded can still contain their row ids: they have to be loaded to filter them out.
+	index_t deleted_count;
 
 public:
 	//! Initialize a scan on the index with the given expression and column ids
@@ -94,6 +104,13 @@ public:
 	//! Insert data into the index.
 	bool Insert(IndexLock &lock, DataChunk &data, Vector &row_ids) override;
 
+	//! Write the nodes of the index to the writer, returns the location of the index (INVALID_BLOCK if the index is
+	//! empty). The row ids in the index are mapped to the row ids of the written table data.
+	BlockPointer Serialize(MetaBlockWriter &writer, const RowIdMap &row_map);
+	//! Initialize the index from the location returned by Serialize. Only the root node is read, the other nodes are
+	//! read from storage when they are first accessed.
+	void Load(BlockPointer pointer);
+
 private:
 	DataChunk expression_result;
 
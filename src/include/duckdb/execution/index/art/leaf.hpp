@@ -15,6 +15,7 @@ namespace duckdb {
 class Leaf : public Node {
 public:
 	Leaf(ART &art, unique_ptr<Key> value, row_t row_id);
+	Leaf(ART &art, unique_ptr<Key> value, unique_ptr<row_t[]> row_ids, index_t num_elements);
 
 	unique_ptr<Key> value;
 	index_t capacity;
@@ -10,11 +10,33 @@
 
 #include "duckdb/execution/index/art/art_key.hpp"
 #include "duckdb/common/common.hpp"
+#include "duckdb/storage/block.hpp"
 
 namespace duckdb {
-enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4 };
+enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4, NUnloaded = 5 };
 
 class ART;
+class MetaBlockReader;
+class MetaBlockWriter;
+struct RowIdMap;
+
+//! The state of writing the nodes of an ART to storage
+struct NodeWriteState {
+	NodeWriteState(MetaBlockWriter &writer, const RowIdMap &row_map, bool keep_unloaded)
+	    : writer(writer), row_map(row_map), keep_unloaded(keep_unloaded), kept_unloaded(false) {
+	}
+
+	MetaBlockWriter &writer;
+	//! Maps the row ids of the leaves to the row ids of the written table data
+	const RowIdMap &row_map;
+	//! Whether the nodes that have not been loaded from storage are written as their existing location, instead of
+	//! being loaded and written again
+	bool keep_unloaded;
+	//! Whether any node that had not been loaded from storage was kept
+	bool kept_unloaded;
+	//! The blocks the nodes were written to
+	vector<block_id_t> blocks;
+};
 
 class Node {
 public:
@@ -60,9 +82,18 @@ public:
 	//! Erase entry from node
 	static void Erase(ART &art, unique_ptr<Node> &node, index_t pos);
 
+	//! Write the node and all of its children to the writer, mapping the row ids of the leaves with the row map.
+	//! Returns a pointer to the serialized node, or INVALID_BLOCK if all rows of the node were deleted.
+	static BlockPointer Serialize(ART &art, unique_ptr<Node> &node, NodeWriteState &state);
+	//! Read a single node from the reader. The children of the node are not read until they are accessed, unless the
+	//! node has a single child: the node is then replaced by its child.
+	static unique_ptr<Node> Deserialize(ART &art, MetaBlockReader &reader);
+
 protected:
 	//! Copies the prefix from the source to the destination node
 	static void CopyPrefix(ART &art, Node *src, Node *dst);
+	//! Reads the node from storage if it has not been loaded yet, and returns it
+	static unique_ptr<Node> *Load(unique_ptr<Node> &node);
 };
 
 } // namespace duckdb
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/index/art/unloaded_node.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/index/art/node.hpp"
+
+namespace duckdb {
+
+//! An UnloadedNode takes the place of a node of a persisted ART that has not been read from storage yet. It is replaced
+//! by the actual node the first time it is accessed.
+class UnloadedNode : public Node {
+public:
+	UnloadedNode(ART &art, BlockPointer pointer);
+
+	//! The ART this node belongs to
+	ART &art;
+	//! The location of the serialized node
+	BlockPointer pointer;
+
+public:
+	//! Read the node from storage
+	unique_ptr<Node> Load();
+};
+
+} // namespace duckdb
@@ -14,7 +14,7 @@
 #include "duckdb/execution/aggregate_hashtable.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 
-#include <mutex>
+#include <atomic>
 
 namespace duckdb {
 
@@ -30,6 +30,13 @@ namespace duckdb {
    [POINTER]
    [POINTER]
    The pointers are either NULL
+   The HT is constructed in two phases. Build only materializes the incoming
+   tuples into Nodes, which means multiple threads can each build their own
+   JoinHashTable without synchronization, after which the Nodes are combined
+   with Merge. Finalize then creates the hash map of pointers and inserts every
+   tuple into it; the insertion uses atomic compare-and-swap on the hash map, so
+   it can be split over multiple threads with InitializePointerTable and
+   InsertNodes.
 */
 class JoinHashTable {
 public:
@@ -99,15 +106,26 @@ private:
 	void Hash(DataChunk &keys, Vector &hashes);
 
 public:
-	JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type,
-	              index_t initial_capacity = 32768, bool parallel = false);
-	//! Resize the HT to the specified size. Must be larger than the current
-	//! size.
-	void Resize(index_t size);
-	//! Add the given data to the HT
+	JoinHashTable(vector<JoinCondition> &conditions, vector<TypeId> build_types, JoinType type);
+	//! Add the given data to the HT. The data is only materialized, it can be found by Probe after Finalize has been
+	//! called.
 	void Build(DataChunk &keys, DataChunk &input);
+	//! Move the materialized data of another HT (built with the same conditions) into this HT
+	void Merge(JoinHashTable &other);
+	//! Create the hash map and insert all the materialized data into it
+	void Finalize();
+	//! Allocate an empty hash map that is large enough for all the materialized data
+	void InitializePointerTable();
+	//! Insert the data of every partition_count-th node, starting at the node with index partition, into the hash map.
+	//! Can be called concurrently for different partitions after InitializePointerTable.
+	void InsertNodes(index_t partition, index_t partition_count);
 	//! Probe the HT with the given input chunk, resulting in the given result
 	unique_ptr<ScanStructure> Probe(DataChunk &keys);
+	//! Compute the radix partition of every row of the given keys, i.e. the upper partition_bits bits of the hash of
+	//! the equality keys. Rows of the build and probe side with the same keys end up in the same partition.
+	void ComputePartitions(DataChunk &keys, index_t partition_bits, index_t partitions[]);
+	//! Returns true if the given keys contain a NULL value in a comparison in which NULL values are not equal
+	bool KeysContainNull(DataChunk &keys);
 
 	//! The stringheap of the JoinHashTable
 	StringHeap string_heap;
@@ -115,6 +133,10 @@ public:
 	index_t size() {
 		return count;
 	}
+	//! The amount of nodes holding the materialized data
+	index_t NodeCount() {
+		return node_count;
+	}
 
 	//! The types of the keys used in equality comparison
 	vector<TypeId> equality_types;
@@ -161,21 +183,18 @@ private:
 	//! Apply a bitmask to the hashes
 	void ApplyBitmask(Vector &hashes);
 	//! Insert the given set of locations into the HT with the given set of
-	//! hashes. Caller should hold lock in parallel HT.
+	//! hashes. Safe to call from multiple threads at the same time.
 	void InsertHashes(Vector &hashes, data_ptr_t key_locations[]);
-	//! The capacity of the HT. This can be increased using
-	//! JoinHashTable::Resize
+	//! The capacity of the hash map
 	index_t capacity;
 	//! The amount of entries stored in the HT currently
 	index_t count;
 	//! The data of the HT
 	unique_ptr<Node> head;
+	//! The amount of nodes in the linked list starting at head
+	index_t node_count;
 	//! The hash map of the HT
-	unique_ptr<data_ptr_t[]> hashed_pointers;
-	//! Whether or not the HT has to support parallel build
-	bool parallel = false;
-	//! Mutex used for parallelism
-	std::mutex parallel_lock;
+	unique_ptr<std::atomic<data_ptr_t>[]> hashed_pointers;
 	//! Whether or not NULL values are considered equal in each of the comparisons
 	vector<bool> null_values_are_equal;
 
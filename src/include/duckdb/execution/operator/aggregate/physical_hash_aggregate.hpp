@@ -9,14 +9,20 @@
 #pragma once
 
 #include "duckdb/execution/aggregate_hashtable.hpp"
-#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/physical_sink.hpp"
 #include "duckdb/storage/data_table.hpp"
 
 namespace duckdb {
 
+class HashAggregateGlobalState;
+struct AggregateSpillState;
+
 //! PhysicalHashAggregate is an group-by and aggregate implementation that uses
-//! a hash table to perform the grouping
-class PhysicalHashAggregate : public PhysicalOperator {
+//! a hash table to perform the grouping. When run in parallel every thread pre-aggregates its input in a thread-local
+//! hash table, which are then partitioned and merged in parallel in Finalize. When a hash table reaches the memory
+//! limit of the buffer manager, the rows of groups that are not in the hash table yet are spilled to radix partitions
+//! instead, which are aggregated one at a time while the result is scanned.
+class PhysicalHashAggregate : public PhysicalSink {
 public:
 	PhysicalHashAggregate(vector<TypeId> types, vector<unique_ptr<Expression>> expressions,
 	                      PhysicalOperatorType type = PhysicalOperatorType::HASH_GROUP_BY);
@@ -32,8 +38,27 @@ public:
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
-
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ClientContext &context) override;
+	void Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
+	void Finalize(ClientContext &context, GlobalOperatorState &state) override;
+
+private:
+	//! Aggregate the given groups and payload in the HT
+	void AddChunk(SuperLargeHashTable &ht, DataChunk &group_chunk, DataChunk &payload_chunk);
+	//! Aggregate the given groups and payload in the HT, or spill them if the HT has reached the memory limit
+	void AddChunk(HashAggregateGlobalState &gstate, SuperLargeHashTable &ht, AggregateSpillState &spill,
+	              DataChunk &group_chunk, DataChunk &payload_chunk);
+	//! Move the spilled input of a HT to the global state
+	void CollectSpilledInput(HashAggregateGlobalState &gstate, AggregateSpillState &spill);
+	//! Aggregate the spilled input of a finalized HT into the HT
+	void AggregateSpilledInput(HashAggregateGlobalState &gstate, index_t ht_index);
+	//! Get the types of the groups and of the payload (the inputs of the aggregates)
+	void GetPayloadTypes(vector<TypeId> &group_types, vector<TypeId> &payload_types,
+	                     vector<BoundAggregateExpression *> &aggregate_kind);
 };
 
 } // namespace duckdb
@@ -8,13 +8,13 @@
 
 #pragma once
 
-#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/physical_sink.hpp"
 
 namespace duckdb {
 
 //! PhysicalSimpleAggregate is an aggregate operator that can only perform aggregates (1) without any groups, and (2)
 //! without any DISTINCT aggregates
-class PhysicalSimpleAggregate : public PhysicalOperator {
+class PhysicalSimpleAggregate : public PhysicalSink {
 public:
 	PhysicalSimpleAggregate(vector<TypeId> types, vector<unique_ptr<Expression>> expressions);
 
@@ -23,8 +23,12 @@ public:
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
-
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ClientContext &context) override;
 };
 
 } // namespace duckdb
@@ -23,5 +23,10 @@ public:
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+
+	bool IsStreaming() const override {
+		return true;
+	}
+	bool ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 };
 } // namespace duckdb
@@ -28,6 +28,9 @@ public:
 
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
 
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+
 	string ExtraRenderInformation() const override;
 };
 
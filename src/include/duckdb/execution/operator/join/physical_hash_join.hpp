@@ -15,6 +15,9 @@
 #include "duckdb/planner/operator/logical_join.hpp"
 
 namespace duckdb {
+class HashJoinGlobalState;
+class HashJoinLocalState;
+class PhysicalHashJoinOperatorState;
 
 //! PhysicalHashJoin represents a hash loop join between two tables
 class PhysicalHashJoin : public PhysicalComparisonJoin {
@@ -22,11 +25,51 @@ public:
 	PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
 	                 vector<JoinCondition> cond, JoinType join_type);
 
-	unique_ptr<JoinHashTable> hash_table;
+	//! The types of the duplicate eliminated columns, only set for a correlated MARK join
+	vector<TypeId> delim_types;
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	//! The probe side of the join is streamed through the HT, except when the build side was spilled (see
+	//! CanProbeInParallel)
+	bool IsStreaming() const override {
+		return true;
+	}
+	bool ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
+	void Finalize(ClientContext &context, GlobalOperatorState &state) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ClientContext &context) override;
+
+	//! Whether or not the join can be probed by multiple threads at the same time, only valid after the build side
+	//! has been finalized
+	bool CanProbeInParallel();
+
+private:
+	//! Build the HT (if it has not been built yet) and initialize the state for probing it
+	void InitializeProbe(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Radix partition the keys and data of the right side over the thread-local partitions, spilling partitions to
+	//! the buffer manager when they exceed the memory limit
+	void SinkPartitioned(HashJoinGlobalState &gstate, HashJoinLocalState &lstate, DataChunk &input);
+	//! Build the HT from the partitions that were kept in memory by every thread, and collect the spilled partitions
+	void FinalizePartitions(HashJoinGlobalState &gstate);
+	//! Build the HT of a spilled partition
+	unique_ptr<JoinHashTable> BuildPartition(HashJoinGlobalState &gstate, index_t partition_idx);
+
+	//! Fetch the next chunk of the left side and compute its join keys, returns false if the left side is exhausted
+	bool FetchChunk(ClientContext &context, PhysicalHashJoinOperatorState &state);
+	//! Compute the join keys of the chunk of the left side in the state
+	void ResolveJoinKeys(PhysicalHashJoinOperatorState &state);
+	//! Fetch the next chunk to probe if the build side was spilled, returns the HT to probe it with or nullptr if the
+	//! join is finished
+	JoinHashTable *FetchPartitionedChunk(ClientContext &context, HashJoinGlobalState &gstate,
+	                                     PhysicalHashJoinOperatorState &state);
+	//! Probe the HT with the current chunk of the state
+	void ProbeHashTable(JoinHashTable &hash_table, PhysicalHashJoinOperatorState &state, DataChunk &chunk);
 };
 
 } // namespace duckdb
@@ -8,13 +8,14 @@
 
 #pragma once
 
-#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/physical_sink.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 
 namespace duckdb {
 
-//! PhysicalJoin represents the base class of the join operators
-class PhysicalJoin : public PhysicalOperator {
+//! PhysicalJoin represents the base class of the join operators. The right side of the join is materialized by
+//! sinking it into the join.
+class PhysicalJoin : public PhysicalSink {
 public:
 	PhysicalJoin(LogicalOperator &op, PhysicalOperatorType type, JoinType join_type);
 
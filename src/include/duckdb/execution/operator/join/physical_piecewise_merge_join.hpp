@@ -25,6 +25,10 @@ public:
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Finalize(ClientContext &context, GlobalOperatorState &state) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
 };
 
 } // namespace duckdb
@@ -9,17 +9,18 @@
 #pragma once
 
 #include "duckdb/common/types/chunk_collection.hpp"
-#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/physical_sink.hpp"
 #include "duckdb/planner/bound_query_node.hpp"
 
 namespace duckdb {
 
 //! Represents a physical ordering of the data. Note that this will not change
-//! the data but only add a selection vector.
-class PhysicalOrder : public PhysicalOperator {
+//! the data but only add a selection vector. Every thread sorts the normalized keys of its own input into a sorted
+//! run, the runs are merged once all input has been collected.
+class PhysicalOrder : public PhysicalSink {
 public:
 	PhysicalOrder(vector<TypeId> types, vector<BoundOrderByNode> orders)
-	    : PhysicalOperator(PhysicalOperatorType::ORDER_BY, move(types)), orders(move(orders)) {
+	    : PhysicalSink(PhysicalOperatorType::ORDER_BY, move(types)), orders(move(orders)) {
 	}
 
 	vector<BoundOrderByNode> orders;
@@ -27,6 +28,12 @@ public:
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
+	void Finalize(ClientContext &context, GlobalOperatorState &state) override;
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ClientContext &context) override;
 };
 
 } // namespace duckdb
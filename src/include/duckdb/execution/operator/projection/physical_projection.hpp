@@ -25,6 +25,11 @@ public:
 
 public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+
+	bool IsStreaming() const override {
+		return true;
+	}
+	bool ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	string ExtraRenderInformation() const override;
 };
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/execution/physical_operator.hpp"
 #include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/parser/parsed_data/create_index_info.hpp"
@@ -43,6 +44,6 @@ public:
 	void GetChunkInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 
 private:
-	void CreateARTIndex();
+	void CreateARTIndex(IndexCatalogEntry &index);
 };
 } // namespace duckdb
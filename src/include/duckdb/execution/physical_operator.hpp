@@ -15,11 +15,13 @@
 #include "duckdb/parser/statement/select_statement.hpp"
 #include "duckdb/planner/expression.hpp"
 #include "duckdb/planner/logical_operator.hpp"
+#include "duckdb/parallel/parallel_state.hpp"
 
 namespace duckdb {
 class ClientContext;
 class ExpressionExecutor;
 class PhysicalOperator;
+class PhysicalSink;
 
 //! The current state/context of the operator. The PhysicalOperatorState is
 //! updated using the GetChunk function, and allows the caller to repeatedly
@@ -33,6 +35,9 @@ public:
 	//! Flag indicating whether or not the operator is finished [note: not all
 	//! operators use this flag]
 	bool finished;
+	//! Whether or not a streaming operator has more output for the chunk in child_chunk, i.e. whether Execute has to
+	//! be called again before the next chunk is fetched from the child
+	bool has_more_output;
 	//! DataChunk that stores data from the child of this operator
 	DataChunk child_chunk;
 	//! State of the child of this operator
@@ -47,6 +52,11 @@ public:
    GetChunk again on its child nodes. Every node in the operator chain has a
    state that is updated as GetChunk is called: PhysicalOperatorState (different
    operators subclass this state and add different properties).
+
+    Streaming operators (e.g. filters and projections) also implement Execute,
+   which transforms a single chunk of input into output. This allows a Pipeline
+   to fuse a chain of streaming operators into a single loop that pushes every
+   chunk of its source through the chain and into its sink.
 */
 class PhysicalOperator {
 public:
@@ -79,6 +89,21 @@ public:
 
 	void GetChunk(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state);
 
+	//! Whether or not this operator is a streaming operator, i.e. whether it can transform the chunks of its (first)
+	//! child one at a time using Execute
+	virtual bool IsStreaming() const {
+		return false;
+	}
+	//! Transforms the chunk of input in state->child_chunk into a chunk of output, only supported by streaming
+	//! operators. Returns true if the operator has more output for the same input, in which case Execute has to be
+	//! called again before the next chunk of input is placed in state->child_chunk. The operator can set
+	//! state->finished to indicate it does not need any more input.
+	virtual bool ExecuteInternal(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
+		throw NotImplementedException("Execute is not supported by this operator");
+	}
+
+	bool Execute(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state);
+
 	//! Create a new empty instance of the operator state
 	virtual unique_ptr<PhysicalOperatorState> GetOperatorState() {
 		return make_unique<PhysicalOperatorState>(children.size() == 0 ? nullptr : children[0].get());
@@ -88,11 +113,30 @@ public:
 		return "";
 	}
 
+	//! Whether or not this operator is a sink, i.e. whether it consumes (part of) its input before it can produce output
+	virtual bool IsSink() const {
+		return false;
+	}
+
+	//! Create the state that is shared between threads that scan this operator in parallel. Returns nullptr if the
+	//! operator cannot be used as the source of a parallel pipeline.
+	virtual unique_ptr<ParallelState> GetParallelState(ClientContext &context) {
+		return nullptr;
+	}
+	//! Make a (thread-local) operator state scan only the morsels handed out by the shared parallel state
+	virtual void SetParallelState(PhysicalOperatorState &state, ParallelState &parallel_state) {
+	}
+
 	//! The physical operator type
 	PhysicalOperatorType type;
 	//! The set of children of the operator
 	vector<unique_ptr<PhysicalOperator>> children;
 	//! The types returned by this physical operator
 	vector<TypeId> types;
+
+protected:
+	//! Implements GetChunkInternal of a streaming operator: pulls chunks from the child and transforms them using
+	//! ExecuteInternal until there is a chunk of output or the child is exhausted
+	void GetStreamingChunk(ClientContext &context, DataChunk &chunk, PhysicalOperatorState *state);
 };
 } // namespace duckdb
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// execution/physical_sink.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/physical_operator.hpp"
+
+namespace duckdb {
+
+//! The global state of a sink, shared between all threads that sink into the operator
+class GlobalOperatorState {
+public:
+	virtual ~GlobalOperatorState() {
+	}
+};
+
+//! The thread-local state of a sink
+class LocalSinkState {
+public:
+	virtual ~LocalSinkState() {
+	}
+};
+
+//! A PhysicalSink is an operator that consumes its (last) child fully before it can produce any output, e.g. the
+//! build side of a hash join or an aggregate. Sinks are the boundaries of the pipelines that are executed by the
+//! Executor: the input of a sink is pushed into it by the pipeline, possibly from multiple threads at the same time.
+class PhysicalSink : public PhysicalOperator {
+public:
+	PhysicalSink(PhysicalOperatorType type, vector<TypeId> types) : PhysicalOperator(type, types) {
+	}
+
+	//! The global sink state, (re)created every time the pipeline that feeds this sink is executed
+	unique_ptr<GlobalOperatorState> sink_state;
+
+public:
+	//! Sink a chunk of input into the sink. Can be called in parallel by different threads, each with its own local
+	//! state.
+	virtual void Sink(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) = 0;
+	//! Merge the local state of a thread into the global state, called once per thread after all its input is sunk
+	virtual void Combine(ClientContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	}
+	//! Called once on the global state after all threads have finished sinking their input
+	virtual void Finalize(ClientContext &context, GlobalOperatorState &state) {
+	}
+
+	virtual unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) {
+		return make_unique<GlobalOperatorState>();
+	}
+	virtual unique_ptr<LocalSinkState> GetLocalSinkState(ClientContext &context) {
+		return make_unique<LocalSinkState>();
+	}
+
+	bool IsSink() const override {
+		return true;
+	}
+
+protected:
+	//! Execute the pipeline that feeds this sink, if it has not been executed yet for the current query
+	void ExecutePipeline(ClientContext &context);
+};
+
+} // namespace duckdb
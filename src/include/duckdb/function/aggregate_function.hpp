@@ -27,24 +27,28 @@ typedef void (*aggregate_finalize_t)(Vector &state, Vector &result);
 typedef Value (*aggregate_simple_initialize_t)();
 //! The type used for updating simple aggregate functions
 typedef void (*aggregate_simple_update_t)(Vector inputs[], index_t input_count, Value &result);
+//! The type used for combining simple aggregate values, i.e. merging "state" into "combined" (optional)
+typedef void (*aggregate_simple_combine_t)(Value &state, Value &combined);
 
 class AggregateFunction : public SimpleFunction {
 public:
 	AggregateFunction(string name, vector<SQLType> arguments, SQLType return_type, aggregate_size_t state_size,
 	                  aggregate_initialize_t initialize, aggregate_update_t update, aggregate_combine_t combine,
 	                  aggregate_finalize_t finalize, aggregate_simple_initialize_t simple_initialize = nullptr,
-	                  aggregate_simple_update_t simple_update = nullptr)
+	                  aggregate_simple_update_t simple_update = nullptr,
+	                  aggregate_simple_combine_t simple_combine = nullptr)
 	    : SimpleFunction(name, arguments, return_type, false), state_size(state_size), initialize(initialize),
 	      update(update), combine(combine), finalize(finalize), simple_initialize(simple_initialize),
-	      simple_update(simple_update) {
+	      simple_update(simple_update), simple_combine(simple_combine) {
 	}
 
 	AggregateFunction(vector<SQLType> arguments, SQLType return_type, aggregate_size_t state_size,
 	                  aggregate_initialize_t initialize, aggregate_update_t update, aggregate_combine_t combine,
 	                  aggregate_finalize_t finalize, aggregate_simple_initialize_t simple_initialize = nullptr,
-	                  aggregate_simple_update_t simple_update = nullptr)
+	                  aggregate_simple_update_t simple_update = nullptr,
+	                  aggregate_simple_combine_t simple_combine = nullptr)
 	    : AggregateFunction(string(), arguments, return_type, state_size, initialize, update, combine, finalize,
-	                        simple_initialize, simple_update) {
+	                        simple_initialize, simple_update, simple_combine) {
 	}
 
 	//! The hashed aggregate state sizing function
@@ -62,6 +66,8 @@ public:
 	aggregate_simple_initialize_t simple_initialize;
 	//! The simple aggregate update function (may be null)
 	aggregate_simple_update_t simple_update;
+	//! The simple aggregate combine function (may be null)
+	aggregate_simple_combine_t simple_combine;
 
 	bool operator==(const AggregateFunction &rhs) const {
 		return state_size == rhs.state_size && initialize == rhs.initialize && update == rhs.update &&
@@ -16,6 +16,8 @@
 #include "duckdb/common/unordered_set.hpp"
 #include "duckdb/main/prepared_statement.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/storage/buffer/query_memory.hpp"
+#include <atomic>
 #include <random>
 
 namespace duckdb {
@@ -34,13 +36,18 @@ public:
 	DuckDB &db;
 	//! Data for the currently running transaction
 	TransactionContext transaction;
-	//! Whether or not the query is interrupted
-	bool interrupted;
+	//! Whether or not the query is interrupted, checked by all threads that execute the query
+	std::atomic<bool> interrupted;
 	//! Whether or not the ClientContext has been invalidated because the underlying database is destroyed
 	bool is_invalidated = false;
 	//! Lock on using the ClientContext in parallel
 	std::mutex context_lock;
 
+	//! The memory reserved by the operators of the currently running query
+	QueryMemory query_memory;
+	//! The maximum amount of memory (in bytes) a query of this client can reserve
+	index_t query_memory_limit;
+
 	ExecutionContext execution_context;
 
 	Catalog &catalog;
@@ -10,6 +10,7 @@
 
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/storage/storage_info.hpp"
 
 namespace duckdb {
 class StorageManager;
@@ -17,6 +18,7 @@ class Catalog;
 class TransactionManager;
 class ConnectionManager;
 class FileSystem;
+class TaskScheduler;
 
 enum class AccessMode : uint8_t {
 	UNDEFINED = 0,
@@ -37,17 +39,42 @@ public:
 	AccessMode access_mode = AccessMode::AUTOMATIC;
 	// Checkpoint when WAL reaches this size
 	index_t checkpoint_wal_size = 1 << 20;
-	//! Whether or not to use Direct IO, bypassing operating system buffers
+	//! Whether or not a background thread checkpoints the database while it is in use, whenever the WAL reaches
+	//! checkpoint_wal_size (or checkpoint_interval has passed)
+	bool background_checkpoint = false;
+	//! The interval (in milliseconds) after which the background thread checkpoints the database if the WAL is not
+	//! empty, regardless of the size of the WAL. Default: 0 (only checkpoint based on the WAL size)
+	index_t checkpoint_interval = 0;
+	//! The time (in microseconds) that a committing transaction waits before syncing the WAL, giving other
+	//! transactions the chance to commit and be synced together with it. Default: 0 (the transactions that commit
+	//! while the WAL is being synced are still synced together afterwards)
+	index_t wal_group_commit_window = 0;
+	//! Whether or not to use Direct IO for the database file and the temporary files, bypassing operating system
+	//! buffers. The blocks are then only cached by the buffer manager instead of also being cached by the operating
+	//! system. File systems that do not support Direct IO fall back to regular IO.
 	bool use_direct_io = false;
+	//! Whether or not to memory-map the database file when it is opened in read-only mode. The blocks of the file are
+	//! then used directly from the mapping instead of being read into the buffer manager, and the operating system
+	//! decides which parts of the file are kept in memory. Processes that open the same file share this memory.
+	bool use_mmap = false;
+	//! When the checksums of the blocks read from the database file are verified. Default: every time a block is read
+	ChecksumVerification checksum_verification = ChecksumVerification::ALWAYS;
 	//! The FileSystem to use, can be overwritten to allow for injecting custom file systems for testing purposes (e.g.
 	//! RamFS or something similar)
 	unique_ptr<FileSystem> file_system;
 	//! The maximum memory used by the database system (in bytes). Default: Infinite
 	index_t maximum_memory = (index_t)-1;
+	//! The maximum memory a single query can reserve for its intermediates (in bytes), a query that needs more memory
+	//! than this spills to disk or fails. Can be changed per connection with PRAGMA query_memory_limit. Default:
+	//! Infinite
+	index_t maximum_query_memory = (index_t)-1;
 	//! Whether or not to create and use a temporary directory to store intermediates that do not fit in memory
 	bool use_temporary_directory = true;
 	//! Directory to store temporary structures that do not fit in memory
 	string temporary_directory;
+	//! The amount of threads used to execute queries, including the thread that issues the query. Default: 1 (serial
+	//! execution)
+	index_t maximum_threads = 1;
 
 private:
 	// FIXME: don't set this as a user: used internally (only for now)
@@ -69,13 +96,21 @@ public:
 	unique_ptr<Catalog> catalog;
 	unique_ptr<TransactionManager> transaction_manager;
 	unique_ptr<ConnectionManager> connection_manager;
+	unique_ptr<TaskScheduler> scheduler;
 
 	AccessMode access_mode;
 	bool use_direct_io;
+	bool use_mmap;
+	ChecksumVerification checksum_verification;
 	bool checkpoint_only;
 	index_t checkpoint_wal_size;
+	bool background_checkpoint;
+	index_t checkpoint_interval;
+	index_t wal_group_commit_window;
 	index_t maximum_memory;
+	index_t maximum_query_memory;
 	string temporary_directory;
+	index_t maximum_threads;
 
 private:
 	void Configure(DBConfig &config);
@@ -16,6 +16,7 @@
 #include "duckdb/common/enums/profiler_format.hpp"
 
 #include <stack>
+#include <thread>
 #include <unordered_map>
 
 namespace duckdb {
@@ -49,7 +50,7 @@ private:
 	static string RenderTree(TreeNode &node);
 
 public:
-	QueryProfiler() : automatic_print_format(ProfilerPrintFormat::NONE), enabled(false) {
+	QueryProfiler() : automatic_print_format(ProfilerPrintFormat::NONE), enabled(false), peak_memory(0) {
 	}
 
 	void Enable() {
@@ -66,6 +67,10 @@ public:
 
 	void StartQuery(string query);
 	void EndQuery();
+	//! Set the highest amount of memory (in bytes) that the operators of the query had reserved at the same time
+	void SetPeakMemory(index_t peak) {
+		peak_memory = peak;
+	}
 
 	void StartPhase(string phase);
 	void EndPhase();
@@ -96,12 +101,16 @@ private:
 
 	//! The timer used to time the execution time of the entire query
 	Profiler main_query;
+	//! The peak memory reserved by the query (in bytes)
+	index_t peak_memory;
 	//! The timer used to time the execution time of the individual Physical Operators
 	Profiler op;
 	//! A map of a Physical Operator pointer to a tree node
 	unordered_map<PhysicalOperator *, TreeNode *> tree_map;
 	//! The stack of Physical Operators that are currently active
 	std::stack<PhysicalOperator *> execution_stack;
+	//! The thread that issued the query. Operators executed by other (worker) threads are not profiled.
+	std::thread::id query_thread;
 
 	//! The timer used to time the individual phases of the planning process
 	Profiler phase_profiler;
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// optimizer/table_filter_pushdown.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+
+namespace duckdb {
+class Expression;
+class LogicalGet;
+class LogicalOperator;
+
+//! The TableFilterPushdown pushes comparisons of numeric columns with constants into the table scan, where they are
+//! used to skip segments based on their min/max statistics
+class TableFilterPushdown {
+public:
+	//! Push the filters directly on top of base table scans into the scans
+	unique_ptr<LogicalOperator> Optimize(unique_ptr<LogicalOperator> node);
+
+private:
+	unique_ptr<LogicalOperator> PushdownFilters(unique_ptr<LogicalOperator> op);
+	//! Try to push the filter expression into the scan, returns true if successful
+	bool PushdownFilter(LogicalGet &get, Expression &expr);
+};
+
+} // namespace duckdb
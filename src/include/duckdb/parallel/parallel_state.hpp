@@ -0,0 +1,21 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// parallel/parallel_state.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace duckdb {
+
+//! The ParallelState is the state that is shared between all threads that scan the same source operator in parallel
+//! (e.g. the position of the next morsel to hand out)
+class ParallelState {
+public:
+	virtual ~ParallelState() {
+	}
+};
+
+} // namespace duckdb
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// parallel/pipeline.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/physical_sink.hpp"
+#include "duckdb/parallel/parallel_state.hpp"
+#include "duckdb/parallel/task.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+class Executor;
+
+//! A Pipeline is a chain of streaming operators that ends in a sink, e.g. SEQ_SCAN -> FILTER -> HASH_JOIN (probe) ->
+//! HASH_GROUP_BY. The pipeline is executed by one or more tasks that each fetch chunks from the source of the chain,
+//! push them through the streaming operators in a single loop and sink the result. If the source can be split into
+//! morsels, the tasks are executed in parallel by the threads of the TaskScheduler.
+class Pipeline {
+	friend class PipelineTask;
+
+public:
+	Pipeline(Executor &executor, PhysicalSink &sink);
+	~Pipeline();
+
+	Executor &executor;
+	//! The sink of the pipeline
+	PhysicalSink &sink;
+	//! The operator that produces the input of the sink (nullptr if the sink has no input)
+	PhysicalOperator *child;
+	//! The operator that produces the chunks that are pushed through the pipeline, only set once the pipeline is
+	//! executed
+	PhysicalOperator *source;
+	//! The streaming operators between the source and the sink, ordered from the source to the sink
+	vector<PhysicalOperator *> operators;
+
+public:
+	//! Execute the pipeline, if it has not been executed yet
+	void Execute();
+
+	bool IsFinished() {
+		return finished;
+	}
+
+private:
+	//! Push all chunks of the source through the chain and into the sink (executed by every task of the pipeline)
+	void ExecuteTask(ParallelState *parallel_state);
+	//! Determine the source and the streaming operators of the chain. The hash joins that are probed within the chain
+	//! are built first.
+	void BuildChain();
+	//! Whether or not the chain can be executed by multiple threads at the same time
+	bool CanExecuteInParallel();
+	//! The priority of the tasks of the pipeline: pipelines that scan large tables get a lower priority than short
+	//! pipelines
+	TaskPriority GetTaskPriority();
+
+	//! Whether or not the pipeline has been executed
+	bool finished;
+	//! Set when one of the tasks has failed, the remaining tasks stop as soon as possible
+	std::atomic<bool> error;
+};
+
+} // namespace duckdb
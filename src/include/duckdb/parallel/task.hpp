@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// parallel/task.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+
+//! The priority of a task: the threads of the TaskScheduler pick up the queued tasks with the highest priority first
+enum class TaskPriority : uint8_t { LOW = 0, NORMAL = 1, HIGH = 2 };
+
+//! Generic parallel task, executed by one of the threads of the TaskScheduler
+class Task {
+public:
+	virtual ~Task() {
+	}
+
+	//! Execute the task. Any exceptions should be handled by the task itself: the worker threads of the TaskScheduler
+	//! cannot propagate them.
+	virtual void Execute() = 0;
+};
+
+} // namespace duckdb
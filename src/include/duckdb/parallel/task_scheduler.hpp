@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// parallel/task_scheduler.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/parallel/task.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define TASK_PRIORITY_COUNT 3
+
+namespace duckdb {
+
+//! The queue of tasks of a single worker thread, with a separate deque for every priority
+struct WorkerQueue {
+	//! Lock protecting the deques
+	std::mutex lock;
+	//! The queued tasks of every priority. The owner of the queue takes tasks from the back, other threads steal
+	//! tasks from the front.
+	std::deque<unique_ptr<Task>> tasks[TASK_PRIORITY_COUNT];
+};
+
+//! The TaskScheduler is responsible for managing the worker threads of the database. Every worker thread has its own
+//! queue of tasks: tasks scheduled by a worker are pushed into its own queue, tasks scheduled by other threads are
+//! distributed over the queues of the workers. A thread that runs out of work steals tasks from the queues of the
+//! other threads. Tasks with a higher priority are always picked up first. Threads that are waiting for tasks to
+//! finish (e.g. the thread that executes a query) help out by executing queued tasks of at least the same priority.
+class TaskScheduler {
+public:
+	TaskScheduler();
+	~TaskScheduler();
+
+	//! Schedule a task to be executed by the worker threads
+	void ScheduleTask(unique_ptr<Task> task, TaskPriority priority = TaskPriority::NORMAL);
+	//! Execute a single queued task with at least the given priority on the calling thread. Returns false if there
+	//! were no tasks available.
+	bool ExecuteTask(TaskPriority minimum_priority = TaskPriority::LOW);
+	//! Execute a set of tasks and wait for all of them to finish. The first task is executed by the calling thread, the
+	//! remaining tasks are scheduled for the worker threads with the given priority. While waiting, the calling thread
+	//! executes queued tasks itself. If any of the tasks throws an exception, the first exception is rethrown after all
+	//! tasks have finished. Once a task has failed or the interrupted flag is set, the tasks that have not started
+	//! yet are skipped.
+	void ExecuteTasks(vector<unique_ptr<Task>> tasks, TaskPriority priority = TaskPriority::NORMAL,
+	                  std::atomic<bool> *interrupted = nullptr);
+
+	//! Sets the total amount of threads used for query execution, including the thread that issues the query. A value
+	//! of 1 means no background threads are used and all queries are executed serially.
+	void SetThreads(index_t n);
+	//! Returns the total amount of threads used for query execution
+	index_t NumberOfThreads();
+
+private:
+	//! Main loop of the background worker threads, the worker stops once the thread generation is no longer the
+	//! generation it was started in
+	void ExecuteForever(index_t worker_idx, index_t generation);
+	//! Fetch a task with at least the given priority from the queues (if any), preferring the queue of the calling
+	//! thread
+	unique_ptr<Task> FetchTask(TaskPriority minimum_priority);
+	//! Stop and join all background threads, the threads lock must be held by the caller
+	void StopThreads();
+
+	//! The queues of the worker threads. The set of queues is fixed, if there are more workers than queues some
+	//! workers share a queue.
+	vector<unique_ptr<WorkerQueue>> queues;
+	//! The amount of queued tasks of every priority
+	std::atomic<index_t> queued_tasks[TASK_PRIORITY_COUNT];
+	//! The amount of background worker threads
+	std::atomic<index_t> worker_count;
+	//! Used to distribute the tasks scheduled by non-worker threads over the queues
+	std::atomic<index_t> next_queue;
+
+	//! Lock serializing the changes to the set of threads (SetThreads and the destructor)
+	std::mutex threads_lock;
+	//! Lock protecting the set of threads, and held by idle worker threads while waiting for tasks
+	std::mutex scheduler_lock;
+	//! Condition variable used to signal the idle worker threads that a task (or the shutdown signal) is available
+	std::condition_variable queue_signal;
+	//! The background worker threads
+	vector<std::thread> threads;
+	//! The generation of the background worker threads, incremented to make the current threads shut down
+	std::atomic<index_t> thread_generation;
+};
+
+} // namespace duckdb
@@ -10,6 +10,7 @@
 
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/enums/index_type.hpp"
+#include "duckdb/parser/parsed_expression.hpp"
 
 namespace duckdb {
 
@@ -20,6 +21,11 @@ struct CreateIndexInfo {
 	string index_name;
 	////! If it is an unique index
 	bool unique = false;
+	//! The schema and name of the indexed table
+	string schema;
+	string table;
+	//! The (unbound) expressions to index by
+	vector<unique_ptr<ParsedExpression>> expressions;
 
 	//! Ignore if the entry already exists, instead of failing
 	bool if_not_exists = false;
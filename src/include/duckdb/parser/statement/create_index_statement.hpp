@@ -18,6 +18,13 @@ namespace duckdb {
 class CreateIndexStatement : public SQLStatement {
 public:
 	CreateIndexStatement() : SQLStatement(StatementType::CREATE_INDEX), info(make_unique<CreateIndexInfo>()){};
+	//! Create a statement that recreates the index described by the info
+	CreateIndexStatement(unique_ptr<CreateIndexInfo> info_p)
+	    : SQLStatement(StatementType::CREATE_INDEX), table(make_unique<BaseTableRef>()),
+	      expressions(move(info_p->expressions)), info(move(info_p)) {
+		table->schema_name = info->schema;
+		table->table_name = info->table;
+	}
 
 	//! The table to create the index on
 	unique_ptr<BaseTableRef> table;
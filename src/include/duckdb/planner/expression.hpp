@@ -26,6 +26,9 @@ public:
 	bool IsScalar() const override;
 	bool HasParameter() const override;
 	virtual bool IsFoldable() const;
+	//! Whether or not the expression has side effects (e.g. random()), in which case it cannot be evaluated from
+	//! multiple threads in parallel
+	virtual bool HasSideEffects() const;
 
 	uint64_t Hash() const override;
 
@@ -30,6 +30,7 @@ public:
 
 public:
 	bool IsFoldable() const override;
+	bool HasSideEffects() const override;
 	string ToString() const override;
 
 	uint64_t Hash() const override;
@@ -10,6 +10,7 @@
 
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/planner/logical_operator.hpp"
+#include "duckdb/planner/table_filter.hpp"
 
 namespace duckdb {
 
@@ -31,6 +32,8 @@ public:
 	index_t table_index;
 	//! Bound column IDs
 	vector<column_t> column_ids;
+	//! The filters that are pushed into the scan
+	vector<TableFilter> table_filters;
 
 	string ParamsToString() const override {
 		if (!table) {
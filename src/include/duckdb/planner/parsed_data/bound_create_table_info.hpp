@@ -11,6 +11,7 @@
 #include "duckdb/parser/parsed_data/create_table_info.hpp"
 #include "duckdb/planner/bound_constraint.hpp"
 #include "duckdb/planner/expression.hpp"
+#include "duckdb/storage/block.hpp"
 #include "duckdb/storage/table/persistent_segment.hpp"
 
 namespace duckdb {
@@ -31,6 +32,10 @@ struct BoundCreateTableInfo {
 	unordered_set<CatalogEntry *> dependencies;
 	//! The existing table data on disk (if any)
 	unique_ptr<vector<unique_ptr<PersistentSegment>>[]> data;
+	//! The rows of the table data on disk that are deleted (if any)
+	vector<row_t> deleted_rows;
+	//! The root nodes of the indexes of the UNIQUE constraints on disk (if any)
+	vector<BlockPointer> indexes;
 	//! The base create table info
 	unique_ptr<CreateTableInfo> base;
 };
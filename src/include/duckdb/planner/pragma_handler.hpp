@@ -28,6 +28,10 @@ private:
 	ClientContext &context;
 
 private:
-	void ParseMemoryLimit(string limit);
+	//! Parses a memory limit with a unit (e.g. 1GB) into an amount of bytes, a negative limit is returned as infinite
+	//! ((index_t)-1)
+	index_t ParseMemoryLimit(string limit);
+	//! Parses the parameter of a memory limit PRAGMA (e.g. PRAGMA memory_limit='1GB')
+	index_t ParseMemoryLimitPragma(PragmaStatement &pragma);
 };
 } // namespace duckdb
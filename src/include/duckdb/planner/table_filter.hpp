@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// planner/table_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/enums/expression_type.hpp"
+#include "duckdb/common/types/value.hpp"
+
+namespace duckdb {
+
+//! TableFilter represents a comparison of a column with a constant that is pushed into a table scan
+class TableFilter {
+public:
+	TableFilter(Value constant, ExpressionType comparison_type, index_t column_index)
+	    : constant(constant), comparison_type(comparison_type), column_index(column_index) {
+	}
+
+	//! The constant the column is compared with
+	Value constant;
+	//! The comparison type (=, <, <=, > or >=), with the column on the left side
+	ExpressionType comparison_type;
+	//! The index of the column in the column_ids of the scan
+	index_t column_index;
+};
+
+} // namespace duckdb
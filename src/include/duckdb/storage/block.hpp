@@ -17,8 +17,16 @@ namespace duckdb {
 class Block : public FileBuffer {
 public:
 	Block(block_id_t id);
+	//! Creates a block that refers to the content of the block in a memory-mapped database file
+	Block(block_id_t id, data_ptr_t internal_buffer);
 
 	block_id_t id;
 };
 
+//! A BlockPointer points to a location within a (meta) block on disk
+struct BlockPointer {
+	block_id_t block_id;
+	uint32_t offset;
+};
+
 } // namespace duckdb
@@ -23,10 +23,34 @@ public:
 	virtual unique_ptr<Block> CreateBlock() = 0;
 	//! Return the next free block id
 	virtual block_id_t GetFreeBlockId() = 0;
+	//! Mark a block that was written by a previous checkpoint as used by the checkpoint that is currently being
+	//! written, so that the block is not freed when the checkpoint completes
+	virtual void MarkBlockAsUsed(block_id_t block_id) = 0;
 	//! Get the first meta block id
 	virtual block_id_t GetMetaBlock() = 0;
+	//! Get the iteration count of the active database header
+	virtual uint64_t GetIteration() = 0;
+	//! Get the position of the checkpoint marker in the WAL of the active database header
+	virtual index_t GetWALOffset() = 0;
 	//! Read the content of the block from disk
 	virtual void Read(Block &block) = 0;
+	//! Read the content of multiple blocks from disk, the blocks are sorted by their id. Implementations can merge the
+	//! reads of adjacent blocks into a single request.
+	virtual void Read(vector<unique_ptr<Block>> &blocks) {
+		for (auto &block : blocks) {
+			Read(*block);
+		}
+	}
+	//! Returns whether or not the blocks are read from disk when they are used, in which case reading them ahead of
+	//! time can hide the latency of the reads
+	virtual bool CanPrefetch() {
+		return false;
+	}
+	//! Returns a block that refers directly to the content of the block in a memory mapping of the database file, or
+	//! nullptr if the file is not mapped. The content of the returned block cannot be modified.
+	virtual unique_ptr<Block> GetMappedBlock(block_id_t block_id) {
+		return nullptr;
+	}
 	//! Writes the block to disk
 	virtual void Write(FileBuffer &block, block_id_t block_id) = 0;
 	//! Writes the block to disk
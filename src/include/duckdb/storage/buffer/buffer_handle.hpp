@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "duckdb/common/common.hpp"
 #include "duckdb/storage/storage_info.hpp"
 
 namespace duckdb {
@@ -17,6 +18,9 @@ class FileBuffer;
 class BufferHandle {
 public:
 	BufferHandle(BufferManager &manager, block_id_t block_id, FileBuffer *node);
+	//! Creates a handle that owns a block which is not managed by the buffer manager (e.g. a block of a memory-mapped
+	//! database file)
+	BufferHandle(BufferManager &manager, block_id_t block_id, unique_ptr<FileBuffer> owned_node);
 	~BufferHandle();
 
 	BufferManager &manager;
@@ -24,6 +28,10 @@ public:
 	block_id_t block_id;
 	//! The managed buffer node
 	FileBuffer *node;
+
+private:
+	//! The node owned by this handle, if it is not managed by the buffer manager
+	unique_ptr<FileBuffer> owned_node;
 };
 
 } // namespace duckdb
@@ -13,7 +13,8 @@
 namespace duckdb {
 
 struct BufferEntry {
-	BufferEntry(unique_ptr<FileBuffer> buffer) : buffer(move(buffer)), ref_count(1), prev(nullptr) {
+	BufferEntry(unique_ptr<FileBuffer> buffer)
+	    : buffer(move(buffer)), ref_count(1), reused(false), prefetched(false), prev(nullptr) {
 	}
 	~BufferEntry() {
 		while (next) {
@@ -25,6 +26,10 @@ struct BufferEntry {
 	unique_ptr<FileBuffer> buffer;
 	//! The amount of references to this entry
 	index_t ref_count;
+	//! Whether or not the entry has been pinned again after it was unpinned
+	bool reused;
+	//! Whether or not the entry was loaded ahead of time and has not been pinned yet
+	bool prefetched;
 	//! Next node
 	unique_ptr<BufferEntry> next;
 	//! Prev entry
@@ -43,6 +48,10 @@ public:
 	unique_ptr<BufferEntry> Erase(BufferEntry *entry);
 	//! Insert an entry to the back of the list
 	void Append(unique_ptr<BufferEntry> entry);
+	//! Returns the amount of entries in the list
+	index_t Count() {
+		return count;
+	}
 
 private:
 	//! Root pointer
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/buffer/query_memory.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+class BufferManager;
+
+//! QueryMemory keeps track of the memory that the operators of the currently running query have reserved in the buffer
+//! manager. Reservations are denied when they would exceed either the memory limit of the query or the memory limit of
+//! the buffer manager, in which case the operator has to spill its data (or fail the query) instead.
+class QueryMemory {
+public:
+	QueryMemory(BufferManager &manager);
+
+	//! Start accounting for a new query that can reserve up to the given amount of memory (in bytes)
+	void Reset(index_t limit = (index_t)-1);
+
+	//! Try to reserve the given amount of memory (in bytes), returns false if the reservation is denied
+	bool TryReserve(index_t size);
+	//! Release memory that was reserved with TryReserve
+	void Release(index_t size);
+
+	//! Returns the amount of memory the query can use: the lowest of the query and buffer manager limits, or
+	//! INVALID_INDEX if neither of them has a limit
+	index_t GetLimit();
+	//! Returns the amount of memory that is currently reserved by the query (in bytes)
+	index_t GetReserved() {
+		return reserved;
+	}
+	//! Returns the highest amount of memory that was reserved at the same time by the query (in bytes)
+	index_t GetPeak() {
+		return peak;
+	}
+
+private:
+	//! The buffer manager the memory is reserved in
+	BufferManager &manager;
+	//! The maximum amount of memory the query can reserve
+	index_t limit;
+	//! The amount of memory that is currently reserved
+	std::atomic<index_t> reserved;
+	//! The highest amount of memory that was reserved at the same time
+	std::atomic<index_t> peak;
+};
+
+//! A MemoryReservation holds the memory reserved by (a single thread of) an operator. The reservation is resized as
+//! the data of the operator grows and shrinks, and the memory is released when the reservation is destroyed.
+class MemoryReservation {
+public:
+	MemoryReservation(QueryMemory &memory) : memory(memory), size(0) {
+	}
+	~MemoryReservation();
+
+	//! Try to resize the reservation to the given amount of memory (in bytes), returns false if growing the reservation
+	//! is denied. Shrinking the reservation always succeeds.
+	bool TryResize(index_t new_size);
+	//! Resize the reservation to the given amount of memory (in bytes), throws an OutOfMemoryException if growing the
+	//! reservation is denied
+	void Resize(index_t new_size);
+	//! Move the memory reserved by another reservation of the same query into this reservation
+	void Merge(MemoryReservation &other);
+
+	//! Returns the amount of memory held by the reservation (in bytes)
+	index_t GetSize() {
+		return size;
+	}
+
+private:
+	QueryMemory &memory;
+	index_t size;
+};
+
+} // namespace duckdb
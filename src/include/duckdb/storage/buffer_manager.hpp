@@ -15,17 +15,50 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/unordered_map.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
 
 namespace duckdb {
 
 //! The buffer manager is in charge of handling memory management for the database. It hands out memory buffers that can
 //! be used by the database internally.
+//!
+//! The loaded blocks and buffers are divided over a number of shards based on their id, each with its own lock, so
+//! concurrent pins of different blocks rarely contend. Blocks are evicted with a scan-resistant policy: unpinned blocks
+//! that have only been used once since they were loaded (such as the blocks of a large sequential scan) are evicted
+//! before blocks that were pinned again after they had been unpinned.
+//!
+//! Blocks that are about to be used can be announced with Prefetch, after which a background thread loads them into
+//! the memory that is not in use yet.
 class BufferManager {
 	friend class BufferHandle;
+	//! The amount of shards the blocks and buffers are divided over
+	static constexpr index_t SHARD_COUNT = 16;
+	//! The maximum amount of blocks the prefetch thread loads at once
+	static constexpr index_t PREFETCH_BATCH_SIZE = 64;
+	//! The maximum amount of blocks that can wait to be prefetched, blocks announced beyond this are not prefetched
+	static constexpr index_t PREFETCH_QUEUE_SIZE = 1024;
+
+	//! A subset of the blocks and buffers held by the buffer manager
+	struct BufferShard {
+		//! The lock protecting the shard
+		std::mutex lock;
+		//! A mapping of block id -> BufferEntry
+		unordered_map<block_id_t, BufferEntry *> blocks;
+		//! A linked list of buffer entries that are in use
+		BufferList used_list;
+		//! LRU list of unused blocks that have been used once since they were loaded, these are evicted first
+		BufferList probation;
+		//! LRU list of unused blocks that were pinned again after they had been unpinned
+		BufferList protected_list;
+	};
 
 public:
-	BufferManager(FileSystem &fs, BlockManager &manager, string temp_directory, index_t maximum_memory);
+	BufferManager(FileSystem &fs, BlockManager &manager, string temp_directory, index_t maximum_memory,
+	              bool use_direct_io);
 	~BufferManager();
 
 	//! Pin a block id, returning a block handle holding a pointer to the block
@@ -38,23 +71,50 @@ public:
 	//! Destroy the managed buffer with the specified buffer_id, freeing its memory
 	void DestroyBuffer(block_id_t buffer_id, bool can_destroy = false);
 
+	//! Announce blocks that are about to be pinned, e.g. the blocks of the segments a scan reaches next. The blocks are
+	//! loaded in the background, reading adjacent blocks with a single request. Prefetching only uses memory that is
+	//! not in use: it never evicts other blocks.
+	void Prefetch(vector<block_id_t> &block_ids);
+
 	//! Set a new memory limit to the buffer manager, throws an exception if the new limit is too low and not enough
 	//! blocks can be evicted
 	void SetLimit(index_t limit = (index_t)-1);
+	//! Returns the maximum amount of memory that the buffer manager can keep (in bytes)
+	index_t GetLimit() {
+		return maximum_memory;
+	}
+
+	//! Reserve memory (in bytes) that is allocated outside of the buffer manager, e.g. by the hash tables of a query.
+	//! Blocks are evicted to make room for the reservation if required. Returns false (without reserving anything) if
+	//! not enough blocks can be evicted to stay within the memory limit.
+	bool TryReserveMemory(index_t size);
+	//! Release memory that was reserved with TryReserveMemory
+	void FreeReservedMemory(index_t size);
+	//! Returns the amount of memory that is currently reserved with TryReserveMemory (in bytes)
+	index_t GetReservedMemory() {
+		return reserved_memory;
+	}
 
 private:
+	BufferShard &GetShard(block_id_t block_id) {
+		return shards[block_id % SHARD_COUNT];
+	}
+
 	unique_ptr<BufferHandle> PinBlock(block_id_t block_id);
 	unique_ptr<BufferHandle> PinBuffer(block_id_t block_id, bool can_destroy = false);
 
 	//! Unpin a block id, decreasing its reference count and potentially allowing it to be freed.
 	void Unpin(block_id_t block);
 
-	//! Evict the least recently used block from the buffer manager, or throws an exception if there are no blocks
-	//! available to evict
+	//! Reserve the given amount of memory, evicting blocks until the memory limit is no longer exceeded. Returns one of
+	//! the evicted blocks (if any), which can be reused to hold another block. No shard lock can be held by the caller.
+	unique_ptr<Block> ReserveMemory(index_t size);
+	//! Evict the least valuable unused block from one of the shards, or throws an exception if there are no blocks
+	//! available to evict. No shard lock can be held by the caller.
 	unique_ptr<Block> EvictBlock();
 
 	//! Add a reference to the refcount of a buffer entry
-	void AddReference(BufferEntry *entry);
+	void AddReference(BufferShard &shard, BufferEntry *entry);
 
 	//! Write a temporary buffer to disk
 	void WriteTemporaryBuffer(ManagedBuffer &buffer);
@@ -65,25 +125,43 @@ private:
 
 	void DeleteTemporaryFile(block_id_t id);
 
+	//! The main loop of the prefetch thread
+	void PrefetchBlocks();
+	//! Load the given blocks into the buffer manager without pinning them, skipping blocks that are already loaded
+	void LoadBlocks(vector<block_id_t> block_ids);
+
 private:
 	FileSystem &fs;
 	//! The block manager
 	BlockManager &manager;
 	//! The current amount of memory that is occupied by the buffer manager (in bytes)
-	index_t current_memory;
+	std::atomic<index_t> current_memory;
+	//! The part of the current memory that is reserved for memory allocated outside of the buffer manager (in bytes)
+	std::atomic<index_t> reserved_memory;
 	//! The maximum amount of memory that the buffer manager can keep (in bytes)
-	index_t maximum_memory;
+	std::atomic<index_t> maximum_memory;
 	//! The directory name where temporary files are stored
 	string temp_directory;
-	//! The lock for the set of blocks
-	std::mutex block_lock;
-	//! A mapping of block id -> BufferEntry
-	unordered_map<block_id_t, BufferEntry *> blocks;
-	//! A linked list of buffer entries that are in use
-	BufferList used_list;
-	//! LRU list of unused blocks
-	BufferList lru;
+	//! Whether or not the temporary files are written and read with Direct IO, bypassing operating system buffers
+	bool use_direct_io;
+	//! The shards of the loaded blocks and buffers
+	BufferShard shards[SHARD_COUNT];
+	//! The shard the next eviction starts looking for a block to evict
+	std::atomic<index_t> evict_shard;
+	//! Lock held while a temporary buffer is read back from disk, so it is only read once
+	std::mutex temporary_load_lock;
 	//! The temporary id used for managed buffers
-	block_id_t temporary_id;
+	std::atomic<block_id_t> temporary_id;
+
+	//! Lock protecting the prefetch queue
+	std::mutex prefetch_lock;
+	//! Signals the prefetch thread that blocks have been announced, or that it has to stop
+	std::condition_variable prefetch_signal;
+	//! The announced blocks that have not been prefetched yet
+	std::deque<block_id_t> prefetch_queue;
+	//! Whether or not the prefetch thread has to stop
+	bool stop_prefetch;
+	//! The thread that loads the announced blocks, started when blocks are announced for the first time
+	std::thread prefetch_thread;
 };
 } // namespace duckdb
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/checkpoint/row_id_map.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//! The RowIdMap maps the row ids of a table to the row ids the rows get when the table is written to disk. The deleted
+//! rows of the table are not written, so any rows after a deleted row move up.
+struct RowIdMap {
+	RowIdMap() : row_end(0), compacted(true) {
+	}
+
+	//! The row ids of the deleted rows, in ascending order
+	vector<row_t> deleted_rows;
+	//! The row id after the last row that was written, all rows after it were deleted as well
+	row_t row_end;
+	//! Whether the deleted rows were removed from the table. If not, they are written as deleted rows and the other
+	//! rows keep their row id.
+	bool compacted;
+
+	//! Returns the row id of the row after it has been written, or INVALID_ROW if the row was deleted
+	row_t Map(row_t row_id) const {
+		if (row_id >= row_end) {
+			return INVALID_ROW;
+		}
+		auto entry = std::lower_bound(deleted_rows.begin(), deleted_rows.end(), row_id);
+		if (entry != deleted_rows.end() && *entry == row_id) {
+			return INVALID_ROW;
+		}
+		return compacted ? row_id - (entry - deleted_rows.begin()) : row_id;
+	}
+
+	static constexpr row_t INVALID_ROW = -1;
+};
+
+} // namespace duckdb
@@ -10,26 +10,58 @@
 
 #include "duckdb/storage/checkpoint_manager.hpp"
 #include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/checkpoint/row_id_map.hpp"
+
+#include <mutex>
 
 namespace duckdb {
 class UncompressedSegment;
+class PersistentSegment;
 class SegmentStatistics;
+class Task;
+class WriteOverflowStringsToDisk;
 
-//! The table data writer is responsible for writing the data of a table to the block manager
+//! The table data writer is responsible for writing the data of a table to the block manager. If the row ids of the
+//! table are unchanged by the checkpoint, the persistent segments that have not been modified are reused and only the
+//! modified and appended rows are written. The columns of the table are written independently, and can be written
+//! concurrently.
 class TableDataWriter {
 public:
 	TableDataWriter(CheckpointManager &manager, TableCatalogEntry &table);
 	~TableDataWriter();
 
-	void WriteTableData(Transaction &transaction);
+	//! Prepare the writer and create the tasks that write the columns of the table
+	void ScheduleTasks(Transaction &transaction, vector<unique_ptr<Task>> &tasks);
+	//! Write the data of a single column of the table
+	void WriteColumn(Transaction &transaction, index_t col_idx);
+	//! Write the data pointers of the written columns to the table data of the checkpoint, should be called after all
+	//! columns have been written
+	void WriteDataPointers();
+
+	//! Maps the row ids of the table to the row ids of the written rows, used to write the indexes of the table
+	RowIdMap row_map;
 
 private:
+	//! Write all (visible) rows of the column, compacting away the deleted rows
+	void WriteAllRows(Transaction &transaction, index_t col_idx);
+	//! Write the modified and appended rows of the column, reusing its unmodified persistent segments
+	void WriteChangedRows(Transaction &transaction, index_t col_idx);
+	//! Append the rows [start_row, end_row) of either the persistent or the transient part of the column to the current
+	//! segment of the column
+	void WriteRows(Transaction &transaction, index_t col_idx, index_t start_row, index_t end_row, bool persistent);
+	//! Write the data pointer of an unmodified persistent segment, keeping its blocks
+	void ReuseSegment(index_t col_idx, PersistentSegment &segment);
+
 	void AppendData(index_t col_idx, Vector &data);
 
 	void CreateSegment(index_t col_idx);
 	void FlushSegment(index_t col_idx);
-
-	void WriteDataPointers();
+	//! Compress the segment of the given column into the current compressed block, returns false if the segment
+	//! cannot be compressed
+	bool FlushCompressedSegment(index_t col_idx, data_ptr_t segment_data, DataPointer &data_pointer);
+	//! Write the current compressed block to disk
+	void FlushCompressedBlock();
 
 private:
 	CheckpointManager &manager;
@@ -37,8 +69,28 @@ private:
 
 	vector<unique_ptr<UncompressedSegment>> segments;
 	vector<unique_ptr<SegmentStatistics>> stats;
+	//! The writers of the big strings of the VARCHAR columns, shared by the segments of the column
+	vector<unique_ptr<WriteOverflowStringsToDisk>> overflow_writers;
 
 	vector<vector<DataPointer>> data_pointers;
+	//! Whether or not all rows of the table are rewritten, instead of only the modified and appended rows
+	bool rewrite_all;
+	//! The amount of rows of the table that are contained in the checkpoint
+	index_t row_count;
+	//! The rows that are written but deleted, if the row ids of the table are kept intact by the checkpoint
+	vector<row_t> deleted_rows;
+
+	//! The buffers that the segments of every column are compressed into before they are copied into the compressed
+	//! block
+	vector<unique_ptr<data_t[]>> compression_buffers;
+	//! Lock protecting the compressed block, which is shared by the columns of the table
+	std::mutex compressed_lock;
+	//! The buffer of the block that compressed segments are currently packed into
+	unique_ptr<BufferHandle> compressed_handle;
+	//! The block id of the current compressed block
+	block_id_t compressed_block_id;
+	//! The offset within the current compressed block
+	index_t compressed_offset;
 };
 
 } // namespace duckdb
@@ -10,34 +10,50 @@
 
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 class ClientContext;
+class IndexCatalogEntry;
+struct RowIdMap;
 class MetaBlockReader;
 class SchemaCatalogEntry;
 class SequenceCatalogEntry;
 class TableCatalogEntry;
+class TableDataWriter;
 class ViewCatalogEntry;
 
 struct DataPointer {
-	double min;
-	double max;
+	//! The minimum and maximum value of the segment, stored in the physical type of the column (numeric columns only)
+	data_t min[8];
+	data_t max[8];
 	uint64_t row_start;
 	uint64_t tuple_count;
 	block_id_t block_id;
 	uint32_t offset;
+	//! Whether or not the segment is stored in compressed form (see CompressedNumericSegment)
+	bool compressed;
+	//! The blocks holding the big strings of the segment (string columns only)
+	vector<block_id_t> overflow_blocks;
 };
 
 //! CheckpointManager is responsible for checkpointing the database
 class CheckpointManager {
 public:
 	CheckpointManager(StorageManager &manager);
+	~CheckpointManager();
 
-	//! Checkpoint the current state of the WAL and flush it to the main storage. This should be called BEFORE any
-	//! connction is available because right now the checkpointing cannot be done online. (TODO)
-	void CreateCheckpoint();
+	//! Checkpoint the current state of the WAL and flush it to the main storage. This is called when the database is
+	//! started, BEFORE any connection is available, and removes the deleted rows from the tables. The checkpoint
+	//! contains the WAL up to the checkpoint marker at the given position.
+	void CreateCheckpoint(index_t wal_offset);
+	//! Checkpoint the database while it is in use. The checkpoint contains the changes of the transactions that
+	//! committed before it started, and keeps the row ids of the tables intact so the changes that are written to the
+	//! WAL in the meantime still apply to it. Returns the position of the checkpoint marker in the WAL, the part of the
+	//! WAL before the marker is contained in the checkpoint.
+	index_t CreateOnlineCheckpoint();
 	//! Load from a stored checkpoint
 	void LoadFromStorage();
 
@@ -51,17 +67,32 @@ public:
 	unique_ptr<MetaBlockWriter> metadata_writer;
 	//! The table data writer is responsible for writing the DataPointers used by the table chunks
 	unique_ptr<MetaBlockWriter> tabledata_writer;
+	//! Whether or not the row ids of the tables are kept intact by the checkpoint: the deleted rows are stored as
+	//! deleted rows instead of being removed from the tables
+	bool keep_row_ids;
 
 private:
+	//! The writers of the data of the tables of the checkpoint, the data of the tables is written before the metadata
+	unordered_map<TableCatalogEntry *, unique_ptr<TableDataWriter>> table_writers;
+
+private:
+	//! Write the checkpoint of the database as seen by the given transaction, the given position of the checkpoint
+	//! marker in the WAL is stored in the header
+	void WriteCheckpoint(Transaction &transaction, index_t wal_offset);
+	//! Write the data of all tables of the given schemas, the columns are written concurrently by the threads of the
+	//! task scheduler
+	void WriteTableData(Transaction &transaction, vector<SchemaCatalogEntry *> &schemas);
 	void WriteSchema(Transaction &transaction, SchemaCatalogEntry &schema);
-	void WriteTable(Transaction &transaction, TableCatalogEntry &table);
+	void WriteTable(Transaction &transaction, TableCatalogEntry &table, vector<IndexCatalogEntry *> &indexes);
 	void WriteView(ViewCatalogEntry &table);
 	void WriteSequence(SequenceCatalogEntry &table);
+	void WriteIndex(IndexCatalogEntry &index, RowIdMap &row_map);
 
 	void ReadSchema(ClientContext &context, MetaBlockReader &reader);
 	void ReadTable(ClientContext &context, MetaBlockReader &reader);
 	void ReadView(ClientContext &context, MetaBlockReader &reader);
 	void ReadSequence(ClientContext &context, MetaBlockReader &reader);
+	void ReadIndex(ClientContext &context, MetaBlockReader &reader);
 };
 
 } // namespace duckdb
@@ -38,6 +38,8 @@ public:
 public:
 	//! Initialize a scan of the column
 	void InitializeScan(ColumnScanState &state);
+	//! Initialize a scan of the column starting at the vector that contains the given row
+	void InitializeScanWithOffset(ColumnScanState &state, index_t row_idx);
 	//! Scan the next vector from the column
 	void Scan(Transaction &transaction, ColumnScanState &state, Vector &result);
 	//! Scan the next vector from the column, throwing an exception if there are any outstanding updates
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// storage/compressed_numeric_segment.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/storage/numeric_segment.hpp"
+
+namespace duckdb {
+
+//! The lightweight compression methods that can be used for a vector of a CompressedNumericSegment
+enum class NumericCompression : uint8_t {
+	//! The values are stored as-is
+	UNCOMPRESSED = 0,
+	//! Run-length encoding: the values are stored as (value, run length) pairs
+	RLE = 1,
+	//! Frame-of-reference: the values are stored as bit-packed offsets from the minimum value
+	BITPACKING = 2,
+	//! The differences between consecutive values are stored as bit-packed offsets from the minimum difference
+	DELTA = 3
+};
+
+//! A CompressedNumericSegment is a persistent numeric segment that is stored in compressed form, possibly sharing
+//! its block with other compressed segments.
+/*!
+    The segments are compressed when they are written to disk by a checkpoint. Every vector of the segment is
+   compressed separately, using the compression method that results in the smallest size for the range and the runs
+   of its values. A vector is decompressed straight into the result vector when it is scanned. The first time the
+   segment is updated it is converted into a regular (uncompressed) NumericSegment in a temporary buffer.
+*/
+class CompressedNumericSegment : public NumericSegment {
+public:
+	CompressedNumericSegment(BufferManager &manager, TypeId type, index_t row_start, block_id_t block_id,
+	                         index_t offset);
+
+	//! The offset of the compressed data within the block
+	index_t offset;
+
+public:
+	//! Fetch a single value and append it to the vector
+	void FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result) override;
+	//! Decompress the segment into a temporary buffer
+	void ToTemporary() override;
+
+	//! Returns whether or not segments of the given type can be compressed
+	static bool SupportsType(TypeId type);
+	//! Compress the contents of the buffer of an (uncompressed) NumericSegment into the target. Returns the size of the
+	//! compressed data, or INVALID_INDEX if it does not fit in the given capacity.
+	static index_t Compress(TypeId type, data_ptr_t source, index_t tuple_count, data_ptr_t target, index_t capacity);
+
+protected:
+	void FetchBaseData(ColumnScanState &state, index_t vector_index, Vector &result) override;
+
+private:
+	//! Decompress a single vector of the segment
+	void DecompressVector(data_ptr_t segment_data, index_t vector_index, data_ptr_t result, nullmask_t &nullmask);
+};
+
+} // namespace duckdb
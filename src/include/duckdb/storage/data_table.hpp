@@ -59,6 +59,15 @@ public:
 	// elements were returned.
 	void Scan(Transaction &transaction, DataChunk &result, TableScanState &state);
 
+	//! Initialize a parallel scan over the table. The rows of the table are handed out in ranges of
+	//! STORAGE_CHUNK_SIZE rows by NextParallelScan.
+	void InitializeParallelScan(ParallelTableScanState &state);
+	//! Fetch the next row range of a parallel scan and initialize the scan state to scan (only) that range with
+	//! DataTable::Scan. Returns false if there are no ranges left. Calls for the same ParallelTableScanState have to
+	//! be serialized by the caller.
+	bool NextParallelScan(Transaction &transaction, ParallelTableScanState &state, TableScanState &scan_state,
+	                      const vector<column_t> &column_ids);
+
 	//! Initialize an index scan with a single predicate and a comparison type (= <= < > >=)
 	void InitializeIndexScan(Transaction &transaction, TableIndexScanState &state, Index &index, Value value,
 	                         ExpressionType expr_type, vector<column_t> column_ids);
@@ -101,6 +110,20 @@ public:
 	//! Is this a temporary table?
 	bool IsTemporary();
 
+	//! Returns whether or not all rows of the table are visible to the transaction, i.e. whether none of the rows
+	//! have been deleted or appended by a transaction that is not visible to it
+	bool AllRowsVisible(Transaction &transaction);
+	//! Returns the amount of rows of the table that were committed before the transaction started
+	index_t GetCommittedRows(Transaction &transaction);
+	//! Adds the row ids of the first [row_count] rows of the table that are deleted for the transaction to the list
+	void GetDeletedRows(Transaction &transaction, index_t row_count, vector<row_t> &deleted_rows);
+	//! Returns the first segment of the given column, the other segments of the column follow through its next pointer
+	ColumnSegment *GetRootSegment(column_t column);
+	//! Initialize the scan state to scan the rows [start_row, end_row) of either the persistent or the transient part
+	//! of the table
+	void InitializeScanWithOffset(TableScanState &state, const vector<column_t> &column_ids, index_t start_row,
+	                              index_t end_row, bool persistent);
+
 private:
 	//! Verify constraints with a chunk from the Append containing all columns of the table
 	void VerifyAppendConstraints(TableCatalogEntry &table, DataChunk &chunk);
@@ -112,6 +135,8 @@ private:
 
 	bool ScanBaseTable(Transaction &transaction, DataChunk &result, TableScanState &state, index_t &current_row,
 	                   index_t max_row, index_t base_row, VersionManager &manager);
+	//! Returns false if the segments that are currently scanned cannot contain any rows that pass the table filters
+	bool CheckZonemap(TableScanState &state);
 	bool ScanCreateIndex(CreateIndexScanState &state, DataChunk &result, index_t &current_row, index_t max_row,
 	                     index_t base_row);
 
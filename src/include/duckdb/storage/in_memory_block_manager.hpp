@@ -23,9 +23,18 @@ public:
 	block_id_t GetFreeBlockId() override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
+	void MarkBlockAsUsed(block_id_t block_id) override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
 	block_id_t GetMetaBlock() override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
+	uint64_t GetIteration() override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
+	index_t GetWALOffset() override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
 	void Read(Block &block) override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
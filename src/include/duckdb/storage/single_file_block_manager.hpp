@@ -14,26 +14,47 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/unordered_set.hpp"
 
+#include <atomic>
+#include <mutex>
+
 namespace duckdb {
 class BufferManager;
 class FileBuffer;
 
-//! SingleFileBlockManager is an implementation for a BlockManager which manages blocks in a single file
+//! SingleFileBlockManager is an implementation for a BlockManager which manages blocks in a single file. Blocks can be
+//! allocated, read and written concurrently by multiple threads.
 class SingleFileBlockManager : public BlockManager {
 	//! The location in the file where the block writing starts
 	static constexpr uint64_t BLOCK_START = Storage::FILE_HEADER_SIZE * 3;
 
 public:
-	SingleFileBlockManager(FileSystem &fs, string path, bool read_only, bool create_new, bool use_direct_io);
+	SingleFileBlockManager(FileSystem &fs, string path, bool read_only, bool create_new, bool use_direct_io,
+	                       bool use_mmap = false,
+	                       ChecksumVerification checksum_verification = ChecksumVerification::ALWAYS);
+	~SingleFileBlockManager();
 
 	//! Creates a new Block and returns a pointer
 	unique_ptr<Block> CreateBlock() override;
 	//! Return the next free block id
 	block_id_t GetFreeBlockId() override;
+	//! Mark a block of the previous checkpoint as used by the current checkpoint
+	void MarkBlockAsUsed(block_id_t block_id) override;
 	//! Return the meta block id
 	block_id_t GetMetaBlock() override;
+	//! Return the iteration count of the active header
+	uint64_t GetIteration() override;
+	//! Return the position of the checkpoint marker in the WAL of the active header
+	index_t GetWALOffset() override;
 	//! Read the content of the block from disk
 	void Read(Block &block) override;
+	//! Read the content of multiple blocks from disk, adjacent blocks are read with a single request
+	void Read(vector<unique_ptr<Block>> &blocks) override;
+	//! Blocks can be prefetched unless they are used directly from the memory mapping of the file
+	bool CanPrefetch() override {
+		return !mapped_file;
+	}
+	//! Returns a block that refers to the memory mapping of the file (if the file is mapped)
+	unique_ptr<Block> GetMappedBlock(block_id_t block_id) override;
 	//! Write the given block to disk
 	void Write(FileBuffer &block, block_id_t block_id) override;
 	//! Write the header to disk, this is the final step of the checkpointing process
@@ -44,20 +65,31 @@ public:
 
 private:
 	void Initialize(DatabaseHeader &header);
+	//! Verify the checksum of a block that was read from disk, unless the verification mode skips the block
+	void VerifyBlock(Block &block);
 
 private:
+	FileSystem &fs;
 	//! The active DatabaseHeader, either 0 (h1) or 1 (h2)
 	uint8_t active_header;
 	//! The path where the file is stored
 	string path;
 	//! The file handle
 	unique_ptr<FileHandle> handle;
+	//! Lock protecting the file handle, reading or writing a block first moves the file pointer
+	std::mutex handle_lock;
+	//! Lock protecting the free list and the set of used blocks
+	std::mutex block_lock;
 	//! The buffer used to read/write to the headers
 	FileBuffer header_buffer;
 	//! The list of free blocks that can be written to currently
 	vector<block_id_t> free_list;
-	//! The list of blocks that are used by the current block manager
+	//! The blocks that are used by the checkpoint that is currently being written, all other blocks are free once the
+	//! header of the checkpoint is written
 	unordered_set<block_id_t> used_blocks;
+	//! The blocks that were in use when the database was loaded. The tables can keep reading from these blocks while
+	//! the database is running, so they are never reused during this session (but they can be freed on disk)
+	unordered_set<block_id_t> loaded_blocks;
 	//! The current meta block id
 	block_id_t meta_block;
 	//! The current maximum block id, this id will be given away first after the free_list runs out
@@ -66,9 +98,24 @@ private:
 	block_id_t free_list_id;
 	//! The current header iteration count
 	uint64_t iteration_count;
+	//! The position of the checkpoint marker in the WAL of the current header
+	index_t wal_offset;
 	//! Whether or not the db is opened in read-only mode
 	bool read_only;
 	//! Whether or not to use Direct IO to read the blocks
 	bool use_direct_io;
+	//! The memory mapping of the database file, only used in read-only mode (nullptr if the file is not mapped)
+	data_ptr_t mapped_file;
+	//! The size of the memory mapping
+	index_t mapped_size;
+	//! Whether or not the checksum of each mapped block has been verified, this happens the first time it is used
+	unique_ptr<std::atomic<bool>[]> verified_mapped_blocks;
+	//! When the checksums of the blocks that are read are verified
+	ChecksumVerification checksum_verification;
+	//! Lock protecting the set of verified blocks
+	std::mutex verified_lock;
+	//! The blocks whose checksum has been verified since the database was opened, only used when the checksums are
+	//! verified on the first read
+	unordered_set<block_id_t> verified_blocks;
 };
 } // namespace duckdb
@@ -22,6 +22,17 @@ using block_id_t = int64_t;
 // maximum block id, 2^62
 #define MAXIMUM_BLOCK 4611686018427388000LL
 
+//! When the checksums of the blocks that are read from the database file are verified
+enum class ChecksumVerification : uint8_t {
+	//! Verify the checksum every time a block is read
+	ALWAYS = 0,
+	//! Verify the checksum only the first time a block is read after the database is opened (or after the block was
+	//! written), blocks that are evicted and read again are not verified again
+	FIRST_READ = 1,
+	//! Never verify the checksums, for storage that is trusted to detect corruption itself
+	NEVER = 2
+};
+
 //! The MainHeader is the first header in the storage file. The MainHeader is typically written only once for a database
 //! file.
 struct MainHeader {
@@ -45,6 +56,9 @@ struct DatabaseHeader {
 	//! The number of blocks that is in the file as of this database header. If the file is larger than BLOCK_SIZE *
 	//! block_count any blocks appearing AFTER block_count are implicitly part of the free_list.
 	uint64_t block_count;
+	//! The position of the checkpoint marker that was written to the WAL when the checkpoint started. The changes in
+	//! the WAL before the marker are contained in the checkpoint, and are skipped when the WAL is replayed.
+	uint64_t wal_offset;
 };
 
 } // namespace duckdb
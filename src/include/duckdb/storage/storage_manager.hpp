@@ -13,6 +13,10 @@
 #include "duckdb/storage/data_table.hpp"
 #include "duckdb/storage/write_ahead_log.hpp"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace duckdb {
 class BlockManager;
 class Catalog;
@@ -23,6 +27,10 @@ class TableCatalogEntry;
 //! StorageManager is responsible for managing the physical storage of the
 //! database on disk
 class StorageManager {
+	//! The interval (in milliseconds) at which the background checkpoint thread checks whether or not the database
+	//! needs to be checkpointed
+	static constexpr index_t BACKGROUND_CHECKPOINT_POLL_INTERVAL = 100;
+
 public:
 	StorageManager(DuckDB &database, string path, bool read_only);
 	~StorageManager();
@@ -37,6 +45,10 @@ public:
 	DuckDB &GetDatabase() {
 		return database;
 	}
+	//! Checkpoint the database while it is in use, and remove the checkpointed changes from the WAL
+	void CreateCheckpoint();
+	//! Stop the background checkpoint thread (if any), waiting for a running checkpoint to finish
+	void StopBackgroundCheckpoint();
 	//! The BlockManager to read/store meta information and data in blocks
 	unique_ptr<BlockManager> block_manager;
 	//! The BufferManager of the database
@@ -49,6 +61,8 @@ private:
 	void LoadDatabase();
 	//! Create a checkpoint of the database
 	void Checkpoint(string wal_path);
+	//! Main loop of the background checkpoint thread
+	void BackgroundCheckpoint();
 
 	//! The path of the database
 	string path;
@@ -57,6 +71,16 @@ private:
 
 	//! Whether or not the database is opened in read-only mode
 	bool read_only;
+
+	//! Lock ensuring that only one checkpoint is created at a time
+	std::mutex checkpoint_lock;
+	//! The background checkpoint thread (if any)
+	std::thread checkpoint_thread;
+	//! Lock and condition variable used to stop the background checkpoint thread
+	std::mutex background_lock;
+	std::condition_variable background_signal;
+	//! Whether or not the background checkpoint thread should stop
+	bool stop_background_checkpoint;
 };
 
 } // namespace duckdb
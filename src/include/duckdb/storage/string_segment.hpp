@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/storage/uncompressed_segment.hpp"
+#include "duckdb/common/unordered_map.hpp"
 
 namespace duckdb {
 class OverflowStringWriter {
@@ -57,8 +58,12 @@ public:
 	unique_ptr<StringBlock> head;
 	//! Blocks that hold string updates (if any)
 	unique_ptr<string_update_info_t[]> string_updates;
-	//! Overflow string writer (if any), if not set overflow strings will be written to memory blocks
-	unique_ptr<OverflowStringWriter> overflow_writer;
+	//! Overflow string writer (if any, not owned by the segment), if not set overflow strings will be written to memory
+	//! blocks
+	OverflowStringWriter *overflow_writer;
+	//! The dictionary offsets of the strings that have been appended (if any). If set, equal strings that are appended
+	//! to the segment share a single dictionary entry, and are returned by a scan as the same pointer.
+	unique_ptr<unordered_map<string, int32_t>> dictionary;
 
 public:
 	void InitializeScan(ColumnScanState &state) override;
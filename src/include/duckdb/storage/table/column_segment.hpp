@@ -12,6 +12,7 @@
 #include "duckdb/storage/table/segment_tree.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/enums/expression_type.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
@@ -44,6 +45,9 @@ public:
 
 public:
 	void Reset();
+	//! Returns false if none of the values in the segment can satisfy the comparison with the constant, based on the
+	//! minimum and maximum of the segment
+	bool CheckZonemap(ExpressionType comparison_type, Value &constant);
 };
 
 class ColumnSegment : public SegmentBase {
@@ -17,7 +17,8 @@ namespace duckdb {
 
 class PersistentSegment : public ColumnSegment {
 public:
-	PersistentSegment(BufferManager &manager, block_id_t id, index_t offset, TypeId type, index_t start, index_t count);
+	PersistentSegment(BufferManager &manager, block_id_t id, index_t offset, TypeId type, index_t start, index_t count,
+	                  bool compressed = false);
 
 	//! The buffer manager
 	BufferManager &manager;
@@ -25,6 +26,10 @@ public:
 	block_id_t block_id;
 	//! The offset into the block
 	index_t offset;
+	//! Whether or not the segment is stored in compressed form
+	bool compressed;
+	//! The blocks holding the big strings of the segment
+	vector<block_id_t> overflow_blocks;
 	//! The uncompressed segment that the data of the persistent segment is loaded into
 	unique_ptr<UncompressedSegment> data;
 
@@ -42,6 +47,10 @@ public:
 
 	//! Perform an update within the segment
 	void Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids) override;
+
+	//! Returns whether or not the segment has been modified since it was loaded, i.e. whether its data no longer
+	//! matches the contents of its block
+	bool IsModified();
 };
 
 } // namespace duckdb
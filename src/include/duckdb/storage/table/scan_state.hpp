@@ -18,6 +18,7 @@ class LocalTableStorage;
 class Index;
 class PersistentSegment;
 class TransientSegment;
+class TableFilter;
 
 struct IndexScanState {
 	vector<column_t> column_ids;
@@ -43,6 +44,8 @@ struct ColumnScanState {
 	vector<unique_ptr<StorageLockKey>> locks;
 	//! Whether or not InitializeState has been called for this segment
 	bool initialized;
+	//! The segments starting before this row have been announced to the buffer manager to be read ahead
+	index_t read_ahead_row;
 
 public:
 	//! Move on to the next vector in the scan
@@ -74,6 +77,18 @@ struct TableScanState {
 	sel_t sel_vector[STANDARD_VECTOR_SIZE];
 	vector<column_t> column_ids;
 	LocalScanState local_state;
+	//! The filters that are evaluated by the scan (if any)
+	vector<TableFilter> *table_filters = nullptr;
+	//! Whether or not the rows that are deleted for the transaction are scanned as well
+	bool scan_deleted_rows = false;
+};
+
+//! The shared state of a parallel table scan, from which the participating threads fetch disjoint row ranges
+struct ParallelTableScanState {
+	index_t current_persistent_row, max_persistent_row;
+	index_t current_transient_row, max_transient_row;
+	//! Whether or not the transaction-local data has been handed out
+	bool transaction_local_data;
 };
 
 struct CreateIndexScanState : public TableScanState {
@@ -49,6 +49,12 @@ public:
 	void Delete(Transaction &transaction, Vector &row_ids);
 	//! Append a set of rows to the version manager, setting their inserted id to the given commit_id
 	void Append(Transaction &transaction, row_t row_start, index_t count, transaction_t commit_id);
+	//! Returns whether or not all rows managed by the version manager are visible to the transaction
+	bool AllRowsVisible(Transaction &transaction);
+	//! Returns the amount of rows that were appended to the version manager before the transaction started
+	index_t GetCommittedRows(Transaction &transaction);
+	//! Adds the row ids of the first [row_count] rows that are deleted for the transaction to the given list
+	void GetDeletedRows(Transaction &transaction, index_t row_count, vector<row_t> &deleted_rows);
 
 private:
 	ChunkInsertInfo *GetInsertInfo(index_t chunk_idx);
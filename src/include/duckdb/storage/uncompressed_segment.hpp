@@ -77,7 +77,7 @@ public:
 
 	//! Convert a persistently backed uncompressed segment (i.e. one where block_id refers to an on-disk block) to a
 	//! temporary in-memory one
-	void ToTemporary();
+	virtual void ToTemporary();
 
 	//! Get the amount of tuples in a vector
 	index_t GetVectorCount(index_t vector_index) {
@@ -95,6 +95,9 @@ protected:
 	virtual void FetchUpdateData(ColumnScanState &state, Transaction &transaction, UpdateInfo *version,
 	                             Vector &result) = 0;
 
+	//! Pin the block of the segment for a scan. The block stays pinned in the scan state until the scan moves on to a
+	//! different block, so a scan pins (and uses) each block only once instead of once per vector
+	BufferHandle &PinForScan(ColumnScanState &state);
 	//! Create a new update info for the specified transaction reflecting an update of the specified rows
 	UpdateInfo *CreateUpdateInfo(ColumnData &data, Transaction &transaction, row_t *ids, index_t count,
 	                             index_t vector_index, index_t vector_offset, index_t type_size);
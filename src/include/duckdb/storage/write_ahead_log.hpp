@@ -14,11 +14,16 @@
 #include "duckdb/common/serializer/buffered_file_writer.hpp"
 #include "duckdb/catalog/catalog_entry/sequence_catalog_entry.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace duckdb {
 
 class BufferedSerializer;
 class Catalog;
 class DuckDB;
+class IndexCatalogEntry;
 class SchemaCatalogEntry;
 class SequenceCatalogEntry;
 class ViewCatalogEntry;
@@ -31,6 +36,10 @@ class TransactionManager;
 //! the database to the log, which can then be replayed upon startup in case the
 //! server crashes or is shut down.
 class WriteAheadLog {
+public:
+	//! The size of a checkpoint marker: the entry type, the iteration of the checkpoint and the flush
+	static constexpr index_t CHECKPOINT_MARKER_SIZE = sizeof(WALType) + sizeof(uint64_t) + sizeof(WALType);
+
 public:
 	WriteAheadLog(DuckDB &database);
 
@@ -53,6 +62,9 @@ public:
 	void WriteCreateView(ViewCatalogEntry *entry);
 	void WriteDropView(ViewCatalogEntry *entry);
 
+	void WriteCreateIndex(IndexCatalogEntry *entry);
+	void WriteDropIndex(IndexCatalogEntry *entry);
+
 	void WriteCreateSequence(SequenceCatalogEntry *entry);
 	void WriteDropSequence(SequenceCatalogEntry *entry);
 	void WriteSequenceValue(SequenceCatalogEntry *entry, SequenceValue val);
@@ -66,11 +78,50 @@ public:
 
 	void WriteQuery(string &query);
 
-	void Flush();
+	//! Write the marker of the checkpoint with the given header iteration. The changes before the marker are contained
+	//! in the checkpoint, and are skipped on replay once the header of the checkpoint has been written. Returns the
+	//! position of the marker; the marker has to be synced before the header is written.
+	index_t WriteCheckpoint(uint64_t iteration);
+	//! Append the marker of the checkpoint with the given header iteration to the WAL file at the given path and sync
+	//! it, returns the position of the marker
+	static index_t WriteCheckpoint(DuckDB &database, string &path, uint64_t iteration);
+
+	//! Write the changes of a committing transaction to the WAL file. The changes are not durable until Sync is
+	//! called with the returned position, which should happen after the transaction lock is released.
+	index_t Flush();
+	//! Sync the WAL file up to (at least) the given position. The transactions that wait for a sync are synced as a
+	//! group: one of them syncs the file for all of them (group commit).
+	void Sync(index_t position);
+	//! Returns the position up to which the WAL has been written during this session
+	index_t GetWrittenPosition() {
+		return written_position;
+	}
+
+	//! Returns the size of the WAL up to and including the last flushed commit
+	index_t GetWALSize() {
+		return wal_size;
+	}
+	//! Remove the first [size] bytes of the WAL, which have been written to a checkpoint. The remainder of the WAL
+	//! (starting with the marker of the checkpoint) is moved to the start of the file. Nothing can be written to the
+	//! WAL while it is truncated.
+	void Truncate(index_t size);
 
 private:
 	DuckDB &database;
 	unique_ptr<BufferedFileWriter> writer;
+	//! The path of the WAL file
+	string wal_path;
+	//! The size of the WAL file, read by the background checkpoints without holding the transaction lock
+	std::atomic<index_t> wal_size;
+	//! The amount of bytes written to the WAL during this session (including the bytes that were truncated since)
+	std::atomic<index_t> written_position;
+	//! The position up to which the WAL is synced to disk
+	index_t synced_position;
+	//! Whether or not a transaction is currently syncing the WAL for the group of waiting transactions
+	bool sync_in_progress;
+	//! Lock and condition variable protecting the sync state, the waiting transactions are woken up after a sync
+	std::mutex sync_lock;
+	std::condition_variable sync_signal;
 };
 
 } // namespace duckdb
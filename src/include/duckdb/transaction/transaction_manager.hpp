@@ -37,7 +37,18 @@ public:
 
 	//! Start a new transaction
 	Transaction *StartTransaction();
-	//! Commit the given transaction
+	//! Start the transaction of a checkpoint that runs while the database is in use. The marker of the checkpoint with
+	//! the given header iteration is written to the WAL together with the start of the transaction: the WAL before the
+	//! marker contains exactly the commits that are visible to the transaction. Returns the position of the (synced)
+	//! marker in wal_offset.
+	Transaction *StartCheckpointTransaction(uint64_t iteration, index_t &wal_offset);
+	//! Remove the first [wal_offset] bytes of the WAL after they have been written to a checkpoint, blocking any
+	//! commits while the WAL is truncated
+	void TruncateWAL(index_t wal_offset);
+	//! Commit the given transaction. The changes of the transaction become visible to other transactions as soon as
+	//! they are written to the WAL, before the WAL is synced: the commit is only durable once this function returns.
+	//! If syncing the WAL fails the changes can already have been read, so the commit cannot be undone: the database
+	//! is invalidated instead, and no more transactions can be started or committed.
 	void CommitTransaction(Transaction *transaction);
 	//! Rollback the given transaction
 	void RollbackTransaction(Transaction *transaction);
@@ -49,6 +60,8 @@ public:
 	}
 
 private:
+	//! Start a new transaction, the transaction lock must be held by the caller
+	Transaction *StartTransactionInternal();
 	//! Remove the given transaction from the list of active transactions
 	void RemoveTransaction(Transaction *transaction);
 
@@ -68,6 +81,8 @@ private:
 	vector<StoredCatalogSet> old_catalog_sets;
 	//! The lock used for transaction operations
 	std::mutex transaction_lock;
+	//! The error that invalidated the database (if any)
+	string invalidated_error;
 	//! The storage manager
 	StorageManager &storage;
 };
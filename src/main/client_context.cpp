@@ -18,12 +18,15 @@
 #include "duckdb/transaction/transaction_manager.hpp"
 #include "duckdb/transaction/transaction.hpp"
 #include "duckdb/parser/statement/deallocate_statement.hpp"
+#include "duckdb/storage/storage_manager.hpp"
 
 using namespace duckdb;
 using namespace std;
 
 ClientContext::ClientContext(DuckDB &database)
-    : db(database), transaction(*database.transaction_manager), interrupted(false), catalog(*database.catalog),
+    : db(database), transaction(*database.transaction_manager), interrupted(false),
+      query_memory(*database.storage->buffer_manager), query_memory_limit(database.maximum_query_memory),
+      execution_context(*this), catalog(*database.catalog),
       temporary_objects(make_unique<SchemaCatalogEntry>(db.catalog.get(), TEMP_SCHEMA)),
       prepared_statements(make_unique<CatalogSet>(*db.catalog)), open_result(nullptr) {
 	random_device rd;
@@ -76,9 +79,12 @@ unique_ptr<DataChunk> ClientContext::Fetch() {
 }
 
 string ClientContext::FinalizeQuery(bool success) {
+	profiler.SetPeakMemory(query_memory.GetPeak());
 	profiler.EndQuery();
 
+	// destroying the plan releases the memory reserved by its operators
 	execution_context.Reset();
+	assert(query_memory.GetReserved() == 0);
 
 	string error;
 	if (transaction.HasActiveTransaction()) {
@@ -183,8 +189,10 @@ unique_ptr<QueryResult> ClientContext::ExecuteStatementInternal(string query, un
 	profiler.EndPhase();
 
 	// store the physical plan in the context for calls to Fetch()
+	execution_context.Reset();
 	execution_context.physical_plan = move(physical_plan);
 	execution_context.physical_state = execution_context.physical_plan->GetOperatorState();
+	execution_context.executor.Initialize(*execution_context.physical_plan);
 
 	auto types = execution_context.physical_plan->GetTypes();
 	assert(types.size() == sql_types.size());
@@ -342,8 +350,9 @@ unique_ptr<QueryResult> ClientContext::ExecuteStatementsInternal(string query,
 			}
 			statement = move(copied_statement);
 		}
-		// start the profiler
+		// start the profiler and the memory accounting of the query
 		profiler.StartQuery(query);
+		query_memory.Reset(query_memory_limit);
 		try {
 			// run the actual query
 			current_result = ExecuteStatementInternal(query, move(statement), allow_stream_result && is_last_statement);
@@ -452,6 +461,8 @@ void ClientContext::Invalidate() {
 	if (open_result) {
 		open_result->is_open = false;
 	}
+	// the plan of the open result can hold memory reservations in the buffer manager of the database: release them
+	execution_context.Reset();
 }
 
 string ClientContext::VerifyQuery(string query, unique_ptr<SQLStatement> statement) {
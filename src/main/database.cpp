@@ -3,6 +3,7 @@
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/main/connection_manager.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/transaction/transaction_manager.hpp"
 
@@ -34,6 +35,8 @@ DuckDB::DuckDB(const char *path, DBConfig *config) {
 	catalog = make_unique<Catalog>(*storage);
 	transaction_manager = make_unique<TransactionManager>(*storage);
 	connection_manager = make_unique<ConnectionManager>();
+	scheduler = make_unique<TaskScheduler>();
+	scheduler->SetThreads(maximum_threads);
 	// initialize the database
 	storage->Initialize();
 }
@@ -42,6 +45,10 @@ DuckDB::DuckDB(const string &path, DBConfig *config) : DuckDB(path.c_str(), conf
 }
 
 DuckDB::~DuckDB() {
+	if (storage) {
+		// the background checkpoints use the other components of the database: stop them first
+		storage->StopBackgroundCheckpoint();
+	}
 }
 
 void DuckDB::Configure(DBConfig &config) {
@@ -57,7 +64,14 @@ void DuckDB::Configure(DBConfig &config) {
 	}
 	checkpoint_only = config.checkpoint_only;
 	checkpoint_wal_size = config.checkpoint_wal_size;
+	background_checkpoint = config.background_checkpoint;
+	checkpoint_interval = config.checkpoint_interval;
+	wal_group_commit_window = config.wal_group_commit_window;
 	use_direct_io = config.use_direct_io;
+	use_mmap = config.use_mmap;
+	checksum_verification = config.checksum_verification;
 	maximum_memory = config.maximum_memory;
+	maximum_query_memory = config.maximum_query_memory;
 	temporary_directory = config.temporary_directory;
+	maximum_threads = config.maximum_threads;
 }
@@ -20,11 +20,13 @@ void QueryProfiler::StartQuery(string query) {
 		return;
 
 	this->query = query;
+	query_thread = std::this_thread::get_id();
 	tree_map.clear();
 	execution_stack = stack<PhysicalOperator *>();
 	root = nullptr;
 	phase_timings.clear();
 	phase_stack.clear();
+	peak_memory = 0;
 
 	main_query.Start();
 }
@@ -95,7 +97,7 @@ void QueryProfiler::EndPhase() {
 }
 
 void QueryProfiler::StartOperator(PhysicalOperator *phys_op) {
-	if (!enabled)
+	if (!enabled || std::this_thread::get_id() != query_thread)
 		return;
 
 	if (!root) {
@@ -125,7 +127,7 @@ void QueryProfiler::StartOperator(PhysicalOperator *phys_op) {
 }
 
 void QueryProfiler::EndOperator(DataChunk &chunk) {
-	if (!enabled)
+	if (!enabled || std::this_thread::get_id() != query_thread)
 		return;
 
 	// finish timing for the current element
@@ -156,6 +158,7 @@ string QueryProfiler::ToString() const {
 	result += StringUtil::Replace(query, "\n", " ") + "\n";
 	result += "<<Timing>>\n";
 	result += "Total Time: " + to_string(main_query.Elapsed()) + "s\n";
+	result += "Peak Memory: " + to_string(peak_memory) + " bytes\n";
 	// print phase timings
 	for (const auto &entry : GetOrderedPhaseTimings()) {
 		result += entry.first + ": " + to_string(entry.second) + "s\n";
@@ -194,6 +197,7 @@ string QueryProfiler::ToJSON() const {
 		return "{ \"result\": \"error\" }\n";
 	}
 	string result = "{ \"result\": " + to_string(main_query.Elapsed()) + ",\n";
+	result += "\"peak_memory\": " + to_string(peak_memory) + ",\n";
 	// print the phase timings
 	result += "\"timings\": {\n";
 	const auto& ordered_phase_timings = GetOrderedPhaseTimings();
@@ -9,6 +9,7 @@
 #include "duckdb/optimizer/join_order_optimizer.hpp"
 #include "duckdb/optimizer/regex_range_filter.hpp"
 #include "duckdb/optimizer/rule/list.hpp"
+#include "duckdb/optimizer/table_filter_pushdown.hpp"
 #include "duckdb/optimizer/topn_optimizer.hpp"
 #include "duckdb/planner/binder.hpp"
 #include "duckdb/planner/expression/bound_columnref_expression.hpp"
@@ -94,6 +95,12 @@ unique_ptr<LogicalOperator> Optimizer::Optimize(unique_ptr<LogicalOperator> plan
 	JoinOrderOptimizer optimizer;
 	plan = optimizer.Optimize(move(plan));
 	context.profiler.EndPhase();
+
+	// push comparisons with constants into the table scans, so they can skip segments using their statistics
+	context.profiler.StartPhase("table_filter_pushdown");
+	TableFilterPushdown table_filter_pushdown;
+	plan = table_filter_pushdown.Optimize(move(plan));
+	context.profiler.EndPhase();
 	// next we make sure that multiple occurences of the same aggregation are only computed once
 	// context.profiler.StartPhase("common_aggregate_expressions");
 	// CommonAggregateOptimizer ca_optimizer;
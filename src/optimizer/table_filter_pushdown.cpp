@@ -0,0 +1,89 @@
+#include "duckdb/optimizer/table_filter_pushdown.hpp"
+
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+unique_ptr<LogicalOperator> TableFilterPushdown::Optimize(unique_ptr<LogicalOperator> op) {
+	if (op->type == LogicalOperatorType::FILTER && op->children[0]->type == LogicalOperatorType::GET) {
+		return PushdownFilters(move(op));
+	}
+	for (auto &child : op->children) {
+		child = Optimize(move(child));
+	}
+	return op;
+}
+
+unique_ptr<LogicalOperator> TableFilterPushdown::PushdownFilters(unique_ptr<LogicalOperator> op) {
+	assert(op->type == LogicalOperatorType::FILTER);
+	auto &filter = (LogicalFilter &)*op;
+	auto &get = (LogicalGet &)*op->children[0];
+	if (!get.table) {
+		return op;
+	}
+	for (index_t i = 0; i < filter.expressions.size(); i++) {
+		if (PushdownFilter(get, *filter.expressions[i])) {
+			// the filter is evaluated by the scan: remove it from the filter
+			filter.expressions.erase(filter.expressions.begin() + i);
+			i--;
+		}
+	}
+	if (filter.expressions.size() == 0) {
+		// all filters were pushed into the scan: remove the filter entirely
+		return move(op->children[0]);
+	}
+	return op;
+}
+
+bool TableFilterPushdown::PushdownFilter(LogicalGet &get, Expression &expr) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+		return false;
+	}
+	auto &comparison = (BoundComparisonExpression &)expr;
+	auto comparison_type = comparison.type;
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		break;
+	default:
+		return false;
+	}
+	// the comparison has to be between a column and a constant
+	Expression *column, *constant;
+	if (comparison.left->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF &&
+	    comparison.right->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+		column = comparison.left.get();
+		constant = comparison.right.get();
+	} else if (comparison.left->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT &&
+	           comparison.right->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		// the column is on the right side, we flip them around
+		column = comparison.right.get();
+		constant = comparison.left.get();
+		comparison_type = FlipComparisionExpression(comparison_type);
+	} else {
+		return false;
+	}
+	auto &colref = (BoundColumnRefExpression &)*column;
+	if (colref.depth > 0 || colref.binding.table_index != get.table_index) {
+		return false;
+	}
+	assert(colref.binding.column_index < get.column_ids.size());
+	if (get.column_ids[colref.binding.column_index] == COLUMN_IDENTIFIER_ROW_ID) {
+		return false;
+	}
+	// only numeric columns keep min/max statistics
+	auto &value = ((BoundConstantExpression &)*constant).value;
+	if (!TypeIsNumeric(colref.return_type) || value.is_null || value.type != colref.return_type) {
+		return false;
+	}
+	get.table_filters.push_back(TableFilter(value, comparison_type, colref.binding.column_index));
+	return true;
+}
@@ -0,0 +1,236 @@
+#include "duckdb/parallel/pipeline.hpp"
+
+#include "duckdb/execution/executor.hpp"
+#include "duckdb/execution/operator/aggregate/physical_hash_aggregate.hpp"
+#include "duckdb/execution/operator/aggregate/physical_simple_aggregate.hpp"
+#include "duckdb/execution/operator/filter/physical_filter.hpp"
+#include "duckdb/execution/operator/join/physical_hash_join.hpp"
+#include "duckdb/execution/operator/order/physical_order.hpp"
+#include "duckdb/execution/operator/projection/physical_projection.hpp"
+#include "duckdb/execution/operator/scan/physical_table_scan.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include <algorithm>
+
+using namespace duckdb;
+using namespace std;
+
+//! Pipelines that scan more rows than this are long-running, their tasks are scheduled with a low priority so they
+//! do not hold up the tasks of short queries
+#define PIPELINE_LONG_SCAN_CARDINALITY 1000000
+
+namespace duckdb {
+
+class PipelineTask : public Task {
+public:
+	PipelineTask(Pipeline &pipeline, ParallelState *parallel_state)
+	    : pipeline(pipeline), parallel_state(parallel_state) {
+	}
+
+	Pipeline &pipeline;
+	ParallelState *parallel_state;
+
+public:
+	void Execute() override {
+		try {
+			pipeline.ExecuteTask(parallel_state);
+		} catch (...) {
+			// signal the other tasks of the pipeline to stop
+			pipeline.error = true;
+			throw;
+		}
+	}
+};
+
+} // namespace duckdb
+
+Pipeline::Pipeline(Executor &executor, PhysicalSink &sink)
+    : executor(executor), sink(sink), child(sink.children.size() == 0 ? nullptr : sink.children.back().get()),
+      source(nullptr), finished(false), error(false) {
+}
+
+Pipeline::~Pipeline() {
+	sink.sink_state = nullptr;
+}
+
+static bool ExpressionsAreParallelSafe(vector<unique_ptr<Expression>> &expressions) {
+	for (auto &expr : expressions) {
+		if (expr->HasSideEffects()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool ConditionsAreParallelSafe(vector<JoinCondition> &conditions) {
+	for (auto &cond : conditions) {
+		if (cond.left->HasSideEffects() || cond.right->HasSideEffects()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Whether or not the operator can be executed by multiple threads at the same time (each with their own state)
+static bool OperatorIsParallelSafe(PhysicalOperator &op) {
+	switch (op.type) {
+	case PhysicalOperatorType::SEQ_SCAN:
+	case PhysicalOperatorType::PRUNE_COLUMNS:
+	case PhysicalOperatorType::BLOCKWISE_NL_JOIN:
+		return true;
+	case PhysicalOperatorType::FILTER:
+		return ExpressionsAreParallelSafe(((PhysicalFilter &)op).expressions);
+	case PhysicalOperatorType::PROJECTION:
+		return ExpressionsAreParallelSafe(((PhysicalProjection &)op).select_list);
+	case PhysicalOperatorType::HASH_JOIN: {
+		auto &join = (PhysicalHashJoin &)op;
+		// the correlated MARK join updates the group counts while probing
+		return join.delim_types.size() == 0 && ConditionsAreParallelSafe(join.conditions);
+	}
+	case PhysicalOperatorType::NESTED_LOOP_JOIN:
+	case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
+		return ConditionsAreParallelSafe(((PhysicalComparisonJoin &)op).conditions);
+	case PhysicalOperatorType::HASH_GROUP_BY:
+	case PhysicalOperatorType::DISTINCT: {
+		auto &aggr = (PhysicalHashAggregate &)op;
+		return ExpressionsAreParallelSafe(aggr.groups) && ExpressionsAreParallelSafe(aggr.aggregates);
+	}
+	case PhysicalOperatorType::SIMPLE_AGGREGATE:
+		return ExpressionsAreParallelSafe(((PhysicalSimpleAggregate &)op).aggregates);
+	case PhysicalOperatorType::ORDER_BY: {
+		for (auto &order : ((PhysicalOrder &)op).orders) {
+			if (order.expression->HasSideEffects()) {
+				return false;
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+void Pipeline::BuildChain() {
+	operators.clear();
+	source = child;
+	while (source->IsStreaming()) {
+		if (source->type == PhysicalOperatorType::HASH_JOIN) {
+			// the probe side of the join is part of this pipeline, the build side has to be finished first
+			auto &join = (PhysicalHashJoin &)*source;
+			executor.ExecutePipeline(join);
+			if (!join.CanProbeInParallel()) {
+				// a join that spilled its build side joins the spilled partitions one at a time after its left side
+				// has been read entirely, so it cannot be streamed: it becomes the source of the chain instead
+				break;
+			}
+		}
+		operators.push_back(source);
+		source = source->children[0].get();
+	}
+	reverse(operators.begin(), operators.end());
+}
+
+bool Pipeline::CanExecuteInParallel() {
+	if (!OperatorIsParallelSafe(sink)) {
+		return false;
+	}
+	for (auto op : operators) {
+		if (!OperatorIsParallelSafe(*op)) {
+			return false;
+		}
+	}
+	return source->type == PhysicalOperatorType::SEQ_SCAN;
+}
+
+TaskPriority Pipeline::GetTaskPriority() {
+	if (source->type == PhysicalOperatorType::SEQ_SCAN &&
+	    ((PhysicalTableScan &)*source).table.cardinality > PIPELINE_LONG_SCAN_CARDINALITY) {
+		return TaskPriority::LOW;
+	}
+	return TaskPriority::HIGH;
+}
+
+void Pipeline::ExecuteTask(ParallelState *parallel_state) {
+	auto &context = executor.context;
+	// the state of the child holds the states of all operators of the chain, find the state of every operator
+	auto state = child->GetOperatorState();
+	vector<PhysicalOperatorState *> states(operators.size());
+	auto source_state = state.get();
+	for (index_t i = operators.size(); i > 0; i--) {
+		states[i - 1] = source_state;
+		source_state = source_state->child_state.get();
+	}
+	if (parallel_state) {
+		// let the source scan the morsels that are handed out by the shared state
+		source->SetParallelState(*source_state, *parallel_state);
+	}
+	auto lstate = sink.GetLocalSinkState(context);
+
+	DataChunk chunk;
+	child->InitializeChunk(chunk);
+	// every operator reads its input from the child_chunk of its state, which is written by the previous operator
+	auto &source_chunk = operators.size() == 0 ? chunk : states[0]->child_chunk;
+	bool finished = false;
+	while (!error && !finished) {
+		// resume the last operator that has more output for its current input, or fetch new input from the source
+		index_t op_idx = operators.size();
+		while (op_idx > 0 && !states[op_idx - 1]->has_more_output) {
+			op_idx--;
+		}
+		if (op_idx == 0) {
+			source->GetChunk(context, source_chunk, source_state);
+			if (source_chunk.size() == 0) {
+				break;
+			}
+		} else {
+			op_idx--;
+		}
+		// push the chunk through the remaining operators
+		for (; op_idx < operators.size(); op_idx++) {
+			auto &result = op_idx + 1 < operators.size() ? states[op_idx + 1]->child_chunk : chunk;
+			operators[op_idx]->Execute(context, result, states[op_idx]);
+			if (states[op_idx]->finished) {
+				// the operator does not need any more input
+				finished = true;
+			}
+			if (result.size() == 0) {
+				break;
+			}
+		}
+		if (op_idx == operators.size()) {
+			sink.Sink(context, *sink.sink_state, *lstate, chunk);
+		}
+	}
+	sink.Combine(context, *sink.sink_state, *lstate);
+}
+
+void Pipeline::Execute() {
+	if (finished) {
+		return;
+	}
+	auto &context = executor.context;
+	sink.sink_state = sink.GetGlobalState(context);
+	if (child) {
+		BuildChain();
+		auto &scheduler = *context.db.scheduler;
+		index_t thread_count = scheduler.NumberOfThreads();
+		unique_ptr<ParallelState> parallel_state;
+		if (thread_count > 1 && CanExecuteInParallel()) {
+			parallel_state = source->GetParallelState(context);
+		}
+		if (parallel_state) {
+			// execute one task for every thread
+			vector<unique_ptr<Task>> tasks;
+			for (index_t i = 0; i < thread_count; i++) {
+				tasks.push_back(make_unique<PipelineTask>(*this, parallel_state.get()));
+			}
+			scheduler.ExecuteTasks(move(tasks), GetTaskPriority(), &context.interrupted);
+		} else {
+			ExecuteTask(nullptr);
+		}
+	}
+	sink.Finalize(context, *sink.sink_state);
+	finished = true;
+}
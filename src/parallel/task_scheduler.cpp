@@ -0,0 +1,233 @@
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+using namespace std;
+
+namespace duckdb {
+
+//! The scheduler that owns the calling thread and the index of its queue, only set for background worker threads
+static thread_local TaskScheduler *current_scheduler = nullptr;
+static thread_local index_t current_queue = INVALID_INDEX;
+
+//! A set of tasks that is waited on by TaskScheduler::ExecuteTasks
+struct TaskGroup {
+	TaskGroup(std::atomic<bool> *interrupted) : finished_tasks(0), cancelled(false), interrupted(interrupted) {
+	}
+
+	std::mutex group_lock;
+	std::condition_variable group_signal;
+	index_t finished_tasks;
+	//! The first exception thrown by any of the tasks
+	std::exception_ptr exception;
+	//! Set when one of the tasks has failed, the tasks that have not started yet are skipped
+	std::atomic<bool> cancelled;
+	//! The interrupted flag of the query the tasks belong to (if any)
+	std::atomic<bool> *interrupted;
+
+	bool IsCancelled() {
+		return cancelled || (interrupted && *interrupted);
+	}
+};
+
+class TaskGroupTask : public Task {
+public:
+	TaskGroupTask(unique_ptr<Task> task, TaskGroup &group) : task(move(task)), group(group) {
+	}
+
+	unique_ptr<Task> task;
+	TaskGroup &group;
+
+public:
+	void Execute() override {
+		std::exception_ptr task_exception;
+		if (!group.IsCancelled()) {
+			try {
+				task->Execute();
+			} catch (...) {
+				task_exception = std::current_exception();
+				group.cancelled = true;
+			}
+		}
+		{
+			lock_guard<mutex> guard(group.group_lock);
+			if (task_exception && !group.exception) {
+				group.exception = task_exception;
+			}
+			group.finished_tasks++;
+		}
+		group.group_signal.notify_all();
+	}
+};
+
+} // namespace duckdb
+
+TaskScheduler::TaskScheduler() : worker_count(0), next_queue(0), thread_generation(0) {
+	index_t queue_count = std::max<index_t>(std::thread::hardware_concurrency(), 1);
+	for (index_t i = 0; i < queue_count; i++) {
+		queues.push_back(make_unique<WorkerQueue>());
+	}
+	for (index_t i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		queued_tasks[i] = 0;
+	}
+}
+
+TaskScheduler::~TaskScheduler() {
+	lock_guard<mutex> guard(threads_lock);
+	StopThreads();
+}
+
+void TaskScheduler::ScheduleTask(unique_ptr<Task> task, TaskPriority priority) {
+	index_t queue_idx;
+	if (current_scheduler == this) {
+		// a worker pushes the tasks it schedules into its own queue
+		queue_idx = current_queue;
+	} else {
+		index_t used_queues = std::min<index_t>(std::max<index_t>(worker_count, 1), queues.size());
+		queue_idx = next_queue++ % used_queues;
+	}
+	auto &queue = *queues[queue_idx];
+	{
+		lock_guard<mutex> guard(queue.lock);
+		queue.tasks[(uint8_t)priority].push_back(move(task));
+	}
+	queued_tasks[(uint8_t)priority]++;
+	{
+		// take the lock so the signal cannot get lost between an idle worker checking for tasks and going to sleep
+		lock_guard<mutex> guard(scheduler_lock);
+	}
+	queue_signal.notify_one();
+}
+
+unique_ptr<Task> TaskScheduler::FetchTask(TaskPriority minimum_priority) {
+	index_t own_queue = current_scheduler == this ? current_queue : 0;
+	for (int priority = TASK_PRIORITY_COUNT - 1; priority >= (int)minimum_priority; priority--) {
+		if (queued_tasks[priority] == 0) {
+			continue;
+		}
+		// first look in the own queue, then steal from the other queues
+		for (index_t i = 0; i < queues.size(); i++) {
+			index_t queue_idx = (own_queue + i) % queues.size();
+			auto &queue = *queues[queue_idx];
+			lock_guard<mutex> guard(queue.lock);
+			auto &tasks = queue.tasks[priority];
+			if (tasks.empty()) {
+				continue;
+			}
+			unique_ptr<Task> task;
+			if (i == 0 && current_scheduler == this) {
+				task = move(tasks.back());
+				tasks.pop_back();
+			} else {
+				task = move(tasks.front());
+				tasks.pop_front();
+			}
+			queued_tasks[priority]--;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+bool TaskScheduler::ExecuteTask(TaskPriority minimum_priority) {
+	auto task = FetchTask(minimum_priority);
+	if (!task) {
+		return false;
+	}
+	task->Execute();
+	return true;
+}
+
+void TaskScheduler::ExecuteTasks(vector<unique_ptr<Task>> tasks, TaskPriority priority,
+                                 std::atomic<bool> *interrupted) {
+	if (tasks.size() == 0) {
+		return;
+	}
+	TaskGroup group(interrupted);
+	index_t task_count = tasks.size();
+	for (index_t i = 1; i < task_count; i++) {
+		ScheduleTask(make_unique<TaskGroupTask>(move(tasks[i]), group), priority);
+	}
+	TaskGroupTask(move(tasks[0]), group).Execute();
+	// wait for the other tasks to finish, executing queued tasks in the meantime. Only tasks of at least the same
+	// priority are executed, so a short query is never held up by the tasks of a long-running query.
+	while (true) {
+		{
+			lock_guard<mutex> guard(group.group_lock);
+			if (group.finished_tasks == task_count) {
+				break;
+			}
+		}
+		if (!ExecuteTask(priority)) {
+			unique_lock<mutex> guard(group.group_lock);
+			group.group_signal.wait_for(guard, std::chrono::milliseconds(1),
+			                            [&] { return group.finished_tasks == task_count; });
+		}
+	}
+	if (group.exception) {
+		std::rethrow_exception(group.exception);
+	}
+}
+
+void TaskScheduler::ExecuteForever(index_t worker_idx, index_t generation) {
+	current_scheduler = this;
+	current_queue = worker_idx % queues.size();
+	while (thread_generation == generation) {
+		auto task = FetchTask(TaskPriority::LOW);
+		if (task) {
+			task->Execute();
+			continue;
+		}
+		unique_lock<mutex> guard(scheduler_lock);
+		queue_signal.wait(guard, [&] {
+			if (thread_generation != generation) {
+				return true;
+			}
+			for (index_t i = 0; i < TASK_PRIORITY_COUNT; i++) {
+				if (queued_tasks[i] > 0) {
+					return true;
+				}
+			}
+			return false;
+		});
+	}
+}
+
+void TaskScheduler::StopThreads() {
+	vector<thread> stopped_threads;
+	{
+		lock_guard<mutex> guard(scheduler_lock);
+		thread_generation++;
+		stopped_threads = move(threads);
+		threads.clear();
+		worker_count = 0;
+	}
+	queue_signal.notify_all();
+	for (auto &thread : stopped_threads) {
+		thread.join();
+	}
+}
+
+void TaskScheduler::SetThreads(index_t n) {
+	if (n == 0) {
+		throw Exception("Number of threads must be at least 1");
+	}
+	// concurrent calls are serialized: the threads of one call are stopped and started before the next call starts
+	lock_guard<mutex> threads_guard(threads_lock);
+	StopThreads();
+	// any tasks that are still in the queues are picked up by the new threads
+	lock_guard<mutex> guard(scheduler_lock);
+	index_t generation = thread_generation;
+	// the thread that issues a query also participates in executing it: only start n - 1 background threads
+	for (index_t i = 0; i + 1 < n; i++) {
+		threads.push_back(thread([this, i, generation] { ExecuteForever(i, generation); }));
+	}
+	worker_count = threads.size();
+}
+
+index_t TaskScheduler::NumberOfThreads() {
+	return worker_count + 1;
+}
@@ -1,3 +1,5 @@
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/parser/statement/create_index_statement.hpp"
 #include "duckdb/planner/binder.hpp"
 #include "duckdb/planner/expression_binder/index_binder.hpp"
@@ -21,9 +23,14 @@ unique_ptr<BoundSQLStatement> Binder::Bind(CreateIndexStatement &stmt) {
 	if (stmt.expressions.size() > 1) {
 		throw NotImplementedException("Multidimensional indexes not supported yet");
 	}
+	// keep the table and the unbound expressions around, they are used to rebind the index when it is loaded from
+	// storage
+	stmt.info->schema = table_ref->table->schema->name;
+	stmt.info->table = table_ref->table->name;
 	// visit the expressions
 	IndexBinder binder(*this, context);
 	for (auto &expr : stmt.expressions) {
+		stmt.info->expressions.push_back(expr->Copy());
 		result->expressions.push_back(binder.Bind(expr));
 	}
 	result->info = move(stmt.info);
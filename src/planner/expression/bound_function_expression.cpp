@@ -17,6 +17,10 @@ bool BoundFunctionExpression::IsFoldable() const {
 	return function.has_side_effects ? false : Expression::IsFoldable();
 }
 
+bool BoundFunctionExpression::HasSideEffects() const {
+	return function.has_side_effects ? true : Expression::HasSideEffects();
+}
+
 string BoundFunctionExpression::ToString() const {
 	string result = function.name + "(";
 	result += StringUtil::Join(children, children.size(), ", ", [](const unique_ptr<Expression>& child){
@@ -1,6 +1,7 @@
 #include "duckdb/planner/pragma_handler.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/common/operator/cast_operators.hpp"
@@ -76,27 +77,43 @@ unique_ptr<SQLStatement> PragmaHandler::HandlePragma(PragmaStatement &pragma) {
 		}
 		context.profiler.save_location = pragma.parameters[0].str_value;
 	} else if (keyword == "memory_limit") {
+		context.db.storage->buffer_manager->SetLimit(ParseMemoryLimitPragma(pragma));
+	} else if (keyword == "query_memory_limit") {
+		// the limit of the memory a single query of this connection can reserve
+		context.query_memory_limit = ParseMemoryLimitPragma(pragma);
+	} else if (keyword == "threads") {
 		if (pragma.pragma_type != PragmaType::ASSIGNMENT) {
-			throw ParserException("Memory limit must be an assignment (e.g. PRAGMA memory_limit='1GB')");
+			throw ParserException("Threads must be an assignment (e.g. PRAGMA threads=4)");
 		}
-		if (pragma.parameters[0].type == TypeId::VARCHAR) {
-			ParseMemoryLimit(pragma.parameters[0].str_value);
-		} else {
-			int64_t value = pragma.parameters[0].GetNumericValue();
-			if (value < 0) {
-				// limit < 0, set limit to infinite
-				context.db.storage->buffer_manager->SetLimit();
-			} else {
-				throw ParserException("Memory limit must be an assignment with a memory unit (e.g. PRAGMA memory_limit='1GB')");
-			}
+		int64_t threads = pragma.parameters[0].GetNumericValue();
+		if (threads < 1) {
+			throw ParserException("Threads must be at least 1");
 		}
+		context.db.scheduler->SetThreads((index_t)threads);
 	} else {
 		throw ParserException("Unrecognized PRAGMA keyword: %s", keyword.c_str());
 	}
 	return nullptr;
 }
 
-void PragmaHandler::ParseMemoryLimit(string arg) {
+index_t PragmaHandler::ParseMemoryLimitPragma(PragmaStatement &pragma) {
+	auto &keyword = pragma.name;
+	if (pragma.pragma_type != PragmaType::ASSIGNMENT) {
+		throw ParserException("Memory limit must be an assignment (e.g. PRAGMA %s='1GB')", keyword.c_str());
+	}
+	if (pragma.parameters[0].type == TypeId::VARCHAR) {
+		return ParseMemoryLimit(pragma.parameters[0].str_value);
+	}
+	int64_t value = pragma.parameters[0].GetNumericValue();
+	if (value >= 0) {
+		throw ParserException("Memory limit must be an assignment with a memory unit (e.g. PRAGMA %s='1GB')",
+		                      keyword.c_str());
+	}
+	// limit < 0, set limit to infinite
+	return (index_t)-1;
+}
+
+index_t PragmaHandler::ParseMemoryLimit(string arg) {
 	// split based on the number/non-number
 	index_t idx = 0;
 	while (std::isspace(arg[idx])) {
@@ -125,8 +142,7 @@ void PragmaHandler::ParseMemoryLimit(string arg) {
 	}
 	if (limit < 0) {
 		// limit < 0, set limit to infinite
-		context.db.storage->buffer_manager->SetLimit();
-		return;
+		return (index_t)-1;
 	}
 	string unit = StringUtil::Lower(arg.substr(start, idx - start));
 	index_t multiplier;
@@ -143,6 +159,5 @@ void PragmaHandler::ParseMemoryLimit(string arg) {
 	} else {
 		throw ParserException("Unknown unit for memory_limit: %s (expected: b, mb, gb or tb)", unit.c_str());
 	}
-	// set the new limit in the buffer manager
-	context.db.storage->buffer_manager->SetLimit((index_t)(multiplier * limit));
+	return (index_t)(multiplier * limit);
 }
@@ -5,3 +5,7 @@ using namespace std;
 
 Block::Block(block_id_t id) : FileBuffer(FileBufferType::BLOCK, Storage::BLOCK_ALLOC_SIZE), id(id) {
 }
+
+Block::Block(block_id_t id, data_ptr_t internal_buffer)
+    : FileBuffer(FileBufferType::BLOCK, internal_buffer, Storage::BLOCK_ALLOC_SIZE), id(id) {
+}
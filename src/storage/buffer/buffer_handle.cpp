@@ -1,5 +1,6 @@
 #include "duckdb/storage/buffer/buffer_handle.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/common/file_buffer.hpp"
 
 using namespace duckdb;
 using namespace std;
@@ -8,6 +9,12 @@ BufferHandle::BufferHandle(BufferManager &manager, block_id_t block_id, FileBuff
     : manager(manager), block_id(block_id), node(node) {
 }
 
+BufferHandle::BufferHandle(BufferManager &manager, block_id_t block_id, unique_ptr<FileBuffer> owned_node)
+    : manager(manager), block_id(block_id), node(owned_node.get()), owned_node(move(owned_node)) {
+}
+
 BufferHandle::~BufferHandle() {
-	manager.Unpin(block_id);
+	if (!owned_node) {
+		manager.Unpin(block_id);
+	}
 }
@@ -0,0 +1,70 @@
+#include "duckdb/storage/buffer/query_memory.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+QueryMemory::QueryMemory(BufferManager &manager) : manager(manager), limit((index_t)-1), reserved(0), peak(0) {
+}
+
+void QueryMemory::Reset(index_t limit) {
+	this->limit = limit;
+	peak = reserved.load();
+}
+
+bool QueryMemory::TryReserve(index_t size) {
+	auto new_reserved = reserved += size;
+	if (new_reserved > limit || !manager.TryReserveMemory(size)) {
+		reserved -= size;
+		return false;
+	}
+	// update the peak, which can be raised concurrently by another thread of the query
+	auto current_peak = peak.load();
+	while (new_reserved > current_peak && !peak.compare_exchange_weak(current_peak, new_reserved)) {
+	}
+	return true;
+}
+
+void QueryMemory::Release(index_t size) {
+	assert(reserved >= size);
+	manager.FreeReservedMemory(size);
+	reserved -= size;
+}
+
+index_t QueryMemory::GetLimit() {
+	// an unlimited buffer manager has a limit of (index_t)-1, which is equal to INVALID_INDEX
+	return std::min(limit, manager.GetLimit());
+}
+
+MemoryReservation::~MemoryReservation() {
+	if (size > 0) {
+		memory.Release(size);
+	}
+}
+
+bool MemoryReservation::TryResize(index_t new_size) {
+	if (new_size > size) {
+		if (!memory.TryReserve(new_size - size)) {
+			return false;
+		}
+	} else if (new_size < size) {
+		memory.Release(size - new_size);
+	}
+	size = new_size;
+	return true;
+}
+
+void MemoryReservation::Resize(index_t new_size) {
+	if (!TryResize(new_size)) {
+		throw OutOfMemoryException("could not reserve %llu bytes for the query (%llu bytes already reserved)",
+		                           (unsigned long long)(new_size - size), (unsigned long long)memory.GetReserved());
+	}
+}
+
+void MemoryReservation::Merge(MemoryReservation &other) {
+	assert(&memory == &other.memory);
+	size += other.size;
+	other.size = 0;
+}
@@ -5,24 +5,42 @@
 using namespace duckdb;
 using namespace std;
 
-BufferManager::BufferManager(FileSystem &fs, BlockManager &manager, string tmp, index_t maximum_memory)
-    : fs(fs), manager(manager), current_memory(0), maximum_memory(maximum_memory), temp_directory(move(tmp)),
-      temporary_id(MAXIMUM_BLOCK) {
+constexpr index_t BufferManager::SHARD_COUNT;
+constexpr index_t BufferManager::PREFETCH_BATCH_SIZE;
+constexpr index_t BufferManager::PREFETCH_QUEUE_SIZE;
+
+BufferManager::BufferManager(FileSystem &fs, BlockManager &manager, string tmp, index_t maximum_memory,
+                             bool use_direct_io)
+    : fs(fs), manager(manager), current_memory(0), reserved_memory(0), maximum_memory(maximum_memory),
+      temp_directory(move(tmp)), use_direct_io(use_direct_io), evict_shard(0), temporary_id(MAXIMUM_BLOCK),
+      stop_prefetch(false) {
 	if (!temp_directory.empty()) {
 		fs.CreateDirectory(temp_directory);
 	}
 }
 
 BufferManager::~BufferManager() {
+	{
+		lock_guard<mutex> lock(prefetch_lock);
+		stop_prefetch = true;
+	}
+	prefetch_signal.notify_one();
+	if (prefetch_thread.joinable()) {
+		prefetch_thread.join();
+	}
 	if (!temp_directory.empty()) {
 		fs.RemoveDirectory(temp_directory);
 	}
 }
 
 unique_ptr<BufferHandle> BufferManager::Pin(block_id_t block_id, bool can_destroy) {
-	// first obtain a lock on the set of blocks
-	lock_guard<mutex> lock(block_lock);
 	if (block_id < MAXIMUM_BLOCK) {
+		// the blocks of a memory-mapped database file are used directly: the operating system decides which parts of
+		// the file are kept in memory, so they do not need to be loaded or tracked here
+		auto mapped_block = manager.GetMappedBlock(block_id);
+		if (mapped_block) {
+			return make_unique<BufferHandle>(*this, block_id, move(mapped_block));
+		}
 		return PinBlock(block_id);
 	} else {
 		return PinBuffer(block_id, can_destroy);
@@ -34,144 +52,205 @@ unique_ptr<BufferHandle> BufferManager::PinBlock(block_id_t block_id) {
 	assert(block_id < MAXIMUM_BLOCK);
 
 	// check if the block is already loaded
-	Block *result_block;
-	auto entry = blocks.find(block_id);
-	if (entry == blocks.end()) {
-		// block is not loaded, load the block
-		current_memory += Storage::BLOCK_ALLOC_SIZE;
-		unique_ptr<Block> block;
-		if (current_memory > maximum_memory) {
-			// not enough memory to hold the block: have to evict a block first
-			block = EvictBlock();
-			if (!block) {
-				// evicted a managed buffer: no block returned
-				// create a new block
-				block = make_unique<Block>(block_id);
-			} else {
-				// take over the evicted block and use it to hold this block
-				block->id = block_id;
-			}
-		} else {
-			// enough memory to create a new block: allocate it
+	auto &shard = GetShard(block_id);
+	{
+		lock_guard<mutex> lock(shard.lock);
+		auto entry = shard.blocks.find(block_id);
+		if (entry != shard.blocks.end()) {
+			auto buffer = entry->second->buffer.get();
+			assert(buffer->type == FileBufferType::BLOCK);
+			// add one to the reference count
+			AddReference(shard, entry->second);
+			return make_unique<BufferHandle>(*this, block_id, buffer);
+		}
+	}
+	// block is not loaded: reserve the memory and load the block without holding the lock of the shard
+	auto block = ReserveMemory(Storage::BLOCK_ALLOC_SIZE);
+	try {
+		if (!block) {
+			// no block was evicted to hold this block: allocate it
 			block = make_unique<Block>(block_id);
+		} else {
+			// take over the evicted block and use it to hold this block
+			block->id = block_id;
 		}
 		manager.Read(*block);
-		result_block = block.get();
-		// create a new buffer entry for this block and insert it into the block list
-		auto buffer_entry = make_unique<BufferEntry>(move(block));
-		blocks.insert(make_pair(block_id, buffer_entry.get()));
-		used_list.Append(move(buffer_entry));
-	} else {
-		auto buffer = entry->second->buffer.get();
-		assert(buffer->type == FileBufferType::BLOCK);
-		result_block = (Block *)buffer;
-		// add one to the reference count
-		AddReference(entry->second);
+	} catch (...) {
+		current_memory -= Storage::BLOCK_ALLOC_SIZE;
+		throw;
+	}
+
+	lock_guard<mutex> lock(shard.lock);
+	auto entry = shard.blocks.find(block_id);
+	if (entry != shard.blocks.end()) {
+		// another thread has loaded the same block in the meantime: use that block instead
+		current_memory -= Storage::BLOCK_ALLOC_SIZE;
+		AddReference(shard, entry->second);
+		return make_unique<BufferHandle>(*this, block_id, entry->second->buffer.get());
 	}
+	auto result_block = block.get();
+	// create a new buffer entry for this block and insert it into the block list
+	auto buffer_entry = make_unique<BufferEntry>(move(block));
+	shard.blocks.insert(make_pair(block_id, buffer_entry.get()));
+	shard.used_list.Append(move(buffer_entry));
 	return make_unique<BufferHandle>(*this, block_id, result_block);
 }
 
-void BufferManager::AddReference(BufferEntry *entry) {
+void BufferManager::AddReference(BufferShard &shard, BufferEntry *entry) {
 	entry->ref_count++;
 	if (entry->ref_count == 1) {
 		// ref count is 1, that means it used to be 0 (unused)
-		// move from lru to used_list
-		auto current_entry = lru.Erase(entry);
-		used_list.Append(move(current_entry));
+		// move from the lru lists to the used_list. A block that is used again after it was unpinned is protected from
+		// eviction in favor of the blocks that were only used once.
+		auto current_entry = entry->reused ? shard.protected_list.Erase(entry) : shard.probation.Erase(entry);
+		if (current_entry->prefetched) {
+			// the first pin of a prefetched block is the first use of the block, not a reuse
+			current_entry->prefetched = false;
+		} else {
+			current_entry->reused = true;
+		}
+		shard.used_list.Append(move(current_entry));
 	}
 }
 
 void BufferManager::Unpin(block_id_t block_id) {
-	lock_guard<mutex> lock(block_lock);
+	auto &shard = GetShard(block_id);
+	lock_guard<mutex> lock(shard.lock);
 	// first find the block in the set of blocks
-	auto entry = blocks.find(block_id);
-	assert(entry != blocks.end());
+	auto entry = shard.blocks.find(block_id);
+	assert(entry != shard.blocks.end());
 
 	auto buffer_entry = entry->second;
 	// then decerase the ref count
 	assert(buffer_entry->ref_count > 0);
 	buffer_entry->ref_count--;
 	if (buffer_entry->ref_count == 0) {
-		if (buffer_entry->buffer->type == FileBufferType::MANAGED_BUFFER) {
-			auto managed = (ManagedBuffer *)buffer_entry->buffer.get();
+		auto current_entry = shard.used_list.Erase(buffer_entry);
+		if (current_entry->buffer->type == FileBufferType::MANAGED_BUFFER) {
+			auto managed = (ManagedBuffer *)current_entry->buffer.get();
 			if (managed->can_destroy) {
 				// this is a managed buffer that we can destroy
 				// instead of adding it to the LRU list, just deallocate the managed buffer immediately
-				current_memory -= managed->size;
+				current_memory -= managed->AllocSize();
+				shard.blocks.erase(entry);
 				return;
 			}
 		}
 		// no references left: move block out of used list and into lru list
-		auto entry = used_list.Erase(buffer_entry);
-		lru.Append(move(entry));
+		if (current_entry->reused) {
+			shard.protected_list.Append(move(current_entry));
+		} else {
+			shard.probation.Append(move(current_entry));
+		}
 	}
 }
 
+unique_ptr<Block> BufferManager::ReserveMemory(index_t size) {
+	current_memory += size;
+	unique_ptr<Block> result;
+	try {
+		while (current_memory > maximum_memory) {
+			// not enough memory: have to evict a block first
+			auto block = EvictBlock();
+			if (block && !result) {
+				result = move(block);
+			}
+		}
+	} catch (...) {
+		current_memory -= size;
+		throw;
+	}
+	return result;
+}
+
 unique_ptr<Block> BufferManager::EvictBlock() {
 	if (temp_directory.empty()) {
-		throw Exception("Out-of-memory: cannot evict buffer because no temporary directory is specified!\nTo enable "
-		                "temporary buffer eviction set a temporary directory in the configuration");
+		throw OutOfMemoryException("cannot evict buffer because no temporary directory is specified!\nTo enable "
+		                           "temporary buffer eviction set a temporary directory in the configuration");
 	}
-	// pop the first entry from the lru list
-	auto entry = lru.Pop();
-	if (!entry) {
-		throw Exception("Not enough memory to complete operation!");
-	}
-	assert(entry->ref_count == 0);
-	// erase this identifier from the set of blocks
-	auto buffer = entry->buffer.get();
-	if (buffer->type == FileBufferType::BLOCK) {
-		// block buffer: remove the block and reuse it
-		auto block = (Block *)buffer;
-		blocks.erase(block->id);
-		// free up the memory
-		current_memory -= Storage::BLOCK_ALLOC_SIZE;
-		// finally return the block obtained from the current entry
-		return unique_ptr_cast<FileBuffer, Block>(move(entry->buffer));
-	} else {
-		// managed buffer: cannot return a block here
-		auto managed = (ManagedBuffer *)buffer;
-		assert(!managed->can_destroy);
+	// the shards are visited round-robin, so the evictions are spread out over all shards
+	for (index_t i = 0; i < SHARD_COUNT; i++) {
+		auto &shard = shards[evict_shard++ % SHARD_COUNT];
+		lock_guard<mutex> lock(shard.lock);
+		// evict the least recently used block that was only used once, unless those make up less than a quarter of the
+		// evictable blocks: the protected blocks are not kept forever if the workload changes
+		unique_ptr<BufferEntry> entry;
+		if (shard.probation.Count() * 4 >= shard.probation.Count() + shard.protected_list.Count()) {
+			entry = shard.probation.Pop();
+		}
+		if (!entry) {
+			entry = shard.protected_list.Pop();
+		}
+		if (!entry) {
+			entry = shard.probation.Pop();
+		}
+		if (!entry) {
+			continue;
+		}
+		assert(entry->ref_count == 0);
+		// erase this identifier from the set of blocks
+		auto buffer = entry->buffer.get();
+		if (buffer->type == FileBufferType::BLOCK) {
+			// block buffer: remove the block and reuse it
+			auto block = (Block *)buffer;
+			shard.blocks.erase(block->id);
+			// free up the memory
+			current_memory -= Storage::BLOCK_ALLOC_SIZE;
+			// finally return the block obtained from the current entry
+			return unique_ptr_cast<FileBuffer, Block>(move(entry->buffer));
+		} else {
+			// managed buffer: cannot return a block here
+			auto managed = (ManagedBuffer *)buffer;
+			assert(!managed->can_destroy);
 
-		// cannot destroy this buffer: write it to disk first so it can be reloaded later
-		WriteTemporaryBuffer(*managed);
+			// cannot destroy this buffer: write it to disk first so it can be reloaded later
+			WriteTemporaryBuffer(*managed);
 
-		blocks.erase(managed->id);
-		// free up the memory
-		current_memory -= managed->size;
-		return nullptr;
+			shard.blocks.erase(managed->id);
+			// free up the memory
+			current_memory -= managed->AllocSize();
+			return nullptr;
+		}
 	}
+	throw OutOfMemoryException("Not enough memory to complete operation!");
 }
 
 unique_ptr<BufferHandle> BufferManager::Allocate(index_t alloc_size, bool can_destroy) {
 	assert(alloc_size >= Storage::BLOCK_ALLOC_SIZE);
 
-	lock_guard<mutex> lock(block_lock);
 	// first evict blocks until we have enough memory to store this buffer
-	while (current_memory + alloc_size > maximum_memory) {
-		EvictBlock();
-	}
+	ReserveMemory(alloc_size);
 	// now allocate the buffer with a new temporary id
 	auto temp_id = ++temporary_id;
-	auto buffer = make_unique<ManagedBuffer>(*this, alloc_size, can_destroy, temp_id);
+	unique_ptr<ManagedBuffer> buffer;
+	try {
+		buffer = make_unique<ManagedBuffer>(*this, alloc_size, can_destroy, temp_id);
+	} catch (...) {
+		current_memory -= alloc_size;
+		throw;
+	}
 	auto managed_buffer = buffer.get();
-	current_memory += buffer->AllocSize();
+	// the allocation is rounded up to the sector size
+	current_memory += buffer->AllocSize() - alloc_size;
 	// create a new entry and append it to the used list
+	auto &shard = GetShard(temp_id);
+	lock_guard<mutex> lock(shard.lock);
 	auto buffer_entry = make_unique<BufferEntry>(move(buffer));
-	blocks.insert(make_pair(temp_id, buffer_entry.get()));
-	used_list.Append(move(buffer_entry));
+	shard.blocks.insert(make_pair(temp_id, buffer_entry.get()));
+	shard.used_list.Append(move(buffer_entry));
 	// now return a handle to the entry
 	return make_unique<BufferHandle>(*this, temp_id, managed_buffer);
 }
 
 void BufferManager::DestroyBuffer(block_id_t buffer_id, bool can_destroy) {
-	lock_guard<mutex> lock(block_lock);
-
 	assert(buffer_id >= MAXIMUM_BLOCK);
+	auto &shard = GetShard(buffer_id);
+	lock_guard<mutex> lock(shard.lock);
+
 	// this is like unpin, except we just destroy the entry entirely instead of adding it to the LRU list
 	// first find the block in the set of blocks
-	auto entry = blocks.find(buffer_id);
-	if (entry == blocks.end()) {
+	auto entry = shard.blocks.find(buffer_id);
+	if (entry == shard.blocks.end()) {
 		// buffer is not currently loaded into memory
 		// check if it was offloaded to disk instead
 		if (!can_destroy) {
@@ -185,13 +264,119 @@ void BufferManager::DestroyBuffer(block_id_t buffer_id, bool can_destroy) {
 	assert(handle->ref_count == 0);
 
 	current_memory -= handle->buffer->AllocSize();
-	blocks.erase(buffer_id);
-	lru.Erase(handle);
+	shard.blocks.erase(entry);
+	if (handle->reused) {
+		shard.protected_list.Erase(handle);
+	} else {
+		shard.probation.Erase(handle);
+	}
 }
 
-void BufferManager::SetLimit(index_t limit) {
-	lock_guard<mutex> lock(block_lock);
+void BufferManager::Prefetch(vector<block_id_t> &block_ids) {
+	if (block_ids.size() == 0 || !manager.CanPrefetch()) {
+		return;
+	}
+	lock_guard<mutex> lock(prefetch_lock);
+	if (!prefetch_thread.joinable()) {
+		prefetch_thread = std::thread(&BufferManager::PrefetchBlocks, this);
+	}
+	for (auto &block_id : block_ids) {
+		if (prefetch_queue.size() >= PREFETCH_QUEUE_SIZE) {
+			break;
+		}
+		assert(block_id < MAXIMUM_BLOCK);
+		prefetch_queue.push_back(block_id);
+	}
+	prefetch_signal.notify_one();
+}
+
+void BufferManager::PrefetchBlocks() {
+	while (true) {
+		vector<block_id_t> block_ids;
+		{
+			unique_lock<mutex> lock(prefetch_lock);
+			prefetch_signal.wait(lock, [&]() { return stop_prefetch || prefetch_queue.size() > 0; });
+			if (stop_prefetch) {
+				return;
+			}
+			while (prefetch_queue.size() > 0 && block_ids.size() < PREFETCH_BATCH_SIZE) {
+				block_ids.push_back(prefetch_queue.front());
+				prefetch_queue.pop_front();
+			}
+		}
+		LoadBlocks(move(block_ids));
+	}
+}
+
+void BufferManager::LoadBlocks(vector<block_id_t> block_ids) {
+	// sort the blocks, so the block manager can merge the reads of adjacent blocks
+	sort(block_ids.begin(), block_ids.end());
+	block_ids.erase(unique(block_ids.begin(), block_ids.end()), block_ids.end());
+	vector<unique_ptr<Block>> blocks;
+	try {
+		for (auto &block_id : block_ids) {
+			{
+				auto &shard = GetShard(block_id);
+				lock_guard<mutex> lock(shard.lock);
+				if (shard.blocks.find(block_id) != shard.blocks.end()) {
+					// the block is loaded already
+					continue;
+				}
+			}
+			// only use memory that is not in use: a prefetched block is not worth evicting another block for
+			if (current_memory.fetch_add(Storage::BLOCK_ALLOC_SIZE) + Storage::BLOCK_ALLOC_SIZE > maximum_memory) {
+				current_memory -= Storage::BLOCK_ALLOC_SIZE;
+				break;
+			}
+			try {
+				blocks.push_back(make_unique<Block>(block_id));
+			} catch (...) {
+				current_memory -= Storage::BLOCK_ALLOC_SIZE;
+				throw;
+			}
+		}
+		manager.Read(blocks);
+	} catch (...) {
+		// prefetching is only a hint: if the blocks cannot be loaded now, the error is reported when they are pinned
+		current_memory -= blocks.size() * Storage::BLOCK_ALLOC_SIZE;
+		return;
+	}
+	for (auto &block : blocks) {
+		auto &shard = GetShard(block->id);
+		lock_guard<mutex> lock(shard.lock);
+		if (shard.blocks.find(block->id) != shard.blocks.end()) {
+			// the block has been pinned (and loaded) in the meantime
+			current_memory -= Storage::BLOCK_ALLOC_SIZE;
+			continue;
+		}
+		// the block is added as an unused block, which is evicted first if it is not used
+		auto block_id = block->id;
+		auto buffer_entry = make_unique<BufferEntry>(move(block));
+		buffer_entry->ref_count = 0;
+		buffer_entry->prefetched = true;
+		shard.blocks.insert(make_pair(block_id, buffer_entry.get()));
+		shard.probation.Append(move(buffer_entry));
+	}
+}
+
+bool BufferManager::TryReserveMemory(index_t size) {
+	try {
+		// any block that is evicted to make room for the reservation is freed
+		ReserveMemory(size);
+	} catch (OutOfMemoryException &ex) {
+		return false;
+	}
+	reserved_memory += size;
+	return true;
+}
 
+void BufferManager::FreeReservedMemory(index_t size) {
+	assert(reserved_memory >= size);
+	reserved_memory -= size;
+	current_memory -= size;
+}
+
+void BufferManager::SetLimit(index_t limit) {
 	while (current_memory > limit) {
 		EvictBlock();
 	}
@@ -200,25 +385,29 @@ void BufferManager::SetLimit(index_t limit) {
 
 unique_ptr<BufferHandle> BufferManager::PinBuffer(block_id_t buffer_id, bool can_destroy) {
 	assert(buffer_id >= MAXIMUM_BLOCK);
-	// check if we have this buffer here
-	auto entry = blocks.find(buffer_id);
-	if (entry == blocks.end()) {
-		if (can_destroy) {
-			// buffer was destroyed: return nullptr
-			return nullptr;
-		} else {
-			// buffer was unloaded but not destroyed: read from disk
-			return ReadTemporaryBuffer(buffer_id);
+	{
+		// check if we have this buffer here
+		auto &shard = GetShard(buffer_id);
+		lock_guard<mutex> lock(shard.lock);
+		auto entry = shard.blocks.find(buffer_id);
+		if (entry != shard.blocks.end()) {
+			// we still have the buffer, add a reference to it
+			auto buffer = entry->second->buffer.get();
+			AddReference(shard, entry->second);
+			// now return it
+			assert(buffer->type == FileBufferType::MANAGED_BUFFER);
+			auto managed = (ManagedBuffer *)buffer;
+			assert(managed->id == buffer_id);
+			return make_unique<BufferHandle>(*this, buffer_id, managed);
 		}
 	}
-	// we still have the buffer, add a reference to it
-	auto buffer = entry->second->buffer.get();
-	AddReference(entry->second);
-	// now return it
-	assert(buffer->type == FileBufferType::MANAGED_BUFFER);
-	auto managed = (ManagedBuffer *)buffer;
-	assert(managed->id == buffer_id);
-	return make_unique<BufferHandle>(*this, buffer_id, managed);
+	if (can_destroy) {
+		// buffer was destroyed: return nullptr
+		return nullptr;
+	} else {
+		// buffer was unloaded but not destroyed: read from disk
+		return ReadTemporaryBuffer(buffer_id);
+	}
 }
 
 string BufferManager::GetTemporaryPath(block_id_t id) {
@@ -229,10 +418,14 @@ void BufferManager::WriteTemporaryBuffer(ManagedBuffer &buffer) {
 	assert(buffer.size + Storage::BLOCK_HEADER_SIZE >= Storage::BLOCK_ALLOC_SIZE);
 	// get the path to write to
 	auto path = GetTemporaryPath(buffer.id);
-	// create the file and write the size followed by the buffer contents
-	auto handle = fs.OpenFile(path, FileFlags::WRITE | FileFlags::CREATE);
-	handle->Write(&buffer.size, sizeof(index_t), 0);
-	buffer.Write(*handle, sizeof(index_t));
+	// create the file and write the buffer contents. The size of the buffer follows from the size of the file, so the
+	// buffer is written at the (sector-aligned) start of the file, as required by Direct IO.
+	uint8_t flags = FileFlags::WRITE | FileFlags::CREATE;
+	if (use_direct_io) {
+		flags |= FileFlags::DIRECT_IO;
+	}
+	auto handle = fs.OpenFile(path, flags);
+	buffer.Write(*handle, 0);
 }
 
 unique_ptr<BufferHandle> BufferManager::ReadTemporaryBuffer(block_id_t id) {
@@ -240,25 +433,48 @@ unique_ptr<BufferHandle> BufferManager::ReadTemporaryBuffer(block_id_t id) {
 		throw Exception("Out-of-memory: cannot read buffer because no temporary directory is specified!\nTo enable "
 		                "temporary buffer eviction set a temporary directory in the configuration");
 	}
-	index_t alloc_size;
-	// open the temporary file and read the size
+	// the temporary file is removed once it is read: only one thread can read a temporary buffer at a time, and a
+	// thread that was waiting uses the buffer that was read in the meantime
+	lock_guard<mutex> load_lock(temporary_load_lock);
+	auto &shard = GetShard(id);
+	{
+		lock_guard<mutex> lock(shard.lock);
+		auto entry = shard.blocks.find(id);
+		if (entry != shard.blocks.end()) {
+			AddReference(shard, entry->second);
+			return make_unique<BufferHandle>(*this, id, (ManagedBuffer *)entry->second->buffer.get());
+		}
+	}
+	// open the temporary file and obtain the size of the buffer from the size of the file
 	auto path = GetTemporaryPath(id);
-	auto handle = fs.OpenFile(path, FileFlags::READ);
-	handle->Read(&alloc_size, sizeof(index_t), 0);
-	// first evict blocks until we can handle the size
-	while (current_memory + alloc_size > maximum_memory) {
-		EvictBlock();
+	uint8_t flags = FileFlags::READ;
+	if (use_direct_io) {
+		flags |= FileFlags::DIRECT_IO;
 	}
+	auto handle = fs.OpenFile(path, flags);
+	index_t alloc_size = fs.GetFileSize(*handle) - Storage::BLOCK_HEADER_SIZE;
+	// first evict blocks until we can handle the size
+	ReserveMemory(alloc_size);
 	// now allocate a buffer of this size and read the data into that buffer
-	auto buffer = make_unique<ManagedBuffer>(*this, alloc_size + Storage::BLOCK_HEADER_SIZE, false, id);
-	buffer->Read(*handle, sizeof(index_t));
+	unique_ptr<ManagedBuffer> buffer;
+	try {
+		buffer = make_unique<ManagedBuffer>(*this, alloc_size + Storage::BLOCK_HEADER_SIZE, false, id);
+		buffer->Read(*handle, 0);
+	} catch (...) {
+		current_memory -= alloc_size;
+		throw;
+	}
+	current_memory += buffer->AllocSize() - alloc_size;
+	// the buffer is rewritten if it is evicted again, so we can remove the file now
+	handle.reset();
+	DeleteTemporaryFile(id);
 
 	auto managed_buffer = buffer.get();
-	current_memory += buffer->AllocSize();
 	// create a new entry and append it to the used list
+	lock_guard<mutex> lock(shard.lock);
 	auto buffer_entry = make_unique<BufferEntry>(move(buffer));
-	blocks.insert(make_pair(id, buffer_entry.get()));
-	used_list.Append(move(buffer_entry));
+	shard.blocks.insert(make_pair(id, buffer_entry.get()));
+	shard.used_list.Append(move(buffer_entry));
 	// now return a handle to the entry
 	return make_unique<BufferHandle>(*this, id, managed_buffer);
 }
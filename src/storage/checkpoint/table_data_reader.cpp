@@ -29,17 +29,34 @@ void TableDataReader::ReadTableData() {
 		for (index_t data_ptr = 0; data_ptr < data_pointer_count; data_ptr++) {
 			// read the data pointer
 			DataPointer data_pointer;
-			data_pointer.min = reader.Read<double>();
-			data_pointer.max = reader.Read<double>();
+			reader.ReadData(data_pointer.min, sizeof(data_pointer.min));
+			reader.ReadData(data_pointer.max, sizeof(data_pointer.max));
 			data_pointer.row_start = reader.Read<index_t>();
 			data_pointer.tuple_count = reader.Read<index_t>();
 			data_pointer.block_id = reader.Read<block_id_t>();
 			data_pointer.offset = reader.Read<uint32_t>();
+			data_pointer.compressed = reader.Read<uint8_t>() != 0;
+			auto overflow_count = reader.Read<uint32_t>();
+			for (index_t i = 0; i < overflow_count; i++) {
+				data_pointer.overflow_blocks.push_back(reader.Read<block_id_t>());
+			}
 			// create a persistent segment
-			auto segment = make_unique<PersistentSegment>(manager.buffer_manager, data_pointer.block_id,
-			                                              data_pointer.offset, GetInternalType(column.type),
-			                                              data_pointer.row_start, data_pointer.tuple_count);
+			auto segment = make_unique<PersistentSegment>(
+			    manager.buffer_manager, data_pointer.block_id, data_pointer.offset, GetInternalType(column.type),
+			    data_pointer.row_start, data_pointer.tuple_count, data_pointer.compressed);
+			if (TypeIsNumeric(segment->type)) {
+				// load the statistics of the segment
+				memcpy(segment->stats.minimum.get(), data_pointer.min, segment->stats.type_size);
+				memcpy(segment->stats.maximum.get(), data_pointer.max, segment->stats.type_size);
+			}
+			segment->overflow_blocks = move(data_pointer.overflow_blocks);
 			info.data[col].push_back(move(segment));
 		}
 	}
+	// finally read the rows that are deleted
+	index_t deleted_count = reader.Read<index_t>();
+	info.deleted_rows.reserve(deleted_count);
+	for (index_t i = 0; i < deleted_count; i++) {
+		info.deleted_rows.push_back(reader.Read<row_t>());
+	}
 }
@@ -5,7 +5,9 @@
 
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/common/serializer/buffered_serializer.hpp"
+#include "duckdb/parallel/task.hpp"
 
+#include "duckdb/storage/compressed_numeric_segment.hpp"
 #include "duckdb/storage/numeric_segment.hpp"
 #include "duckdb/storage/string_segment.hpp"
 #include "duckdb/storage/table/column_segment.hpp"
@@ -13,6 +15,10 @@
 using namespace duckdb;
 using namespace std;
 
+namespace duckdb {
+
+//! Writes the big strings of a column to overflow blocks. The writer is shared by the segments of the column, so a big
+//! string that is repeated in different segments is only written once.
 class WriteOverflowStringsToDisk : public OverflowStringWriter {
 public:
 	WriteOverflowStringsToDisk(CheckpointManager &manager);
@@ -26,43 +32,118 @@ public:
 	block_id_t block_id;
 	//! The offset within the current block
 	index_t offset;
+	//! The blocks that have been allocated by the writer
+	vector<block_id_t> written_blocks;
+	//! The blocks holding the big strings of the current segment
+	vector<block_id_t> segment_blocks;
 
 	static constexpr index_t STRING_SPACE = Storage::BLOCK_SIZE - sizeof(block_id_t);
+	//! The maximum total size of the written strings that are kept to deduplicate the strings that follow
+	static constexpr index_t MAXIMUM_DEDUPLICATED_SIZE = 4 * Storage::BLOCK_SIZE;
 
 public:
 	void WriteString(string_t string, block_id_t &result_block, int32_t &result_offset) override;
+	//! Start writing the big strings of a new segment of the column
+	void StartSegment();
 
 private:
+	struct WrittenString {
+		block_id_t block_id;
+		int32_t offset;
+		//! The range of written blocks that the string is stored in
+		index_t first_block;
+		index_t last_block;
+	};
+	//! The written strings, up to MAXIMUM_DEDUPLICATED_SIZE
+	unordered_map<string, WrittenString> written_strings;
+	index_t deduplicated_size;
+
 	void AllocateNewBlock(block_id_t new_block_id);
+	//! Add the written blocks [first_block, last_block] to the blocks of the current segment
+	void AddSegmentBlocks(index_t first_block, index_t last_block);
 };
 
+} // namespace duckdb
+
 TableDataWriter::TableDataWriter(CheckpointManager &manager, TableCatalogEntry &table)
-    : manager(manager), table(table) {
+    : manager(manager), table(table), rewrite_all(false), row_count(0), compressed_block_id(INVALID_BLOCK),
+      compressed_offset(0) {
 }
 
 TableDataWriter::~TableDataWriter() {
 }
 
-void TableDataWriter::WriteTableData(Transaction &transaction) {
+//! Writes a single column of the table
+class WriteColumnTask : public Task {
+public:
+	WriteColumnTask(TableDataWriter &writer, Transaction &transaction, index_t col_idx)
+	    : writer(writer), transaction(transaction), col_idx(col_idx) {
+	}
+
+	TableDataWriter &writer;
+	Transaction &transaction;
+	index_t col_idx;
+
+public:
+	void Execute() override {
+		writer.WriteColumn(transaction, col_idx);
+	}
+};
+
+void TableDataWriter::ScheduleTasks(Transaction &transaction, vector<unique_ptr<Task>> &tasks) {
 	// allocate segments to write the table to
 	segments.resize(table.columns.size());
+	overflow_writers.resize(table.columns.size());
 	data_pointers.resize(table.columns.size());
+	compression_buffers.resize(table.columns.size());
 	for (index_t i = 0; i < table.columns.size(); i++) {
 		auto type_id = GetInternalType(table.columns[i].type);
 		stats.push_back(make_unique<SegmentStatistics>(type_id, GetTypeIdSize(type_id)));
 		CreateSegment(i);
 	}
+	// the rows that were appended after the checkpoint started are not part of the checkpoint
+	row_count = table.storage->GetCommittedRows(transaction);
+	if (manager.keep_row_ids) {
+		// the deleted rows are written as well, and stored as deleted rows
+		table.storage->GetDeletedRows(transaction, row_count, deleted_rows);
+		rewrite_all = false;
+		// the keys of the deleted rows are not written to the indexes of the table
+		row_map.deleted_rows = deleted_rows;
+		row_map.compacted = false;
+	} else {
+		// if the row ids of the rows are unchanged by the checkpoint only the modified and appended rows have to be
+		// written, and the unmodified persistent segments are reused. Otherwise the deleted rows are removed from the
+		// table, which changes the row ids of all rows that follow them: the entire table is rewritten.
+		rewrite_all = !table.storage->AllRowsVisible(transaction);
+	}
+	// the columns are written independently of each other
+	for (index_t i = 0; i < table.columns.size(); i++) {
+		tasks.push_back(make_unique<WriteColumnTask>(*this, transaction, i));
+	}
+}
 
-	// now start scanning the table and append the data to the uncompressed segments
-	vector<column_t> column_ids;
-	for (auto &column : table.columns) {
-		column_ids.push_back(column.oid);
+void TableDataWriter::WriteColumn(Transaction &transaction, index_t col_idx) {
+	if (rewrite_all) {
+		WriteAllRows(transaction, col_idx);
+	} else {
+		WriteChangedRows(transaction, col_idx);
+	}
+}
+
+void TableDataWriter::WriteAllRows(Transaction &transaction, index_t col_idx) {
+	// scan the column and append the data to the uncompressed segments
+	vector<column_t> column_ids = {table.columns[col_idx].oid};
+	vector<TypeId> types = {GetInternalType(table.columns[col_idx].type)};
+	// for the first column we also scan the row ids, to keep track of the rows that are skipped because they were
+	// deleted
+	bool track_rows = col_idx == 0;
+	if (track_rows) {
+		column_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
+		types.push_back(ROW_TYPE);
 	}
 	// initialize scan structures to prepare for the scan
 	TableScanState state;
 	table.storage->InitializeScan(transaction, state, column_ids);
-	//! get all types of the table and initialize the chunk
-	auto types = table.GetTypes();
 	DataChunk chunk;
 	chunk.Initialize(types);
 
@@ -73,24 +154,126 @@ void TableDataWriter::WriteTableData(Transaction &transaction) {
 		if (chunk.size() == 0) {
 			break;
 		}
-		// for each column, we append whatever we can fit into the block
-		for (index_t i = 0; i < table.columns.size(); i++) {
-			assert(chunk.data[i].type == GetInternalType(table.columns[i].type));
-			AppendData(i, chunk.data[i]);
+		AppendData(col_idx, chunk.data[0]);
+		if (!track_rows) {
+			continue;
 		}
+		auto &row_ids = chunk.data[1];
+		auto row_data = (row_t *)row_ids.data;
+		VectorOperations::Exec(row_ids, [&](index_t i, index_t k) {
+			for (; row_map.row_end < row_data[i]; row_map.row_end++) {
+				row_map.deleted_rows.push_back(row_map.row_end);
+			}
+			row_map.row_end = row_data[i] + 1;
+		});
 	}
-	// flush any remaining data and write the data pointers to disk
-	for (index_t i = 0; i < table.columns.size(); i++) {
-		FlushSegment(i);
+	// flush any remaining data
+	FlushSegment(col_idx);
+}
+
+void TableDataWriter::WriteChangedRows(Transaction &transaction, index_t col_idx) {
+	// find the end of the persistent rows of the column, the transient rows follow them
+	index_t persistent_end = 0, row_end = row_count;
+	for (auto segment = table.storage->GetRootSegment(col_idx); segment;
+	     segment = (ColumnSegment *)segment->next.get()) {
+		if (segment->segment_type != ColumnSegmentType::PERSISTENT) {
+			break;
+		}
+		persistent_end = segment->start + segment->count;
+	}
+	assert(persistent_end <= row_end);
+	// now write the column, reusing the unmodified persistent segments. A scan steps through a segment by whole
+	// vectors, so every segment except the last one has to start and end at a vector boundary: a segment can only be
+	// reused if it does, and the rows that are written in between are appended to the same segment until the next
+	// reused segment
+	index_t write_start = 0;
+	for (auto segment = table.storage->GetRootSegment(col_idx); segment;
+	     segment = (ColumnSegment *)segment->next.get()) {
+		if (segment->segment_type != ColumnSegmentType::PERSISTENT) {
+			break;
+		}
+		auto &persistent = (PersistentSegment &)*segment;
+		index_t segment_end = segment->start + segment->count;
+		if (persistent.IsModified() || segment->start % STANDARD_VECTOR_SIZE != 0 ||
+		    (segment_end % STANDARD_VECTOR_SIZE != 0 && segment_end != row_end)) {
+			continue;
+		}
+		// write the rows in front of the segment, and then reuse the segment itself
+		WriteRows(transaction, col_idx, write_start, segment->start, true);
+		FlushSegment(col_idx);
+		CreateSegment(col_idx);
+		ReuseSegment(col_idx, persistent);
+		write_start = segment_end;
+	}
+	// finally write the remaining persistent rows and the appended rows
+	WriteRows(transaction, col_idx, write_start, persistent_end, true);
+	WriteRows(transaction, col_idx, 0, row_end - persistent_end, false);
+	FlushSegment(col_idx);
+
+	if (col_idx == 0) {
+		row_map.row_end = row_end;
 	}
-	WriteDataPointers();
+}
+
+void TableDataWriter::WriteRows(Transaction &transaction, index_t col_idx, index_t start_row, index_t end_row,
+                                bool persistent) {
+	if (start_row >= end_row) {
+		return;
+	}
+	vector<column_t> column_ids = {table.columns[col_idx].oid};
+	TableScanState state;
+	table.storage->InitializeScanWithOffset(state, column_ids, start_row, end_row, persistent);
+	// the rows keep their position in the column: deleted rows are written too
+	state.scan_deleted_rows = true;
+	vector<TypeId> types = {GetInternalType(table.columns[col_idx].type)};
+	DataChunk chunk;
+	chunk.Initialize(types);
+	while (true) {
+		chunk.Reset();
+		table.storage->Scan(transaction, chunk, state);
+		if (chunk.size() == 0) {
+			break;
+		}
+		AppendData(col_idx, chunk.data[0]);
+	}
+}
+
+void TableDataWriter::ReuseSegment(index_t col_idx, PersistentSegment &segment) {
+	DataPointer data_pointer;
+	memset(data_pointer.min, 0, sizeof(data_pointer.min));
+	memset(data_pointer.max, 0, sizeof(data_pointer.max));
+	if (TypeIsNumeric(segment.type)) {
+		memcpy(data_pointer.min, segment.stats.minimum.get(), segment.stats.type_size);
+		memcpy(data_pointer.max, segment.stats.maximum.get(), segment.stats.type_size);
+	}
+	data_pointer.row_start = segment.start;
+	data_pointer.tuple_count = segment.count;
+	data_pointer.block_id = segment.block_id;
+	data_pointer.offset = segment.offset;
+	data_pointer.compressed = segment.compressed;
+	data_pointer.overflow_blocks = segment.overflow_blocks;
+	assert(data_pointers[col_idx].size() == 0 ||
+	       data_pointers[col_idx].back().row_start + data_pointers[col_idx].back().tuple_count == segment.start);
+	// the blocks of the segment are kept by the checkpoint
+	manager.block_manager.MarkBlockAsUsed(segment.block_id);
+	for (auto &block_id : segment.overflow_blocks) {
+		manager.block_manager.MarkBlockAsUsed(block_id);
+	}
+	data_pointers[col_idx].push_back(move(data_pointer));
 }
 
 void TableDataWriter::CreateSegment(index_t col_idx) {
 	auto type_id = GetInternalType(table.columns[col_idx].type);
+	stats[col_idx]->Reset();
 	if (type_id == TypeId::VARCHAR) {
 		auto string_segment = make_unique<StringSegment>(manager.buffer_manager, 0);
-		string_segment->overflow_writer = make_unique<WriteOverflowStringsToDisk>(manager);
+		if (!overflow_writers[col_idx]) {
+			overflow_writers[col_idx] = make_unique<WriteOverflowStringsToDisk>(manager);
+		}
+		overflow_writers[col_idx]->StartSegment();
+		string_segment->overflow_writer = overflow_writers[col_idx].get();
+		// deduplicate the strings of the segment, so repeated strings are only written once
+		string_segment->dictionary = make_unique<unordered_map<string, int32_t>>();
 		segments[col_idx] = move(string_segment);
 	} else {
 		segments[col_idx] = make_unique<NumericSegment>(manager.buffer_manager, type_id, 0);
@@ -125,25 +308,84 @@ void TableDataWriter::FlushSegment(index_t col_idx) {
 	// get the buffer of the segment and pin it
 	auto handle = manager.buffer_manager.Pin(segments[col_idx]->block_id);
 
-	// get a free block id to write to
-	auto block_id = manager.block_manager.GetFreeBlockId();
-
-	// construct the data pointer, FIXME: add statistics as well
+	// construct the data pointer
 	DataPointer data_pointer;
-	data_pointer.block_id = block_id;
-	data_pointer.offset = 0;
+	memset(data_pointer.min, 0, sizeof(data_pointer.min));
+	memset(data_pointer.max, 0, sizeof(data_pointer.max));
+	if (TypeIsNumeric(stats[col_idx]->type)) {
+		memcpy(data_pointer.min, stats[col_idx]->minimum.get(), stats[col_idx]->type_size);
+		memcpy(data_pointer.max, stats[col_idx]->maximum.get(), stats[col_idx]->type_size);
+	}
 	data_pointer.row_start = 0;
 	if (data_pointers[col_idx].size() > 0) {
 		auto &last_pointer = data_pointers[col_idx].back();
 		data_pointer.row_start = last_pointer.row_start + last_pointer.tuple_count;
 	}
 	data_pointer.tuple_count = tuple_count;
+	if (segments[col_idx]->type == TypeId::VARCHAR) {
+		// keep track of the blocks that the big strings of the segment were written to
+		data_pointer.overflow_blocks = overflow_writers[col_idx]->segment_blocks;
+	}
+	if (FlushCompressedSegment(col_idx, handle->node->buffer, data_pointer)) {
+		data_pointers[col_idx].push_back(data_pointer);
+		return;
+	}
+	// the segment cannot be compressed: write it to its own block
+	auto block_id = manager.block_manager.GetFreeBlockId();
+	data_pointer.block_id = block_id;
+	data_pointer.offset = 0;
+	data_pointer.compressed = false;
 	data_pointers[col_idx].push_back(data_pointer);
 	// write the block to disk
 	manager.block_manager.Write(*handle->node, block_id);
 }
 
+bool TableDataWriter::FlushCompressedSegment(index_t col_idx, data_ptr_t segment_data, DataPointer &data_pointer) {
+	auto &segment = *segments[col_idx];
+	if (!CompressedNumericSegment::SupportsType(segment.type)) {
+		return false;
+	}
+	auto &compression_buffer = compression_buffers[col_idx];
+	if (!compression_buffer) {
+		compression_buffer = unique_ptr<data_t[]>(new data_t[Storage::BLOCK_SIZE]);
+	}
+	auto compressed_size = CompressedNumericSegment::Compress(segment.type, segment_data, segment.tuple_count,
+	                                                          compression_buffer.get(), Storage::BLOCK_SIZE);
+	if (compressed_size == INVALID_INDEX) {
+		// the compressed segment does not fit in a block
+		return false;
+	}
+	// the compressed block is shared by the columns of the table
+	lock_guard<mutex> guard(compressed_lock);
+	if (compressed_block_id == INVALID_BLOCK || compressed_offset + compressed_size > Storage::BLOCK_SIZE) {
+		// the segment does not fit in the current compressed block: write it and start a new one
+		FlushCompressedBlock();
+		if (!compressed_handle) {
+			compressed_handle = manager.buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
+		}
+		compressed_block_id = manager.block_manager.GetFreeBlockId();
+	}
+	memcpy(compressed_handle->node->buffer + compressed_offset, compression_buffer.get(), compressed_size);
+	data_pointer.block_id = compressed_block_id;
+	data_pointer.offset = compressed_offset;
+	data_pointer.compressed = true;
+	// keep the compressed segments 8-byte aligned
+	compressed_offset = (compressed_offset + compressed_size + 7) & ~(index_t)7;
+	return true;
+}
+
+void TableDataWriter::FlushCompressedBlock() {
+	if (compressed_block_id == INVALID_BLOCK) {
+		return;
+	}
+	manager.block_manager.Write(*compressed_handle->node, compressed_block_id);
+	compressed_block_id = INVALID_BLOCK;
+	compressed_offset = 0;
+}
+
 void TableDataWriter::WriteDataPointers() {
+	// the last compressed block is written once all columns have been written
+	FlushCompressedBlock();
 	for (index_t i = 0; i < data_pointers.size(); i++) {
 		// get a reference to the data column
 		auto &data_pointer_list = data_pointers[i];
@@ -151,18 +393,28 @@ void TableDataWriter::WriteDataPointers() {
 		// then write the data pointers themselves
 		for (index_t k = 0; k < data_pointer_list.size(); k++) {
 			auto &data_pointer = data_pointer_list[k];
-			manager.tabledata_writer->Write<double>(data_pointer.min);
-			manager.tabledata_writer->Write<double>(data_pointer.max);
+			manager.tabledata_writer->WriteData(data_pointer.min, sizeof(data_pointer.min));
+			manager.tabledata_writer->WriteData(data_pointer.max, sizeof(data_pointer.max));
 			manager.tabledata_writer->Write<index_t>(data_pointer.row_start);
 			manager.tabledata_writer->Write<index_t>(data_pointer.tuple_count);
 			manager.tabledata_writer->Write<block_id_t>(data_pointer.block_id);
 			manager.tabledata_writer->Write<uint32_t>(data_pointer.offset);
+			manager.tabledata_writer->Write<uint8_t>(data_pointer.compressed ? 1 : 0);
+			manager.tabledata_writer->Write<uint32_t>(data_pointer.overflow_blocks.size());
+			for (auto &block_id : data_pointer.overflow_blocks) {
+				manager.tabledata_writer->Write<block_id_t>(block_id);
+			}
 		}
 	}
+	// finally write the rows that are deleted
+	manager.tabledata_writer->Write<index_t>(deleted_rows.size());
+	for (auto &row_id : deleted_rows) {
+		manager.tabledata_writer->Write<row_t>(row_id);
+	}
 }
 
 WriteOverflowStringsToDisk::WriteOverflowStringsToDisk(CheckpointManager &manager)
-    : manager(manager), handle(nullptr), block_id(INVALID_BLOCK), offset(0) {
+    : manager(manager), handle(nullptr), block_id(INVALID_BLOCK), offset(0), deduplicated_size(0) {
 }
 
 WriteOverflowStringsToDisk::~WriteOverflowStringsToDisk() {
@@ -171,7 +423,20 @@ WriteOverflowStringsToDisk::~WriteOverflowStringsToDisk() {
 	}
 }
 
+void WriteOverflowStringsToDisk::StartSegment() {
+	segment_blocks.clear();
+}
+
 void WriteOverflowStringsToDisk::WriteString(string_t string, block_id_t &result_block, int32_t &result_offset) {
+	// check if the string was already written for a previous segment
+	auto entry = written_strings.find(std::string(string.data, string.length));
+	if (entry != written_strings.end()) {
+		// it was: point to the existing string
+		result_block = entry->second.block_id;
+		result_offset = entry->second.offset;
+		AddSegmentBlocks(entry->second.first_block, entry->second.last_block);
+		return;
+	}
 	if (!handle) {
 		handle = manager.buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
 	}
@@ -181,6 +446,7 @@ void WriteOverflowStringsToDisk::WriteString(string_t string, block_id_t &result
 	}
 	result_block = block_id;
 	result_offset = offset;
+	index_t first_block = written_blocks.size() - 1;
 
 	// write the length field
 	*((uint32_t *)(handle->node->buffer + offset)) = string.length;
@@ -206,6 +472,24 @@ void WriteOverflowStringsToDisk::WriteString(string_t string, block_id_t &result
 			AllocateNewBlock(new_block_id);
 		}
 	}
+	AddSegmentBlocks(first_block, written_blocks.size() - 1);
+	if (deduplicated_size + string.length <= MAXIMUM_DEDUPLICATED_SIZE) {
+		deduplicated_size += string.length;
+		WrittenString written_string;
+		written_string.block_id = result_block;
+		written_string.offset = result_offset;
+		written_string.first_block = first_block;
+		written_string.last_block = written_blocks.size() - 1;
+		written_strings[std::string(string.data, string.length)] = written_string;
+	}
+}
+
+void WriteOverflowStringsToDisk::AddSegmentBlocks(index_t first_block, index_t last_block) {
+	for (index_t i = first_block; i <= last_block; i++) {
+		if (std::find(segment_blocks.begin(), segment_blocks.end(), written_blocks[i]) == segment_blocks.end()) {
+			segment_blocks.push_back(written_blocks[i]);
+		}
+	}
 }
 
 void WriteOverflowStringsToDisk::AllocateNewBlock(block_id_t new_block_id) {
@@ -215,4 +499,5 @@ void WriteOverflowStringsToDisk::AllocateNewBlock(block_id_t new_block_id) {
 	}
 	offset = 0;
 	block_id = new_block_id;
+	written_blocks.push_back(new_block_id);
 }
@@ -7,6 +7,7 @@
 #include "duckdb/common/types/null_value.hpp"
 
 #include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/sequence_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
@@ -16,12 +17,20 @@
 #include "duckdb/parser/parsed_data/create_table_info.hpp"
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
 
+#include "duckdb/parser/statement/create_index_statement.hpp"
+
 #include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/operator/logical_create_index.hpp"
 #include "duckdb/planner/parsed_data/bound_create_table_info.hpp"
+#include "duckdb/planner/planner.hpp"
+
+#include "duckdb/execution/index/art/art.hpp"
 
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 
+#include "duckdb/parallel/task_scheduler.hpp"
+
 #include "duckdb/transaction/transaction_manager.hpp"
 
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
@@ -33,14 +42,39 @@ using namespace std;
 // constexpr uint64_t CheckpointManager::DATA_BLOCK_HEADER_SIZE;
 
 CheckpointManager::CheckpointManager(StorageManager &manager)
-    : block_manager(*manager.block_manager), buffer_manager(*manager.buffer_manager), database(manager.database) {
+    : block_manager(*manager.block_manager), buffer_manager(*manager.buffer_manager), database(manager.database),
+      keep_row_ids(false) {
 }
 
-void CheckpointManager::CreateCheckpoint() {
-	// assert that the checkpoint manager hasn't been used before
-	assert(!metadata_writer);
+CheckpointManager::~CheckpointManager() {
+}
 
+void CheckpointManager::CreateCheckpoint(index_t wal_offset) {
 	auto transaction = database.transaction_manager->StartTransaction();
+	WriteCheckpoint(*transaction, wal_offset);
+	database.transaction_manager->RollbackTransaction(transaction);
+}
+
+index_t CheckpointManager::CreateOnlineCheckpoint() {
+	// the header of the checkpoint gets the next iteration
+	index_t wal_offset;
+	auto transaction =
+	    database.transaction_manager->StartCheckpointTransaction(block_manager.GetIteration() + 1, wal_offset);
+	keep_row_ids = true;
+	try {
+		WriteCheckpoint(*transaction, wal_offset);
+	} catch (...) {
+		database.transaction_manager->RollbackTransaction(transaction);
+		throw;
+	}
+	// the checkpoint only reads from the database: end its transaction by rolling it back
+	database.transaction_manager->RollbackTransaction(transaction);
+	return wal_offset;
+}
+
+void CheckpointManager::WriteCheckpoint(Transaction &transaction, index_t wal_offset) {
+	// assert that the checkpoint manager hasn't been used before
+	assert(!metadata_writer);
 
 	//! Set up the writers for the checkpoints
 	metadata_writer = make_unique<MetaBlockWriter>(block_manager);
@@ -51,13 +85,15 @@ void CheckpointManager::CreateCheckpoint() {
 
 	vector<SchemaCatalogEntry *> schemas;
 	// we scan the schemas
-	database.catalog->schemas.Scan(*transaction,
+	database.catalog->schemas.Scan(transaction,
 	                               [&](CatalogEntry *entry) { schemas.push_back((SchemaCatalogEntry *)entry); });
+	// first write the data of the tables, the metadata is written afterwards in catalog order
+	WriteTableData(transaction, schemas);
 	// write the actual data into the database
 	// write the amount of schemas
 	metadata_writer->Write<uint32_t>(schemas.size());
 	for (auto &schema : schemas) {
-		WriteSchema(*transaction, *schema);
+		WriteSchema(transaction, *schema);
 	}
 	// flush the meta data to disk
 	metadata_writer->Flush();
@@ -66,6 +102,7 @@ void CheckpointManager::CreateCheckpoint() {
 	// finally write the updated header
 	DatabaseHeader header;
 	header.meta_block = meta_block;
+	header.wal_offset = wal_offset;
 	block_manager.WriteHeader(header);
 }
 
@@ -87,6 +124,23 @@ void CheckpointManager::LoadFromStorage() {
 	context.transaction.Commit();
 }
 
+void CheckpointManager::WriteTableData(Transaction &transaction, vector<SchemaCatalogEntry *> &schemas) {
+	vector<unique_ptr<Task>> tasks;
+	for (auto &schema : schemas) {
+		schema->tables.Scan(transaction, [&](CatalogEntry *entry) {
+			if (entry->type == CatalogType::TABLE) {
+				auto table = (TableCatalogEntry *)entry;
+				auto writer = make_unique<TableDataWriter>(*this, *table);
+				writer->ScheduleTasks(transaction, tasks);
+				table_writers[table] = move(writer);
+			}
+		});
+	}
+	// the columns of all tables are written concurrently, with a low priority so checkpoints that run while the database
+	// is in use do not hold up the queries
+	database.scheduler->ExecuteTasks(move(tasks), TaskPriority::LOW);
+}
+
 //===--------------------------------------------------------------------===//
 // Schema
 //===--------------------------------------------------------------------===//
@@ -105,6 +159,14 @@ void CheckpointManager::WriteSchema(Transaction &transaction, SchemaCatalogEntry
 			throw NotImplementedException("Catalog type for entries");
 		}
 	});
+	// the indexes are written together with the table they belong to
+	unordered_map<DataTable *, vector<IndexCatalogEntry *>> indexes;
+	schema.indexes.Scan(transaction, [&](CatalogEntry *entry) {
+		auto index = (IndexCatalogEntry *)entry;
+		if (index->index) {
+			indexes[index->storage.get()].push_back(index);
+		}
+	});
 	vector<SequenceCatalogEntry *> sequences;
 	schema.sequences.Scan(transaction,
 	                      [&](CatalogEntry *entry) { sequences.push_back((SequenceCatalogEntry *)entry); });
@@ -117,7 +179,7 @@ void CheckpointManager::WriteSchema(Transaction &transaction, SchemaCatalogEntry
 	// now write the tables
 	metadata_writer->Write<uint32_t>(tables.size());
 	for (auto &table : tables) {
-		WriteTable(transaction, *table);
+		WriteTable(transaction, *table, indexes[table->storage.get()]);
 	}
 	// finally write the views
 	metadata_writer->Write<uint32_t>(views.size());
@@ -176,19 +238,86 @@ void CheckpointManager::ReadSequence(ClientContext &context, MetaBlockReader &re
 	database.catalog->CreateSequence(context.ActiveTransaction(), info.get());
 }
 
+//===--------------------------------------------------------------------===//
+// Indexes
+//===--------------------------------------------------------------------===//
+static void WriteBlockPointer(Serializer &serializer, BlockPointer pointer) {
+	serializer.Write<block_id_t>(pointer.block_id);
+	serializer.Write<uint32_t>(pointer.offset);
+}
+
+static BlockPointer ReadBlockPointer(Deserializer &source) {
+	BlockPointer pointer;
+	pointer.block_id = source.Read<block_id_t>();
+	pointer.offset = source.Read<uint32_t>();
+	return pointer;
+}
+
+void CheckpointManager::WriteIndex(IndexCatalogEntry &index, RowIdMap &row_map) {
+	index.Serialize(*metadata_writer);
+	// write the nodes of the index together with the table data
+	assert(index.index->type == IndexType::ART);
+	auto root = ((ART &)*index.index).Serialize(*tabledata_writer, row_map);
+	WriteBlockPointer(*metadata_writer, root);
+}
+
+void CheckpointManager::ReadIndex(ClientContext &context, MetaBlockReader &reader) {
+	auto info = IndexCatalogEntry::Deserialize(reader);
+	auto root = ReadBlockPointer(reader);
+
+	// bind the index to the table
+	Planner planner(context);
+	planner.CreatePlan(make_unique<CreateIndexStatement>(move(info)));
+	assert(planner.plan->type == LogicalOperatorType::CREATE_INDEX);
+	auto &create_index = (LogicalCreateIndex &)*planner.plan;
+	auto &table = create_index.table;
+	auto index_entry = table.schema->CreateIndex(context.ActiveTransaction(), create_index.info.get());
+	assert(index_entry);
+
+	// instead of scanning the table to build the index, only the root node is read: the other nodes are read from
+	// storage when they are first accessed
+	auto art = make_unique<ART>(*table.storage, create_index.column_ids, move(create_index.unbound_expressions));
+	art->Load(root);
+	index_entry->index = art.get();
+	index_entry->storage = table.storage;
+	table.storage->indexes.push_back(move(art));
+}
+
 //===--------------------------------------------------------------------===//
 // Table Metadata
 //===--------------------------------------------------------------------===//
-void CheckpointManager::WriteTable(Transaction &transaction, TableCatalogEntry &table) {
+void CheckpointManager::WriteTable(Transaction &transaction, TableCatalogEntry &table,
+                                   vector<IndexCatalogEntry *> &indexes) {
 	// write the table meta data
 	table.Serialize(*metadata_writer);
 	//! write the blockId for the table info
 	metadata_writer->Write<block_id_t>(tabledata_writer->block->id);
 	//! and the offset to where the info starts
 	metadata_writer->Write<uint64_t>(tabledata_writer->offset);
-	// now we need to write the table data
-	TableDataWriter writer(*this, table);
-	writer.WriteTableData(transaction);
+	// now we need to write the table data, the columns of the table have already been written
+	assert(table_writers.find(&table) != table_writers.end());
+	auto &writer = *table_writers[&table];
+	writer.WriteDataPointers();
+	// write the indexes of the UNIQUE constraints, which are the first indexes of the table
+	index_t unique_count = 0;
+	for (auto &constraint : table.bound_constraints) {
+		if (constraint->type == ConstraintType::UNIQUE) {
+			unique_count++;
+		}
+	}
+	assert(unique_count <= table.storage->indexes.size());
+	metadata_writer->Write<uint32_t>(unique_count);
+	for (index_t i = 0; i < unique_count; i++) {
+		auto &index = table.storage->indexes[i];
+		assert(index->type == IndexType::ART);
+		WriteBlockPointer(*metadata_writer, ((ART &)*index).Serialize(*tabledata_writer, writer.row_map));
+	}
+	// finally write the indexes that were created with CREATE INDEX
+	metadata_writer->Write<uint32_t>(indexes.size());
+	for (auto &index : indexes) {
+		WriteIndex(*index, writer.row_map);
+	}
+	table_writers.erase(&table);
 }
 
 void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reader) {
@@ -205,7 +334,28 @@ void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reade
 	table_data_reader.offset = offset;
 	TableDataReader data_reader(*this, table_data_reader, *bound_info);
 	data_reader.ReadTableData();
+	// read the locations of the indexes of the UNIQUE constraints
+	auto unique_count = reader.Read<uint32_t>();
+	for (uint32_t i = 0; i < unique_count; i++) {
+		bound_info->indexes.push_back(ReadBlockPointer(reader));
+	}
 
-	// finally create the table in the catalog
+	// create the table in the catalog
 	database.catalog->CreateTable(context.ActiveTransaction(), bound_info.get());
+	if (bound_info->deleted_rows.size() > 0) {
+		// the checkpoint kept the deleted rows of the table: delete them again
+		auto table = database.catalog->GetTable(context, bound_info->base->schema, bound_info->base->table);
+		auto &deleted_rows = bound_info->deleted_rows;
+		for (index_t i = 0; i < deleted_rows.size(); i += STANDARD_VECTOR_SIZE) {
+			Vector row_ids(ROW_TYPE, (data_ptr_t)&deleted_rows[i]);
+			row_ids.count = std::min((index_t)STANDARD_VECTOR_SIZE, deleted_rows.size() - i);
+			table->storage->Delete(*table, context, row_ids);
+		}
+	}
+
+	// finally read the indexes that were created with CREATE INDEX
+	auto index_count = reader.Read<uint32_t>();
+	for (uint32_t i = 0; i < index_count; i++) {
+		ReadIndex(context, reader);
+	}
 }
@@ -7,6 +7,9 @@
 using namespace duckdb;
 using namespace std;
 
+//! The amount of persistent segments whose blocks are read ahead of a scan
+#define COLUMN_READ_AHEAD_SEGMENTS 8
+
 ColumnData::ColumnData() : persistent_rows(0) {
 }
 
@@ -21,10 +24,56 @@ void ColumnData::InitializeScan(ColumnScanState &state) {
 	state.current = (ColumnSegment *)data.GetRootSegment();
 	state.vector_index = 0;
 	state.initialized = false;
+	state.read_ahead_row = 0;
+}
+
+void ColumnData::InitializeScanWithOffset(ColumnScanState &state, index_t row_idx) {
+	state.current = (ColumnSegment *)data.GetSegment(row_idx);
+	state.vector_index = (row_idx - state.current->start) / STANDARD_VECTOR_SIZE;
+	state.initialized = false;
+	state.read_ahead_row = 0;
+}
+
+//! Announce the blocks of the persistent segments that follow the current segment to the buffer manager, so they are
+//! loaded in the background while the current segment is scanned. The blocks are announced in batches of half of the
+//! read-ahead window, so the reads of adjacent blocks can be merged.
+static void ReadAhead(ColumnScanState &state) {
+	auto segment = state.current->next.get();
+	index_t announced_segments = 0;
+	while (segment && segment->start < state.read_ahead_row) {
+		announced_segments++;
+		segment = segment->next.get();
+	}
+	if (!segment || announced_segments >= COLUMN_READ_AHEAD_SEGMENTS / 2) {
+		return;
+	}
+	PersistentSegment *persistent = nullptr;
+	vector<block_id_t> block_ids;
+	for (; segment && announced_segments < COLUMN_READ_AHEAD_SEGMENTS; segment = segment->next.get()) {
+		auto column_segment = (ColumnSegment *)segment;
+		if (column_segment->segment_type != ColumnSegmentType::PERSISTENT) {
+			// the persistent segments precede the transient segments
+			break;
+		}
+		persistent = (PersistentSegment *)column_segment;
+		if (!persistent->IsModified()) {
+			// segments that have been modified are no longer read from their blocks
+			block_ids.push_back(persistent->block_id);
+			block_ids.insert(block_ids.end(), persistent->overflow_blocks.begin(), persistent->overflow_blocks.end());
+		}
+		state.read_ahead_row = segment->start + segment->count;
+		announced_segments++;
+	}
+	if (persistent) {
+		persistent->manager.Prefetch(block_ids);
+	}
 }
 
 void ColumnData::Scan(Transaction &transaction, ColumnScanState &state, Vector &result) {
 	if (!state.initialized) {
+		if (state.current->segment_type == ColumnSegmentType::PERSISTENT) {
+			ReadAhead(state);
+		}
 		state.current->InitializeScan(state);
 		state.initialized = true;
 	}
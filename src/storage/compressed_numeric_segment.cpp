@@ -0,0 +1,438 @@
+#include "duckdb/storage/compressed_numeric_segment.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include <type_traits>
+
+using namespace duckdb;
+using namespace std;
+
+//! The header of a compressed vector, followed by the nullmask of the vector (if it has NULL values) and the
+//! compressed values
+struct CompressedVectorHeader {
+	//! The compression method of the vector
+	NumericCompression compression;
+	//! Whether or not the vector has NULL values
+	uint8_t has_null;
+	//! The bit width of the packed values (BITPACKING and DELTA only)
+	uint8_t bit_width;
+	uint8_t padding;
+	//! The amount of runs (RLE only)
+	uint32_t run_count;
+};
+
+static index_t AlignSize(index_t size) {
+	return (size + 7) & ~(index_t)7;
+}
+
+static index_t PackedSize(index_t count, uint8_t bit_width) {
+	return ((count * bit_width + 63) / 64) * sizeof(uint64_t);
+}
+
+static uint8_t BitWidth(uint64_t range) {
+	uint8_t bit_width = 0;
+	while (range > 0) {
+		bit_width++;
+		range >>= 1;
+	}
+	return bit_width;
+}
+
+//===--------------------------------------------------------------------===//
+// Bit packing
+//===--------------------------------------------------------------------===//
+template <class U> static void BitPack(U *__restrict values, index_t count, uint8_t bit_width, uint64_t *__restrict target) {
+	if (bit_width == 0) {
+		return;
+	}
+	memset(target, 0, PackedSize(count, bit_width));
+	for (index_t i = 0; i < count; i++) {
+		auto value = (uint64_t)values[i];
+		index_t bit_position = i * bit_width;
+		index_t word = bit_position >> 6;
+		index_t shift = bit_position & 63;
+		target[word] |= value << shift;
+		if (shift + bit_width > 64) {
+			// the value straddles two words
+			target[word + 1] |= value >> (64 - shift);
+		}
+	}
+}
+
+template <class U>
+static void BitUnpack(uint64_t *__restrict source, index_t count, uint8_t bit_width, U base, U *__restrict target) {
+	if (bit_width == 0) {
+		for (index_t i = 0; i < count; i++) {
+			target[i] = base;
+		}
+		return;
+	}
+	uint64_t mask = bit_width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << bit_width) - 1;
+	for (index_t i = 0; i < count; i++) {
+		index_t bit_position = i * bit_width;
+		index_t word = bit_position >> 6;
+		index_t shift = bit_position & 63;
+		uint64_t value = source[word] >> shift;
+		if (shift + bit_width > 64) {
+			value |= source[word + 1] << (64 - shift);
+		}
+		target[i] = (U)(base + (U)(value & mask));
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Compress
+//===--------------------------------------------------------------------===//
+template <class T>
+static index_t CompressVector(T *source, nullmask_t &nullmask, index_t count, data_ptr_t target, index_t capacity) {
+	typedef typename std::make_unsigned<T>::type U;
+	typedef typename std::make_signed<U>::type S;
+	assert(count > 0);
+
+	// replace the NULL values with the previous value, so they do not affect the range or the runs of the values
+	U values[STANDARD_VECTOR_SIZE];
+	bool has_null = false;
+	U last_value = 0;
+	for (index_t i = 0; i < count; i++) {
+		if (!nullmask[i]) {
+			last_value = (U)source[i];
+			break;
+		}
+	}
+	for (index_t i = 0; i < count; i++) {
+		if (nullmask[i]) {
+			has_null = true;
+			values[i] = last_value;
+		} else {
+			last_value = values[i] = (U)source[i];
+		}
+	}
+
+	// analyze the range, the runs and the differences of the values
+	T min = (T)values[0], max = (T)values[0];
+	S min_delta = 0, max_delta = 0;
+	index_t run_count = 1;
+	for (index_t i = 1; i < count; i++) {
+		T value = (T)values[i];
+		if (value < min) {
+			min = value;
+		}
+		if (value > max) {
+			max = value;
+		}
+		if (values[i] != values[i - 1]) {
+			run_count++;
+		}
+		S delta = (S)(U)(values[i] - values[i - 1]);
+		if (i == 1 || delta < min_delta) {
+			min_delta = delta;
+		}
+		if (i == 1 || delta > max_delta) {
+			max_delta = delta;
+		}
+	}
+	uint8_t bit_width = BitWidth((U)((U)max - (U)min));
+	uint8_t delta_bit_width = BitWidth((U)((U)max_delta - (U)min_delta));
+
+	// pick the compression method that results in the smallest size
+	NumericCompression compression = NumericCompression::UNCOMPRESSED;
+	index_t payload_size = AlignSize(count * sizeof(T));
+	index_t rle_size = AlignSize(run_count * sizeof(T)) + AlignSize(run_count * sizeof(uint16_t));
+	if (rle_size < payload_size) {
+		compression = NumericCompression::RLE;
+		payload_size = rle_size;
+	}
+	index_t bitpacking_size = sizeof(uint64_t) + PackedSize(count, bit_width);
+	if (bitpacking_size < payload_size) {
+		compression = NumericCompression::BITPACKING;
+		payload_size = bitpacking_size;
+	}
+	index_t delta_size = 2 * sizeof(uint64_t) + PackedSize(count - 1, delta_bit_width);
+	if (delta_size < payload_size) {
+		compression = NumericCompression::DELTA;
+		payload_size = delta_size;
+	}
+	index_t total_size = sizeof(CompressedVectorHeader) + (has_null ? sizeof(nullmask_t) : 0) + payload_size;
+	if (total_size > capacity) {
+		return INVALID_INDEX;
+	}
+
+	// write the header and the nullmask
+	auto header = (CompressedVectorHeader *)target;
+	header->compression = compression;
+	header->has_null = has_null;
+	header->bit_width = compression == NumericCompression::DELTA ? delta_bit_width : bit_width;
+	header->padding = 0;
+	header->run_count = run_count;
+	auto payload = target + sizeof(CompressedVectorHeader);
+	if (has_null) {
+		memcpy(payload, &nullmask, sizeof(nullmask_t));
+		payload += sizeof(nullmask_t);
+	}
+	// write the values
+	switch (compression) {
+	case NumericCompression::UNCOMPRESSED:
+		memcpy(payload, values, count * sizeof(T));
+		break;
+	case NumericCompression::RLE: {
+		auto run_values = (U *)payload;
+		auto run_lengths = (uint16_t *)(payload + AlignSize(run_count * sizeof(T)));
+		index_t run_idx = 0;
+		run_values[0] = values[0];
+		run_lengths[0] = 1;
+		for (index_t i = 1; i < count; i++) {
+			if (values[i] == run_values[run_idx]) {
+				run_lengths[run_idx]++;
+			} else {
+				run_idx++;
+				run_values[run_idx] = values[i];
+				run_lengths[run_idx] = 1;
+			}
+		}
+		assert(run_idx + 1 == run_count);
+		break;
+	}
+	case NumericCompression::BITPACKING: {
+		*((uint64_t *)payload) = (uint64_t)(U)min;
+		U offsets[STANDARD_VECTOR_SIZE];
+		for (index_t i = 0; i < count; i++) {
+			offsets[i] = (U)(values[i] - (U)min);
+		}
+		BitPack<U>(offsets, count, bit_width, (uint64_t *)(payload + sizeof(uint64_t)));
+		break;
+	}
+	case NumericCompression::DELTA: {
+		*((uint64_t *)payload) = (uint64_t)values[0];
+		*((uint64_t *)(payload + sizeof(uint64_t))) = (uint64_t)(U)min_delta;
+		U offsets[STANDARD_VECTOR_SIZE];
+		for (index_t i = 1; i < count; i++) {
+			offsets[i - 1] = (U)(values[i] - values[i - 1] - (U)min_delta);
+		}
+		BitPack<U>(offsets, count - 1, delta_bit_width, (uint64_t *)(payload + 2 * sizeof(uint64_t)));
+		break;
+	}
+	}
+	return total_size;
+}
+
+template <class T>
+static index_t CompressSegment(data_ptr_t source, index_t tuple_count, data_ptr_t target, index_t capacity) {
+	index_t vector_size = sizeof(nullmask_t) + sizeof(T) * STANDARD_VECTOR_SIZE;
+	index_t vector_count = (tuple_count + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	// the segment starts with the amount of vectors and the offset of every vector
+	index_t offset = AlignSize(sizeof(uint32_t) * (1 + vector_count));
+	if (offset > capacity) {
+		return INVALID_INDEX;
+	}
+	*((uint32_t *)target) = vector_count;
+	auto vector_offsets = (uint32_t *)(target + sizeof(uint32_t));
+	for (index_t vector_index = 0; vector_index < vector_count; vector_index++) {
+		auto vector_data = source + vector_index * vector_size;
+		auto &nullmask = *((nullmask_t *)vector_data);
+		index_t count = std::min((index_t)STANDARD_VECTOR_SIZE, tuple_count - vector_index * STANDARD_VECTOR_SIZE);
+		auto vector_compressed_size = CompressVector<T>((T *)(vector_data + sizeof(nullmask_t)), nullmask, count,
+		                                                target + offset, capacity - offset);
+		if (vector_compressed_size == INVALID_INDEX) {
+			return INVALID_INDEX;
+		}
+		vector_offsets[vector_index] = offset;
+		offset += vector_compressed_size;
+	}
+	return offset;
+}
+
+bool CompressedNumericSegment::SupportsType(TypeId type) {
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+	case TypeId::SMALLINT:
+	case TypeId::INTEGER:
+	case TypeId::BIGINT:
+	case TypeId::FLOAT:
+	case TypeId::DOUBLE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+index_t CompressedNumericSegment::Compress(TypeId type, data_ptr_t source, index_t tuple_count, data_ptr_t target,
+                                          index_t capacity) {
+	// floating point values are compressed by their bit representation
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		return CompressSegment<int8_t>(source, tuple_count, target, capacity);
+	case TypeId::SMALLINT:
+		return CompressSegment<int16_t>(source, tuple_count, target, capacity);
+	case TypeId::INTEGER:
+		return CompressSegment<int32_t>(source, tuple_count, target, capacity);
+	case TypeId::BIGINT:
+		return CompressSegment<int64_t>(source, tuple_count, target, capacity);
+	case TypeId::FLOAT:
+		return CompressSegment<uint32_t>(source, tuple_count, target, capacity);
+	case TypeId::DOUBLE:
+		return CompressSegment<uint64_t>(source, tuple_count, target, capacity);
+	default:
+		throw InvalidTypeException(type, "Unsupported type for compressed segment");
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Decompress
+//===--------------------------------------------------------------------===//
+template <class T>
+static void DecompressVectorTemplated(data_ptr_t vector_data, index_t count, data_ptr_t result, nullmask_t &nullmask) {
+	typedef typename std::make_unsigned<T>::type U;
+	auto header = (CompressedVectorHeader *)vector_data;
+	auto payload = vector_data + sizeof(CompressedVectorHeader);
+	if (header->has_null) {
+		memcpy(&nullmask, payload, sizeof(nullmask_t));
+		payload += sizeof(nullmask_t);
+	} else {
+		nullmask.reset();
+	}
+	auto target = (U *)result;
+	switch (header->compression) {
+	case NumericCompression::UNCOMPRESSED:
+		memcpy(target, payload, count * sizeof(T));
+		break;
+	case NumericCompression::RLE: {
+		auto run_values = (U *)payload;
+		auto run_lengths = (uint16_t *)(payload + AlignSize(header->run_count * sizeof(T)));
+		index_t k = 0;
+		for (index_t run_idx = 0; run_idx < header->run_count; run_idx++) {
+			auto value = run_values[run_idx];
+			for (index_t end = k + run_lengths[run_idx]; k < end; k++) {
+				target[k] = value;
+			}
+		}
+		assert(k == count);
+		break;
+	}
+	case NumericCompression::BITPACKING: {
+		auto base = (U) * ((uint64_t *)payload);
+		BitUnpack<U>((uint64_t *)(payload + sizeof(uint64_t)), count, header->bit_width, base, target);
+		break;
+	}
+	case NumericCompression::DELTA: {
+		auto value = (U) * ((uint64_t *)payload);
+		auto min_delta = (U) * ((uint64_t *)(payload + sizeof(uint64_t)));
+		// unpack the differences (offset by the minimum difference) and compute the prefix sum
+		target[0] = value;
+		BitUnpack<U>((uint64_t *)(payload + 2 * sizeof(uint64_t)), count - 1, header->bit_width, min_delta,
+		             target + 1);
+		for (index_t i = 1; i < count; i++) {
+			value = (U)(value + target[i]);
+			target[i] = value;
+		}
+		break;
+	}
+	default:
+		throw IOException("Unknown compression method in compressed segment");
+	}
+}
+
+CompressedNumericSegment::CompressedNumericSegment(BufferManager &manager, TypeId type, index_t row_start,
+                                                   block_id_t block_id, index_t offset)
+    : NumericSegment(manager, type, row_start, block_id), offset(offset) {
+	assert(block_id != INVALID_BLOCK);
+	assert(SupportsType(type));
+}
+
+void CompressedNumericSegment::DecompressVector(data_ptr_t segment_data, index_t vector_index, data_ptr_t result,
+                                                nullmask_t &nullmask) {
+	assert(vector_index < *((uint32_t *)segment_data));
+	auto vector_offsets = (uint32_t *)(segment_data + sizeof(uint32_t));
+	auto vector_data = segment_data + vector_offsets[vector_index];
+	index_t count = GetVectorCount(vector_index);
+	switch (type) {
+	case TypeId::BOOLEAN:
+	case TypeId::TINYINT:
+		DecompressVectorTemplated<int8_t>(vector_data, count, result, nullmask);
+		break;
+	case TypeId::SMALLINT:
+		DecompressVectorTemplated<int16_t>(vector_data, count, result, nullmask);
+		break;
+	case TypeId::INTEGER:
+		DecompressVectorTemplated<int32_t>(vector_data, count, result, nullmask);
+		break;
+	case TypeId::BIGINT:
+		DecompressVectorTemplated<int64_t>(vector_data, count, result, nullmask);
+		break;
+	case TypeId::FLOAT:
+		DecompressVectorTemplated<uint32_t>(vector_data, count, result, nullmask);
+		break;
+	case TypeId::DOUBLE:
+		DecompressVectorTemplated<uint64_t>(vector_data, count, result, nullmask);
+		break;
+	default:
+		throw InvalidTypeException(type, "Unsupported type for compressed segment");
+	}
+}
+
+void CompressedNumericSegment::FetchBaseData(ColumnScanState &state, index_t vector_index, Vector &result) {
+	if (block_id >= MAXIMUM_BLOCK) {
+		// the segment has been converted to a temporary uncompressed segment
+		NumericSegment::FetchBaseData(state, vector_index, result);
+		return;
+	}
+	assert(vector_index < max_vector_count);
+	assert(vector_index * STANDARD_VECTOR_SIZE <= tuple_count);
+
+	// pin the block and decompress the vector straight into the result
+	auto &handle = PinForScan(state);
+	DecompressVector(handle.node->buffer + offset, vector_index, result.data, result.nullmask);
+	result.count = GetVectorCount(vector_index);
+}
+
+void CompressedNumericSegment::FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id,
+                                        Vector &result) {
+	{
+		auto read_lock = lock.GetSharedLock();
+		if (block_id < MAXIMUM_BLOCK) {
+			// compressed segments have no updates: decompress the vector of the row and copy the value
+			auto handle = manager.Pin(block_id);
+			index_t vector_index = row_id / STANDARD_VECTOR_SIZE;
+			index_t id_in_vector = row_id - vector_index * STANDARD_VECTOR_SIZE;
+			assert(!versions);
+
+			data_t vector_data[STANDARD_VECTOR_SIZE * sizeof(int64_t)];
+			nullmask_t nullmask;
+			DecompressVector(handle->node->buffer + offset, vector_index, vector_data, nullmask);
+			result.nullmask[result.count] = nullmask[id_in_vector];
+			memcpy(result.data + result.count * type_size, vector_data + id_in_vector * type_size, type_size);
+			result.count++;
+			return;
+		}
+	}
+	NumericSegment::FetchRow(state, transaction, row_id, result);
+}
+
+void CompressedNumericSegment::ToTemporary() {
+	auto write_lock = lock.GetExclusiveLock();
+
+	if (block_id >= MAXIMUM_BLOCK) {
+		// conversion has already been performed by a different thread
+		return;
+	}
+	// pin the current block
+	auto current = manager.Pin(block_id);
+
+	// now allocate a new block from the buffer manager and decompress the vectors into the layout of a NumericSegment
+	auto handle = manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
+	index_t vector_count = (tuple_count + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	for (index_t vector_index = 0; vector_index < max_vector_count; vector_index++) {
+		auto vector_data = handle->node->buffer + vector_index * vector_size;
+		auto &nullmask = *((nullmask_t *)vector_data);
+		if (vector_index < vector_count) {
+			DecompressVector(current->node->buffer + offset, vector_index, vector_data + sizeof(nullmask_t),
+			                 nullmask);
+		} else {
+			nullmask.reset();
+		}
+	}
+	this->block_id = handle->block_id;
+}
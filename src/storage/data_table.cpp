@@ -8,6 +8,7 @@
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/planner/constraints/list.hpp"
+#include "duckdb/planner/table_filter.hpp"
 #include "duckdb/transaction/transaction.hpp"
 #include "duckdb/transaction/transaction_manager.hpp"
 #include "duckdb/storage/table/transient_segment.hpp"
@@ -67,6 +68,38 @@ void DataTable::InitializeScan(Transaction &transaction, TableScanState &state,
 	transaction.storage.InitializeScan(this, state.local_state);
 }
 
+static void ApplyTableFilters(DataChunk &result, vector<TableFilter> &filters) {
+	for (auto &filter : filters) {
+		if (result.size() == 0) {
+			return;
+		}
+		// compare the column with the constant and only keep the matching rows
+		Vector constant(filter.constant);
+		StaticVector<bool> matches;
+		auto &column = result.data[filter.column_index];
+		switch (filter.comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			VectorOperations::Equals(column, constant, matches);
+			break;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			VectorOperations::GreaterThanEquals(column, constant, matches);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			VectorOperations::GreaterThan(column, constant, matches);
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			VectorOperations::LessThanEquals(column, constant, matches);
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+			VectorOperations::LessThan(column, constant, matches);
+			break;
+		default:
+			throw NotImplementedException("Unsupported comparison type for table filter");
+		}
+		result.SetSelectionVector(matches);
+	}
+}
+
 void DataTable::Scan(Transaction &transaction, DataChunk &result, TableScanState &state) {
 	// scan the persistent segments
 	while (ScanBaseTable(transaction, result, state, state.current_persistent_row, state.max_persistent_row, 0,
@@ -84,7 +117,72 @@ void DataTable::Scan(Transaction &transaction, DataChunk &result, TableScanState
 	}
 
 	// scan the transaction-local segments
-	transaction.storage.Scan(state.local_state, state.column_ids, result);
+	do {
+		result.Reset();
+		transaction.storage.Scan(state.local_state, state.column_ids, result);
+		if (result.size() == 0 || !state.table_filters) {
+			return;
+		}
+		ApplyTableFilters(result, *state.table_filters);
+	} while (result.size() == 0);
+}
+
+void DataTable::InitializeParallelScan(ParallelTableScanState &state) {
+	state.current_persistent_row = 0;
+	state.max_persistent_row = persistent_manager.max_row;
+	state.current_transient_row = 0;
+	state.max_transient_row = transient_manager.max_row;
+	state.transaction_local_data = false;
+}
+
+bool DataTable::NextParallelScan(Transaction &transaction, ParallelTableScanState &state, TableScanState &scan_state,
+                                 const vector<column_t> &column_ids) {
+	if (state.current_persistent_row < state.max_persistent_row) {
+		// hand out the next chunk of the persistent segments
+		index_t next = std::min(state.current_persistent_row + STORAGE_CHUNK_SIZE, state.max_persistent_row);
+		InitializeScanWithOffset(scan_state, column_ids, state.current_persistent_row, next, true);
+		state.current_persistent_row = next;
+		return true;
+	}
+	if (state.current_transient_row < state.max_transient_row) {
+		// hand out the next chunk of the transient segments
+		index_t next = std::min(state.current_transient_row + STORAGE_CHUNK_SIZE, state.max_transient_row);
+		InitializeScanWithOffset(scan_state, column_ids, state.current_transient_row, next, false);
+		state.current_transient_row = next;
+		return true;
+	}
+	if (!state.transaction_local_data) {
+		// the transaction-local data is scanned by a single thread
+		InitializeScanWithOffset(scan_state, column_ids, 0, 0, true);
+		transaction.storage.InitializeScan(this, scan_state.local_state);
+		state.transaction_local_data = true;
+		return true;
+	}
+	return false;
+}
+
+void DataTable::InitializeScanWithOffset(TableScanState &state, const vector<column_t> &column_ids, index_t start_row,
+                                         index_t end_row, bool persistent) {
+	index_t base_row = persistent ? 0 : persistent_manager.max_row;
+	state.column_scans = unique_ptr<ColumnScanState[]>(new ColumnScanState[column_ids.size()]);
+	if (start_row < end_row) {
+		// the range is aligned to vectors, so the version info and the column vectors line up
+		assert(start_row % STANDARD_VECTOR_SIZE == 0);
+		for (index_t i = 0; i < column_ids.size(); i++) {
+			auto column = column_ids[i];
+			if (column != COLUMN_IDENTIFIER_ROW_ID) {
+				columns[column].InitializeScanWithOffset(state.column_scans[i], base_row + start_row);
+			}
+		}
+	}
+	state.column_ids = column_ids;
+	state.offset = 0;
+	state.current_persistent_row = persistent ? start_row : 0;
+	state.max_persistent_row = persistent ? end_row : 0;
+	state.current_transient_row = persistent ? 0 : start_row;
+	state.max_transient_row = persistent ? 0 : end_row;
+	// the transaction-local data is only scanned if the range explicitly requests it
+	state.local_state.storage = nullptr;
 }
 
 bool DataTable::ScanBaseTable(Transaction &transaction, DataChunk &result, TableScanState &state, index_t &current_row,
@@ -93,10 +191,17 @@ bool DataTable::ScanBaseTable(Transaction &transaction, DataChunk &result, Table
 		// exceeded the amount of rows to scan
 		return false;
 	}
+	// the table filters can have removed all rows of the previous vector: start from an empty chunk again
+	result.Reset();
 	index_t max_count = std::min((index_t)STANDARD_VECTOR_SIZE, max_row - current_row);
 	index_t vector_offset = current_row / STANDARD_VECTOR_SIZE;
-	// first scan the version chunk manager to figure out which tuples to load for this transaction
-	index_t count = manager.GetSelVector(transaction, vector_offset, state.sel_vector, max_count);
+	// first check the zonemaps, and then scan the version chunk manager to figure out which tuples to load for this
+	// transaction
+	index_t count = 0;
+	if (!state.table_filters || CheckZonemap(state)) {
+		count = state.scan_deleted_rows ? max_count
+		                                : manager.GetSelVector(transaction, vector_offset, state.sel_vector, max_count);
+	}
 	if (count == 0) {
 		// nothing to scan for this vector, skip the entire vector
 		for (index_t i = 0; i < state.column_ids.size(); i++) {
@@ -126,11 +231,24 @@ bool DataTable::ScanBaseTable(Transaction &transaction, DataChunk &result, Table
 		result.data[i].count = count;
 	}
 	result.sel_vector = sel_vector;
+	if (state.table_filters) {
+		ApplyTableFilters(result, *state.table_filters);
+	}
 
 	current_row += STANDARD_VECTOR_SIZE;
 	return true;
 }
 
+bool DataTable::CheckZonemap(TableScanState &state) {
+	for (auto &filter : *state.table_filters) {
+		auto segment = state.column_scans[filter.column_index].current;
+		if (segment && !segment->stats.CheckZonemap(filter.comparison_type, filter.constant)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Index Scan
 //===--------------------------------------------------------------------===//
@@ -331,7 +449,8 @@ void DataTable::InitializeAppend(TableAppendState &state) {
 	for (index_t i = 0; i < types.size(); i++) {
 		columns[i].InitializeAppend(state.states[i]);
 	}
-	state.row_start = transient_manager.max_row;
+	// the appended rows follow the persistent rows: the indexes have to point to their row ids within the table
+	state.row_start = transient_manager.base_row + transient_manager.max_row;
 	state.current_row = state.row_start;
 }
 
@@ -340,7 +459,7 @@ void DataTable::Append(Transaction &transaction, transaction_t commit_id, DataCh
 	chunk.Verify();
 
 	// set up the inserted info in the version manager
-	transient_manager.Append(transaction, state.current_row, chunk.size(), commit_id);
+	transient_manager.Append(transaction, state.current_row - transient_manager.base_row, chunk.size(), commit_id);
 
 	// append the physical data to each of the entries
 	for (index_t i = 0; i < types.size(); i++) {
@@ -663,3 +782,24 @@ void DataTable::AddIndex(unique_ptr<Index> index, vector<unique_ptr<Expression>>
 bool DataTable::IsTemporary() {
 	return schema.compare(TEMP_SCHEMA) == 0;
 }
+
+bool DataTable::AllRowsVisible(Transaction &transaction) {
+	return persistent_manager.AllRowsVisible(transaction) && transient_manager.AllRowsVisible(transaction);
+}
+
+index_t DataTable::GetCommittedRows(Transaction &transaction) {
+	// the persistent rows were all committed when the table was loaded
+	return persistent_manager.max_row + transient_manager.GetCommittedRows(transaction);
+}
+
+void DataTable::GetDeletedRows(Transaction &transaction, index_t row_count, vector<row_t> &deleted_rows) {
+	persistent_manager.GetDeletedRows(transaction, std::min(row_count, persistent_manager.max_row), deleted_rows);
+	if (row_count > persistent_manager.max_row) {
+		transient_manager.GetDeletedRows(transaction, row_count - persistent_manager.max_row, deleted_rows);
+	}
+}
+
+ColumnSegment *DataTable::GetRootSegment(column_t column) {
+	assert(column < types.size());
+	return (ColumnSegment *)columns[column].data.GetRootSegment();
+}
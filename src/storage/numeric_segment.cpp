@@ -52,8 +52,8 @@ void NumericSegment::FetchBaseData(ColumnScanState &state, index_t vector_index,
 	assert(vector_index * STANDARD_VECTOR_SIZE <= tuple_count);
 
 	// pin the buffer for this segment
-	auto handle = manager.Pin(block_id);
-	auto data = handle->node->buffer;
+	auto &handle = PinForScan(state);
+	auto data = handle.node->buffer;
 
 	auto offset = vector_index * vector_size;
 
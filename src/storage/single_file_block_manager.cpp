@@ -3,13 +3,17 @@
 #include "duckdb/storage/meta_block_reader.hpp"
 #include "duckdb/common/exception.hpp"
 
+#include <algorithm>
+
 using namespace duckdb;
 using namespace std;
 
 SingleFileBlockManager::SingleFileBlockManager(FileSystem &fs, string path, bool read_only, bool create_new,
-                                               bool use_direct_io)
-    : path(path), header_buffer(FileBufferType::MANAGED_BUFFER, Storage::FILE_HEADER_SIZE), read_only(read_only),
-      use_direct_io(use_direct_io) {
+                                               bool use_direct_io, bool use_mmap,
+                                               ChecksumVerification checksum_verification)
+    : fs(fs), path(path), header_buffer(FileBufferType::MANAGED_BUFFER, Storage::FILE_HEADER_SIZE),
+      read_only(read_only), use_direct_io(use_direct_io), mapped_file(nullptr), mapped_size(0),
+      checksum_verification(checksum_verification) {
 
 	uint8_t flags;
 	FileLockType lock;
@@ -48,6 +52,7 @@ SingleFileBlockManager::SingleFileBlockManager(FileSystem &fs, string path, bool
 		header->meta_block = INVALID_BLOCK;
 		header->free_list = INVALID_BLOCK;
 		header->block_count = 0;
+		header->wal_offset = 0;
 		header_buffer.Write(*handle, Storage::FILE_HEADER_SIZE);
 		// header 2
 		header->iteration = 1;
@@ -56,18 +61,19 @@ SingleFileBlockManager::SingleFileBlockManager(FileSystem &fs, string path, bool
 		handle->Sync();
 		// we start with h2 as active_header, this way our initial write will be in h1
 		active_header = 1;
-		max_block = 0;
+		Initialize(*header);
 	} else {
 		MainHeader header;
 		// otherwise, we check the metadata of the file
-		header_buffer.Read(*handle, 0);
+		handle->Read(header_buffer.InternalBuffer(), header_buffer.AllocSize(), 0);
 		header = *((MainHeader *)header_buffer.buffer);
-		// check the version number
+		// check the version number before the checksum: files of other versions can use a different checksum
 		if (header.version_number != VERSION_NUMBER) {
 			throw IOException(
 			    "Trying to read a database file with version number %lld, but we can only read version %lld",
 			    header.version_number, VERSION_NUMBER);
 		}
+		header_buffer.VerifyChecksum();
 		// read the database headers from disk
 		DatabaseHeader h1, h2;
 		header_buffer.Read(*handle, Storage::FILE_HEADER_SIZE);
@@ -84,6 +90,22 @@ SingleFileBlockManager::SingleFileBlockManager(FileSystem &fs, string path, bool
 			active_header = 1;
 			Initialize(h2);
 		}
+		if (read_only && use_mmap) {
+			// the file cannot change while it is opened read-only: map all blocks of the file so they can be read
+			// without copying them
+			mapped_size = BLOCK_START + max_block * Storage::BLOCK_ALLOC_SIZE;
+			mapped_file = fs.MapFile(*handle, mapped_size);
+			verified_mapped_blocks = unique_ptr<std::atomic<bool>[]>(new std::atomic<bool>[max_block]);
+			for (block_id_t block_id = 0; block_id < max_block; block_id++) {
+				verified_mapped_blocks[block_id] = false;
+			}
+		}
+	}
+}
+
+SingleFileBlockManager::~SingleFileBlockManager() {
+	if (mapped_file) {
+		fs.UnmapFile(mapped_file, mapped_size);
 	}
 }
 
@@ -92,6 +114,7 @@ void SingleFileBlockManager::Initialize(DatabaseHeader &header) {
 	meta_block = header.meta_block;
 	iteration_count = header.iteration;
 	max_block = header.block_count;
+	wal_offset = header.wal_offset;
 }
 
 void SingleFileBlockManager::LoadFreeList(BufferManager &manager) {
@@ -99,68 +122,186 @@ void SingleFileBlockManager::LoadFreeList(BufferManager &manager) {
 		// no need to load free list for read only db
 		return;
 	}
-	if (free_list_id == INVALID_BLOCK) {
-		// no free list
-		return;
+	if (free_list_id != INVALID_BLOCK) {
+		MetaBlockReader reader(manager, free_list_id);
+		auto free_list_count = reader.Read<uint64_t>();
+		free_list.reserve(free_list_count);
+		for (index_t i = 0; i < free_list_count; i++) {
+			free_list.push_back(reader.Read<block_id_t>());
+		}
 	}
-	MetaBlockReader reader(manager, free_list_id);
-	auto free_list_count = reader.Read<uint64_t>();
-	free_list.reserve(free_list_count);
-	for (index_t i = 0; i < free_list_count; i++) {
-		free_list.push_back(reader.Read<block_id_t>());
+	// all other blocks are used by the loaded checkpoint
+	unordered_set<block_id_t> free_blocks(free_list.begin(), free_list.end());
+	for (block_id_t block_id = 0; block_id < max_block; block_id++) {
+		if (free_blocks.find(block_id) == free_blocks.end()) {
+			loaded_blocks.insert(block_id);
+		}
 	}
 }
 
 block_id_t SingleFileBlockManager::GetFreeBlockId() {
+	lock_guard<mutex> guard(block_lock);
 	if (free_list.size() > 0) {
 		// free list is non empty
 		// take an entry from the free list
 		block_id_t block = free_list.back();
 		// erase the entry from the free list again
 		free_list.pop_back();
+		used_blocks.insert(block);
 		return block;
 	}
+	used_blocks.insert(max_block);
 	return max_block++;
 }
 
+void SingleFileBlockManager::MarkBlockAsUsed(block_id_t block_id) {
+	lock_guard<mutex> guard(block_lock);
+	assert(block_id >= 0 && block_id < max_block);
+	used_blocks.insert(block_id);
+}
+
 block_id_t SingleFileBlockManager::GetMetaBlock() {
 	return meta_block;
 }
 
+uint64_t SingleFileBlockManager::GetIteration() {
+	return iteration_count;
+}
+
+index_t SingleFileBlockManager::GetWALOffset() {
+	return wal_offset;
+}
+
 unique_ptr<Block> SingleFileBlockManager::CreateBlock() {
 	return make_unique<Block>(GetFreeBlockId());
 }
 
+void SingleFileBlockManager::VerifyBlock(Block &block) {
+	switch (checksum_verification) {
+	case ChecksumVerification::ALWAYS:
+		block.VerifyChecksum();
+		break;
+	case ChecksumVerification::FIRST_READ: {
+		{
+			lock_guard<mutex> guard(verified_lock);
+			if (verified_blocks.find(block.id) != verified_blocks.end()) {
+				return;
+			}
+		}
+		block.VerifyChecksum();
+		lock_guard<mutex> guard(verified_lock);
+		verified_blocks.insert(block.id);
+		break;
+	}
+	default:
+		assert(checksum_verification == ChecksumVerification::NEVER);
+		break;
+	}
+}
+
 void SingleFileBlockManager::Read(Block &block) {
 	assert(block.id >= 0);
-	used_blocks.insert(block.id);
-	block.Read(*handle, BLOCK_START + block.id * Storage::BLOCK_ALLOC_SIZE);
+	{
+		lock_guard<mutex> guard(handle_lock);
+		handle->Read(block.InternalBuffer(), block.AllocSize(), BLOCK_START + block.id * Storage::BLOCK_ALLOC_SIZE);
+	}
+	VerifyBlock(block);
+}
+
+void SingleFileBlockManager::Read(vector<unique_ptr<Block>> &blocks) {
+	index_t start = 0;
+	while (start < blocks.size()) {
+		// find the run of blocks that are stored consecutively in the file and read them with a single request
+		index_t end = start + 1;
+		while (end < blocks.size() && blocks[end]->id == blocks[end - 1]->id + 1) {
+			end++;
+		}
+		vector<data_ptr_t> buffers;
+		for (index_t i = start; i < end; i++) {
+			assert(blocks[i]->id >= 0 && blocks[i]->AllocSize() == Storage::BLOCK_ALLOC_SIZE);
+			buffers.push_back(blocks[i]->InternalBuffer());
+		}
+		{
+			lock_guard<mutex> guard(handle_lock);
+			fs.ReadBuffers(*handle, buffers, Storage::BLOCK_ALLOC_SIZE,
+			               BLOCK_START + blocks[start]->id * Storage::BLOCK_ALLOC_SIZE);
+		}
+		for (index_t i = start; i < end; i++) {
+			VerifyBlock(*blocks[i]);
+		}
+		start = end;
+	}
+}
+
+unique_ptr<Block> SingleFileBlockManager::GetMappedBlock(block_id_t block_id) {
+	if (!mapped_file) {
+		return nullptr;
+	}
+	assert(block_id >= 0 && block_id < max_block);
+	auto block = make_unique<Block>(block_id, mapped_file + BLOCK_START + block_id * Storage::BLOCK_ALLOC_SIZE);
+	if (checksum_verification != ChecksumVerification::NEVER && !verified_mapped_blocks[block_id]) {
+		// the mapped blocks are only verified the first time they are used, also when the checksums are verified on
+		// every read: the mapping is not read again. Two threads can verify the same block concurrently, which is
+		// harmless.
+		block->VerifyChecksum();
+		verified_mapped_blocks[block_id] = true;
+	}
+	return block;
 }
 
 void SingleFileBlockManager::Write(FileBuffer &buffer, block_id_t block_id) {
 	assert(block_id >= 0);
+	if (checksum_verification == ChecksumVerification::FIRST_READ) {
+		// the block gets new contents: verify it again the next time it is read
+		lock_guard<mutex> guard(verified_lock);
+		verified_blocks.erase(block_id);
+	}
+	lock_guard<mutex> guard(handle_lock);
 	buffer.Write(*handle, BLOCK_START + block_id * Storage::BLOCK_ALLOC_SIZE);
 }
 
 void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	// set the iteration count
 	header.iteration = ++iteration_count;
-	header.block_count = max_block;
+	// all blocks that are not used by the new checkpoint are free once the header is written: this includes the
+	// blocks of the previous checkpoint that were rewritten, and the blocks of dropped tables
+	vector<block_id_t> new_free_list;
+	for (block_id_t block_id = 0; block_id < max_block; block_id++) {
+		if (used_blocks.find(block_id) == used_blocks.end()) {
+			new_free_list.push_back(block_id);
+		}
+	}
+	// the blocks that were loaded can still be read by the running database: move them to the front of the list, so
+	// only the blocks at the end of the list can be reused in this session
+	auto reusable_start = std::stable_partition(new_free_list.begin(), new_free_list.end(), [&](block_id_t block_id) {
+		return loaded_blocks.find(block_id) != loaded_blocks.end();
+	});
+	index_t loaded_count = reusable_start - new_free_list.begin();
 	// now handle the free list
-	if (used_blocks.size() > 0) {
+	if (new_free_list.size() > 0) {
 		// there are blocks in the free list
-		// write them to the file
+		// the free list is written to reusable blocks taken from the end of the new free list itself, which are
+		// removed from the list before it is written (if there are not enough of them, new blocks are allocated)
+		index_t list_size = sizeof(uint64_t) + new_free_list.size() * sizeof(block_id_t);
+		index_t list_blocks = list_size / (Storage::BLOCK_SIZE - sizeof(block_id_t)) + 1;
+		list_blocks = std::min(list_blocks, (index_t)new_free_list.size() - loaded_count);
+		free_list.assign(new_free_list.end() - list_blocks, new_free_list.end());
+		new_free_list.resize(new_free_list.size() - list_blocks);
+
 		MetaBlockWriter writer(*this);
 		header.free_list = writer.block->id;
-		writer.Write<uint64_t>(used_blocks.size());
-		for (auto &block_id : used_blocks) {
+		writer.Write<uint64_t>(new_free_list.size());
+		for (auto &block_id : new_free_list) {
 			writer.Write<block_id_t>(block_id);
 		}
 		writer.Flush();
+		// any reserved blocks that were not needed are not in the written free list, but can be used in this session
+		new_free_list.insert(new_free_list.end(), free_list.begin(), free_list.end());
 	} else {
 		// no blocks in the free list
 		header.free_list = INVALID_BLOCK;
 	}
+	header.block_count = max_block;
 	if (!use_direct_io) {
 		// if we are not using Direct IO we need to fsync BEFORE we write the header to ensure that all the previous
 		// blocks are written as well
@@ -171,15 +312,17 @@ void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	*((DatabaseHeader *)header_buffer.buffer) = header;
 	// now write the header to the file, active_header determines whether we write to h1 or h2
 	// note that if active_header is h1 we write to h2, and vice versa
-	header_buffer.Write(*handle, active_header == 1 ? Storage::FILE_HEADER_SIZE : Storage::FILE_HEADER_SIZE * 2);
+	{
+		lock_guard<mutex> guard(handle_lock);
+		header_buffer.Write(*handle, active_header == 1 ? Storage::FILE_HEADER_SIZE : Storage::FILE_HEADER_SIZE * 2);
+	}
 	// switch active header to the other header
 	active_header = 1 - active_header;
+	wal_offset = header.wal_offset;
 	//! Ensure the header write ends up on disk
 	handle->Sync();
 
-	// the free list is now equal to the blocks that were used by the previous iteration
-	for (auto &block_id : used_blocks) {
-		free_list.push_back(block_id);
-	}
+	// the blocks of the written free list are freed by the next checkpoint
+	free_list.assign(new_free_list.begin() + loaded_count, new_free_list.end());
 	used_blocks.clear();
 }
@@ -13,14 +13,19 @@
 #include "duckdb/planner/binder.hpp"
 #include "duckdb/common/serializer/buffered_file_reader.hpp"
 
+#include <chrono>
+
 using namespace duckdb;
 using namespace std;
 
+constexpr index_t StorageManager::BACKGROUND_CHECKPOINT_POLL_INTERVAL;
+
 StorageManager::StorageManager(DuckDB &db, string path, bool read_only)
-    : database(db), path(path), wal(db), read_only(read_only) {
+    : database(db), path(path), wal(db), read_only(read_only), stop_background_checkpoint(false) {
 }
 
 StorageManager::~StorageManager() {
+	StopBackgroundCheckpoint();
 }
 
 void StorageManager::Initialize() {
@@ -49,10 +54,13 @@ void StorageManager::Initialize() {
 	if (!in_memory) {
 		// create or load the database from disk, if not in-memory mode
 		LoadDatabase();
+		if (database.background_checkpoint && !database.checkpoint_only && !read_only) {
+			checkpoint_thread = std::thread(&StorageManager::BackgroundCheckpoint, this);
+		}
 	} else {
 		block_manager = make_unique<InMemoryBlockManager>();
 		buffer_manager = make_unique<BufferManager>(*database.file_system, *block_manager, database.temporary_directory,
-		                                            database.maximum_memory);
+		                                            database.maximum_memory, database.use_direct_io);
 	}
 }
 
@@ -68,8 +76,8 @@ void StorageManager::Checkpoint(string wal_path) {
 	// check the size of the WAL
 	{
 		BufferedFileReader reader(*database.file_system, wal_path.c_str());
-		if (reader.FileSize() <= database.checkpoint_wal_size) {
-			// WAL is too small
+		if (reader.FileSize() <= std::max(database.checkpoint_wal_size, WriteAheadLog::CHECKPOINT_MARKER_SIZE)) {
+			// WAL is too small, or only contains the marker of the last checkpoint
 			return;
 		}
 	}
@@ -80,9 +88,64 @@ void StorageManager::Checkpoint(string wal_path) {
 	// this should be fixed and turned into an incremental checkpoint
 	DBConfig config;
 	config.checkpoint_only = true;
+	// the columns of the tables are written by the threads of the checkpointing database
+	config.maximum_threads = database.maximum_threads;
 	DuckDB db(path, &config);
 }
 
+void StorageManager::CreateCheckpoint() {
+	if (!wal.initialized) {
+		// in-memory or read-only database: nothing to checkpoint
+		return;
+	}
+	lock_guard<mutex> guard(checkpoint_lock);
+	CheckpointManager checkpointer(*this);
+	index_t wal_offset = checkpointer.CreateOnlineCheckpoint();
+	// the changes in the WAL before the checkpoint marker are now stored in the database file: remove them from the
+	// WAL. If the system crashes before the WAL is truncated, the replay skips the WAL up to the marker instead.
+	database.transaction_manager->TruncateWAL(wal_offset);
+}
+
+void StorageManager::StopBackgroundCheckpoint() {
+	if (!checkpoint_thread.joinable()) {
+		return;
+	}
+	{
+		lock_guard<mutex> guard(background_lock);
+		stop_background_checkpoint = true;
+	}
+	background_signal.notify_one();
+	checkpoint_thread.join();
+}
+
+void StorageManager::BackgroundCheckpoint() {
+	auto last_checkpoint = chrono::steady_clock::now();
+	unique_lock<mutex> guard(background_lock);
+	while (!stop_background_checkpoint) {
+		background_signal.wait_for(guard, chrono::milliseconds(BACKGROUND_CHECKPOINT_POLL_INTERVAL));
+		if (stop_background_checkpoint) {
+			break;
+		}
+		// checkpoint when the WAL has become too big, or when the checkpoint interval has passed
+		index_t wal_size = wal.GetWALSize();
+		bool interval_passed = database.checkpoint_interval > 0 &&
+		                       chrono::steady_clock::now() - last_checkpoint >=
+		                           chrono::milliseconds(database.checkpoint_interval);
+		if (wal_size <= WriteAheadLog::CHECKPOINT_MARKER_SIZE ||
+		    (wal_size <= database.checkpoint_wal_size && !interval_passed)) {
+			continue;
+		}
+		guard.unlock();
+		try {
+			CreateCheckpoint();
+		} catch (...) {
+			// the WAL is only truncated after a successful checkpoint: the checkpoint is retried later
+		}
+		guard.lock();
+		last_checkpoint = chrono::steady_clock::now();
+	}
+}
+
 void StorageManager::LoadDatabase() {
 	string wal_path = path + ".wal";
 	// first check if the database exists
@@ -98,19 +161,21 @@ void StorageManager::LoadDatabase() {
 			database.file_system->RemoveFile(wal_path);
 		}
 		// initialize the block manager while creating a new db file
-		block_manager =
-		    make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, true, database.use_direct_io);
+		block_manager = make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, true,
+		                                                    database.use_direct_io, false,
+		                                                    database.checksum_verification);
 		buffer_manager = make_unique<BufferManager>(*database.file_system, *block_manager, database.temporary_directory,
-		                                            database.maximum_memory);
+		                                            database.maximum_memory, database.use_direct_io);
 	} else {
 		if (!database.checkpoint_only) {
 			Checkpoint(wal_path);
 		}
 		// initialize the block manager while loading the current db file
-		auto sf =
-		    make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, false, database.use_direct_io);
+		auto sf = make_unique<SingleFileBlockManager>(*database.file_system, path, read_only, false,
+		                                              database.use_direct_io, database.use_mmap,
+		                                              database.checksum_verification);
 		buffer_manager = make_unique<BufferManager>(*database.file_system, *sf, database.temporary_directory,
-		                                            database.maximum_memory);
+		                                            database.maximum_memory, database.use_direct_io);
 		sf->LoadFreeList(*buffer_manager);
 		block_manager = move(sf);
 
@@ -123,8 +188,11 @@ void StorageManager::LoadDatabase() {
 			WriteAheadLog::Replay(database, wal_path);
 			if (database.checkpoint_only) {
 				assert(!read_only);
+				// mark the end of the replayed WAL, so the WAL is skipped if the system stops before it is removed
+				auto wal_offset =
+				    WriteAheadLog::WriteCheckpoint(database, wal_path, block_manager->GetIteration() + 1);
 				// checkpoint the database
-				checkpointer.CreateCheckpoint();
+				checkpointer.CreateCheckpoint(wal_offset);
 				// remove the WAL
 				database.file_system->RemoveFile(wal_path);
 			}
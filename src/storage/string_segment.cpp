@@ -19,6 +19,7 @@ StringSegment::StringSegment(BufferManager &manager, index_t row_start, block_id
 	// the vector_size is given in the size of the dictionary offsets
 	this->vector_size = STANDARD_VECTOR_SIZE * sizeof(int32_t) + sizeof(nullmask_t);
 	this->string_updates = nullptr;
+	this->overflow_writer = nullptr;
 
 	this->block_id = block;
 	if (block_id == INVALID_BLOCK) {
@@ -104,8 +105,15 @@ void StringSegment::FetchBaseData(ColumnScanState &state, data_ptr_t baseptr, in
 		}
 	} else {
 		// no updates: fetch only from the string dictionary
+		// runs of the same dictionary entry are only looked up once
+		int32_t last_offset = -1;
+		char *last_string = nullptr;
 		for (index_t i = 0; i < count; i++) {
-			result_data[i] = FetchStringFromDict(state.handles, baseptr, base_data[i]).data;
+			if (base_data[i] != last_offset) {
+				last_offset = base_data[i];
+				last_string = FetchStringFromDict(state.handles, baseptr, last_offset).data;
+			}
+			result_data[i] = last_string;
 		}
 	}
 	result.nullmask = base_nullmask;
@@ -342,6 +350,16 @@ void StringSegment::AppendData(SegmentStatistics &stats, data_ptr_t target, data
 			    if (string_length > stats.max_string_length) {
 				    stats.max_string_length = string_length;
 			    }
+			    if (dictionary) {
+				    // check if the string is already in the dictionary
+				    auto entry = dictionary->find(string(ldata[i], string_length));
+				    if (entry != dictionary->end()) {
+					    // it is: point to the existing dictionary entry
+					    result_data[k - offset + target_offset] = entry->second;
+					    remaining_strings--;
+					    return;
+				    }
+			    }
 			    // determine hwether or not the string needs to be stored in an overflow block
 			    // we never place small strings in the overflow blocks: the pointer would take more space than the
 			    // string itself we always place big strings (>= STRING_BLOCK_LIMIT) in the overflow blocks we also have
@@ -377,6 +395,9 @@ void StringSegment::AppendData(SegmentStatistics &stats, data_ptr_t target, data
 			    }
 			    // place the dictionary offset into the set of vectors
 			    result_data[k - offset + target_offset] = dictionary_offset;
+			    if (dictionary) {
+				    dictionary->insert(make_pair(string(ldata[i], string_length), (int32_t)dictionary_offset));
+			    }
 		    }
 		    remaining_strings--;
 	    },
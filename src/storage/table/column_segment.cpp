@@ -1,4 +1,6 @@
 #include "duckdb/storage/table/column_segment.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/value.hpp"
 #include <cstring>
 
 using namespace duckdb;
@@ -15,7 +17,7 @@ SegmentStatistics::SegmentStatistics(TypeId type, index_t type_size) : type(type
 
 template <class T> void initialize_max_min(data_ptr_t min, data_ptr_t max) {
 	*((T *)min) = std::numeric_limits<T>::max();
-	*((T *)max) = std::numeric_limits<T>::min();
+	*((T *)max) = std::numeric_limits<T>::lowest();
 }
 
 void SegmentStatistics::Reset() {
@@ -49,3 +51,43 @@ void SegmentStatistics::Reset() {
 		break;
 	}
 }
+
+template <class T> static bool check_zonemap(SegmentStatistics &stats, ExpressionType comparison_type, T constant) {
+	T min = *((T *)stats.minimum.get());
+	T max = *((T *)stats.maximum.get());
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		return constant >= min && constant <= max;
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return max >= constant;
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return max > constant;
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return min <= constant;
+	case ExpressionType::COMPARE_LESSTHAN:
+		return min < constant;
+	default:
+		throw NotImplementedException("Unsupported comparison type for zonemap");
+	}
+}
+
+bool SegmentStatistics::CheckZonemap(ExpressionType comparison_type, Value &constant) {
+	assert(constant.type == type);
+	switch (type) {
+	case TypeId::TINYINT:
+		return check_zonemap<int8_t>(*this, comparison_type, constant.value_.tinyint);
+	case TypeId::SMALLINT:
+		return check_zonemap<int16_t>(*this, comparison_type, constant.value_.smallint);
+	case TypeId::INTEGER:
+		return check_zonemap<int32_t>(*this, comparison_type, constant.value_.integer);
+	case TypeId::BIGINT:
+		return check_zonemap<int64_t>(*this, comparison_type, constant.value_.bigint);
+	case TypeId::FLOAT:
+		return check_zonemap<float>(*this, comparison_type, constant.value_.float_);
+	case TypeId::DOUBLE:
+		return check_zonemap<double>(*this, comparison_type, constant.value_.double_);
+	default:
+		// no statistics for this type: the segment has to be scanned
+		return true;
+	}
+}
@@ -6,6 +6,7 @@
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
 #include "duckdb/storage/meta_block_reader.hpp"
 
+#include "duckdb/storage/compressed_numeric_segment.hpp"
 #include "duckdb/storage/numeric_segment.hpp"
 #include "duckdb/storage/string_segment.hpp"
 
@@ -13,13 +14,17 @@ using namespace duckdb;
 using namespace std;
 
 PersistentSegment::PersistentSegment(BufferManager &manager, block_id_t id, index_t offset, TypeId type, index_t start,
-                                     index_t count)
-    : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count), manager(manager), block_id(id), offset(offset) {
-	assert(offset == 0);
-	if (type == TypeId::VARCHAR) {
+                                     index_t count, bool compressed)
+    : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count), manager(manager), block_id(id), offset(offset),
+      compressed(compressed) {
+	if (compressed) {
+		data = make_unique<CompressedNumericSegment>(manager, type, start, id, offset);
+	} else if (type == TypeId::VARCHAR) {
+		assert(offset == 0);
 		data = make_unique<StringSegment>(manager, start, id);
 		data->max_vector_count = count / STANDARD_VECTOR_SIZE + (count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
 	} else {
+		assert(offset == 0);
 		data = make_unique<NumericSegment>(manager, type, start, id);
 	}
 	data->tuple_count = count;
@@ -54,3 +59,8 @@ void PersistentSegment::Update(ColumnData &column_data, Transaction &transaction
 	}
 	data->Update(column_data, stats, transaction, updates, ids, this->start);
 }
+
+bool PersistentSegment::IsModified() {
+	// the data is moved to a temporary buffer the first time the segment is updated
+	return data->block_id != block_id;
+}
@@ -19,6 +19,71 @@ index_t VersionManager::GetSelVector(Transaction &transaction, index_t index, se
 	}
 }
 
+bool VersionManager::AllRowsVisible(Transaction &transaction) {
+	auto read_lock = lock.GetSharedLock();
+
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	for (auto &entry : info) {
+		// only the chunks with an info can contain deleted or uncommitted rows
+		index_t chunk_start = entry.first * STANDARD_VECTOR_SIZE;
+		if (chunk_start >= max_row) {
+			continue;
+		}
+		index_t count = std::min((index_t)STANDARD_VECTOR_SIZE, max_row - chunk_start);
+		if (entry.second->GetSelVector(transaction, sel_vector, count) != count) {
+			return false;
+		}
+	}
+	return true;
+}
+
+index_t VersionManager::GetCommittedRows(Transaction &transaction) {
+	auto read_lock = lock.GetSharedLock();
+
+	// rows are appended in the order in which their transactions commit: the rows that were committed after the
+	// transaction started are at the end
+	index_t row_count = max_row;
+	while (row_count > 0) {
+		index_t row = row_count - 1;
+		auto entry = info.find(row / STANDARD_VECTOR_SIZE);
+		if (entry == info.end() || entry->second->type != ChunkInfoType::INSERT_INFO) {
+			break;
+		}
+		auto &insert_info = (ChunkInsertInfo &)*entry->second;
+		if (insert_info.inserted[row % STANDARD_VECTOR_SIZE] < transaction.start_time) {
+			break;
+		}
+		row_count--;
+	}
+	return row_count;
+}
+
+void VersionManager::GetDeletedRows(Transaction &transaction, index_t row_count, vector<row_t> &deleted_rows) {
+	auto read_lock = lock.GetSharedLock();
+
+	sel_t sel_vector[STANDARD_VECTOR_SIZE];
+	for (index_t chunk_start = 0; chunk_start < row_count; chunk_start += STANDARD_VECTOR_SIZE) {
+		auto entry = info.find(chunk_start / STANDARD_VECTOR_SIZE);
+		if (entry == info.end()) {
+			continue;
+		}
+		index_t count = std::min((index_t)STANDARD_VECTOR_SIZE, row_count - chunk_start);
+		index_t visible_count = entry->second->GetSelVector(transaction, sel_vector, count);
+		if (visible_count == count) {
+			continue;
+		}
+		// the selection vector is sorted: every row that is not in it is deleted
+		index_t sel_idx = 0;
+		for (index_t i = 0; i < count; i++) {
+			if (sel_idx < visible_count && sel_vector[sel_idx] == i) {
+				sel_idx++;
+			} else {
+				deleted_rows.push_back(base_row + chunk_start + i);
+			}
+		}
+	}
+}
+
 bool VersionManager::Fetch(Transaction &transaction, index_t row) {
 	row -= base_row;
 	index_t vector_index = row / STANDARD_VECTOR_SIZE;
@@ -117,6 +117,13 @@ UpdateInfo *UncompressedSegment::CreateUpdateInfo(ColumnData &column_data, Trans
 	return node;
 }
 
+BufferHandle &UncompressedSegment::PinForScan(ColumnScanState &state) {
+	if (!state.primary_handle || state.primary_handle->block_id != block_id) {
+		state.primary_handle = manager.Pin(block_id);
+	}
+	return *state.primary_handle;
+}
+
 void UncompressedSegment::Fetch(ColumnScanState &state, index_t vector_index, Vector &result) {
 	auto read_lock = lock.GetSharedLock();
 
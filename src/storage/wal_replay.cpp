@@ -1,25 +1,130 @@
 #include "duckdb/storage/write_ahead_log.hpp"
 #include "duckdb/storage/data_table.hpp"
 #include "duckdb/common/serializer/buffered_file_reader.hpp"
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/parser/parsed_data/drop_info.hpp"
 #include "duckdb/parser/parsed_data/create_schema_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_info.hpp"
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/statement/create_index_statement.hpp"
 #include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/planner.hpp"
 #include "duckdb/planner/parsed_data/bound_create_table_info.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+#include <unordered_map>
 
 using namespace duckdb;
 using namespace std;
 
+//! The WAL is read in large blocks
+static constexpr index_t WAL_REPLAY_BUFFER_SIZE = 1 << 20;
+//! The amount of decoded data chunks after which the batched data operations are applied
+static constexpr index_t WAL_REPLAY_BATCH_SIZE = 1024;
+
+//! An insert, delete or update of a single table decoded from the WAL
+struct ReplayDataOperation {
+	ReplayDataOperation(WALType type, unique_ptr<DataChunk> chunk, column_t column_index = 0)
+	    : type(type), chunk(move(chunk)), column_index(column_index) {
+	}
+
+	WALType type;
+	unique_ptr<DataChunk> chunk;
+	//! The updated column (only used for updates)
+	column_t column_index;
+};
+
+static void ApplyDataOperation(ClientContext &context, TableCatalogEntry &table, ReplayDataOperation &operation) {
+	auto &chunk = *operation.chunk;
+	switch (operation.type) {
+	case WALType::INSERT_TUPLE:
+		table.storage->Append(table, context, chunk);
+		break;
+	case WALType::DELETE_TUPLE: {
+		assert(chunk.column_count == 1 && chunk.data[0].type == ROW_TYPE);
+		row_t row_ids[1];
+		Vector row_identifiers(ROW_TYPE, (data_ptr_t)row_ids);
+		row_identifiers.count = 1;
+
+		auto source_ids = (row_t *)chunk.data[0].data;
+		// delete the tuples from the table
+		for (index_t i = 0; i < chunk.size(); i++) {
+			row_ids[0] = source_ids[i];
+			table.storage->Delete(table, context, row_identifiers);
+		}
+		break;
+	}
+	default: {
+		assert(operation.type == WALType::UPDATE_TUPLE);
+		vector<column_t> column_ids{operation.column_index};
+		// remove the row id vector from the chunk
+		auto &row_ids = chunk.data[chunk.column_count - 1];
+		chunk.column_count = chunk.column_count - 1;
+
+		// now perform the update
+		table.storage->Update(table, context, row_ids, column_ids, chunk);
+		break;
+	}
+	}
+}
+
+//! Applies the batched data operations of a single table in the order in which they were written to the WAL
+class ReplayTableTask : public Task {
+public:
+	ReplayTableTask(DuckDB &db, TableCatalogEntry &table, vector<ReplayDataOperation> &operations)
+	    : db(db), table(table), operations(operations) {
+	}
+
+	DuckDB &db;
+	TableCatalogEntry &table;
+	vector<ReplayDataOperation> &operations;
+
+public:
+	void Execute() override {
+		ClientContext context(db);
+		context.transaction.SetAutoCommit(false);
+		context.transaction.BeginTransaction();
+		try {
+			// consecutive inserts are appended in a single transaction, even if they were committed separately
+			bool appended = false;
+			for (auto &operation : operations) {
+				if (appended && operation.type != WALType::INSERT_TUPLE) {
+					// the deletes and updates can refer to the appended rows, which only get their row ids when they
+					// are committed
+					context.transaction.Commit();
+					context.transaction.BeginTransaction();
+					appended = false;
+				}
+				ApplyDataOperation(context, table, operation);
+				appended = appended || operation.type == WALType::INSERT_TUPLE;
+			}
+			context.transaction.Commit();
+		} catch (...) {
+			context.transaction.Rollback();
+			throw;
+		}
+	}
+};
+
+//! The data operations of the transactions that only insert, delete or update rows are not applied directly: they are
+//! collected in a batch, and the batch is applied by replaying the operations of every table in parallel. The
+//! operations on a single table are still applied in order, but consecutive transactions are merged into one.
+//! Transactions that change the catalog or run a query are replayed serially, after the preceding batch is applied.
+//! So are the transactions that change a table with indexes: the entries of deleted rows are only removed from an
+//! index once no older transaction is active, so a key that is deleted and inserted again in separate transactions
+//! would violate a PRIMARY KEY or UNIQUE constraint if the transactions were merged or replayed concurrently.
 class ReplayState {
 public:
 	ReplayState(DuckDB &db, ClientContext &context, Deserializer &source)
-	    : db(db), context(context), source(source), current_table(nullptr) {
+	    : db(db), context(context), source(source), current_table(nullptr), serial_transaction(false),
+	      batch_size(0) {
 	}
 
 	DuckDB &db;
@@ -29,14 +134,34 @@ public:
 
 public:
 	void ReplayEntry(WALType entry_type);
+	//! Finish the current transaction. The main context still has to commit afterwards.
+	void CommitTransaction();
+	//! Apply the batched data operations of the completed transactions
+	void ApplyBatch();
 
 private:
+	//! Whether or not the current transaction is replayed serially in the main context
+	bool serial_transaction;
+	//! The data operations of the current transaction (if it is not replayed serially)
+	vector<pair<TableCatalogEntry *, ReplayDataOperation>> transaction_operations;
+	//! The data operations of the completed transactions that have not been applied yet, per table
+	unordered_map<TableCatalogEntry *, vector<ReplayDataOperation>> batch;
+	//! The amount of data chunks in the batch
+	index_t batch_size;
+
+	//! Replay the remainder of the current transaction serially
+	void BeginSerialTransaction();
+	void AddDataOperation(ReplayDataOperation operation);
+
 	void ReplayCreateTable();
 	void ReplayDropTable();
 
 	void ReplayCreateView();
 	void ReplayDropView();
 
+	void ReplayCreateIndex();
+	void ReplayDropIndex();
+
 	void ReplayCreateSchema();
 	void ReplayDropSchema();
 
@@ -52,8 +177,51 @@ private:
 	void ReplayQuery();
 };
 
+//! Returns true if the WAL contains the marker of the checkpoint with the given header iteration at the given position
+static bool HasCheckpointMarker(FileHandle &handle, index_t file_size, index_t position, uint64_t iteration) {
+	if (position + WriteAheadLog::CHECKPOINT_MARKER_SIZE > file_size) {
+		return false;
+	}
+	data_t marker[WriteAheadLog::CHECKPOINT_MARKER_SIZE];
+	handle.Read(marker, WriteAheadLog::CHECKPOINT_MARKER_SIZE, position);
+	uint64_t marker_iteration;
+	memcpy(&marker_iteration, marker + sizeof(WALType), sizeof(uint64_t));
+	return marker[0] == (data_t)WALType::CHECKPOINT && marker_iteration == iteration &&
+	       marker[WriteAheadLog::CHECKPOINT_MARKER_SIZE - 1] == (data_t)WALType::WAL_FLUSH;
+}
+
+//! Returns the position in the WAL up to which the changes are contained in the checkpoint the database was loaded
+//! from. Once the WAL is truncated it starts with the marker of the checkpoint, but if the system stopped after the
+//! header of the checkpoint was written and before the WAL was truncated, the marker is found at the position that is
+//! stored in the header.
+static index_t GetCheckpointEnd(DuckDB &database, string &path, index_t file_size) {
+	auto &block_manager = *database.storage->block_manager;
+	auto iteration = block_manager.GetIteration();
+	auto wal_offset = block_manager.GetWALOffset();
+	auto handle = database.file_system->OpenFile(path, FileFlags::READ);
+	if (HasCheckpointMarker(*handle, file_size, 0, iteration)) {
+		return WriteAheadLog::CHECKPOINT_MARKER_SIZE;
+	}
+	if (HasCheckpointMarker(*handle, file_size, wal_offset, iteration)) {
+		return wal_offset + WriteAheadLog::CHECKPOINT_MARKER_SIZE;
+	}
+	// the WAL does not contain the marker: none of its changes are contained in the checkpoint
+	return 0;
+}
+
 void WriteAheadLog::Replay(DuckDB &database, string &path) {
-	BufferedFileReader reader(*database.file_system, path.c_str());
+	BufferedFileReader reader(*database.file_system, path.c_str(), WAL_REPLAY_BUFFER_SIZE);
+
+	// skip the part of the WAL that is already contained in the checkpoint
+	index_t skip_size = GetCheckpointEnd(database, path, reader.FileSize());
+	if (skip_size > 0) {
+		auto skip_buffer = unique_ptr<data_t[]>(new data_t[WAL_REPLAY_BUFFER_SIZE]);
+		while (skip_size > 0) {
+			index_t read_size = std::min(skip_size, WAL_REPLAY_BUFFER_SIZE);
+			reader.ReadData(skip_buffer.get(), read_size);
+			skip_size -= read_size;
+		}
+	}
 
 	if (reader.Finished()) {
 		// WAL is empty
@@ -76,6 +244,7 @@ void WriteAheadLog::Replay(DuckDB &database, string &path) {
 			WALType entry_type = reader.Read<WALType>();
 			if (entry_type == WALType::WAL_FLUSH) {
 				// flush: commit the current transaction
+				state.CommitTransaction();
 				context.transaction.Commit();
 				// check if the file is exhausted
 				if (reader.Finished()) {
@@ -89,41 +258,123 @@ void WriteAheadLog::Replay(DuckDB &database, string &path) {
 				state.ReplayEntry(entry_type);
 			}
 		}
+		state.ApplyBatch();
 	} catch (std::exception &ex) {
 		// FIXME: this report a proper warning in the connection
 		fprintf(stderr, "Exception in WAL playback: %s\n", ex.what());
-		// exception thrown in WAL replay: rollback
+		// exception thrown in WAL replay: the completed transactions are still applied, the current one is rolled back
+		try {
+			state.ApplyBatch();
+		} catch (std::exception &ex) {
+			fprintf(stderr, "Exception in WAL playback: %s\n", ex.what());
+		}
 		context.transaction.Rollback();
 	}
 }
 
+void ReplayState::CommitTransaction() {
+	if (serial_transaction) {
+		serial_transaction = false;
+		return;
+	}
+	// move the data operations of the transaction into the batch
+	for (auto &entry : transaction_operations) {
+		batch[entry.first].push_back(move(entry.second));
+		batch_size++;
+	}
+	transaction_operations.clear();
+	if (batch_size >= WAL_REPLAY_BATCH_SIZE) {
+		ApplyBatch();
+	}
+}
+
+void ReplayState::ApplyBatch() {
+	if (batch.size() == 0) {
+		return;
+	}
+	// the batch is cleared first, so it is not applied twice if one of the tasks fails
+	auto operations = move(batch);
+	batch.clear();
+	batch_size = 0;
+
+	vector<unique_ptr<Task>> tasks;
+	for (auto &entry : operations) {
+		tasks.push_back(make_unique<ReplayTableTask>(db, *entry.first, entry.second));
+	}
+	db.scheduler->ExecuteTasks(move(tasks));
+}
+
+void ReplayState::BeginSerialTransaction() {
+	if (serial_transaction) {
+		return;
+	}
+	serial_transaction = true;
+	// apply the preceding transactions first, and restart the transaction of the main context so it can see them. The
+	// transaction has only been used to look up tables so far.
+	ApplyBatch();
+	context.transaction.Commit();
+	context.transaction.BeginTransaction();
+	// then apply the data operations the current transaction did so far
+	for (auto &entry : transaction_operations) {
+		ApplyDataOperation(context, *entry.first, entry.second);
+	}
+	transaction_operations.clear();
+}
+
+void ReplayState::AddDataOperation(ReplayDataOperation operation) {
+	if (current_table->storage->indexes.size() > 0) {
+		BeginSerialTransaction();
+	}
+	if (serial_transaction) {
+		ApplyDataOperation(context, *current_table, operation);
+	} else {
+		transaction_operations.push_back(make_pair(current_table, move(operation)));
+	}
+}
+
 //===--------------------------------------------------------------------===//
 // Replay Entries
 //===--------------------------------------------------------------------===//
 void ReplayState::ReplayEntry(WALType entry_type) {
 	switch (entry_type) {
 	case WALType::CREATE_TABLE:
+		BeginSerialTransaction();
 		ReplayCreateTable();
 		break;
 	case WALType::DROP_TABLE:
+		BeginSerialTransaction();
 		ReplayDropTable();
 		break;
 	case WALType::CREATE_VIEW:
+		BeginSerialTransaction();
 		ReplayCreateView();
 		break;
 	case WALType::DROP_VIEW:
+		BeginSerialTransaction();
 		ReplayDropView();
 		break;
+	case WALType::CREATE_INDEX:
+		BeginSerialTransaction();
+		ReplayCreateIndex();
+		break;
+	case WALType::DROP_INDEX:
+		BeginSerialTransaction();
+		ReplayDropIndex();
+		break;
 	case WALType::CREATE_SCHEMA:
+		BeginSerialTransaction();
 		ReplayCreateSchema();
 		break;
 	case WALType::DROP_SCHEMA:
+		BeginSerialTransaction();
 		ReplayDropSchema();
 		break;
 	case WALType::CREATE_SEQUENCE:
+		BeginSerialTransaction();
 		ReplayCreateSequence();
 		break;
 	case WALType::DROP_SEQUENCE:
+		BeginSerialTransaction();
 		ReplayDropSequence();
 		break;
 	case WALType::SEQUENCE_VALUE:
@@ -142,8 +393,13 @@ void ReplayState::ReplayEntry(WALType entry_type) {
 		ReplayUpdate();
 		break;
 	case WALType::QUERY:
+		BeginSerialTransaction();
 		ReplayQuery();
 		break;
+	case WALType::CHECKPOINT:
+		// the marker of a checkpoint that was not completed, or that the database was not loaded from
+		source.Read<uint64_t>();
+		break;
 	default:
 		throw Exception("Invalid WAL entry type!");
 	}
@@ -189,6 +445,32 @@ void ReplayState::ReplayDropView() {
 	db.catalog->DropView(context.ActiveTransaction(), &info);
 }
 
+//===--------------------------------------------------------------------===//
+// Replay Index
+//===--------------------------------------------------------------------===//
+void ReplayState::ReplayCreateIndex() {
+	auto info = IndexCatalogEntry::Deserialize(source);
+
+	// the index was created after the last checkpoint: bind the index and build it from the table data
+	Planner planner(context);
+	planner.CreatePlan(make_unique<CreateIndexStatement>(move(info)));
+	PhysicalPlanGenerator generator(context);
+	auto plan = generator.CreatePlan(move(planner.plan));
+
+	DataChunk chunk;
+	plan->InitializeChunk(chunk);
+	auto state = plan->GetOperatorState();
+	plan->GetChunk(context, chunk, state.get());
+}
+
+void ReplayState::ReplayDropIndex() {
+	DropInfo info;
+	info.type = CatalogType::INDEX;
+	info.schema = source.Read<string>();
+	info.name = source.Read<string>();
+	db.catalog->DropIndex(context.ActiveTransaction(), &info);
+}
+
 //===--------------------------------------------------------------------===//
 // Replay Schema
 //===--------------------------------------------------------------------===//
@@ -253,31 +535,20 @@ void ReplayState::ReplayInsert() {
 	if (!current_table) {
 		throw Exception("Corrupt WAL: insert without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
+	auto chunk = make_unique<DataChunk>();
+	chunk->Deserialize(source);
 
-	// append to the current table
-	current_table->storage->Append(*current_table, context, chunk);
+	AddDataOperation(ReplayDataOperation(WALType::INSERT_TUPLE, move(chunk)));
 }
 
 void ReplayState::ReplayDelete() {
 	if (!current_table) {
 		throw Exception("Corrupt WAL: delete without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
-
-	assert(chunk.column_count == 1 && chunk.data[0].type == ROW_TYPE);
-	row_t row_ids[1];
-	Vector row_identifiers(ROW_TYPE, (data_ptr_t)row_ids);
-	row_identifiers.count = 1;
-
-	auto source_ids = (row_t *)chunk.data[0].data;
-	// delete the tuples from the current table
-	for (index_t i = 0; i < chunk.size(); i++) {
-		row_ids[0] = source_ids[i];
-		current_table->storage->Delete(*current_table, context, row_identifiers);
-	}
+	auto chunk = make_unique<DataChunk>();
+	chunk->Deserialize(source);
+
+	AddDataOperation(ReplayDataOperation(WALType::DELETE_TUPLE, move(chunk)));
 }
 
 void ReplayState::ReplayUpdate() {
@@ -287,20 +558,13 @@ void ReplayState::ReplayUpdate() {
 
 	index_t column_index = source.Read<column_t>();
 
-	DataChunk chunk;
-	chunk.Deserialize(source);
+	auto chunk = make_unique<DataChunk>();
+	chunk->Deserialize(source);
 
-	vector<column_t> column_ids{column_index};
 	if (column_index >= current_table->columns.size()) {
 		throw Exception("Corrupt WAL: column index for update out of bounds");
 	}
-
-	// remove the row id vector from the chunk
-	auto &row_ids = chunk.data[chunk.column_count - 1];
-	chunk.column_count = chunk.column_count - 1;
-
-	// now perform the update
-	current_table->storage->Update(*current_table, context, row_ids, column_ids, chunk);
+	AddDataOperation(ReplayDataOperation(WALType::UPDATE_TUPLE, move(chunk), column_index));
 }
 
 //===--------------------------------------------------------------------===//
@@ -1,21 +1,66 @@
 #include "duckdb/storage/write_ahead_log.hpp"
 #include "duckdb/main/database.hpp"
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
+#include <chrono>
 #include <cstring>
+#include <thread>
 
 using namespace duckdb;
 using namespace std;
 
-WriteAheadLog::WriteAheadLog(DuckDB &database) : initialized(false), database(database) {
+constexpr index_t WriteAheadLog::CHECKPOINT_MARKER_SIZE;
+
+WriteAheadLog::WriteAheadLog(DuckDB &database)
+    : initialized(false), database(database), wal_size(0), written_position(0), synced_position(0),
+      sync_in_progress(false) {
 }
 
 void WriteAheadLog::Initialize(string &path) {
+	wal_path = path;
 	writer = make_unique<BufferedFileWriter>(*database.file_system, path.c_str(), true);
+	wal_size = database.file_system->GetFileSize(*writer->handle);
 	initialized = true;
 }
 
+void WriteAheadLog::Truncate(index_t size) {
+	// wait for a running sync to finish, and prevent new syncs from starting while the file is replaced
+	unique_lock<mutex> guard(sync_lock);
+	sync_signal.wait(guard, [&]() { return !sync_in_progress; });
+
+	auto &fs = *database.file_system;
+	writer->Sync();
+	index_t file_size = fs.GetFileSize(*writer->handle);
+	assert(size <= file_size);
+	// read the part of the WAL that is not contained in the checkpoint, which starts with the checkpoint marker
+	index_t remaining = file_size - size;
+	auto remaining_data = unique_ptr<data_t[]>(new data_t[remaining]);
+	if (remaining > 0) {
+		auto handle = fs.OpenFile(wal_path, FileFlags::READ);
+		handle->Read(remaining_data.get(), remaining, size);
+	}
+	writer.reset();
+	// write it to a new file, and atomically replace the WAL with the new file
+	string temp_path = wal_path + ".tmp";
+	if (fs.FileExists(temp_path)) {
+		fs.RemoveFile(temp_path);
+	}
+	{
+		BufferedFileWriter temp_writer(fs, temp_path.c_str());
+		temp_writer.WriteData(remaining_data.get(), remaining);
+		temp_writer.Sync();
+	}
+	fs.MoveFile(temp_path, wal_path);
+	// finally continue appending to the truncated WAL
+	writer = make_unique<BufferedFileWriter>(fs, wal_path.c_str(), true);
+	wal_size = remaining;
+	// everything that was written to the WAL has been synced as part of the truncation
+	synced_position = written_position;
+	sync_signal.notify_all();
+}
+
 //===--------------------------------------------------------------------===//
 // Write Entries
 //===--------------------------------------------------------------------===//
@@ -80,6 +125,20 @@ void WriteAheadLog::WriteDropView(ViewCatalogEntry *entry) {
 	writer->WriteString(entry->name);
 }
 
+//===--------------------------------------------------------------------===//
+// INDEXES
+//===--------------------------------------------------------------------===//
+void WriteAheadLog::WriteCreateIndex(IndexCatalogEntry *entry) {
+	writer->Write<WALType>(WALType::CREATE_INDEX);
+	entry->Serialize(*writer);
+}
+
+void WriteAheadLog::WriteDropIndex(IndexCatalogEntry *entry) {
+	writer->Write<WALType>(WALType::DROP_INDEX);
+	writer->WriteString(entry->schema->name);
+	writer->WriteString(entry->name);
+}
+
 //===--------------------------------------------------------------------===//
 // DROP SCHEMA
 //===--------------------------------------------------------------------===//
@@ -131,12 +190,70 @@ void WriteAheadLog::WriteQuery(string &query) {
 	writer->WriteString(query);
 }
 
+//===--------------------------------------------------------------------===//
+// CHECKPOINT
+//===--------------------------------------------------------------------===//
+index_t WriteAheadLog::WriteCheckpoint(uint64_t iteration) {
+	index_t position = wal_size;
+	// the marker is a separate (empty) transaction, so it can also be replayed like any other entry
+	writer->Write<WALType>(WALType::CHECKPOINT);
+	writer->Write<uint64_t>(iteration);
+	Flush();
+	assert(wal_size == position + CHECKPOINT_MARKER_SIZE);
+	return position;
+}
+
+index_t WriteAheadLog::WriteCheckpoint(DuckDB &database, string &path, uint64_t iteration) {
+	BufferedFileWriter writer(*database.file_system, path.c_str(), true);
+	index_t position = database.file_system->GetFileSize(*writer.handle);
+	writer.Write<WALType>(WALType::CHECKPOINT);
+	writer.Write<uint64_t>(iteration);
+	writer.Write<WALType>(WALType::WAL_FLUSH);
+	writer.Sync();
+	return position;
+}
+
 //===--------------------------------------------------------------------===//
 // FLUSH
 //===--------------------------------------------------------------------===//
-void WriteAheadLog::Flush() {
+index_t WriteAheadLog::Flush() {
 	// write an empty entry
 	writer->Write<WALType>(WALType::WAL_FLUSH);
-	// flushes all changes made to the WAL to disk
-	writer->Sync();
+	// write all changes made to the WAL to the file, they are synced to disk in Sync
+	writer->Flush();
+	index_t file_size = database.file_system->GetFileSize(*writer->handle);
+	written_position += file_size - wal_size;
+	wal_size = file_size;
+	return written_position;
+}
+
+void WriteAheadLog::Sync(index_t position) {
+	unique_lock<mutex> guard(sync_lock);
+	while (synced_position < position) {
+		if (sync_in_progress) {
+			// another transaction is syncing the WAL: wait for it to finish, it might have synced our changes as well
+			sync_signal.wait(guard);
+			continue;
+		}
+		// no sync is running: sync the WAL for all transactions that have written to it up until now
+		sync_in_progress = true;
+		guard.unlock();
+		if (database.wal_group_commit_window > 0) {
+			// give other committing transactions the chance to join the sync
+			this_thread::sleep_for(chrono::microseconds(database.wal_group_commit_window));
+		}
+		index_t sync_position = written_position;
+		try {
+			writer->handle->Sync();
+		} catch (...) {
+			guard.lock();
+			sync_in_progress = false;
+			sync_signal.notify_all();
+			throw;
+		}
+		guard.lock();
+		synced_position = std::max(synced_position, sync_position);
+		sync_in_progress = false;
+		sync_signal.notify_all();
+	}
 }
@@ -1,4 +1,5 @@
 #include "duckdb/transaction/commit_state.hpp"
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
 #include "duckdb/transaction/delete_info.hpp"
 #include "duckdb/transaction/update_info.hpp"
 
@@ -49,6 +50,9 @@ void CommitState::WriteCatalogEntry(CatalogEntry *entry) {
 	case CatalogType::SEQUENCE:
 		log->WriteCreateSequence((SequenceCatalogEntry *)parent);
 		break;
+	case CatalogType::INDEX:
+		log->WriteCreateIndex((IndexCatalogEntry *)parent);
+		break;
 	case CatalogType::DELETED_ENTRY:
 		if (entry->type == CatalogType::TABLE) {
 			log->WriteDropTable((TableCatalogEntry *)entry);
@@ -58,6 +62,8 @@ void CommitState::WriteCatalogEntry(CatalogEntry *entry) {
 			log->WriteDropView((ViewCatalogEntry *)entry);
 		} else if (entry->type == CatalogType::SEQUENCE) {
 			log->WriteDropSequence((SequenceCatalogEntry *)entry);
+		} else if (entry->type == CatalogType::INDEX) {
+			log->WriteDropIndex((IndexCatalogEntry *)entry);
 		} else if (entry->type == CatalogType::PREPARED_STATEMENT) {
 			// do nothing, we log the query to drop this
 		} else {
@@ -65,7 +71,6 @@ void CommitState::WriteCatalogEntry(CatalogEntry *entry) {
 		}
 		break;
 
-	case CatalogType::INDEX:
 	case CatalogType::PREPARED_STATEMENT:
 		// do nothing, we log the query to recreate this
 		break;
@@ -72,7 +72,7 @@ void Transaction::Commit(WriteAheadLog *log, transaction_t commit_id) noexcept {
 		for (auto &entry : sequence_usage) {
 			log->WriteSequenceValue(entry.first, entry.second);
 		}
-		// flush the WAL
+		// write the changes to the WAL file, the transaction manager syncs them to disk
 		if (changes_made) {
 			log->Flush();
 		}
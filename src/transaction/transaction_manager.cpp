@@ -30,7 +30,49 @@ TransactionManager::~TransactionManager() {
 Transaction *TransactionManager::StartTransaction() {
 	// obtain the transaction lock during this function
 	lock_guard<mutex> lock(transaction_lock);
+	return StartTransactionInternal();
+}
 
+Transaction *TransactionManager::StartCheckpointTransaction(uint64_t iteration, index_t &wal_offset) {
+	auto wal = storage.GetWriteAheadLog();
+	Transaction *transaction;
+	index_t sync_position = 0;
+	{
+		// no transaction can commit while we hold the transaction lock: the WAL before the marker contains exactly the
+		// transactions that committed before this transaction started
+		lock_guard<mutex> lock(transaction_lock);
+		wal_offset = 0;
+		if (wal) {
+			wal_offset = wal->WriteCheckpoint(iteration);
+			sync_position = wal->GetWrittenPosition();
+		}
+		transaction = StartTransactionInternal();
+	}
+	if (wal) {
+		// the marker has to be on disk before the header of the checkpoint, which refers to it, is written
+		try {
+			wal->Sync(sync_position);
+		} catch (...) {
+			RollbackTransaction(transaction);
+			throw;
+		}
+	}
+	return transaction;
+}
+
+void TransactionManager::TruncateWAL(index_t wal_offset) {
+	// obtain the transaction lock, so no transaction commits (and writes to the WAL) while the WAL is truncated
+	lock_guard<mutex> lock(transaction_lock);
+	auto wal = storage.GetWriteAheadLog();
+	if (wal) {
+		wal->Truncate(wal_offset);
+	}
+}
+
+Transaction *TransactionManager::StartTransactionInternal() {
+	if (!invalidated_error.empty()) {
+		throw FatalException("The database was invalidated: %s", invalidated_error.c_str());
+	}
 	if (current_start_timestamp >= TRANSACTION_ID_START) {
 		throw Exception("Cannot start more transactions, ran out of "
 		                "transaction identifiers!");
@@ -52,10 +94,13 @@ Transaction *TransactionManager::StartTransaction() {
 
 void TransactionManager::CommitTransaction(Transaction *transaction) {
 	// obtain the transaction lock during this function
-	lock_guard<mutex> lock(transaction_lock);
+	unique_lock<mutex> lock(transaction_lock);
 
 	// first check whether we can commit this transaction
 	try {
+		if (!invalidated_error.empty()) {
+			throw FatalException("The database was invalidated: %s", invalidated_error.c_str());
+		}
 		transaction->CheckCommit();
 	} catch (Exception &ex) {
 		// cannot commit transaction! roll it back instead of committing it
@@ -68,11 +113,31 @@ void TransactionManager::CommitTransaction(Transaction *transaction) {
 	transaction_t commit_id = current_start_timestamp++;
 
 	// commit the UndoBuffer of the transaction
-	transaction->Commit(storage.GetWriteAheadLog(), commit_id);
+	auto log = storage.GetWriteAheadLog();
+	index_t log_start = log ? log->GetWrittenPosition() : 0;
+	transaction->Commit(log, commit_id);
+	index_t log_end = log ? log->GetWrittenPosition() : 0;
 
 	// remove the transaction id from the list of active transactions
 	// potentially resulting in garbage collection
 	RemoveTransaction(transaction);
+
+	if (log_end > log_start) {
+		// the changes of the transaction are written to the WAL, but have not been synced yet: sync them after
+		// releasing the transaction lock, so the transactions that commit in the meantime can share the sync
+		lock.unlock();
+		try {
+			log->Sync(log_end);
+		} catch (std::exception &ex) {
+			// the changes of the transaction are already visible, and can have been read by other transactions: the
+			// commit cannot be rolled back. The changes might not be durable, so no more changes can be committed.
+			lock.lock();
+			if (invalidated_error.empty()) {
+				invalidated_error = string("failed to sync the WAL after a commit: ") + ex.what();
+			}
+			throw FatalException("The database was invalidated: %s", invalidated_error.c_str());
+		}
+	}
 }
 
 void TransactionManager::RollbackTransaction(Transaction *transaction) {
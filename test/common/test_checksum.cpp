@@ -38,3 +38,24 @@ TEST_CASE("Checksum tests", "[checksum]") {
 	REQUIRE(c1 != c4);
 	REQUIRE(c1 != c5);
 }
+
+TEST_CASE("CRC32C checksum tests", "[checksum]") {
+	// the check value of CRC32C
+	string check = "123456789";
+	REQUIRE(Crc32c(0, (uint8_t *)check.c_str(), check.size()) == 0xE3069283);
+	REQUIRE(Crc32cPortable(0, (uint8_t *)check.c_str(), check.size()) == 0xE3069283);
+	// the checksum can be computed incrementally
+	uint32_t crc = Crc32c(0, (uint8_t *)check.c_str(), 4);
+	REQUIRE(Crc32c(crc, (uint8_t *)check.c_str() + 4, check.size() - 4) == 0xE3069283);
+
+	// the accelerated implementation matches the portable implementation for any size and alignment
+	vector<uint8_t> buffer(Storage::BLOCK_ALLOC_SIZE + 8);
+	for (size_t i = 0; i < buffer.size(); i++) {
+		buffer[i] = (uint8_t)(i * 7 + i / 251);
+	}
+	for (size_t offset = 0; offset < 8; offset++) {
+		for (size_t size : vector<size_t>{0, 1, 3, 8, 15, 256 * 3 + 5, 8192 * 3 + 1000, Storage::BLOCK_ALLOC_SIZE}) {
+			REQUIRE(Crc32c(1, buffer.data() + offset, size) == Crc32cPortable(1, buffer.data() + offset, size));
+		}
+	}
+}
@@ -5,6 +5,7 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/value_operations/value_operations.hpp"
 #include "compare_result.hpp"
+#include "duckdb/main/client_context.hpp"
 #include "duckdb/main/query_result.hpp"
 #include "test_helpers.hpp"
 #include "duckdb/parser/parsed_data/copy_info.hpp"
@@ -17,6 +18,10 @@ using namespace std;
 
 namespace duckdb {
 
+unique_ptr<QueryResult> SQLQuery(Connection &con, string query) {
+	return con.context->Query(query, false);
+}
+
 bool NO_FAIL(QueryResult &result) {
 	if (!result.success) {
 		fprintf(stderr, "Query failed with message: %s\n", result.error.c_str());
@@ -25,6 +25,10 @@ void TestDeleteFile(string path);
 string TestCreatePath(string suffix);
 unique_ptr<DBConfig> GetTestConfig();
 
+//! Runs a query directly against the client context of the connection, bypassing the TQL front end of
+//! Connection::Query
+unique_ptr<QueryResult> SQLQuery(Connection &con, string query);
+
 bool NO_FAIL(QueryResult &result);
 bool NO_FAIL(unique_ptr<QueryResult> result);
 
@@ -0,0 +1,47 @@
+#include "catch.hpp"
+#include "duckdb/common/helper.hpp"
+#include "expression_helper.hpp"
+#include "duckdb/optimizer/table_filter_pushdown.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test Table Filter Pushdown Optimizer", "[optimizer]") {
+	ExpressionHelper helper;
+	auto &con = helper.con;
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER, j INTEGER, s VARCHAR)"));
+
+	// comparisons of a column with a constant are pushed into the scan, and the filter is removed
+	auto tree = helper.ParseLogicalTree("SELECT i FROM integers WHERE i > 10 AND 20 >= j");
+	TableFilterPushdown pushdown;
+	auto plan = pushdown.Optimize(move(tree));
+	REQUIRE(plan->children[0]->type == LogicalOperatorType::GET);
+	auto &get = (LogicalGet &)*plan->children[0];
+	REQUIRE(get.table_filters.size() == 2);
+	// the filters can be pushed in any order: look them up by the column they filter
+	auto find_filter = [&](column_t column) -> TableFilter * {
+		for (auto &filter : get.table_filters) {
+			if (get.column_ids[filter.column_index] == column) {
+				return &filter;
+			}
+		}
+		return nullptr;
+	};
+	auto filter_i = find_filter(0), filter_j = find_filter(1);
+	REQUIRE(filter_i);
+	REQUIRE(filter_j);
+	REQUIRE(filter_i->comparison_type == ExpressionType::COMPARE_GREATERTHAN);
+	// the constant is on the left side: the comparison is flipped
+	REQUIRE(filter_j->comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO);
+
+	// other filters remain in the filter
+	tree = helper.ParseLogicalTree("SELECT i FROM integers WHERE i = 10 AND i + j = 20 AND s = 'hello'");
+	plan = pushdown.Optimize(move(tree));
+	REQUIRE(plan->children[0]->type == LogicalOperatorType::FILTER);
+	REQUIRE(((LogicalFilter &)*plan->children[0]).expressions.size() == 2);
+	REQUIRE(plan->children[0]->children[0]->type == LogicalOperatorType::GET);
+	REQUIRE(((LogicalGet &)*plan->children[0]->children[0]).table_filters.size() == 1);
+}
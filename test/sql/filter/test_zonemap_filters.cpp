@@ -0,0 +1,137 @@
+#include "catch.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test filters that are pushed into the table scan", "[filter]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+	con.EnableQueryVerification();
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(a INTEGER, b INTEGER)"));
+	REQUIRE_NO_FAIL(
+	    con.Query("INSERT INTO integers VALUES (1, 10), (2, 12), (3, 14), (4, 16), (5, NULL), (NULL, NULL)"));
+
+	result = con.Query("SELECT a FROM integers WHERE a > 2 ORDER BY a");
+	REQUIRE(CHECK_COLUMN(result, 0, {3, 4, 5}));
+	result = con.Query("SELECT a FROM integers WHERE 2 >= a ORDER BY a");
+	REQUIRE(CHECK_COLUMN(result, 0, {1, 2}));
+	result = con.Query("SELECT a, b FROM integers WHERE a >= 2 AND b < 16 ORDER BY a");
+	REQUIRE(CHECK_COLUMN(result, 0, {2, 3}));
+	REQUIRE(CHECK_COLUMN(result, 1, {12, 14}));
+	result = con.Query("SELECT b FROM integers WHERE b = 14");
+	REQUIRE(CHECK_COLUMN(result, 0, {14}));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE a > 10");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+
+	// filters on transaction-local data
+	REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (11, 20), (12, 22)"));
+	result = con.Query("SELECT a FROM integers WHERE a > 4 ORDER BY a");
+	REQUIRE(CHECK_COLUMN(result, 0, {5, 11, 12}));
+	REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+
+	// filters in updates and deletes
+	REQUIRE_NO_FAIL(con.Query("UPDATE integers SET b=100 WHERE a=1"));
+	result = con.Query("SELECT a FROM integers WHERE b >= 100");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	REQUIRE_NO_FAIL(con.Query("DELETE FROM integers WHERE a <= 2"));
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE a < 10");
+	REQUIRE(CHECK_COLUMN(result, 0, {3}));
+}
+
+TEST_CASE("Test skipping segments with zonemaps", "[filter][.]") {
+	constexpr int64_t VALUE_COUNT = 500000;
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// an append-ordered table spans many segments with disjoint ranges
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE events(ts BIGINT, value DOUBLE)"));
+	auto appender = con.OpenAppender(DEFAULT_SCHEMA, "events");
+	for (int64_t i = 0; i < VALUE_COUNT; i++) {
+		appender->BeginRow();
+		appender->AppendBigInt(i);
+		appender->AppendDouble(i % 100);
+		appender->EndRow();
+	}
+	con.CloseAppender();
+
+	result = con.Query("SELECT COUNT(*), MIN(ts), MAX(ts) FROM events WHERE ts >= 250000 AND ts < 250100");
+	REQUIRE(CHECK_COLUMN(result, 0, {100}));
+	REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(250000)}));
+	REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(250099)}));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE ts > 499990");
+	REQUIRE(CHECK_COLUMN(result, 0, {9}));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE ts = 123456");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE value = 99.0");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT / 100)}));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE value > 99.0");
+	REQUIRE(CHECK_COLUMN(result, 0, {0}));
+
+	// updating a value outside of the range of a segment widens its zonemap
+	REQUIRE_NO_FAIL(con.Query("UPDATE events SET ts=-1 WHERE ts=300000"));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE ts < 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	result = con.Query("SELECT COUNT(*) FROM events WHERE ts >= 299999 AND ts <= 300001");
+	REQUIRE(CHECK_COLUMN(result, 0, {2}));
+}
+
+TEST_CASE("Test zonemaps of persistent segments", "[filter]") {
+	constexpr int32_t VALUE_COUNT = 100000;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("zonemap_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			if (i % 10 == 0) {
+				appender->AppendValue(Value());
+			} else {
+				appender->AppendInteger(-i);
+			}
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// the min/max statistics of the segments are stored with the checkpoint
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), MIN(a), MAX(a) FROM test WHERE a >= 70000 AND a < 70010");
+		REQUIRE(CHECK_COLUMN(result, 0, {10}));
+		REQUIRE(CHECK_COLUMN(result, 1, {70000}));
+		REQUIRE(CHECK_COLUMN(result, 2, {70009}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE b <= -99990");
+		REQUIRE(CHECK_COLUMN(result, 0, {9}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE b > 0");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+	}
+	// update a value outside of the range of its segment, and reload
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=1000000 WHERE a=5"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE a > 999999");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM test WHERE a > 999999");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+	}
+	DeleteDatabase(storage_database);
+}
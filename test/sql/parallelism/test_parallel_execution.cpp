@@ -0,0 +1,388 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test PRAGMA threads", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=4"));
+	REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=1"));
+	// the thread count has to be a positive number
+	REQUIRE_FAIL(SQLQuery(con, "PRAGMA threads=0"));
+	REQUIRE_FAIL(SQLQuery(con, "PRAGMA threads=-1"));
+	REQUIRE_FAIL(SQLQuery(con, "PRAGMA threads"));
+}
+
+TEST_CASE("Test parallel query execution", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	// create a table that spans many vectors
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE integers(i INTEGER, j INTEGER, s VARCHAR)"));
+	auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+	for (int32_t i = 0; i < 100000; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i);
+		appender->AppendInteger(i % 100);
+		appender->AppendValue(Value("thisisalongstring" + to_string(i % 10)));
+		appender->EndRow();
+	}
+	con.CloseAppender();
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE groups AS SELECT DISTINCT j AS k, j * 2 AS v FROM integers"));
+
+	vector<string> queries = {
+	    "SELECT COUNT(*), SUM(i), MIN(i), MAX(s) FROM integers",
+	    "SELECT COUNT(*), SUM(i) FROM integers WHERE j > 50",
+	    "SELECT j, COUNT(*), SUM(i), MIN(s), MAX(i) FROM integers GROUP BY j ORDER BY j",
+	    "SELECT s, COUNT(DISTINCT j) FROM integers GROUP BY s ORDER BY s",
+	    "SELECT DISTINCT s FROM integers ORDER BY s",
+	    "SELECT i, j, s FROM integers WHERE i % 997 = 0 ORDER BY i DESC, j",
+	    "SELECT v, COUNT(*), SUM(i) FROM integers JOIN groups ON j = k WHERE i > 100 GROUP BY v ORDER BY v",
+	    "SELECT COUNT(*), SUM(v) FROM integers JOIN groups ON j = k",
+	    "SELECT COUNT(*) FROM integers WHERE j IN (SELECT k FROM groups WHERE v < 50)",
+	    // joins with a large build side
+	    "SELECT COUNT(*), SUM(i2.j), MIN(i2.s), MAX(i2.s) FROM integers i1 JOIN integers i2 ON i1.i = i2.i + 1",
+	    "SELECT i1.s, COUNT(*) FROM integers i1 JOIN integers i2 ON i1.i = i2.i AND i1.s = i2.s WHERE i2.j < 10 "
+	    "GROUP BY i1.s ORDER BY i1.s",
+	    // aggregates with many groups
+	    "SELECT COUNT(*), SUM(c), SUM(a), MIN(m), MAX(m) FROM (SELECT i % 50000 AS g, COUNT(*) AS c, AVG(j) AS a, "
+	    "MIN(s) AS m FROM integers GROUP BY g) t",
+	    "SELECT s, j % 7 AS g, COUNT(*), SUM(i), AVG(j), MIN(i), MAX(s) FROM integers GROUP BY s, g ORDER BY s, g",
+	    // groups for which some threads only see NULL values
+	    "SELECT j, SUM(CASE WHEN i < 50000 THEN i ELSE NULL END), MIN(CASE WHEN i > 90000 THEN s ELSE NULL END) "
+	    "FROM integers GROUP BY j ORDER BY j",
+	    // NULL groups
+	    "SELECT CASE WHEN j < 10 THEN NULL ELSE j END AS g, COUNT(*), SUM(i) FROM integers GROUP BY g ORDER BY g",
+	    // sorts of many rows on strings, NULL values and doubles
+	    "SELECT i, s FROM integers ORDER BY s DESC, i",
+	    "SELECT i, j FROM integers ORDER BY CASE WHEN j % 3 = 0 THEN NULL ELSE j END, i DESC",
+	    "SELECT i FROM integers ORDER BY (i % 1000) * -0.5, i",
+	};
+	for (auto &query : queries) {
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=1"));
+		auto serial_result = SQLQuery(con, query);
+		REQUIRE_NO_FAIL(*serial_result);
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=4"));
+		auto parallel_result = SQLQuery(con, query);
+		REQUIRE_NO_FAIL(*parallel_result);
+		INFO(query);
+		REQUIRE(serial_result->Equals(*parallel_result));
+	}
+
+	// scans inside a transaction also see the transaction-local changes
+	REQUIRE_NO_FAIL(SQLQuery(con, "BEGIN TRANSACTION"));
+	REQUIRE_NO_FAIL(SQLQuery(con, "DELETE FROM integers WHERE j >= 50"));
+	REQUIRE_NO_FAIL(SQLQuery(con, "INSERT INTO integers VALUES (NULL, 1000, NULL)"));
+	result = SQLQuery(con, "SELECT COUNT(*), COUNT(i), SUM(j) FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {50001}));
+	REQUIRE(CHECK_COLUMN(result, 1, {50000}));
+	REQUIRE(CHECK_COLUMN(result, 2, {1226000}));
+	REQUIRE_NO_FAIL(SQLQuery(con, "ROLLBACK"));
+
+	// join on multiple keys with a large build side
+	result = SQLQuery(con, "SELECT COUNT(*) FROM integers i1 JOIN integers i2 ON i1.i = i2.i AND i1.j = i2.j");
+	REQUIRE(CHECK_COLUMN(result, 0, {100000}));
+
+	// sort on strings that only differ after the prefix that is stored in the sort key
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE strings(s VARCHAR)"));
+	REQUIRE_NO_FAIL(SQLQuery(
+	    con, "INSERT INTO strings VALUES ('longprefixb'), (NULL), ('longprefix'), ('longprefixa'), ('long')"));
+	result = SQLQuery(con, "SELECT s FROM strings ORDER BY s DESC");
+	REQUIRE(CHECK_COLUMN(result, 0, {"longprefixb", "longprefixa", "longprefix", "long", Value()}));
+	result = SQLQuery(con, "SELECT s FROM strings ORDER BY s");
+	REQUIRE(CHECK_COLUMN(result, 0, {Value(), "long", "longprefix", "longprefixa", "longprefixb"}));
+
+	// errors that happen in a background thread are reported to the client
+	REQUIRE_FAIL(SQLQuery(con, "SELECT SUM(CAST(s AS INTEGER)) FROM integers"));
+	REQUIRE_FAIL(SQLQuery(con, "SELECT j, SUM(CAST(s AS INTEGER)) FROM integers GROUP BY j"));
+	// the connection is still usable afterwards
+	result = SQLQuery(con, "SELECT COUNT(*) FROM integers");
+	REQUIRE(CHECK_COLUMN(result, 0, {100000}));
+}
+
+TEST_CASE("Test pipelines that stream chunks through a chain of operators", "[parallelism]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE integers(i INTEGER)"));
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE dups(k INTEGER)"));
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE empty(k INTEGER)"));
+	auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+	for (int32_t i = 0; i < 10000; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i);
+		appender->EndRow();
+	}
+	con.CloseAppender();
+	appender = con.OpenAppender(DEFAULT_SCHEMA, "dups");
+	for (int32_t i = 0; i < 2000; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i % 5);
+		appender->EndRow();
+	}
+	con.CloseAppender();
+
+	for (index_t threads = 1; threads <= 4; threads += 3) {
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=" + to_string(threads)));
+		// filter -> projection -> join -> filter -> aggregate
+		result = SQLQuery(con, "SELECT COUNT(*), SUM(x) FROM (SELECT i + 1 AS x FROM integers WHERE i % 2 = 0) t1 "
+		                       "JOIN (SELECT i FROM integers WHERE i < 100) t2 ON t1.x = t2.i + 1 WHERE x > 10");
+		REQUIRE(CHECK_COLUMN(result, 0, {45}));
+		REQUIRE(CHECK_COLUMN(result, 1, {2475}));
+		// every row of the probe side matches 400 rows: the join produces more than one chunk per input chunk
+		result = SQLQuery(con, "SELECT COUNT(*), SUM(i) FROM integers JOIN dups ON i = k WHERE k < 3");
+		REQUIRE(CHECK_COLUMN(result, 0, {1200}));
+		REQUIRE(CHECK_COLUMN(result, 1, {1200}));
+		// two joins in the same pipeline
+		result = SQLQuery(con, "SELECT COUNT(*) FROM integers i1 JOIN integers i2 ON i1.i = i2.i JOIN dups ON "
+		                       "i2.i = dups.k");
+		REQUIRE(CHECK_COLUMN(result, 0, {2000}));
+		// a join with an empty build side stops the pipeline early
+		result = SQLQuery(con, "SELECT COUNT(*) FROM integers JOIN empty ON i = k");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = SQLQuery(con, "SELECT COUNT(*) FROM integers WHERE i NOT IN (SELECT k FROM empty)");
+		REQUIRE(CHECK_COLUMN(result, 0, {10000}));
+		result = SQLQuery(con, "SELECT COUNT(*) FROM integers WHERE i IN (SELECT k FROM dups)");
+		REQUIRE(CHECK_COLUMN(result, 0, {5}));
+	}
+}
+
+TEST_CASE("Test parallel scan of persistent, transient and transaction-local data", "[parallelism]") {
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("parallel_scan_test");
+
+	DeleteDatabase(storage_database);
+	{
+		// create a table and write it to disk
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE integers(i INTEGER, s VARCHAR)"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+		for (int32_t i = 0; i < 50000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendValue(Value("string" + to_string(i % 100)));
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		// append transient data to the persistent data
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+		for (int32_t i = 50000; i < 80000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendValue(Value("string" + to_string(i % 100)));
+			appender->EndRow();
+		}
+		con.CloseAppender();
+		REQUIRE_NO_FAIL(SQLQuery(con, "DELETE FROM integers WHERE i % 10 = 0"));
+		REQUIRE_NO_FAIL(SQLQuery(con, "UPDATE integers SET i = i + 1000000 WHERE i % 10 = 1"));
+
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=4"));
+		result = SQLQuery(con, "SELECT COUNT(*), SUM(i), COUNT(DISTINCT s) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {72000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(10880000000LL)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {90}));
+
+		// another transaction does not see the uncommitted changes of this transaction
+		Connection con2(db);
+		REQUIRE_NO_FAIL(SQLQuery(con2, "BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(SQLQuery(con2, "DELETE FROM integers WHERE i < 40000"));
+		REQUIRE_NO_FAIL(SQLQuery(con2, "INSERT INTO integers VALUES (-1, 'string')"));
+		result = SQLQuery(con2, "SELECT COUNT(*), MIN(i), COUNT(DISTINCT s) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {40001}));
+		REQUIRE(CHECK_COLUMN(result, 1, {-1}));
+		REQUIRE(CHECK_COLUMN(result, 2, {91}));
+		result = SQLQuery(con, "SELECT COUNT(*), MIN(i) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {72000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {2}));
+		REQUIRE_NO_FAIL(SQLQuery(con2, "ROLLBACK"));
+	}
+	DeleteDatabase(storage_database);
+}
+
+static void RunParallelQueries(DuckDB *db, bool *success) {
+	Connection con(*db);
+	for (index_t i = 0; i < 20; i++) {
+		auto result = SQLQuery(con, "SELECT COUNT(*), SUM(i) FROM integers WHERE i % 2 = 0");
+		if (!CHECK_COLUMN(result, 0, {50000}) || !CHECK_COLUMN(result, 1, {Value::BIGINT(2499950000)})) {
+			*success = false;
+			return;
+		}
+	}
+	*success = true;
+}
+
+TEST_CASE("Test parallel queries from multiple connections sharing the task scheduler", "[parallelism]") {
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE integers(i INTEGER)"));
+	auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+	for (int32_t i = 0; i < 100000; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i);
+		appender->EndRow();
+	}
+	con.CloseAppender();
+	REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=4"));
+
+	// the tasks of all connections are scheduled on the same worker threads
+	bool success[4];
+	vector<thread> threads;
+	for (index_t i = 0; i < 4; i++) {
+		threads.push_back(thread(RunParallelQueries, &db, success + i));
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	for (index_t i = 0; i < 4; i++) {
+		REQUIRE(success[i]);
+	}
+}
+
+static void SetThreadsConcurrently(DuckDB *db, index_t thread_count, bool *success) {
+	Connection con(*db);
+	for (index_t i = 0; i < 10; i++) {
+		if (!SQLQuery(con, "PRAGMA threads=" + to_string(thread_count))->success) {
+			*success = false;
+			return;
+		}
+	}
+	*success = true;
+}
+
+TEST_CASE("Test changing the amount of threads from multiple connections", "[parallelism]") {
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	bool success[4];
+	vector<thread> threads;
+	for (index_t i = 0; i < 4; i++) {
+		threads.push_back(thread(SetThreadsConcurrently, &db, i + 2, success + i));
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	for (index_t i = 0; i < 4; i++) {
+		REQUIRE(success[i]);
+	}
+	// the threads of the last call replaced the threads of all previous calls
+	auto thread_count = db.scheduler->NumberOfThreads();
+	REQUIRE(thread_count >= 2);
+	REQUIRE(thread_count <= 5);
+	REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=1"));
+	REQUIRE(db.scheduler->NumberOfThreads() == 1);
+}
+
+//! Records the order in which the tasks are executed
+class RecordTask : public Task {
+public:
+	RecordTask(vector<index_t> &order, index_t id) : order(order), id(id) {
+	}
+
+	vector<index_t> &order;
+	index_t id;
+
+public:
+	void Execute() override {
+		order.push_back(id);
+	}
+};
+
+TEST_CASE("Test executing the tasks of the task scheduler in priority order", "[parallelism]") {
+	DuckDB db(nullptr);
+	auto &scheduler = *db.scheduler;
+	// no background threads: the tasks are only executed when they are fetched by this thread
+	scheduler.SetThreads(1);
+
+	vector<index_t> order;
+	scheduler.ScheduleTask(make_unique<RecordTask>(order, 0), TaskPriority::LOW);
+	scheduler.ScheduleTask(make_unique<RecordTask>(order, 1), TaskPriority::NORMAL);
+	scheduler.ScheduleTask(make_unique<RecordTask>(order, 2), TaskPriority::HIGH);
+	scheduler.ScheduleTask(make_unique<RecordTask>(order, 3), TaskPriority::NORMAL);
+	// only the tasks of at least the given priority are executed
+	REQUIRE(scheduler.ExecuteTask(TaskPriority::HIGH));
+	REQUIRE(!scheduler.ExecuteTask(TaskPriority::HIGH));
+	while (scheduler.ExecuteTask(TaskPriority::LOW)) {
+	}
+	REQUIRE(order.size() == 4);
+	REQUIRE(order[0] == 2);
+	REQUIRE(order[1] != 0);
+	REQUIRE(order[2] != 0);
+	REQUIRE(order[3] == 0);
+}
+
+//! Interrupts the tasks of the group it belongs to
+class InterruptTask : public Task {
+public:
+	InterruptTask(std::atomic<bool> &interrupted, std::atomic<index_t> &executed)
+	    : interrupted(interrupted), executed(executed) {
+	}
+
+	std::atomic<bool> &interrupted;
+	std::atomic<index_t> &executed;
+
+public:
+	void Execute() override {
+		executed++;
+		interrupted = true;
+	}
+};
+
+TEST_CASE("Test interrupting parallel tasks", "[parallelism]") {
+	DuckDB db(nullptr);
+	Connection con(db);
+	auto &scheduler = *db.scheduler;
+
+	// the tasks that have not started yet once the group is interrupted are skipped
+	scheduler.SetThreads(1);
+	std::atomic<bool> interrupted(false);
+	std::atomic<index_t> executed(0);
+	vector<unique_ptr<Task>> tasks;
+	for (index_t i = 0; i < 10; i++) {
+		tasks.push_back(make_unique<InterruptTask>(interrupted, executed));
+	}
+	scheduler.ExecuteTasks(move(tasks), TaskPriority::NORMAL, &interrupted);
+	REQUIRE(executed == 1);
+
+	// interrupting a query cancels its running tasks
+	REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE integers(i INTEGER)"));
+	auto appender = con.OpenAppender(DEFAULT_SCHEMA, "integers");
+	for (int32_t i = 0; i < 100000; i++) {
+		appender->BeginRow();
+		appender->AppendInteger(i);
+		appender->EndRow();
+	}
+	con.CloseAppender();
+	REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=4"));
+	std::atomic<bool> finished(false);
+	unique_ptr<QueryResult> result;
+	thread query_thread([&] {
+		result = SQLQuery(con, "SELECT SUM(t1.i + t2.i) FROM integers t1, integers t2");
+		finished = true;
+	});
+	// the query resets the interrupted flag when it starts: keep interrupting it until it has stopped
+	while (!finished) {
+		con.Interrupt();
+		this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	query_thread.join();
+	REQUIRE(!result->success);
+	REQUIRE_NO_FAIL(SQLQuery(con, "SELECT COUNT(*) FROM integers"));
+}
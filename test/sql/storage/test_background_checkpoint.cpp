@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/write_ahead_log.hpp"
+#include "test_helpers.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+//! Wait until the background thread has checkpointed the database and truncated the WAL, after which the WAL only
+//! contains the marker of the checkpoint
+static bool WaitForEmptyWAL(FileSystem &fs, string wal_path) {
+	for (index_t i = 0; i < 1000; i++) {
+		auto handle = fs.OpenFile(wal_path, FileFlags::READ);
+		if (fs.GetFileSize(*handle) == WriteAheadLog::CHECKPOINT_MARKER_SIZE) {
+			return true;
+		}
+		this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	return false;
+}
+
+static string ReadWAL(FileSystem &fs, string wal_path) {
+	auto handle = fs.OpenFile(wal_path, FileFlags::READ);
+	string data(fs.GetFileSize(*handle), '\0');
+	handle->Read((void *)data.data(), data.size(), 0);
+	return data;
+}
+
+static void WriteWAL(FileSystem &fs, string wal_path, string data) {
+	fs.RemoveFile(wal_path);
+	auto handle = fs.OpenFile(wal_path, FileFlags::WRITE | FileFlags::CREATE);
+	handle->Write((void *)data.data(), data.size(), 0);
+	handle->Sync();
+}
+
+TEST_CASE("Test checkpointing in the background while the database is in use", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	config->background_checkpoint = true;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("background_checkpoint_test");
+	auto wal_path = storage_database + ".wal";
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), reader(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER PRIMARY KEY, b INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 10000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendInteger(i);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+		REQUIRE(WaitForEmptyWAL(fs, wal_path));
+		// the deleted rows keep their row ids in the checkpoints that are created while the database is running
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a % 2 = 0"));
+		REQUIRE(WaitForEmptyWAL(fs, wal_path));
+		// keep modifying and reading the table while it is checkpointed
+		for (int32_t i = 0; i < 20; i++) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(10000 + i) + ", 0)"));
+			REQUIRE_NO_FAIL(con.Query("UPDATE test SET b=b+1 WHERE a=1"));
+			REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=" + to_string(1001 + 2 * i)));
+			result = reader.Query("SELECT COUNT(*) FROM test");
+			REQUIRE(CHECK_COLUMN(result, 0, {5000}));
+			this_thread::sleep_for(chrono::milliseconds(20));
+		}
+	}
+	// reload the database, which replays the part of the WAL that was not checkpointed yet
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {5000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(25000000 + 20 - 20 * 1020)}));
+		result = con.Query("SELECT b FROM test WHERE a=1");
+		REQUIRE(CHECK_COLUMN(result, 0, {21}));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (10019, 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1001, 1001)"));
+		REQUIRE(WaitForEmptyWAL(fs, wal_path));
+	}
+	// the checkpoint contains all changes: the database can be loaded without the WAL
+	fs.RemoveFile(wal_path);
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, GetTestConfig().get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {5001}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(25000000 + 20 - 20 * 1020 + 1001)}));
+		result = con.Query("SELECT b FROM test WHERE a=1001");
+		REQUIRE(CHECK_COLUMN(result, 0, {1001}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE a % 2 = 0 AND a < 10000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (1, 0)"));
+		if (i == 0) {
+			// the deleted keys can be inserted again
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (0, 0)"));
+			REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=0"));
+		}
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test reloading a database that stopped before the WAL was truncated by a checkpoint", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("checkpoint_marker_test");
+	auto wal_path = storage_database + ".wal";
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	string checkpointed_wal;
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER PRIMARY KEY, b INTEGER);"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (1, 1), (2, 2), (3, 3)"));
+		checkpointed_wal = ReadWAL(fs, wal_path);
+		db.storage->CreateCheckpoint();
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (4, 4)"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET b=b+10 WHERE a=1"));
+	}
+	// put the checkpointed part back in front of the truncated WAL, as if the system stopped after the header of the
+	// checkpoint was written but before the WAL was truncated
+	WriteWAL(fs, wal_path, checkpointed_wal + ReadWAL(fs, wal_path));
+	// the checkpointed part of the WAL is skipped: the table is not created twice, and the rows are not duplicated
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT a, b FROM test ORDER BY a");
+		REQUIRE(CHECK_COLUMN(result, 0, {1, 2, 3, 4}));
+		REQUIRE(CHECK_COLUMN(result, 1, {11, 2, 3, 4}));
+	}
+	DeleteDatabase(storage_database);
+}
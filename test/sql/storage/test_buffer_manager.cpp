@@ -2,6 +2,13 @@
 #include "duckdb/common/file_system.hpp"
 #include "test_helpers.hpp"
 #include "duckdb/storage/storage_info.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+#include <atomic>
+#include <thread>
 
 using namespace duckdb;
 using namespace std;
@@ -222,3 +229,321 @@ TEST_CASE("Modifying the buffer manager limit at runtime for an in-memory databa
 	REQUIRE_NO_FAIL(con.Query("DROP TABLE test"));
 	REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit='1MB'"));
 }
+
+TEST_CASE("Test sorting data that exceeds the buffer manager size", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE test (a INTEGER, b VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 200000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger((i * 7919) % 200000);
+			if (i % 10 == 0) {
+				appender->AppendValue(Value());
+			} else {
+				appender->AppendValue(Value("thisisastringvalue" + to_string(i % 1000)));
+			}
+			appender->EndRow();
+		}
+		con.CloseAppender();
+
+		// sort once without a memory limit to obtain the expected result
+		auto expected_integers = SQLQuery(con, "SELECT a, b FROM test ORDER BY a DESC");
+		REQUIRE_NO_FAIL(*expected_integers);
+		auto expected_strings = SQLQuery(con, "SELECT b, a FROM test ORDER BY b, a");
+		REQUIRE_NO_FAIL(*expected_strings);
+
+		// the sort does not fit in 4MB: the sorted runs have to be offloaded to the temporary directory
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA memory_limit='4MB'"));
+		for (index_t threads = 1; threads <= 4; threads += 3) {
+			REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=" + to_string(threads)));
+			result = SQLQuery(con, "SELECT a, b FROM test ORDER BY a DESC");
+			REQUIRE_NO_FAIL(*result);
+			REQUIRE(result->Equals(*expected_integers));
+			result = SQLQuery(con, "SELECT b, a FROM test ORDER BY b, a");
+			REQUIRE_NO_FAIL(*result);
+			REQUIRE(result->Equals(*expected_strings));
+		}
+		// a LIMIT on top of the sort stops reading the runs early
+		result = SQLQuery(con, "SELECT a FROM test ORDER BY a LIMIT 3");
+		REQUIRE(CHECK_COLUMN(result, 0, {0, 1, 2}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test joining tables of which the build side exceeds the buffer manager size", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE build (a INTEGER, b VARCHAR);"));
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE probe (a INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "build");
+		for (int32_t i = 0; i < 200000; i++) {
+			appender->BeginRow();
+			if (i % 100 == 0) {
+				appender->AppendValue(Value());
+			} else {
+				appender->AppendInteger(i);
+			}
+			appender->AppendValue(Value("thisisastringvalue" + to_string(i % 1000)));
+			appender->EndRow();
+		}
+		con.CloseAppender();
+		appender = con.OpenAppender(DEFAULT_SCHEMA, "probe");
+		for (int32_t i = 0; i < 100000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i * 3);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+
+		vector<string> queries = {
+		    "SELECT COUNT(*), SUM(probe.a), MIN(b), MAX(b) FROM probe JOIN build ON probe.a=build.a",
+		    "SELECT COUNT(*), COUNT(b), MIN(b), MAX(b) FROM probe LEFT JOIN build ON probe.a=build.a",
+		    "SELECT COUNT(*), SUM(a) FROM probe WHERE a IN (SELECT a FROM build)",
+		    "SELECT COUNT(*), SUM(a) FROM probe WHERE a NOT IN (SELECT a FROM build)",
+		    "SELECT COUNT(*), SUM(a) FROM probe WHERE EXISTS (SELECT a FROM build WHERE build.a=probe.a)",
+		    "SELECT COUNT(*), SUM(a) FROM probe WHERE NOT EXISTS (SELECT a FROM build WHERE build.a=probe.a)"};
+		// run the joins once without a memory limit to obtain the expected results
+		vector<unique_ptr<QueryResult>> expected_results;
+		for (auto &query : queries) {
+			auto expected = SQLQuery(con, query);
+			REQUIRE_NO_FAIL(*expected);
+			expected_results.push_back(move(expected));
+		}
+
+		// the build side does not fit in 4MB: the join has to spill partitions to the temporary directory
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA memory_limit='4MB'"));
+		for (index_t threads = 1; threads <= 4; threads += 3) {
+			REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=" + to_string(threads)));
+			for (index_t i = 0; i < queries.size(); i++) {
+				result = SQLQuery(con, queries[i]);
+				REQUIRE_NO_FAIL(*result);
+				REQUIRE(result->Equals(*expected_results[i]));
+			}
+		}
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test aggregating a table of which the groups exceed the buffer manager size", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE test (a INTEGER, b INTEGER, c VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 300000; i++) {
+			appender->BeginRow();
+			if (i % 1000 == 0) {
+				appender->AppendValue(Value());
+			} else {
+				appender->AppendInteger(i % 150000);
+			}
+			appender->AppendInteger(i % 7);
+			appender->AppendValue(Value("thisisastringvalue" + to_string(i)));
+			appender->EndRow();
+		}
+		con.CloseAppender();
+
+		vector<string> queries = {
+		    "SELECT COUNT(*), SUM(s), MIN(m), MAX(m) FROM (SELECT a, SUM(b) s, MIN(c) m FROM test GROUP BY a) t",
+		    "SELECT COUNT(*), MIN(c), MAX(c) FROM (SELECT c FROM test GROUP BY c) t",
+		    "SELECT COUNT(*), SUM(d) FROM (SELECT a, COUNT(DISTINCT b) d FROM test GROUP BY a) t",
+		    "SELECT a, COUNT(*), MAX(c) FROM test GROUP BY a ORDER BY a LIMIT 5 OFFSET 100000"};
+		// run the aggregates once without a memory limit to obtain the expected results
+		vector<unique_ptr<QueryResult>> expected_results;
+		for (auto &query : queries) {
+			auto expected = SQLQuery(con, query);
+			REQUIRE_NO_FAIL(*expected);
+			expected_results.push_back(move(expected));
+		}
+
+		// the groups do not fit in 4MB: the aggregate has to spill its input to the temporary directory
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA memory_limit='4MB'"));
+		for (index_t threads = 1; threads <= 4; threads += 3) {
+			REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=" + to_string(threads)));
+			for (index_t i = 0; i < queries.size(); i++) {
+				result = SQLQuery(con, queries[i]);
+				REQUIRE_NO_FAIL(*result);
+				REQUIRE(result->Equals(*expected_results[i]));
+			}
+		}
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test scanning tables that exceed the buffer manager size from concurrent connections", "[storage]") {
+	constexpr index_t THREAD_COUNT = 8;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE big (a INTEGER, b VARCHAR);"));
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE small (a INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "big");
+		for (int32_t i = 0; i < 1000000; i++) {
+			auto value = "value-" + to_string(i);
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendString(value.c_str());
+			appender->EndRow();
+		}
+		con.CloseAppender();
+		appender = con.OpenAppender(DEFAULT_SCHEMA, "small");
+		for (int32_t i = 0; i < 1000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	{
+		// reload the database, so the tables are read from the blocks of the database file
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		// the big table takes up more than 20MB
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA memory_limit='16MB'"));
+		// every connection alternates between scanning the small table and the big table, the blocks are loaded,
+		// evicted and pinned concurrently by all connections
+		vector<unique_ptr<Connection>> connections;
+		for (index_t i = 0; i < THREAD_COUNT; i++) {
+			connections.push_back(make_unique<Connection>(db));
+		}
+		std::atomic<index_t> failures(0);
+		vector<thread> threads;
+		for (index_t i = 0; i < THREAD_COUNT; i++) {
+			threads.push_back(thread([&, i]() {
+				for (index_t j = 0; j < 5; j++) {
+					auto result = SQLQuery(*connections[i], "SELECT SUM(a) FROM small");
+					if (!CHECK_COLUMN(result, 0, {Value::BIGINT(499500)})) {
+						failures++;
+					}
+					result = SQLQuery(*connections[i], "SELECT COUNT(*), SUM(a), MAX(b) FROM big");
+					if (!CHECK_COLUMN(result, 0, {Value::BIGINT(1000000)}) ||
+					    !CHECK_COLUMN(result, 1, {Value::BIGINT(499999500000)}) ||
+					    !CHECK_COLUMN(result, 2, {"value-999999"})) {
+						failures++;
+					}
+				}
+			}));
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		REQUIRE(failures == 0);
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test limiting the memory that the operators of a query can reserve", "[storage]") {
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("storage_test");
+	auto config = GetTestConfig();
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), other(db);
+		auto &buffer_manager = *db.storage->buffer_manager;
+		REQUIRE_NO_FAIL(SQLQuery(con, "CREATE TABLE test (a INTEGER, b VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 300000; i++) {
+			auto value = "thisisastringvalue" + to_string(i);
+			appender->BeginRow();
+			appender->AppendInteger(i % 150000);
+			appender->AppendString(value.c_str());
+			appender->EndRow();
+		}
+		con.CloseAppender();
+
+		vector<string> queries = {
+		    "SELECT COUNT(*), MIN(m), MAX(m) FROM (SELECT a, MIN(b) m FROM test GROUP BY a) t",
+		    "SELECT COUNT(*), MIN(t1.b), MAX(t2.b) FROM test t1 JOIN test t2 ON t1.a=t2.a",
+		    "SELECT a, b FROM test ORDER BY b DESC"};
+		// without any memory limit the operators do not reserve memory
+		vector<unique_ptr<QueryResult>> expected_results;
+		for (auto &query : queries) {
+			auto expected = SQLQuery(con, query);
+			REQUIRE_NO_FAIL(*expected);
+			REQUIRE(con.context->query_memory.GetPeak() == 0);
+			expected_results.push_back(move(expected));
+		}
+
+		// limit the memory of the queries of one connection: its operators spill once their reservations are denied
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA query_memory_limit='2MB'"));
+		con.EnableProfiling();
+		for (index_t threads = 1; threads <= 4; threads += 3) {
+			REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA threads=" + to_string(threads)));
+			for (index_t i = 0; i < queries.size(); i++) {
+				result = SQLQuery(con, queries[i]);
+				REQUIRE_NO_FAIL(*result);
+				REQUIRE(result->Equals(*expected_results[i]));
+				// the peak memory of the query is reported by the profiler
+				auto peak = con.context->query_memory.GetPeak();
+				REQUIRE(peak > 0);
+				REQUIRE(peak <= 2000000);
+				auto profile = con.context->profiler.ToString();
+				REQUIRE(profile.find("Peak Memory: " + to_string(peak) + " bytes") != string::npos);
+				// the reservations are released when the query is finished
+				REQUIRE(buffer_manager.GetReservedMemory() == 0);
+			}
+		}
+		con.DisableProfiling();
+		// the limit only applies to the queries of that connection
+		result = SQLQuery(other, queries[0]);
+		REQUIRE(result->Equals(*expected_results[0]));
+		REQUIRE(other.context->query_memory.GetPeak() == 0);
+
+		// a reservation is denied when the query would exceed its limit
+		QueryMemory query_memory(buffer_manager);
+		query_memory.Reset(1000000);
+		{
+			MemoryReservation reservation(query_memory), other_reservation(query_memory);
+			REQUIRE(reservation.TryResize(600000));
+			REQUIRE(!other_reservation.TryResize(600000));
+			REQUIRE_THROWS(other_reservation.Resize(600000));
+			REQUIRE(other_reservation.TryResize(400000));
+			REQUIRE(buffer_manager.GetReservedMemory() == 1000000);
+			reservation.Merge(other_reservation);
+			REQUIRE(reservation.GetSize() == 1000000);
+			REQUIRE(other_reservation.GetSize() == 0);
+			REQUIRE(reservation.TryResize(100000));
+			REQUIRE(query_memory.GetReserved() == 100000);
+			REQUIRE(query_memory.GetPeak() == 1000000);
+		}
+		REQUIRE(query_memory.GetReserved() == 0);
+		REQUIRE(buffer_manager.GetReservedMemory() == 0);
+
+		// a reservation is also denied when the buffer manager cannot evict enough blocks to stay within its limit
+		REQUIRE_NO_FAIL(SQLQuery(con, "PRAGMA memory_limit='4MB'"));
+		query_memory.Reset();
+		{
+			MemoryReservation reservation(query_memory);
+			REQUIRE(!reservation.TryResize(8000000));
+			REQUIRE(reservation.TryResize(1000000));
+			REQUIRE(buffer_manager.GetReservedMemory() == 1000000);
+		}
+		REQUIRE(buffer_manager.GetReservedMemory() == 0);
+	}
+	DeleteDatabase(storage_database);
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
 #include "test_helpers.hpp"
 
 using namespace duckdb;
@@ -35,3 +36,65 @@ TEST_CASE("Test functioning of checksum", "[storage]") {
 
 	DeleteDatabase(storage_database);
 }
+
+TEST_CASE("Test the checksum verification modes", "[storage]") {
+	FileSystem fs;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("checksum_test");
+	auto config = GetTestConfig();
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a BIGINT)"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int64_t i = 0; i < 1000000; i++) {
+			appender->BeginRow();
+			appender->AppendBigInt(i);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// the checksums of the blocks can be verified on every read, or only on the first read of every block
+	for (auto verification : {ChecksumVerification::ALWAYS, ChecksumVerification::FIRST_READ}) {
+		config->checksum_verification = verification;
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		// a low memory limit makes the blocks be evicted and read again
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit='1MB'"));
+		for (index_t i = 0; i < 3; i++) {
+			result = con.Query("SELECT SUM(a) FROM test");
+			REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(499999500000)}));
+		}
+	}
+
+	// now overwrite the checksum of the first block, leaving the contents of the block intact
+	auto handle = fs.OpenFile(storage_database, FileFlags::WRITE);
+	uint64_t checksum = 0;
+	fs.Write(*handle, &checksum, sizeof(uint64_t), Storage::FILE_HEADER_SIZE * 3);
+	handle->Sync();
+	handle.reset();
+	for (auto verification : {ChecksumVerification::ALWAYS, ChecksumVerification::FIRST_READ}) {
+		// the block is either read while the database is loaded or when the table is scanned, both of which fail
+		config->checksum_verification = verification;
+		unique_ptr<DuckDB> db;
+		try {
+			db = make_unique<DuckDB>(storage_database, config.get());
+		} catch (...) {
+			continue;
+		}
+		Connection con(*db);
+		REQUIRE_FAIL(con.Query("SELECT SUM(a) FROM test"));
+	}
+	// without verification the block can be read
+	config->checksum_verification = ChecksumVerification::NEVER;
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(499999500000)}));
+	}
+	DeleteDatabase(storage_database);
+}
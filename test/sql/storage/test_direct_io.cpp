@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test storing a database with Direct IO", "[storage]") {
+	auto config = GetTestConfig();
+	config->use_direct_io = true;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("direct_io_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b VARCHAR)"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 200000; i++) {
+			auto value = "value-" + to_string(i);
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendString(value.c_str());
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	for (index_t reload = 0; reload < 2; reload++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), MIN(b), MAX(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {200000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(19999900000)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {"value-0"}));
+		REQUIRE(CHECK_COLUMN(result, 3, {"value-99999"}));
+		// the sort does not fit in 4MB: the sorted runs are offloaded to temporary files, which also use Direct IO
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit='4MB'"));
+		result = con.Query("SELECT a, b FROM test ORDER BY a DESC LIMIT 2");
+		REQUIRE(CHECK_COLUMN(result, 0, {199999, 199998}));
+		REQUIRE(CHECK_COLUMN(result, 1, {"value-199999", "value-199998"}));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=-1"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (-1, NULL)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=-1"));
+	}
+	DeleteDatabase(storage_database);
+}
@@ -0,0 +1,59 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test committing concurrent transactions with a shared WAL sync", "[storage]") {
+	constexpr int32_t THREAD_COUNT = 8;
+	constexpr int32_t INSERT_COUNT = 200;
+	constexpr int64_t TOTAL_COUNT = THREAD_COUNT * INSERT_COUNT;
+	auto config = GetTestConfig();
+	config->wal_group_commit_window = 100;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("group_commit_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER PRIMARY KEY, b INTEGER);"));
+		// every connection commits its inserts one by one, the commits of the connections are synced together
+		vector<thread> threads;
+		vector<int32_t> success(THREAD_COUNT, 1);
+		for (int32_t t = 0; t < THREAD_COUNT; t++) {
+			threads.push_back(thread([&db, &success, t]() {
+				Connection thread_con(db);
+				for (int32_t i = 0; i < INSERT_COUNT; i++) {
+					int32_t value = t * INSERT_COUNT + i;
+					auto insert = thread_con.Query("INSERT INTO test VALUES (" + to_string(value) + ", " +
+					                               to_string(t) + ")");
+					if (!insert->success) {
+						success[t] = 0;
+					}
+				}
+			}));
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		for (int32_t t = 0; t < THREAD_COUNT; t++) {
+			REQUIRE(success[t]);
+		}
+		result = con.Query("SELECT COUNT(*) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(TOTAL_COUNT)}));
+	}
+	// all committed transactions are replayed from the WAL
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), SUM(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(TOTAL_COUNT)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(TOTAL_COUNT * (TOTAL_COUNT - 1) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(INSERT_COUNT * THREAD_COUNT * (THREAD_COUNT - 1) / 2)}));
+	}
+	DeleteDatabase(storage_database);
+}
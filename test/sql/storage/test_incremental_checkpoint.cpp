@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+static index_t GetDatabaseSize(FileSystem &fs, string path) {
+	auto handle = fs.OpenFile(path, FileFlags::READ);
+	return fs.GetFileSize(*handle);
+}
+
+TEST_CASE("Test incremental checkpoints", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 200000;
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("incremental_checkpoint_test");
+	string big_string(10000, 'x');
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (i INTEGER, s VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			if (i % 50000 == 1) {
+				appender->AppendString(big_string.c_str());
+			} else {
+				appender->AppendString(("value-" + to_string(i)).c_str());
+			}
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// the first checkpoint writes the entire table
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT)}));
+	}
+	auto initial_size = GetDatabaseSize(fs, storage_database);
+
+	// append a few rows at a time: the checkpoints only write the appended rows, and reuse the blocks of the rest of
+	// the table
+	for (int32_t i = 0; i < 5; i++) {
+		{
+			DuckDB db(storage_database, config.get());
+			Connection con(db);
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(VALUE_COUNT + i) + ", 'appended')"));
+		}
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT + i + 1)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT((int64_t)(VALUE_COUNT + i + 1) * (VALUE_COUNT + i) / 2)}));
+		result = con.Query("SELECT s FROM test WHERE i=50001 OR i=150000 OR i=" + to_string(VALUE_COUNT + i) +
+		                   " ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {big_string, "value-150000", "appended"}));
+	}
+	// update a few rows in the middle of the table: only the modified segments are rewritten
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET s='updated' WHERE i >= 100000 AND i < 100010"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM test WHERE s='updated'");
+		REQUIRE(CHECK_COLUMN(result, 0, {10}));
+		result = con.Query("SELECT s FROM test WHERE i=99999 OR i=100000 OR i=100010 OR i=150001 ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {"value-99999", "updated", "value-100010", big_string}));
+	}
+	// rewriting the entire table on every checkpoint would (at least) double the size of the database file
+	REQUIRE(GetDatabaseSize(fs, storage_database) < initial_size + 2 * 1024 * 1024);
+
+	// deleting rows changes the row ids of the table, which rewrites the entire table
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE i % 2 = 0"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), COUNT(s) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT((VALUE_COUNT + 5) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT((VALUE_COUNT + 5) / 2)}));
+		result = con.Query("SELECT s FROM test WHERE i=50001 OR i=100001 OR i=100003 OR i=" +
+		                   to_string(VALUE_COUNT + 3) + " ORDER BY i");
+		REQUIRE(CHECK_COLUMN(result, 0, {big_string, "updated", "updated", "appended"}));
+	}
+	DeleteDatabase(storage_database);
+}
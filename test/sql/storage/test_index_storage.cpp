@@ -0,0 +1,187 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test storing the index of a PRIMARY KEY", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 100000;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("index_storage_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER PRIMARY KEY, b INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendInteger(i % 100);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// reload the database a few times, the index is loaded from storage instead of being rebuilt
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (77777, 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (-1, 0)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=-1"));
+		result = con.Query("SELECT b FROM test WHERE a=77777");
+		REQUIRE(CHECK_COLUMN(result, 0, {77}));
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test WHERE a >= 1000 AND a < 2000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {49500}));
+	}
+	// delete rows: the remaining rows are moved when the table is checkpointed
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a % 2 = 0"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {VALUE_COUNT / 2}));
+		result = con.Query("SELECT b FROM test WHERE a=77777");
+		REQUIRE(CHECK_COLUMN(result, 0, {77}));
+		result = con.Query("SELECT b FROM test WHERE a=77778");
+		REQUIRE(CHECK_COLUMN(result, 0, {}));
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test WHERE a >= 1000 AND a < 2000");
+		REQUIRE(CHECK_COLUMN(result, 0, {500}));
+		REQUIRE(CHECK_COLUMN(result, 1, {25000}));
+		// the deleted keys can be inserted again, the remaining keys cannot
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (99999, 0)"));
+		if (i == 0) {
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (99998, 0)"));
+		} else {
+			REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (99998, 0)"));
+		}
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test storing CREATE INDEX indexes", "[storage]") {
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("index_storage_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (i INTEGER, j INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 10000; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendInteger(i * 2);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+		REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON test(i)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE INDEX expr_index ON test using art((i+j))"));
+	}
+	// the indexes are replayed from the WAL and then stored in the checkpoint
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON test(i)"));
+		REQUIRE_FAIL(con.Query("CREATE INDEX expr_index ON test(j)"));
+		result = con.Query("SELECT j FROM test WHERE i=4242");
+		REQUIRE(CHECK_COLUMN(result, 0, {8484}));
+		result = con.Query("SELECT i FROM test WHERE i+j=300");
+		REQUIRE(CHECK_COLUMN(result, 0, {100}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE i >= 100 AND i < 200");
+		REQUIRE(CHECK_COLUMN(result, 0, {100}));
+	}
+	// modify the table and drop one of the indexes
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE i < 5000"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (4242, 0)"));
+		REQUIRE_NO_FAIL(con.Query("DROP INDEX expr_index"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT j FROM test WHERE i=4242");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		result = con.Query("SELECT j FROM test WHERE i=7000");
+		REQUIRE(CHECK_COLUMN(result, 0, {14000}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE i >= 100 AND i < 200");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON test(i)"));
+	}
+	{
+		// the dropped index can be created again
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE INDEX expr_index ON test using art((i+j))"));
+		result = con.Query("SELECT i FROM test WHERE i+j=21000");
+		REQUIRE(CHECK_COLUMN(result, 0, {7000}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test checkpointing a stored index without reading all of its nodes", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 100000;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("index_storage_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER PRIMARY KEY, b INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendInteger(i % 100);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// no rows are deleted: the checkpoints (both while the database is running and when it is started) only write the
+	// nodes that were read, and keep the other nodes where they are stored
+	for (int32_t i = 0; i < 10; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(VALUE_COUNT + i) + ", 0)"));
+		db.storage->CreateCheckpoint();
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(i * 7777) + ", 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (" + to_string(-1 - i) + ", 0)"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {VALUE_COUNT + 20}));
+		result = con.Query("SELECT b FROM test WHERE a=77777");
+		REQUIRE(CHECK_COLUMN(result, 0, {77}));
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test WHERE a >= 1000 AND a < 2000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {49500}));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (0, 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (99999, 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (100009, 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test VALUES (-10, 0)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (100010, 0)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test WHERE a=100010"));
+	}
+	DeleteDatabase(storage_database);
+}
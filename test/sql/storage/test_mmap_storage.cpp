@@ -0,0 +1,54 @@
+#include "catch.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test reading a memory-mapped read-only database", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 200000;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("mmap_storage_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, GetTestConfig().get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (i INTEGER, s VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendString(("value-" + to_string(i)).c_str());
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	{
+		// checkpoint the database, so all data is stored in the database file
+		DuckDB db(storage_database, GetTestConfig().get());
+	}
+	DBConfig config;
+	config.access_mode = AccessMode::READ_ONLY;
+	config.use_mmap = true;
+	// the mapped blocks are not loaded into the buffer manager: the table can be read with a memory limit that is much
+	// smaller than the table, even though no blocks can be evicted to a temporary directory
+	config.use_temporary_directory = false;
+	config.maximum_memory = 1 << 20;
+	{
+		// several databases can share the mapped file
+		DuckDB db1(storage_database, &config), db2(storage_database, &config);
+		Connection con1(db1), con2(db2);
+		for (auto con : {&con1, &con2}) {
+			result = con->Query("SELECT COUNT(*), SUM(i), SUM(LENGTH(s)) FROM test");
+			REQUIRE(CHECK_COLUMN(result, 0, {VALUE_COUNT}));
+			REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT((int64_t)VALUE_COUNT * (VALUE_COUNT - 1) / 2)}));
+			REQUIRE(CHECK_COLUMN(result, 2, {2288890}));
+			result = con->Query("SELECT s FROM test WHERE i=123456");
+			REQUIRE(CHECK_COLUMN(result, 0, {"value-123456"}));
+			REQUIRE_FAIL(con->Query("INSERT INTO test VALUES (1, 'x')"));
+		}
+	}
+	DeleteDatabase(storage_database);
+}
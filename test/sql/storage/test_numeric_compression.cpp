@@ -0,0 +1,135 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test storing compressed numeric columns", "[storage]") {
+	constexpr int64_t VALUE_COUNT = 100000;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("compression_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		// create a database with columns that favor the different compression methods
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(
+		    con.Query("CREATE TABLE test (a INTEGER, b BIGINT, c SMALLINT, d DOUBLE, e BIGINT, f TINYINT, g BOOLEAN);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int64_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			// a sequence (delta)
+			appender->AppendInteger(i);
+			// a constant with NULL values (RLE)
+			if (i % 7 == 0) {
+				appender->AppendValue(Value());
+			} else {
+				appender->AppendBigInt(42);
+			}
+			// a small range (bit-packing)
+			appender->AppendSmallInt(i % 100 - 50);
+			// doubles
+			appender->AppendDouble(i * 0.5);
+			// the extremes of the domain (uncompressed)
+			appender->AppendBigInt(i % 2 == 0 ? 9223372036854775807LL : -9223372036854775807LL);
+			// runs of values
+			appender->AppendTinyInt((i / 1000) % 100);
+			appender->AppendBoolean(i % 3 == 0);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// reload the database a few times, the data is compressed when it is checkpointed
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), MIN(a), MAX(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(VALUE_COUNT * (VALUE_COUNT - 1) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {0}));
+		REQUIRE(CHECK_COLUMN(result, 3, {Value::INTEGER(VALUE_COUNT - 1)}));
+		result = con.Query("SELECT COUNT(b), SUM(b), MIN(b), MAX(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT - (VALUE_COUNT + 6) / 7)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(42 * (VALUE_COUNT - (VALUE_COUNT + 6) / 7))}));
+		REQUIRE(CHECK_COLUMN(result, 2, {42}));
+		REQUIRE(CHECK_COLUMN(result, 3, {42}));
+		result = con.Query("SELECT SUM(c), MIN(c), MAX(c), SUM(d), MIN(e), MAX(e), SUM(f) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(-50 * VALUE_COUNT / 100)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {-50}));
+		REQUIRE(CHECK_COLUMN(result, 2, {49}));
+		REQUIRE(CHECK_COLUMN(result, 3, {Value::DOUBLE(0.5 * VALUE_COUNT * (VALUE_COUNT - 1) / 2)}));
+		REQUIRE(CHECK_COLUMN(result, 4, {Value::BIGINT(-9223372036854775807LL)}));
+		REQUIRE(CHECK_COLUMN(result, 5, {Value::BIGINT(9223372036854775807LL)}));
+		REQUIRE(CHECK_COLUMN(result, 6, {Value::BIGINT(4950 * 1000)}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE g");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT((VALUE_COUNT + 2) / 3)}));
+		// fetch individual values
+		result = con.Query("SELECT a, b, c, d, e, f, g FROM test WHERE a=70000 OR a=70001");
+		REQUIRE(CHECK_COLUMN(result, 0, {70000, 70001}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value(), 42}));
+		REQUIRE(CHECK_COLUMN(result, 2, {-50, -49}));
+		REQUIRE(CHECK_COLUMN(result, 3, {35000.0, 35000.5}));
+		REQUIRE(CHECK_COLUMN(result, 4, {Value::BIGINT(9223372036854775807LL), Value::BIGINT(-9223372036854775807LL)}));
+		REQUIRE(CHECK_COLUMN(result, 5, {70, 70}));
+		REQUIRE(CHECK_COLUMN(result, 6, {false, false}));
+	}
+	// update the compressed data after a reload
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET a=a+1, b=NULL WHERE a % 1000 = 0"));
+		result = con.Query("SELECT SUM(a), COUNT(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT * (VALUE_COUNT - 1) / 2 + VALUE_COUNT / 1000)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(VALUE_COUNT - (VALUE_COUNT + 6) / 7 - 85)}));
+	}
+	// reload and verify the updated data
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT SUM(a), COUNT(b) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(VALUE_COUNT * (VALUE_COUNT - 1) / 2 + VALUE_COUNT / 1000)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(VALUE_COUNT - (VALUE_COUNT + 6) / 7 - 85)}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test that compressed numeric columns reduce the database size", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 500000;
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("compression_size_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// force a checkpoint by reloading
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT SUM(a) FROM test");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT((int64_t)VALUE_COUNT * (VALUE_COUNT - 1) / 2)}));
+	}
+	// the uncompressed column would take up (at least) 2MB, the compressed segments share a single block
+	{
+		auto handle = fs.OpenFile(storage_database, FileFlags::READ);
+		REQUIRE(fs.GetFileSize(*handle) < 1024 * 1024);
+	}
+	DeleteDatabase(storage_database);
+}
@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test checkpointing multiple tables with multiple threads", "[storage]") {
+	constexpr index_t TABLE_COUNT = 8;
+	auto config = GetTestConfig();
+	config->maximum_threads = 4;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("parallel_checkpoint_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		for (index_t i = 0; i < TABLE_COUNT; i++) {
+			auto table_name = "test" + to_string(i);
+			REQUIRE_NO_FAIL(con.Query("CREATE TABLE " + table_name +
+			                          " (a INTEGER PRIMARY KEY, b BIGINT, c VARCHAR, d DOUBLE, e VARCHAR)"));
+			auto appender = con.OpenAppender(DEFAULT_SCHEMA, table_name);
+			for (int32_t x = 0; x < (int32_t)(50000 + i * 1000); x++) {
+				auto value = "value-" + to_string(x);
+				appender->BeginRow();
+				appender->AppendInteger(x);
+				appender->AppendBigInt(x * 2);
+				appender->AppendString(value.c_str());
+				appender->AppendDouble(x / 2.0);
+				if (x % 3 == 0) {
+					appender->AppendValue(Value());
+				} else {
+					appender->AppendString("abc");
+				}
+				appender->EndRow();
+			}
+			con.CloseAppender();
+		}
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test3 WHERE a % 2 = 0"));
+	}
+	// the tables are checkpointed concurrently on every reload
+	for (index_t reload = 0; reload < 3; reload++) {
+		{
+			DuckDB db(storage_database, config.get());
+			Connection con(db);
+			for (index_t i = 0; i < TABLE_COUNT; i++) {
+				auto table_name = "test" + to_string(i);
+				int64_t count = 50000 + i * 1000;
+				result = con.Query("SELECT COUNT(*), SUM(a), SUM(b), COUNT(c), SUM(d), COUNT(e) FROM " + table_name);
+				if (i == 3) {
+					REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(count / 2)}));
+					REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT((count / 2) * (count / 2))}));
+				} else {
+					REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(count)}));
+					REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(count * (count - 1) / 2)}));
+					REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(count * (count - 1))}));
+					REQUIRE(CHECK_COLUMN(result, 3, {Value::BIGINT(count)}));
+					REQUIRE(CHECK_COLUMN(result, 4, {Value::DOUBLE(count * (count - 1) / 4.0)}));
+					REQUIRE(CHECK_COLUMN(result, 5, {Value::BIGINT(count - (count + 2) / 3)}));
+				}
+				result = con.Query("SELECT c FROM " + table_name + " WHERE a=12345");
+				REQUIRE(CHECK_COLUMN(result, 0, {"value-12345"}));
+				REQUIRE_FAIL(con.Query("INSERT INTO " + table_name + " VALUES (12345, 0, NULL, NULL, NULL)"));
+			}
+			// modify some of the tables before the next reload
+			REQUIRE_NO_FAIL(con.Query("UPDATE test1 SET c='value-' || a WHERE a < 1000"));
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO test2 VALUES (-1, 0, NULL, NULL, NULL)"));
+			REQUIRE_NO_FAIL(con.Query("DELETE FROM test2 WHERE a=-1"));
+		}
+	}
+	DeleteDatabase(storage_database);
+}
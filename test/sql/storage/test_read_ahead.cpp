@@ -0,0 +1,59 @@
+#include "catch.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test scanning persistent tables while their blocks are read ahead", "[storage]") {
+	auto config = GetTestConfig();
+	config->maximum_threads = 4;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("read_ahead_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (a INTEGER, b BIGINT, c VARCHAR, d DOUBLE)"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < 500000; i++) {
+			auto value = "value-" + to_string(i);
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			appender->AppendBigInt(i * 2);
+			appender->AppendString(value.c_str());
+			appender->AppendDouble(i / 2.0);
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	for (index_t reload = 0; reload < 2; reload++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		// a low memory limit leaves no room to prefetch most of the blocks: they are read when they are pinned
+		for (auto memory_limit : {"-1", "'4MB'"}) {
+			REQUIRE_NO_FAIL(con.Query(string("PRAGMA memory_limit=") + memory_limit));
+			for (index_t i = 0; i < 2; i++) {
+				result = con.Query("SELECT COUNT(*), SUM(a), SUM(b), COUNT(c), SUM(d) FROM test");
+				REQUIRE(CHECK_COLUMN(result, 0, {500000}));
+				REQUIRE(CHECK_COLUMN(result, 1, {Value::BIGINT(124999750000)}));
+				REQUIRE(CHECK_COLUMN(result, 2, {Value::BIGINT(249999500000)}));
+				REQUIRE(CHECK_COLUMN(result, 3, {500000}));
+				REQUIRE(CHECK_COLUMN(result, 4, {Value::DOUBLE(62499875000.0)}));
+				result = con.Query("SELECT c FROM test WHERE a=123456");
+				REQUIRE(CHECK_COLUMN(result, 0, {"value-123456"}));
+			}
+		}
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit=-1"));
+		if (reload == 0) {
+			// segments that have been updated are not read from their blocks anymore
+			REQUIRE_NO_FAIL(con.Query("UPDATE test SET b=b+1 WHERE a < 100000"));
+			result = con.Query("SELECT SUM(b) FROM test");
+			REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(249999600000)}));
+			REQUIRE_NO_FAIL(con.Query("UPDATE test SET b=b-1 WHERE a < 100000"));
+		}
+	}
+	DeleteDatabase(storage_database);
+}
@@ -87,7 +87,12 @@ TEST_CASE("CREATE INDEX statement after shutdown", "[storage]") {
 
 		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11, 24)"));
 
-		REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON test using art(a)"));
+		if (i == 0) {
+			REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON test using art(a)"));
+		} else {
+			// the index is persistent
+			REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON test using art(a)"));
+		}
 
 		result = con.Query("SELECT a, b FROM test WHERE a=11 ORDER BY b");
 		REQUIRE(CHECK_COLUMN(result, 0, {11, 11}));
@@ -114,7 +119,7 @@ TEST_CASE("CREATE INDEX statement after shutdown", "[storage]") {
 
 		REQUIRE_NO_FAIL(con.Query("INSERT INTO test VALUES (11, 24)"));
 
-		REQUIRE_NO_FAIL(con.Query("CREATE INDEX i_index ON test using art(a)"));
+		REQUIRE_FAIL(con.Query("CREATE INDEX i_index ON test using art(a)"));
 
 		result = con.Query("SELECT a, b FROM test WHERE a=11 ORDER BY b");
 		REQUIRE(CHECK_COLUMN(result, 0, {11, 11}));
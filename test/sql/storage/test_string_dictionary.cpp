@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/appender.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test storing low-cardinality string columns with a dictionary", "[storage]") {
+	constexpr int32_t VALUE_COUNT = 200000;
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("string_dictionary_test");
+	vector<string> countries = {"Netherlands", "Germany", "France", "Belgium", "Luxembourg"};
+	string big_string(10000, 'x');
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test (i INTEGER, country VARCHAR);"));
+		auto appender = con.OpenAppender(DEFAULT_SCHEMA, "test");
+		for (int32_t i = 0; i < VALUE_COUNT; i++) {
+			appender->BeginRow();
+			appender->AppendInteger(i);
+			if (i % 10 == 9) {
+				appender->AppendValue(Value());
+			} else if (i % 1000 == 1) {
+				appender->AppendString(big_string.c_str());
+			} else {
+				appender->AppendString(countries[i % countries.size()].c_str());
+			}
+			appender->EndRow();
+		}
+		con.CloseAppender();
+	}
+	// reload the database a few times, the strings are deduplicated when they are checkpointed
+	for (index_t i = 0; i < 2; i++) {
+		{
+			DuckDB db(storage_database, config.get());
+			Connection con(db);
+			result = con.Query("SELECT country, COUNT(*) FROM test GROUP BY country ORDER BY country");
+			REQUIRE(CHECK_COLUMN(result, 0,
+			                     {Value(), "Belgium", "France", "Germany", "Luxembourg", "Netherlands", big_string}));
+			REQUIRE(CHECK_COLUMN(result, 1, {20000, 40000, 40000, 39800, 20000, 40000, 200}));
+			result = con.Query("SELECT COUNT(*) FROM test WHERE country='Germany'");
+			REQUIRE(CHECK_COLUMN(result, 0, {39800}));
+			result = con.Query("SELECT COUNT(*) FROM test WHERE country<>'Germany'");
+			REQUIRE(CHECK_COLUMN(result, 0, {140200}));
+			result = con.Query("SELECT country FROM test WHERE i=11 OR i=12 OR i=19 OR i=1001 ORDER BY i");
+			REQUIRE(CHECK_COLUMN(result, 0, {"Germany", "France", Value(), big_string}));
+		}
+		if (i == 0) {
+			// the rows share the dictionary entries of the segments, and the big string is written to the overflow
+			// blocks only once: the file holds the 3 file headers, 4 blocks of string segments, 1 overflow block, 1
+			// block with the compressed integer column and 2 meta blocks. Writing the big string once for every segment
+			// takes 3 more overflow blocks, without any deduplication the strings take up more than 7MB.
+			auto handle = fs.OpenFile(storage_database, FileFlags::READ);
+			REQUIRE(fs.GetFileSize(*handle) <= 3 * Storage::FILE_HEADER_SIZE + 8 * Storage::BLOCK_ALLOC_SIZE);
+		}
+	}
+	// update the strings after a reload, and reload again
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("UPDATE test SET country='Austria' WHERE country='Germany' AND i < 1000"));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE country='Germany'");
+		REQUIRE(CHECK_COLUMN(result, 0, {39601}));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM test WHERE country='Germany'");
+		REQUIRE(CHECK_COLUMN(result, 0, {39601}));
+		result = con.Query("SELECT COUNT(*) FROM test WHERE country='Austria'");
+		REQUIRE(CHECK_COLUMN(result, 0, {199}));
+	}
+	DeleteDatabase(storage_database);
+}
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test replaying the WAL of multiple tables in parallel", "[storage]") {
+	constexpr index_t TABLE_COUNT = 4;
+	constexpr int32_t ROW_COUNT = 300;
+	auto config = GetTestConfig();
+	config->maximum_threads = 4;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("wal_replay_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		for (index_t i = 0; i < TABLE_COUNT; i++) {
+			REQUIRE_NO_FAIL(con.Query("CREATE TABLE test" + to_string(i) + " (a INTEGER PRIMARY KEY, b INTEGER)"));
+		}
+		// many small transactions that alternate between the tables
+		for (int32_t i = 0; i < ROW_COUNT; i++) {
+			for (index_t j = 0; j < TABLE_COUNT; j++) {
+				auto value = to_string(i);
+				REQUIRE_NO_FAIL(
+				    con.Query("INSERT INTO test" + to_string(j) + " VALUES (" + value + ", " + value + ")"));
+			}
+		}
+		// deletes and updates of the appended rows
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test0 WHERE a % 2 = 0"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE test1 SET b=b+1000 WHERE a < 50"));
+		// a transaction that changes the catalog as well as the data
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE other (i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO other VALUES (1), (2), (3)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM test2 WHERE a >= 290"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test2 VALUES (295, 0)"));
+		REQUIRE_NO_FAIL(con.Query("DROP TABLE test3"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE test3 (a INTEGER PRIMARY KEY, b INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO test3 VALUES (1, 1)"));
+	}
+	// the WAL is replayed on every reload
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test0");
+		REQUIRE(CHECK_COLUMN(result, 0, {ROW_COUNT / 2}));
+		REQUIRE(CHECK_COLUMN(result, 1, {(ROW_COUNT / 2) * (ROW_COUNT / 2)}));
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test1");
+		REQUIRE(CHECK_COLUMN(result, 0, {ROW_COUNT}));
+		REQUIRE(CHECK_COLUMN(result, 1, {ROW_COUNT * (ROW_COUNT - 1) / 2 + 50 * 1000}));
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM test2");
+		REQUIRE(CHECK_COLUMN(result, 0, {291}));
+		REQUIRE(CHECK_COLUMN(result, 1, {290 * 289 / 2}));
+		result = con.Query("SELECT * FROM test3");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		REQUIRE(CHECK_COLUMN(result, 1, {1}));
+		result = con.Query("SELECT SUM(i) FROM other");
+		REQUIRE(CHECK_COLUMN(result, 0, {6}));
+		// the indexes contain the replayed rows
+		REQUIRE_FAIL(con.Query("INSERT INTO test1 VALUES (1, 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test2 VALUES (295, 0)"));
+		REQUIRE_FAIL(con.Query("INSERT INTO test3 VALUES (1, 0)"));
+		result = con.Query("SELECT b FROM test0 WHERE a=101");
+		REQUIRE(CHECK_COLUMN(result, 0, {101}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test replaying the WAL of keys that are deleted and inserted again", "[storage]") {
+	auto config = GetTestConfig();
+	config->maximum_threads = 4;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("wal_replay_test");
+
+	// make sure the database does not exist
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE keys (a INTEGER PRIMARY KEY, b INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE plain (a INTEGER, b INTEGER)"));
+	}
+	// the tables are created by the checkpoint: the WAL of the following transactions contains only data operations
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		for (int32_t i = 0; i < 10; i++) {
+			for (auto table : {"keys", "plain"}) {
+				auto table_name = string(table);
+				REQUIRE_NO_FAIL(con.Query("INSERT INTO " + table_name + " VALUES (1, " + to_string(i) + ")"));
+				REQUIRE_NO_FAIL(con.Query("DELETE FROM " + table_name + " WHERE a=1"));
+			}
+		}
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO keys VALUES (1, 100)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO plain VALUES (1, 100)"));
+	}
+	for (index_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT a, b FROM keys");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		REQUIRE(CHECK_COLUMN(result, 1, {100}));
+		result = con.Query("SELECT a, b FROM plain");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		REQUIRE(CHECK_COLUMN(result, 1, {100}));
+		REQUIRE_FAIL(con.Query("INSERT INTO keys VALUES (1, 0)"));
+	}
+	DeleteDatabase(storage_database);
+}